@@ -1,26 +1,54 @@
 /******************************************** INCLUDES ********************************************/
 /* System includes */
+#include <Arduino.h>
 
 /* Custom includes */
-#include <arduino.h> // TODO: just to use Serial.print
 #include "ActuadorLineal.h"
 
 
+/******************************************** GLOBALS *********************************************/
+LinearServo_cl* LinearServo_cl::apclInstances_[LINEAR_SERVO_MAX_INSTANCES_UC] = {};
+
+void (* const LinearServo_cl::apfHallSensorIsrs_[LINEAR_SERVO_MAX_INSTANCES_UC])() = 
+{
+	LinearServo_cl::vHallSensorIsr<0>,
+	LinearServo_cl::vHallSensorIsr<1>,
+	LinearServo_cl::vHallSensorIsr<2>,
+};
+static_assert(LINEAR_SERVO_MAX_INSTANCES_UC == 3, "Add one trampoline for each servo instance");
+
+
 /******************************************** FUNCTION *****************************************//**
 ***************************************************************************************************/
 LinearServo_cl::LinearServo_cl()
 {
-
+	ulCurrentTurns_      = 0;
+	ulLastPulseTimeUs_   = 0;
+	ulDebounceUs_        = HALL_DEBOUNCE_US_UL;
+	eServoState_         = SERVOSTATE_STOPPED;
+	ulMaxTurns_          = 0;
+	ulRejectedPulses_    = 0;
+	scDirection_         = 0;
+	ulStopTimeUs_        = 0;
+	ulPulsePeriodUs_     = 0;
+	ucMovementPulses_    = 0;
+	ulLastSwitchTimeMs_  = 0;
+	ulRelaySwitches_     = 0;
+	ulOvershoots_        = 0;
+	sStopTargetTurns_   = 0;
+	bOvershootChecked_   = true;
+	bHallAttached_       = false;
 }
 
 /******************************************** FUNCTION *****************************************//**
 ***************************************************************************************************/
-void LinearServo_cl::vSetup(const int   ulRelayRetractionPin, 
+bool LinearServo_cl::bSetup(const int   ulRelayRetractionPin, 
 							const int   ulRelayExtensionPin, 
 							const int   ulHallSensorPin, 
 							const float fServoTotalLenght, 
 							const float fServoUsedLength, 
-							const int   ulMaxTurns)
+							const int   ulMaxTurns,
+							const int   ulInitialTurns)
 {
 	/* Store input variables */
 	ulRelayRetractionPin_ = ulRelayRetractionPin;
@@ -30,54 +58,115 @@ void LinearServo_cl::vSetup(const int   ulRelayRetractionPin,
 	fServoUsedLength_ = fServoUsedLength;
 	ulMaxTurns_ = ulMaxTurns;
 
-	/* Attach the interrupt function */
-	attachInterrupt(digitalPinToInterrupt(ulHallSensorPin), vReadHallSensor, RISING);
-
 	/* Declare pint for relays and hall sensor */
 	pinMode(ulRelayRetractionPin_, OUTPUT); 
 	pinMode(ulRelayExtensionPin_,  OUTPUT); 
 	pinMode(ulHallSensorPin_,      INPUT);
 
-	/* Retract actuator completely, to start from a known position */
-	Serial.println("Initial retraction...");
-	vRetractServo();
-	delay(CALIBRATION_TIME_MS_ULL);
- 	ulCurrentTurns_ = 0;
+	/* Release both relays, the servo starts stopped */
+	digitalWrite(ulRelayExtensionPin_,  HIGH);
+	digitalWrite(ulRelayRetractionPin_, HIGH);
+
+	/* Attach the interrupt function, through the trampoline of a free slot. Without it the position
+	can't be followed, so the servo is left stopped */
+	bHallAttached_ = false;
+	for (unsigned char ucSlot = 0; ucSlot < LINEAR_SERVO_MAX_INSTANCES_UC && !bHallAttached_; ucSlot++)
+	{
+		if (apclInstances_[ucSlot] == NULL || apclInstances_[ucSlot] == this)
+		{
+			apclInstances_[ucSlot] = this;
+			attachInterrupt(digitalPinToInterrupt(ulHallSensorPin), apfHallSensorIsrs_[ucSlot], RISING);
+			bHallAttached_ = true;
+		}
+	}
+	if (!bHallAttached_)
+	{
+		bCalibrating_ = false;
+		return false;
+	}
 
 	/* Compute extension/turns ratio */
 	fExtensionTurnRatio_ = fServoTotalLenght / ulMaxTurns;	
+	fRequestedLength_ = 0.0f;
+
+	/* Start from the known position, if any */
+	bCalibrating_ = false;
+	if (ulInitialTurns != UNKNOWN_TURNS_UL)
+	{
+		ulCurrentTurns_ = min(ulInitialTurns, ulMaxTurns);
+		return true;
+	}
 
-	/* Set to false the calibration boolean */
-	bCalibrating_ = false;	
+	/* Retract actuator completely, to start from a known position. vOperate() ends the calibration,
+	so the rest of the system does not need to wait */
+	vCalibrate();
+	return true;
 }
 
 /******************************************** FUNCTION *****************************************//**
 ***************************************************************************************************/
 void LinearServo_cl::vOperate() 
 {
+	/* The position can't be followed without the hall sensor */
+	if (!bHallAttached_)
+	{
+		return;
+	}
+
 	/* Check if it is in calibration mode or not */
 	if (!bCalibrating_) 
 	{ 
 		/* Compute the target number of turns */
 		ulTargetTurns_ = fRequestedLength_ / fExtensionTurnRatio_;
 
-		/* Compare current position with target position */
-		if (ulTargetTurns_ > ulCurrentTurns_ &&
-			abs(ulTargetTurns_ - ulCurrentTurns_) > MAX_TURNS_ERROR_UL) 
+		/* Estimate the position, and the turns that the servo travels after releasing the relays */
+		float fSpeedTurnsPerSec = 0.0f;
+		float fError = ulTargetTurns_ - fEstimateTurns(fSpeedTurnsPerSec);
+		float fBrakingTurns = fSpeedTurnsPerSec * SERVO_COAST_TIME_MS_UL / 1000.0f;
+
+		ServoState_e eNewState = eServoState_;
+		if (eServoState_ == SERVOSTATE_EXTENDING)
+		{
+			/* Stop early, the servo coasts to the target */
+			if (fError <= fBrakingTurns)
+			{
+				eNewState = SERVOSTATE_STOPPED;
+			}
+		}
+		else if (eServoState_ == SERVOSTATE_RETRACTING)
 		{
-			/* Need to extend */
-			vExtendServo();
+			if (-fError <= fBrakingTurns)
+			{
+				eNewState = SERVOSTATE_STOPPED;
+			}
 		}
-		else if (ulTargetTurns_ < ulCurrentTurns_ &&
-				 abs(ulTargetTurns_ - ulCurrentTurns_) > MAX_TURNS_ERROR_UL) 
+		else
 		{
-			/* Need to retract */
-			vRetractServo();
+			/* Check where the last movement ended, once the servo has stopped coasting */
+			if (!bOvershootChecked_ && millis() - ulLastSwitchTimeMs_ > SERVO_COAST_TIME_MS_UL)
+			{
+				bOvershootChecked_ = true;
+				if ((ulGetCurrentTurns() - sStopTargetTurns_) * scDirection_ > MAX_TURNS_ERROR_UL)
+				{
+					ulOvershoots_++;
+				}
+			}
+
+			if (fError > MAX_TURNS_ERROR_UL)
+			{
+				eNewState = SERVOSTATE_EXTENDING;
+			}
+			else if (fError < -MAX_TURNS_ERROR_UL)
+			{
+				eNewState = SERVOSTATE_RETRACTING;
+			}
 		}
-		else 
+
+		/* Stop at once. Starts respect the minimum dwell, to avoid chattering the relays */
+		if (eNewState != eServoState_ &&
+			(eNewState == SERVOSTATE_STOPPED || millis() - ulLastSwitchTimeMs_ >= SERVO_MIN_DWELL_MS_UL))
 		{
-			/* Need to stop */
-			vStopActuador();
+			vSetState(eNewState);
 		}
 	}
 	/* In calibration mode... */
@@ -117,36 +206,110 @@ float LinearServo_cl::fGetExtensionPercentage()
 ***************************************************************************************************/
 void LinearServo_cl::vExtendServo()
 {
-	vStopActuador();
-	eServoState_ = SERVOSTATE_EXTENDING;
-	digitalWrite(ulRelayRetractionPin_, HIGH);
-	digitalWrite(ulRelayExtensionPin_, LOW);
+	vSetState(SERVOSTATE_EXTENDING);
 }
 
 /******************************************** FUNCTION *****************************************//**
 ***************************************************************************************************/
 void LinearServo_cl::vRetractServo()
 {
-	vStopActuador();
-	eServoState_ = SERVOSTATE_RETRACTING;
-	digitalWrite(ulRelayRetractionPin_, LOW);
-	digitalWrite(ulRelayExtensionPin_, HIGH);
+	vSetState(SERVOSTATE_RETRACTING);
 }
 
 /******************************************** FUNCTION *****************************************//**
 ***************************************************************************************************/
 void LinearServo_cl::vStopActuador()
 {
-	eServoState_ = SERVOSTATE_STOPPED;
-	digitalWrite(ulRelayExtensionPin_, HIGH);
+	vSetState(SERVOSTATE_STOPPED);
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+void LinearServo_cl::vSetState(const ServoState_e eState)
+{
+	if (eState == eServoState_)
+	{
+		return;
+	}
+
+	digitalWrite(ulRelayExtensionPin_,  HIGH);
 	digitalWrite(ulRelayRetractionPin_, HIGH);
+
+	/* Disable interrupts while writing, the movement data is used by the ISR */
+	noInterrupts();
+	if (eState == SERVOSTATE_STOPPED)
+	{
+		ulStopTimeUs_ = micros();
+	}
+	else
+	{
+		scDirection_      = (eState == SERVOSTATE_EXTENDING) ? 1 : -1;
+		ulPulsePeriodUs_  = 0;
+		ucMovementPulses_ = 0;
+	}
+	eServoState_ = eState;
+	interrupts();
+
+	if (eState == SERVOSTATE_EXTENDING)
+	{
+		digitalWrite(ulRelayExtensionPin_, LOW);
+	}
+	else if (eState == SERVOSTATE_RETRACTING)
+	{
+		digitalWrite(ulRelayRetractionPin_, LOW);
+	}
+	else
+	{
+		/* A stop because the target moved behind the servo is not an overshoot */
+		sStopTargetTurns_ = ulTargetTurns_;
+		bOvershootChecked_ = bCalibrating_ || (ulTargetTurns_ - ulCurrentTurns_) * scDirection_ < 0;
+	}
+
+	ulLastSwitchTimeMs_ = millis();
+	ulRelaySwitches_++;
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+float LinearServo_cl::fEstimateTurns(float& fSpeedTurnsPerSec)
+{
+	/* Disable interrupts while reading, the pulse data is updated by the ISR */
+	noInterrupts();
+	int           ulCurrentTurns  = ulCurrentTurns_;
+	signed char   scDirection     = scDirection_;
+	unsigned long ulLastPulseUs   = ulLastPulseTimeUs_;
+	unsigned long ulPulsePeriodUs = ulPulsePeriodUs_;
+	unsigned long ulStopTimeUs    = ulStopTimeUs_;
+	ServoState_e  eServoState     = eServoState_;
+	interrupts();
+
+	/* Speed not measured yet, or the servo is not moving any more */
+	unsigned long ulNowUs = micros();
+	fSpeedTurnsPerSec = 0.0f;
+	if (ulPulsePeriodUs == 0 ||
+		(eServoState == SERVOSTATE_STOPPED && ulNowUs - ulStopTimeUs > SERVO_COAST_TIME_MS_UL * 1000UL))
+	{
+		return ulCurrentTurns;
+	}
+
+	/* Fraction of turn since the last pulse. It never goes beyond the next pulse, in case the servo
+	is slowing down */
+	fSpeedTurnsPerSec = 1000000.0f / ulPulsePeriodUs;
+	float fFraction = min((ulNowUs - ulLastPulseUs) / static_cast<float>(ulPulsePeriodUs), 1.0f);
+
+	return ulCurrentTurns + scDirection * fFraction;
 }
 
 /******************************************** FUNCTION *****************************************//**
 ***************************************************************************************************/
 int LinearServo_cl::ulGetCurrentTurns()
 {
-	return ulCurrentTurns_;
+	/* Disable interrupts while reading, the counter is updated by the ISR */
+	noInterrupts();
+	int ulCurrentTurns = ulCurrentTurns_;
+	interrupts();
+
+	return ulCurrentTurns;
 }
 
 /******************************************** FUNCTION *****************************************//**
@@ -171,25 +334,95 @@ void LinearServo_cl::vCalibrate()
 
 /******************************************** FUNCTION *****************************************//**
 ***************************************************************************************************/
-static void vReadHallSensor() 
+ServoState_e LinearServo_cl::eGetState()
+{
+	return eServoState_;
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+bool LinearServo_cl::bIsCalibrating() 
+{
+	return bCalibrating_;
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+unsigned long LinearServo_cl::ulGetRejectedPulses()
+{
+	/* Disable interrupts while reading, the counter is updated by the ISR */
+	noInterrupts();
+	unsigned long ulRejectedPulses = ulRejectedPulses_;
+	interrupts();
+
+	return ulRejectedPulses;
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+unsigned long LinearServo_cl::ulGetRelaySwitches()
+{
+	return ulRelaySwitches_;
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+unsigned long LinearServo_cl::ulGetOvershoots()
+{
+	return ulOvershoots_;
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+void LinearServo_cl::vSetDebounceWindow(const unsigned long ulDebounceUs)
+{
+	/* Disable interrupts while writing, the window is used by the ISR */
+	noInterrupts();
+	ulDebounceUs_ = ulDebounceUs;
+	interrupts();
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+void LinearServo_cl::vAttachHallSensorIsr(void (*pfIsr)())
+{
+	if (bHallAttached_)
+	{
+		attachInterrupt(digitalPinToInterrupt(ulHallSensorPin_), pfIsr, RISING);
+	}
+}
+
+/******************************************** FUNCTION *****************************************//**
+***************************************************************************************************/
+bool LinearServo_cl::bReadHallSensor(unsigned long& ulIntervalUs) 
 {
 	/* This if avoids triggering the interrupt multiple times for the same detection */
-	if (millis() - ulLastInterruptTime_ > 10) 
+	unsigned long ulNowUs = micros();
+	ulIntervalUs = ulNowUs - ulLastPulseTimeUs_;
+	if (ulIntervalUs >= ulDebounceUs_) 
 	{
-		if (eServoState_ == SERVOSTATE_EXTENDING) 
+		/* After the relays are released the servo coasts, so the pulses keep the last direction */
+		ulCurrentTurns_ = ulCurrentTurns_ + scDirection_;
+
+		/* Measure the speed with two consecutive pulses of the same movement */
+		if (scDirection_ != 0 && ucMovementPulses_ > 0)
 		{
-			ulCurrentTurns_ = ulCurrentTurns_ + 1;
+			ulPulsePeriodUs_ = ulIntervalUs;
 		}
-		else if (eServoState_ == SERVOSTATE_RETRACTING) 
+		if (scDirection_ != 0 && ucMovementPulses_ < 255)
 		{
-			ulCurrentTurns_ = ulCurrentTurns_ - 1;
+			ucMovementPulses_ = ucMovementPulses_ + 1;
 		}
 		
 		/* Saturate between min and max value */
 		ulCurrentTurns_ = min(ulCurrentTurns_, ulMaxTurns_); 
 
 		/* Update time of last activation */
-		ulLastInterruptTime_ = millis();
+		ulLastPulseTimeUs_ = ulNowUs;
+		return true;
 	}
+
+	ulRejectedPulses_ = ulRejectedPulses_ + 1;
+	return false;
 }
 
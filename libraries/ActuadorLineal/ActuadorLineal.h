@@ -3,6 +3,7 @@
 
 /******************************************** INCLUDES ********************************************/
 /* System includes */
+#include <stdint.h>
 
 /* Custom includes */
 
@@ -13,11 +14,34 @@ relates to te gear angle turned to reach the next magnet and get a positive read
 sensor 
 - NOTE2: Relays have inverse logic. If not signal is set, the are "normally open", which makes them 
 consume more energy. We will adapt to this so they are not signaled when servo is stopped 
+- NOTE3: bSetup() does not block. It starts a calibration (full retraction) that vOperate() finishes
+after CALIBRATION_TIME_MS_ULL. Requested positions are applied once bIsCalibrating() is false. If the
+position is known (e.g. stored before the last reset), the calibration can be skipped
+- NOTE4: Each servo keeps its own interrupt state, so up to LINEAR_SERVO_MAX_INSTANCES_UC servos can be
+used at the same time (each one with its own hall sensor pin). bSetup() attaches the hall sensor
+interrupt to a trampoline that forwards it to the instance, and fails if all the slots are taken
+- NOTE5: Hall sensor pulses closer than the debounce window to the previous accepted pulse are glitches.
+They are counted and ignored. The window is measured with micros() (4 us resolution), so it must be
+shorter than the time between two pulses at the top speed of the actuator
+- NOTE6: Between pulses, the position is estimated from the time since the last pulse and the speed
+measured between the last two pulses of the movement. The relays are released SERVO_COAST_TIME_MS_UL
+ahead of the target (the distance the actuator travels until it stops). Pulses received after the
+relays are released are counted in the direction of the last movement. A stop is applied at once,
+but the relays are not energised again until SERVO_MIN_DWELL_MS_UL after the last switch, so a late
+target change or a small overshoot does not chatter them
+- NOTE7: The sketch can attach its own function to the hall sensor interrupt (vAttachHallSensorIsr()),
+e.g. to measure it with an interrupt monitor. That function forwards the pulse to bReadHallSensor(),
+which tells if the debounce filter accepted it and the time since the last accepted pulse
 */
 
 /******************************************* CONSTANTS ********************************************/
-const int  MAX_TURNS_ERROR_UL      = 2; 	/**< Max gear turns difference allowed between requested and actual servo position */
-const long CALIBRATION_TIME_MS_ULL = 10000; /**< Calibration time, in milliseconds        
+const int           MAX_TURNS_ERROR_UL            = 2;     /**< Max gear turns difference allowed between requested and actual servo position */
+const unsigned long HALL_DEBOUNCE_US_UL           = 1000;  /**< Default minimum time between two hall sensor pulses [us]. Faster are glitches */
+const int           UNKNOWN_TURNS_UL              = -1;    /**< Initial position not known, calibration is needed                             */
+const unsigned char LINEAR_SERVO_MAX_INSTANCES_UC = 3;     /**< Maximum number of servos with an attached hall sensor interrupt               */
+const long          CALIBRATION_TIME_MS_ULL       = 10000; /**< Calibration time, in milliseconds                                             */
+const unsigned long SERVO_COAST_TIME_MS_UL        = 60;    /**< Time the actuator keeps moving after the relays are released [ms]             */
+const unsigned long SERVO_MIN_DWELL_MS_UL         = 250;   /**< Minimum time from a relay switch to the next start [ms]                       */
 
 /********************************************* TYPES **********************************************/
 /***********************************************************************************************//**
@@ -31,12 +55,6 @@ enum ServoState_e : int16_t
     SERVOSTATE_EXTENDING  = 2, /**< Servo is extending  */
 }; 
 
-/* Declare as volatile variables used in interrupts */
-volatile static int          ulCurrentTurns_      = 0;                  /**< Current number of gear turns          */
-volatile static long         ulLastInterruptTime_ = 0;                  /**< Time of the last interrupt activation */
-volatile static ServoState_e eServoState_         = SERVOSTATE_STOPPED; /**< Current state of the servo servo   */
-volatile static int 		 ulMaxTurns_          = 0; 				   /**< Number of turns to total extension    */
-
 /********************************************* CLASS **********************************************/
 
 /***********************************************************************************************//**
@@ -52,7 +70,8 @@ public:
 	LinearServo_cl();
 
 	/*******************************************************************************************//**
-	* \brief Setup the class. Method to be called during the setup of Arduino
+	* \brief Setup the class and start the initial calibration. Method to be called during the setup
+	* of Arduino
 	* \param[in] ulRelayRetractionPin: Pin to activate the relay that retracts the servo
 	* \param[in] ulRelayExtensionPin: Pin to activate the relay that extends the servo
 	* \param[in] ulHallSensorPin: Pin for the hall sensor that detects gear turns
@@ -60,13 +79,18 @@ public:
 	* \param[in] fServoUsedLength: Length of the servo that wants to be used. 100% extension will be
 	* this value
 	* \param[in] ulMaxTurns: Total number of gear turns to completely extend servo
+	* \param[in] ulInitialTurns: Current position of the servo, in gear turns. If UNKNOWN_TURNS_UL, the
+	* servo is calibrated
+	* \return False if the hall sensor interrupt could not be attached (more than
+	* LINEAR_SERVO_MAX_INSTANCES_UC servos). The relays are released and the servo is not operated
 	***********************************************************************************************/
-	void vSetup(const int   ulRelayRetractionPin, 
+	bool bSetup(const int   ulRelayRetractionPin, 
 				const int   ulRelayExtensionPin, 
 				const int   ulHallSensorPin, 
 				const float fServoTotalLenght, 
 				const float fServoUsedLength, 
-				const int   ulMaxTurns); 
+				const int   ulMaxTurns,
+				const int   ulInitialTurns = UNKNOWN_TURNS_UL); 
 	
 	/*******************************************************************************************//**
 	* \brief This functions needs to be invoked in every step of the main Arduino loop to check for
@@ -92,19 +116,73 @@ public:
 	***********************************************************************************************/
 	void vCalibrate();
 
+	/*******************************************************************************************//**
+	* \brief This function checks if the servo is calibrating
+	* \return True while the servo is retracting to its calibration position
+	***********************************************************************************************/
+	bool bIsCalibrating();
+
 	/*******************************************************************************************//**
 	* \brief This function gets the current extension percentage
 	* \return Current extension percentage
 	***********************************************************************************************/
 	float fGetExtensionPercentage();
 
-private:
+	/*******************************************************************************************//**
+	* \brief This function gets the number of hall sensor pulses rejected by the debounce filter
+	* (glitches) since the start
+	* \return Number of rejected pulses
+	***********************************************************************************************/
+	unsigned long ulGetRejectedPulses();
+
+	/*******************************************************************************************//**
+	* \brief This function gets the number of relay switches (start, stop or reversal) since the start
+	* \return Number of relay switches
+	***********************************************************************************************/
+	unsigned long ulGetRelaySwitches();
+
+	/*******************************************************************************************//**
+	* \brief This function gets the number of movements that stopped beyond the target by more than
+	* MAX_TURNS_ERROR_UL, so another movement back was needed
+	* \return Number of overshoots
+	***********************************************************************************************/
+	unsigned long ulGetOvershoots();
+
+	/*******************************************************************************************//**
+	* \brief This function sets the debounce window of the hall sensor
+	* \param[in] ulDebounceUs: Minimum time between two valid pulses [us] (HALL_DEBOUNCE_US_UL by
+	* default)
+	***********************************************************************************************/
+	void vSetDebounceWindow(const unsigned long ulDebounceUs);
+
+	/*******************************************************************************************//**
+	* \brief This function attaches another function to the hall sensor interrupt (see NOTE7). To be
+	* called after bSetup(), which attaches the default one
+	* \param[in] pfIsr: Interrupt function. It must call bReadHallSensor() of this servo
+	***********************************************************************************************/
+	void vAttachHallSensorIsr(void (*pfIsr)());
+
+	/*******************************************************************************************//**
+	* \brief Funtion triggered when an interruption happens. Increments/decrements gear turns count
+	* \param[out] ulIntervalUs: Time since the last accepted pulse [us]
+	* \return False if the pulse is rejected by the debounce filter (glitch)
+	***********************************************************************************************/
+	bool bReadHallSensor(unsigned long& ulIntervalUs);
+
 	/*******************************************************************************************//**
 	* \brief This function gets the current number of gear turns
 	* \return Number of current gear turns
 	***********************************************************************************************/
 	int ulGetCurrentTurns();
 
+	/*******************************************************************************************//**
+	* \brief This function gets the current state of the servo
+	* \return Servo state
+	***********************************************************************************************/
+	ServoState_e eGetState();
+
+private:
+
 	/*******************************************************************************************//**
 	* \brief This function sets the current number of gear turns
 	* \param[in] ulCurrentTurns: Number of gear turns to set
@@ -126,7 +204,35 @@ private:
 	***********************************************************************************************/
 	void vStopActuador();
 
+	/*******************************************************************************************//**
+	* \brief This function switches the relays to a new state. Both relays are released first, so they
+	* are never energised at the same time
+	* \param[in] eState: New state of the servo
+	***********************************************************************************************/
+	void vSetState(const ServoState_e eState);
+
+	/*******************************************************************************************//**
+	* \brief This function estimates the position of the servo between two hall sensor pulses
+	* \param[out] fSpeedTurnsPerSec: Measured speed of the servo. 0 if not known
+	* \return Estimated number of gear turns
+	***********************************************************************************************/
+	float fEstimateTurns(float& fSpeedTurnsPerSec);
+
+	/*******************************************************************************************//**
+	* \brief Interrupt trampoline. Forwards the hall sensor interrupt to the servo registered in a slot
+	* \tparam ucSlot: Slot of the servo in apclInstances_
+	***********************************************************************************************/
+	template<unsigned char ucSlot>
+	static void vHallSensorIsr()
+	{
+		unsigned long ulIntervalUs;
+		apclInstances_[ucSlot]->bReadHallSensor(ulIntervalUs);
+	}
+
 	/***************************************** ATTRIBUTES *****************************************/
+	static LinearServo_cl* apclInstances_[LINEAR_SERVO_MAX_INSTANCES_UC]; /**< Servos with an attached interrupt  */
+	static void (* const apfHallSensorIsrs_[LINEAR_SERVO_MAX_INSTANCES_UC])(); /**< Trampoline of each slot */
+
 	int   ulRelayRetractionPin_;    /**< Relay retraction pin. Relay uses inverse logic, LOW means "normally open" is set */ 
 	int   ulRelayExtensionPin_;     /**< Relay extension pin. Relay uses inverse logic, LOW means "normally open" is set  */
 	int   ulHallSensorPin_;         /**< Pin of the hall sensor that reads gear turns                                     */
@@ -137,12 +243,27 @@ private:
 	bool  bCalibrating_; 		    /**< Servo is calibrating                                                             */
 	long  ullCalibrationStartTime_; /**< Calibration start time                                                           */
 	float fRequestedLength_; 		/**< Extension requested by the user (millimeters)						              */
-};
 
-/***********************************************************************************************//**
-* \brief Funtion triggered when an interruption happens. Increments/decrements gear turns count
-***************************************************************************************************/
-static void vReadHallSensor();
+	/* Motion profile */
+	unsigned long ulLastSwitchTimeMs_; /**< Output of millis() at the last relay switch                            */
+	unsigned long ulRelaySwitches_;    /**< Number of relay switches                                               */
+	unsigned long ulOvershoots_;       /**< Movements that stopped beyond the target more than MAX_TURNS_ERROR_UL  */
+	int16_t       sStopTargetTurns_;   /**< Target of the last movement, stored when it is stopped                 */
+	bool          bOvershootChecked_;  /**< The position after the last movement has been checked                  */
+	bool          bHallAttached_;      /**< The hall sensor interrupt is attached (bSetup() succeeded)             */
+
+	/* Declare as volatile variables used in interrupts */
+	volatile int           ulCurrentTurns_;      /**< Current number of gear turns                                      */
+	volatile unsigned long ulLastPulseTimeUs_;   /**< Output of micros() at the last accepted pulse                     */
+	volatile unsigned long ulDebounceUs_;        /**< Minimum time between two valid pulses [us]                        */
+	volatile ServoState_e  eServoState_;         /**< Current state of the servo                                        */
+	volatile int           ulMaxTurns_;          /**< Number of turns to total extension                                */
+	volatile unsigned long ulRejectedPulses_;    /**< Pulses rejected by the debounce filter                            */
+	volatile signed char   scDirection_;         /**< Last movement: 1 extending, -1 retracting, 0 none                 */
+	volatile unsigned long ulStopTimeUs_;        /**< Output of micros() when the relays were released                  */
+	volatile unsigned long ulPulsePeriodUs_;     /**< Time between the last two pulses of the movement (0 if not known) */
+	volatile unsigned char ucMovementPulses_;    /**< Pulses since the start of the movement (saturated)                */
+};
 
 #endif // LINEAR_ACTUATOR
 
@@ -127,23 +127,32 @@ boolean DHT::read(bool force) {
   if (!force && ((currenttime - _lastreadtime) < 2000)) {
     return _lastresult; // return last correct measurement
   }
-  _lastreadtime = currenttime;
 
+  // Go into high impedence state to let pull-up raise data line level and
+  // start the reading process.
+  digitalWrite(_pin, HIGH);
+  delay(250);
+
+  startRead();
+  delay(20);
+  return finishRead();
+}
+
+void DHT::startRead(void) {
   // Reset 40 bits of received data to zero.
   data[0] = data[1] = data[2] = data[3] = data[4] = 0;
 
   // Send start signal.  See DHT datasheet for full signal diagram:
   //   http://www.adafruit.com/datasheets/Digital%20humidity%20and%20temperature%20sensor%20AM2302.pdf
 
-  // Go into high impedence state to let pull-up raise data line level and
-  // start the reading process.
-  digitalWrite(_pin, HIGH);
-  delay(250);
-
-  // First set data line low for 20 milliseconds.
+  // First set data line low for 20 milliseconds (until finishRead()).
   pinMode(_pin, OUTPUT);
   digitalWrite(_pin, LOW);
-  delay(20);
+}
+
+boolean DHT::finishRead(void) {
+  // The result is kept for MIN_INTERVAL, as in read().
+  _lastreadtime = millis();
 
   uint32_t cycles[80];
   {
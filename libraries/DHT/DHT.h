@@ -42,6 +42,14 @@ class DHT {
    float computeHeatIndex(float temperature, float percentHumidity, bool isFahrenheit=true);
    float readHumidity(bool force=false);
    boolean read(bool force=false);
+   // Non-blocking read in two steps. startRead() sends the start signal (data
+   // line low) and returns. finishRead() must be called at least 20 ms later:
+   // it receives the 40 bits (~5 ms with interrupts disabled) and stores the
+   // result, returned by the next readTemperature()/readHumidity() calls for 2
+   // seconds. The data line must have been released (high) for 250 ms before
+   // startRead(), as read() does.
+   void startRead(void);
+   boolean finishRead(void);
 
  private:
   uint8_t data[5];
@@ -22,6 +22,19 @@
 // can't assume that its in that state when a sketch starts (and the
 // LiquidCrystal constructor is called).
 
+// Burst mode: the data and commands are sent with all their expander states in one I2C
+// transaction, instead of one transaction per state plus delays. Each nibble needs two
+// states (En high, En low), and the transaction starts with one state to settle RS/RW
+// before the first En rise. At the default 100 kHz each byte takes 90us on the bus, which
+// is the enable pulse width and more than the 37us execution time of the HD44780 between
+// characters, so no delays are needed. Faster bus clocks would need extra states.
+#ifdef BUFFER_LENGTH
+#define LCD_BURST_BUFFER_LENGTH BUFFER_LENGTH	// Wire transmit buffer (AVR Wire.h)
+#else
+#define LCD_BURST_BUFFER_LENGTH 32
+#endif
+#define LCD_BURST_MAX_CHARS ((LCD_BURST_BUFFER_LENGTH - 1) / 4)	// 4 states per character
+
 LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t lcd_addr, uint8_t lcd_cols, uint8_t lcd_rows, uint8_t charsize)
 {
 	_addr = lcd_addr;
@@ -177,9 +190,7 @@ void LiquidCrystal_I2C::noAutoscroll(void) {
 void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[]) {
 	location &= 0x7; // we only have 8 locations 0-7
 	command(LCD_SETCGRAMADDR | (location << 3));
-	for (int i=0; i<8; i++) {
-		write(charmap[i]);
-	}
+	write(charmap, 8);
 }
 
 // Turn the (optional) backlight off/on
@@ -208,15 +219,41 @@ inline size_t LiquidCrystal_I2C::write(uint8_t value) {
 	return 1;
 }
 
+size_t LiquidCrystal_I2C::write(const uint8_t *buffer, size_t size) {
+	sendBurst(buffer, size, Rs);
+	return size;
+}
+
 
 /************ low level data pushing commands **********/
 
 // write either command or data
 void LiquidCrystal_I2C::send(uint8_t value, uint8_t mode) {
-	uint8_t highnib=value&0xf0;
-	uint8_t lownib=(value<<4)&0xf0;
-	write4bits((highnib)|mode);
-	write4bits((lownib)|mode);
+	sendBurst(&value, 1, mode);
+}
+
+// write a run of commands or data, as few I2C transactions as possible (see burst mode above)
+void LiquidCrystal_I2C::sendBurst(const uint8_t *buffer, size_t size, uint8_t mode) {
+	while (size > 0) {
+		size_t chunk = (size > LCD_BURST_MAX_CHARS) ? LCD_BURST_MAX_CHARS : size;
+
+		Wire.beginTransmission(_addr);
+		Wire.write((int)(mode) | _backlightval);	// RS/RW settle with En low
+		for (size_t i = 0; i < chunk; i++) {
+			burstNibble((buffer[i]&0xf0)|mode);
+			burstNibble(((buffer[i]<<4)&0xf0)|mode);
+		}
+		Wire.endTransmission();
+
+		buffer += chunk;
+		size -= chunk;
+	}
+}
+
+// queue one nibble in the current transaction: the HD44780 latches it on the En falling edge
+void LiquidCrystal_I2C::burstNibble(uint8_t value) {
+	Wire.write((int)(value | En) | _backlightval);
+	Wire.write((int)(value & ~En) | _backlightval);
 }
 
 void LiquidCrystal_I2C::write4bits(uint8_t value) {
@@ -135,6 +135,17 @@ public:
 	void createChar(uint8_t, uint8_t[]);
 	void setCursor(uint8_t, uint8_t);
 	virtual size_t write(uint8_t);
+
+	/**
+	 * Write a run of characters from the current cursor position. All the expander states of
+	 * the run are streamed in as few I2C transactions as the Wire buffer allows (see send()),
+	 * so print() of a string is much faster than writing the characters one by one.
+	 *
+	 * @param buffer	Characters to write.
+	 * @param size		Number of characters.
+	 */
+	virtual size_t write(const uint8_t *buffer, size_t size);
+	using Print::write;
 	void command(uint8_t);
 
 	inline void blink_on() { blink(); }
@@ -149,6 +160,8 @@ public:
 
 private:
 	void send(uint8_t, uint8_t);
+	void sendBurst(const uint8_t *, size_t, uint8_t);
+	void burstNibble(uint8_t);
 	void write4bits(uint8_t);
 	void expanderWrite(uint8_t);
 	void pulseEnable(uint8_t);
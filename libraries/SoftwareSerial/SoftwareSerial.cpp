@@ -39,93 +39,66 @@ http://arduiniana.org.
 // Includes
 // 
 #include <avr/interrupt.h>
-#include <avr/pgmspace.h>
 #include "Arduino.h"
 #include "SoftwareSerial.h"
 //
-// Lookup table
+// Timer
 //
-typedef struct _DELAY_TABLE
-{
-  long baud;
-  unsigned short rx_delay_centering;
-  unsigned short rx_delay_intrabit;
-  unsigned short rx_delay_stopbit;
-  unsigned short tx_delay;
-} DELAY_TABLE;
-
-#if F_CPU == 16000000
-
-static const DELAY_TABLE PROGMEM table[] = 
-{
-  //  baud    rxcenter   rxintra    rxstop    tx
-  { 115200,   1,         17,        17,       12,    },
-  { 57600,    10,        37,        37,       33,    },
-  { 38400,    25,        57,        57,       54,    },
-  { 31250,    31,        70,        70,       68,    },
-  { 28800,    34,        77,        77,       74,    },
-  { 19200,    54,        117,       117,      114,   },
-  { 14400,    74,        156,       156,      153,   },
-  { 9600,     114,       236,       236,      233,   },
-  { 4800,     233,       474,       474,      471,   },
-  { 2400,     471,       950,       950,      947,   },
-  { 1200,     947,       1902,      1902,     1899,  },
-  { 300,      3804,      7617,      7617,     7614,  },
-};
-
-const int XMIT_START_ADJUSTMENT = 5;
-
-#elif F_CPU == 8000000
-
-static const DELAY_TABLE table[] PROGMEM = 
-{
-  //  baud    rxcenter    rxintra    rxstop  tx
-  { 115200,   1,          5,         5,      3,      },
-  { 57600,    1,          15,        15,     13,     },
-  { 38400,    2,          25,        26,     23,     },
-  { 31250,    7,          32,        33,     29,     },
-  { 28800,    11,         35,        35,     32,     },
-  { 19200,    20,         55,        55,     52,     },
-  { 14400,    30,         75,        75,     72,     },
-  { 9600,     50,         114,       114,    112,    },
-  { 4800,     110,        233,       233,    230,    },
-  { 2400,     229,        472,       472,    469,    },
-  { 1200,     467,        948,       948,    945,    },
-  { 300,      1895,       3805,      3805,   3802,   },
-};
-
-const int XMIT_START_ADJUSTMENT = 4;
-
-#elif F_CPU == 20000000
-
-// 20MHz support courtesy of the good people at macegr.com.
-// Thanks, Garrett!
-
-static const DELAY_TABLE PROGMEM table[] =
-{
-  //  baud    rxcenter    rxintra    rxstop  tx
-  { 115200,   3,          21,        21,     18,     },
-  { 57600,    20,         43,        43,     41,     },
-  { 38400,    37,         73,        73,     70,     },
-  { 31250,    45,         89,        89,     88,     },
-  { 28800,    46,         98,        98,     95,     },
-  { 19200,    71,         148,       148,    145,    },
-  { 14400,    96,         197,       197,    194,    },
-  { 9600,     146,        297,       297,    294,    },
-  { 4800,     296,        595,       595,    592,    },
-  { 2400,     592,        1189,      1189,   1186,   },
-  { 1200,     1187,       2379,      2379,   2376,   },
-  { 300,      4759,       9523,      9523,   9520,   },
-};
-
-const int XMIT_START_ADJUSTMENT = 6;
+// The bits are clocked by the compare interrupts of a 16 bit timer
+// running free with prescaler 8: compare A transmits, compare B receives.
+// On the Mega it is timer 4 (PWM on pins 6, 7 and 8 is lost), as timer 5
+// is used by the interrupt monitor and timer 3 by the PWM on pins 2, 3
+// and 5. On other processors it is timer 1 (PWM on pins 9 and 10 is lost)
+//
+#if defined(__AVR_ATmega1280__) || defined(__AVR_ATmega2560__)
+
+#define _SS_TCCRA TCCR4A
+#define _SS_TCCRB TCCR4B
+#define _SS_CLOCK_SELECT _BV(CS41)
+#define _SS_TCNT TCNT4
+#define _SS_OCRA OCR4A
+#define _SS_OCRB OCR4B
+#define _SS_TIMSK TIMSK4
+#define _SS_TIFR TIFR4
+#define _SS_OCIEA OCIE4A
+#define _SS_OCIEB OCIE4B
+#define _SS_OCFA OCF4A
+#define _SS_OCFB OCF4B
+#define _SS_COMPA_vect TIMER4_COMPA_vect
+#define _SS_COMPB_vect TIMER4_COMPB_vect
 
 #else
 
-#error This version of SoftwareSerial supports only 20, 16 and 8MHz processors
+#define _SS_TCCRA TCCR1A
+#define _SS_TCCRB TCCR1B
+#define _SS_CLOCK_SELECT _BV(CS11)
+#define _SS_TCNT TCNT1
+#define _SS_OCRA OCR1A
+#define _SS_OCRB OCR1B
+#define _SS_TIMSK TIMSK1
+#define _SS_TIFR TIFR1
+#define _SS_OCIEA OCIE1A
+#define _SS_OCIEB OCIE1B
+#define _SS_OCFA OCF1A
+#define _SS_OCFB OCF1B
+#define _SS_COMPA_vect TIMER1_COMPA_vect
+#define _SS_COMPB_vect TIMER1_COMPB_vect
 
 #endif
 
+// Timer ticks (8 CPU cycles) per second
+const unsigned long TICKS_PER_SECOND = F_CPU / 8;
+
+// Shortest bit the interrupt handlers keep up with (38400 baud at 16MHz)
+const uint16_t MIN_BIT_TICKS = 48;
+
+// Time from the write() that wakes up the transmitter to its start bit
+const uint16_t XMIT_START_TICKS = 16;
+
+// Entry latency of the pin change interrupt up to the read of the timer,
+// plus the one of the compare interrupt up to the sample (about 160 cycles)
+const uint16_t RECV_START_ADJUSTMENT = 20;
+
 //
 // Statics
 //
@@ -133,6 +106,16 @@ SoftwareSerial *SoftwareSerial::active_object = 0;
 char SoftwareSerial::_receive_buffer[_SS_MAX_RX_BUFF]; 
 volatile uint8_t SoftwareSerial::_receive_buffer_tail = 0;
 volatile uint8_t SoftwareSerial::_receive_buffer_head = 0;
+char SoftwareSerial::_transmit_buffer[_SS_MAX_TX_BUFF];
+volatile uint8_t SoftwareSerial::_transmit_buffer_tail = 0;
+volatile uint8_t SoftwareSerial::_transmit_buffer_head = 0;
+SoftwareSerial * volatile SoftwareSerial::tx_object = 0;
+uint8_t SoftwareSerial::_tx_byte = 0;
+volatile uint8_t SoftwareSerial::_tx_bit = 0;
+uint8_t SoftwareSerial::_tx_frac = 0;
+uint8_t SoftwareSerial::_rx_byte = 0;
+uint8_t SoftwareSerial::_rx_bit = 0;
+uint8_t SoftwareSerial::_rx_frac = 0;
 
 //
 // Debugging
@@ -157,20 +140,6 @@ inline void DebugPulse(uint8_t pin, uint8_t count)
 // Private methods
 //
 
-/* static */ 
-inline void SoftwareSerial::tunedDelay(uint16_t delay) { 
-  uint8_t tmp=0;
-
-  asm volatile("sbiw    %0, 0x01 \n\t"
-    "ldi %1, 0xFF \n\t"
-    "cpi %A0, 0xFF \n\t"
-    "cpc %B0, %1 \n\t"
-    "brne .-10 \n\t"
-    : "+r" (delay), "+a" (tmp)
-    : "0" (delay)
-    );
-}
-
 // This function sets the current object as the "listening"
 // one and returns true if it replaces another 
 bool SoftwareSerial::listen()
@@ -180,6 +149,7 @@ bool SoftwareSerial::listen()
     _buffer_overflow = false;
     uint8_t oldSREG = SREG;
     cli();
+    rx_cancel();
     _receive_buffer_head = _receive_buffer_tail = 0;
     active_object = this;
     SREG = oldSREG;
@@ -190,86 +160,43 @@ bool SoftwareSerial::listen()
 }
 
 //
-// The receive routine called by the interrupt handler
+// The receive routine called by the pin change interrupt handler.
+// It only catches the start bit, the timer samples the rest
 //
 void SoftwareSerial::recv()
 {
-
-#if GCC_VERSION < 40302
-// Work-around for avr-gcc 4.3.0 OSX version bug
-// Preserve the registers that the compiler misses
-// (courtesy of Arduino forum user *etracer*)
-  asm volatile(
-    "push r18 \n\t"
-    "push r19 \n\t"
-    "push r20 \n\t"
-    "push r21 \n\t"
-    "push r22 \n\t"
-    "push r23 \n\t"
-    "push r26 \n\t"
-    "push r27 \n\t"
-    ::);
-#endif  
-
-  uint8_t d = 0;
+  // Already receiving: the change is on another pin of the port
+  if (_SS_TIMSK & _BV(_SS_OCIEB))
+    return;
 
   // If RX line is high, then we don't see any start bit
   // so interrupt is probably not for us
   if (_inverse_logic ? rx_pin_read() : !rx_pin_read())
   {
-    // Wait approximately 1/2 of a bit width to "center" the sample
-    tunedDelay(_rx_delay_centering);
-    DebugPulse(_DEBUG_PIN2, 1);
-
-    // Read each of the 8 bits
-    for (uint8_t i=0x1; i; i <<= 1)
-    {
-      tunedDelay(_rx_delay_intrabit);
-      DebugPulse(_DEBUG_PIN2, 1);
-      uint8_t noti = ~i;
-      if (rx_pin_read())
-        d |= i;
-      else // else clause added to ensure function timing is ~balanced
-        d &= noti;
-    }
+    uint16_t start = _SS_TCNT;
 
-    // skip the stop bit
-    tunedDelay(_rx_delay_stopbit);
-    DebugPulse(_DEBUG_PIN2, 1);
+    // Mask the pin until the stop bit, the data bits would wake us up
+    *_pcint_maskreg &= ~_pcint_maskvalue;
 
-    if (_inverse_logic)
-      d = ~d;
-
-    // if buffer full, set the overflow flag and return
-    if ((_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF != _receive_buffer_head) 
-    {
-      // save new data in buffer: tail points to where byte goes
-      _receive_buffer[_receive_buffer_tail] = d; // save new byte
-      _receive_buffer_tail = (_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF;
-    } 
-    else 
-    {
-#if _DEBUG // for scope: pulse pin as overflow indictator
-      DebugPulse(_DEBUG_PIN1, 1);
-#endif
-      _buffer_overflow = true;
-    }
+    _rx_byte = 0;
+    _rx_bit = 0;
+    _rx_frac = _rx_start_frac;
+    _SS_OCRB = start + _rx_start_ticks;
+    _SS_TIFR = _BV(_SS_OCFB);
+    _SS_TIMSK |= _BV(_SS_OCIEB);
   }
+}
 
-#if GCC_VERSION < 40302
-// Work-around for avr-gcc 4.3.0 OSX version bug
-// Restore the registers that the compiler misses
-  asm volatile(
-    "pop r27 \n\t"
-    "pop r26 \n\t"
-    "pop r23 \n\t"
-    "pop r22 \n\t"
-    "pop r21 \n\t"
-    "pop r20 \n\t"
-    "pop r19 \n\t"
-    "pop r18 \n\t"
-    ::);
-#endif
+// This function drops the byte being received, if any, and unmasks the
+// pin of the listening object. Called with interrupts disabled
+/* static */
+void SoftwareSerial::rx_cancel()
+{
+  if (_SS_TIMSK & _BV(_SS_OCIEB))
+  {
+    _SS_TIMSK &= ~_BV(_SS_OCIEB);
+    *active_object->_pcint_maskreg |= active_object->_pcint_maskvalue;
+  }
 }
 
 void SoftwareSerial::tx_pin_write(uint8_t pin_state)
@@ -298,6 +225,103 @@ inline void SoftwareSerial::handle_interrupt()
   }
 }
 
+// Compare A: sets the next bit of the transmitted byte. The next
+// compare is one bit later, the fraction of tick is carried over
+/* static */
+inline void SoftwareSerial::handle_tx()
+{
+  SoftwareSerial *obj = tx_object;
+
+  if (_tx_bit == 10)
+  {
+    // End of the stop bit: start the next byte, or go idle
+    uint8_t head = _transmit_buffer_head;
+    if (head == _transmit_buffer_tail)
+    {
+      _SS_TIMSK &= ~_BV(_SS_OCIEA);
+      tx_object = 0;
+      return;
+    }
+    _tx_byte = _transmit_buffer[head];
+    _transmit_buffer_head = (head + 1) % _SS_MAX_TX_BUFF;
+    obj->tx_pin_write(obj->_inverse_logic ? HIGH : LOW);
+    _tx_bit = 1;
+  }
+  else if (_tx_bit == 9)
+  {
+    // Stop bit (natural state of the pin)
+    obj->tx_pin_write(obj->_inverse_logic ? LOW : HIGH);
+    _tx_bit = 10;
+  }
+  else
+  {
+    // Data bits, LSB first
+    obj->tx_pin_write((_tx_byte & 0x01) ^ obj->_inverse_logic);
+    _tx_byte >>= 1;
+    _tx_bit = _tx_bit + 1;
+  }
+
+  uint8_t frac = _tx_frac + obj->_bit_frac;
+  _SS_OCRA += obj->_bit_ticks + (frac < _tx_frac);
+  _tx_frac = frac;
+}
+
+// Compare B: samples the received bits in their centre
+/* static */
+inline void SoftwareSerial::handle_rx()
+{
+  SoftwareSerial *obj = active_object;
+  DebugPulse(_DEBUG_PIN2, 1);
+
+  if (_rx_bit < 8)
+  {
+    // Data bits, LSB first
+    _rx_byte >>= 1;
+    if (obj->rx_pin_read())
+      _rx_byte |= 0x80;
+    _rx_bit++;
+
+    uint8_t frac = _rx_frac + obj->_bit_frac;
+    _SS_OCRB += obj->_bit_ticks + (frac < _rx_frac);
+    _rx_frac = frac;
+    return;
+  }
+
+  // Centre of the stop bit: wait for the next start bit
+  _SS_TIMSK &= ~_BV(_SS_OCIEB);
+  *obj->_pcint_maskreg |= obj->_pcint_maskvalue;
+
+  uint8_t d = obj->_inverse_logic ? ~_rx_byte : _rx_byte;
+
+  // if buffer full, set the overflow flag and return
+  if ((_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF != _receive_buffer_head) 
+  {
+    // save new data in buffer: tail points to where byte goes
+    _receive_buffer[_receive_buffer_tail] = d; // save new byte
+    _receive_buffer_tail = (_receive_buffer_tail + 1) % _SS_MAX_RX_BUFF;
+  } 
+  else 
+  {
+#if _DEBUG // for scope: pulse pin as overflow indictator
+    DebugPulse(_DEBUG_PIN1, 1);
+#endif
+    obj->_buffer_overflow = true;
+  }
+}
+
+// This function lets the transmitter progress while write() waits. With
+// interrupts disabled (e.g. write() called from an interrupt handler) the
+// compare interrupt can't run, so its flag is polled here
+/* static */
+void SoftwareSerial::tx_wait()
+{
+  if (!(SREG & _BV(SREG_I)) && (_SS_TIMSK & _BV(_SS_OCIEA)) && (_SS_TIFR & _BV(_SS_OCFA)))
+  {
+    _SS_TIFR = _BV(_SS_OCFA);
+    handle_tx();
+  }
+}
+
 #if defined(PCINT0_vect)
 ISR(PCINT0_vect)
 {
@@ -326,14 +350,26 @@ ISR(PCINT3_vect)
 }
 #endif
 
+ISR(_SS_COMPA_vect)
+{
+  SoftwareSerial::handle_tx();
+}
+
+ISR(_SS_COMPB_vect)
+{
+  SoftwareSerial::handle_rx();
+}
+
 //
 // Constructor
 //
 SoftwareSerial::SoftwareSerial(uint8_t receivePin, uint8_t transmitPin, bool inverse_logic /* = false */) : 
-  _rx_delay_centering(0),
-  _rx_delay_intrabit(0),
-  _rx_delay_stopbit(0),
-  _tx_delay(0),
+  _pcint_maskreg(0),
+  _pcint_maskvalue(0),
+  _bit_ticks(0),
+  _bit_frac(0),
+  _rx_start_ticks(0),
+  _rx_start_frac(0),
   _buffer_overflow(false),
   _inverse_logic(inverse_logic)
 {
@@ -367,6 +403,8 @@ void SoftwareSerial::setRX(uint8_t rx)
   _receiveBitMask = digitalPinToBitMask(rx);
   uint8_t port = digitalPinToPort(rx);
   _receivePortRegister = portInputRegister(port);
+  _pcint_maskreg = digitalPinToPCMSK(rx);
+  _pcint_maskvalue = _BV(digitalPinToPCMSKbit(rx));
 }
 
 //
@@ -375,30 +413,32 @@ void SoftwareSerial::setRX(uint8_t rx)
 
 void SoftwareSerial::begin(long speed)
 {
-  _rx_delay_centering = _rx_delay_intrabit = _rx_delay_stopbit = _tx_delay = 0;
+  _bit_ticks = _rx_start_ticks = 0;
 
-  for (unsigned i=0; i<sizeof(table)/sizeof(table[0]); ++i)
+  // Bit time in 1/256 ticks. 1.5 bits must fit in the 16 bit timer
+  unsigned long bit_time = speed > 0 ? (TICKS_PER_SECOND << 8) / speed : 0;
+  if (bit_time >= ((unsigned long)MIN_BIT_TICKS << 8) && bit_time < 0x800000UL)
   {
-    long baud = pgm_read_dword(&table[i].baud);
-    if (baud == speed)
-    {
-      _rx_delay_centering = pgm_read_word(&table[i].rx_delay_centering);
-      _rx_delay_intrabit = pgm_read_word(&table[i].rx_delay_intrabit);
-      _rx_delay_stopbit = pgm_read_word(&table[i].rx_delay_stopbit);
-      _tx_delay = pgm_read_word(&table[i].tx_delay);
-      break;
-    }
+    _bit_ticks = bit_time >> 8;
+    _bit_frac = bit_time & 0xFF;
+    unsigned long rx_start = bit_time * 3 / 2 - ((unsigned long)RECV_START_ADJUSTMENT << 8);
+    _rx_start_ticks = rx_start >> 8;
+    _rx_start_frac = rx_start & 0xFF;
+
+    // Normal mode, prescaler 8. Shared by all the objects
+    _SS_TCCRA = 0;
+    _SS_TCCRB = _SS_CLOCK_SELECT;
   }
 
   // Set up RX interrupts, but only if we have a valid RX baud rate
-  if (_rx_delay_stopbit)
+  if (_bit_ticks)
   {
-    if (digitalPinToPCICR(_receivePin))
+    if (_pcint_maskreg)
     {
       *digitalPinToPCICR(_receivePin) |= _BV(digitalPinToPCICRbit(_receivePin));
-      *digitalPinToPCMSK(_receivePin) |= _BV(digitalPinToPCMSKbit(_receivePin));
+      *_pcint_maskreg |= _pcint_maskvalue;
     }
-    tunedDelay(_tx_delay); // if we were low this establishes the end
+    delayMicroseconds(1000000L / speed); // if we were low this establishes the end
   }
 
 #if _DEBUG
@@ -411,8 +451,17 @@ void SoftwareSerial::begin(long speed)
 
 void SoftwareSerial::end()
 {
-  if (digitalPinToPCMSK(_receivePin))
-    *digitalPinToPCMSK(_receivePin) &= ~_BV(digitalPinToPCMSKbit(_receivePin));
+  // Let the queued bytes out
+  while (tx_object == this)
+    tx_wait();
+
+  uint8_t oldSREG = SREG;
+  cli();
+  if (active_object == this)
+    rx_cancel();
+  if (_pcint_maskreg)
+    *_pcint_maskreg &= ~_pcint_maskvalue;
+  SREG = oldSREG;
 }
 
 
@@ -440,53 +489,37 @@ int SoftwareSerial::available()
   return (_receive_buffer_tail + _SS_MAX_RX_BUFF - _receive_buffer_head) % _SS_MAX_RX_BUFF;
 }
 
+// Queue the byte for the timer. It only waits if the FIFO is full, or
+// while the bytes of another object are being transmitted
 size_t SoftwareSerial::write(uint8_t b)
 {
-  if (_tx_delay == 0) {
+  if (_bit_ticks == 0) {
     setWriteError();
     return 0;
   }
 
-  uint8_t oldSREG = SREG;
-  cli();  // turn off interrupts for a clean txmit
+  while (tx_object != 0 && tx_object != this)
+    tx_wait();
 
-  // Write the start bit
-  tx_pin_write(_inverse_logic ? HIGH : LOW);
-  tunedDelay(_tx_delay + XMIT_START_ADJUSTMENT);
+  uint8_t tail = (_transmit_buffer_tail + 1) % _SS_MAX_TX_BUFF;
+  while (tail == _transmit_buffer_head)
+    tx_wait();
+  _transmit_buffer[_transmit_buffer_tail] = b;
 
-  // Write each of the 8 bits
-  if (_inverse_logic)
-  {
-    for (byte mask = 0x01; mask; mask <<= 1)
-    {
-      if (b & mask) // choose bit
-        tx_pin_write(LOW); // send 1
-      else
-        tx_pin_write(HIGH); // send 0
-    
-      tunedDelay(_tx_delay);
-    }
-
-    tx_pin_write(LOW); // restore pin to natural state
-  }
-  else
+  uint8_t oldSREG = SREG;
+  cli();
+  _transmit_buffer_tail = tail;
+  if (tx_object == 0)
   {
-    for (byte mask = 0x01; mask; mask <<= 1)
-    {
-      if (b & mask) // choose bit
-        tx_pin_write(HIGH); // send 1
-      else
-        tx_pin_write(LOW); // send 0
-    
-      tunedDelay(_tx_delay);
-    }
-
-    tx_pin_write(HIGH); // restore pin to natural state
+    // Idle transmitter: the first compare takes the byte
+    tx_object = this;
+    _tx_bit = 10;
+    _SS_OCRA = _SS_TCNT + XMIT_START_TICKS;
+    _SS_TIFR = _BV(_SS_OCFA);
+    _SS_TIMSK |= _BV(_SS_OCIEA);
   }
+  SREG = oldSREG;
 
-  SREG = oldSREG; // turn interrupts back on
-  tunedDelay(_tx_delay);
-  
   return 1;
 }
 
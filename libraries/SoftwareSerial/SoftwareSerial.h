@@ -10,6 +10,7 @@ Multi-instance software serial library for Arduino/Wiring
 -- Pin change interrupt macros by Paul Stoffregen (http://www.pjrc.com)
 -- 20MHz processor support by Garrett Mace (http://www.macetech.com)
 -- ATmega1280/2560 support by Brett Hagman (http://www.roguerobotics.com/)
+-- Timer compare driven transmit and receive, with a transmit FIFO
 
 This library is free software; you can redistribute it and/or
 modify it under the terms of the GNU Lesser General Public
@@ -40,10 +41,18 @@ http://arduiniana.org.
 ******************************************************************************/
 
 #define _SS_MAX_RX_BUFF 64 // RX buffer size
+#define _SS_MAX_TX_BUFF 64 // TX buffer size
 #ifndef GCC_VERSION
 #define GCC_VERSION (__GNUC__ * 10000 + __GNUC_MINOR__ * 100 + __GNUC_PATCHLEVEL__)
 #endif
 
+// Timer takeover: begin() with a valid speed claims a 16 bit timer for all
+// the objects, in normal mode with prescaler 8, and its compare A and B
+// interrupts. On the ATmega1280/2560 it is timer 4, so analogWrite() no
+// longer works on pins 6, 7 and 8; on other processors it is timer 1
+// (pins 9 and 10). end() leaves the timer in that mode, and nothing else
+// may reconfigure it or use its interrupts while an object is in use
+
 class SoftwareSerial : public Stream
 {
 private:
@@ -53,11 +62,14 @@ private:
   volatile uint8_t *_receivePortRegister;
   uint8_t _transmitBitMask;
   volatile uint8_t *_transmitPortRegister;
+  volatile uint8_t *_pcint_maskreg;
+  uint8_t _pcint_maskvalue;
 
-  uint16_t _rx_delay_centering;
-  uint16_t _rx_delay_intrabit;
-  uint16_t _rx_delay_stopbit;
-  uint16_t _tx_delay;
+  // bit times, in timer ticks plus a fraction of 1/256 tick
+  uint16_t _bit_ticks;
+  uint8_t _bit_frac;
+  uint16_t _rx_start_ticks; // from the start bit edge to the first sample
+  uint8_t _rx_start_frac;
 
   uint16_t _buffer_overflow:1;
   uint16_t _inverse_logic:1;
@@ -68,15 +80,27 @@ private:
   static volatile uint8_t _receive_buffer_head;
   static SoftwareSerial *active_object;
 
+  static char _transmit_buffer[_SS_MAX_TX_BUFF];
+  static volatile uint8_t _transmit_buffer_tail;
+  static volatile uint8_t _transmit_buffer_head;
+  static SoftwareSerial * volatile tx_object; // 0 while the transmitter is idle
+
+  // bit state machines, only touched by the interrupt handlers
+  static uint8_t _tx_byte;
+  static volatile uint8_t _tx_bit;
+  static uint8_t _tx_frac;
+  static uint8_t _rx_byte;
+  static uint8_t _rx_bit;
+  static uint8_t _rx_frac;
+
   // private methods
   void recv();
   uint8_t rx_pin_read();
   void tx_pin_write(uint8_t pin_state);
   void setTX(uint8_t transmitPin);
   void setRX(uint8_t receivePin);
-
-  // private static method for timing
-  static inline void tunedDelay(uint16_t delay);
+  static void rx_cancel();
+  static void tx_wait();
 
 public:
   // public methods
@@ -98,6 +122,8 @@ public:
 
   // public only for easy access by interrupt handlers
   static inline void handle_interrupt();
+  static inline void handle_tx();
+  static inline void handle_rx();
 };
 
 // Arduino 0012 workaround
@@ -0,0 +1,200 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+
+/* Custom includes */
+#include "AdcSampler.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+static const unsigned char DECIMATION_SHIFT_UC = 2; /**< Bits removed from the sums (16 samples of 10 bits to 12 bits) */
+
+/******************************************** GLOBALS *********************************************/
+static AdcSampler_cl* pclActiveSampler_ = NULL; /**< Sampler that receives the conversion interrupts */
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the ADC sampler class
+***************************************************************************************************/
+AdcSampler_cl::AdcSampler_cl()
+{
+    for (unsigned char ucChannel = 0; ucChannel < ADC_SAMPLER_MAX_CHANNELS_UC; ucChannel++)
+    {
+        aucInputs_[ucChannel] = 0;
+        ausSums_[ucChannel]   = 0;
+        ausValues_[ucChannel] = 0;
+    }
+    ucNumChannels_  = 0;
+    ucChannel_      = 0;
+    ucSamples_      = 0;
+    ulDecimations_  = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds an analog input. Must be called before vBegin()
+* \param[in] ucAnalogPin: Analog input (0 to 15, or A0 to A15)
+* \return Index of the channel, or ADC_SAMPLER_INVALID_CHANNEL_UC if there is no room for more
+***************************************************************************************************/
+unsigned char AdcSampler_cl::ucAddChannel(const uint8_t ucAnalogPin)
+{
+    if (ucNumChannels_ >= ADC_SAMPLER_MAX_CHANNELS_UC)
+    {
+        return ADC_SAMPLER_INVALID_CHANNEL_UC;
+    }
+
+    /* Same pin numbers as analogRead() */
+#if defined(A0)
+    aucInputs_[ucNumChannels_] = ucAnalogPin >= A0 ? ucAnalogPin - A0 : ucAnalogPin;
+#else
+    aucInputs_[ucNumChannels_] = ucAnalogPin;
+#endif
+    return ucNumChannels_++;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function takes a first reading of each channel (blocking, ~110 us per channel) and
+* starts the sampling. Only one sampler can be running
+***************************************************************************************************/
+void AdcSampler_cl::vBegin()
+{
+    /* Initial values, so the users don't see a jump from 0 when the first decimation is done */
+    for (unsigned char ucChannel = 0; ucChannel < ucNumChannels_; ucChannel++)
+    {
+        ausValues_[ucChannel] = static_cast<uint16_t>(analogRead(aucInputs_[ucChannel])) << DECIMATION_SHIFT_UC;
+    }
+    if (ucNumChannels_ == 0)
+    {
+        return;
+    }
+
+    pclActiveSampler_ = this;
+
+#if defined(ADCSRA) && defined(ADATE)
+    /* Same reference (AVcc) and clock (prescaler 128, 125 kHz) as analogRead(). Auto trigger on the
+    Timer0 overflow (see NOTE2) */
+    noInterrupts();
+    ucChannel_ = 0;
+    ucSamples_ = 0;
+    vSelectChannel(0);
+#if defined(ADTS2)
+    ADCSRB = (ADCSRB & ~(_BV(ADTS1) | _BV(ADTS0))) | _BV(ADTS2);
+#endif
+    ADCSRA = _BV(ADEN) | _BV(ADATE) | _BV(ADIF) | _BV(ADIE) | _BV(ADPS2) | _BV(ADPS1) | _BV(ADPS0);
+    interrupts();
+#endif
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the latest filtered value of a channel
+* \param[in] ucChannel: Index of the channel (returned by ucAddChannel())
+* \return Filtered value [0, ADC_SAMPLER_FULL_SCALE_US]
+***************************************************************************************************/
+uint16_t AdcSampler_cl::usGetValue(const unsigned char ucChannel) const
+{
+    if (ucChannel >= ucNumChannels_)
+    {
+        return 0;
+    }
+
+    /* 16 bits reads are not atomic on AVR */
+    noInterrupts();
+    uint16_t usValue = ausValues_[ucChannel];
+    interrupts();
+
+    return usValue;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the number of decimations since the start (every channel is updated in
+* each one)
+* \return Number of decimations
+***************************************************************************************************/
+uint32_t AdcSampler_cl::ulGetDecimations() const
+{
+    noInterrupts();
+    uint32_t ulDecimations = ulDecimations_;
+    interrupts();
+
+    return ulDecimations;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function must only be called by the conversion complete interrupt. It adds the result
+* to the current channel and selects the next one
+* \param[in] usSample: Result of the conversion
+***************************************************************************************************/
+void AdcSampler_cl::vOnConversion(const uint16_t usSample)
+{
+    ausSums_[ucChannel_] += usSample;
+
+    /* Next channel. The multiplexer is changed long before the next trigger (see NOTE2) */
+    if (++ucChannel_ < ucNumChannels_)
+    {
+        vSelectChannel(ucChannel_);
+        return;
+    }
+    ucChannel_ = 0;
+    vSelectChannel(0);
+
+    /* Decimation, once all the channels have all their samples */
+    if (++ucSamples_ < ADC_SAMPLER_OVERSAMPLES_UC)
+    {
+        return;
+    }
+    ucSamples_ = 0;
+    ulDecimations_++;
+
+    for (unsigned char ucChannel = 0; ucChannel < ucNumChannels_; ucChannel++)
+    {
+        uint16_t usDecimated = ausSums_[ucChannel] >> DECIMATION_SHIFT_UC;
+        ausSums_[ucChannel] = 0;
+
+        /* Hysteresis. The ends of the range are always reached, so a potentiometer at its stop gives
+        exactly 0 or the full scale */
+        uint16_t usValue = ausValues_[ucChannel];
+        uint16_t usDelta = usDecimated > usValue ? usDecimated - usValue : usValue - usDecimated;
+        if (usDelta > ADC_SAMPLER_HYSTERESIS_US ||
+            (usDelta > 0 && (usDecimated == 0 || usDecimated == ADC_SAMPLER_FULL_SCALE_US)))
+        {
+            ausValues_[ucChannel] = usDecimated;
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function selects the input of the next conversion
+* \param[in] ucChannel: Index of the channel
+***************************************************************************************************/
+void AdcSampler_cl::vSelectChannel(const unsigned char ucChannel)
+{
+#if defined(ADMUX)
+    uint8_t ucInput = aucInputs_[ucChannel];
+    ADMUX = _BV(REFS0) | (ucInput & 0x07);
+#if defined(MUX5)
+    if (ucInput & 0x08)
+    {
+        ADCSRB |= _BV(MUX5);
+    }
+    else
+    {
+        ADCSRB &= ~_BV(MUX5);
+    }
+#endif
+#else
+    (void)ucChannel;
+#endif
+}
+
+#if defined(ADC_vect)
+/****************************************** FUNCTION *******************************************//**
+* \brief Conversion complete interrupt
+***************************************************************************************************/
+ISR(ADC_vect)
+{
+    uint16_t usSample = ADC;
+    if (pclActiveSampler_ != NULL)
+    {
+        pclActiveSampler_->vOnConversion(usSample);
+    }
+}
+#endif
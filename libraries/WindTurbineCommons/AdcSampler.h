@@ -0,0 +1,100 @@
+#ifndef ADC_SAMPLER_H_
+#define ADC_SAMPLER_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: The ADC runs on its own, in auto trigger mode, and the conversion complete interrupt reads
+the result and selects the next channel. The main loop never waits for a conversion, it only reads
+the latest filtered value of each channel (usGetValue())
+- NOTE2: Conversions are triggered by the Timer0 overflow (every 1.024 ms, the timer of millis()),
+instead of back to back (free running, one every 104 us). The potentiometers don't need more, the
+interrupt load is ten times lower, and as the multiplexer is changed long before the next conversion
+starts, no result has to be discarded after a channel change
+- NOTE3: Channels are sampled in turns. When every channel has ADC_SAMPLER_OVERSAMPLES_UC samples,
+each sum is decimated to ADC_SAMPLER_BITS_UC bits (2 bits more than the ADC, the noise works as
+dither) and passed through a hysteresis: the published value only follows the input when it moves
+more than ADC_SAMPLER_HYSTERESIS_US. Noise can't make the value toggle, only real movements change it
+- NOTE4: Once started, analogRead() must not be used, as it would change the ADC configuration
+- NOTE5: On boards without the AVR ADC registers, vBegin() only takes one reading of each channel
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char ADC_SAMPLER_MAX_CHANNELS_UC    = 4;    /**< Maximum number of sampled channels                       */
+const unsigned char ADC_SAMPLER_INVALID_CHANNEL_UC = 0xFF; /**< Channel index returned when a channel can't be added     */
+const unsigned char ADC_SAMPLER_OVERSAMPLES_UC     = 16;   /**< Samples added in each decimation (4^2, 2 more bits)      */
+const unsigned char ADC_SAMPLER_BITS_UC            = 12;   /**< Resolution of the filtered values                        */
+const uint16_t      ADC_SAMPLER_FULL_SCALE_US      = 4092; /**< Filtered value at the top of the ADC range (1023 * 4)    */
+const uint16_t      ADC_SAMPLER_HYSTERESIS_US      = 8;    /**< Movement needed to change a filtered value (2 ADC steps) */
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class AdcSampler_cl
+ * \brief Interrupt driven sampling of several analog inputs, with oversampling and hysteresis
+ **************************************************************************************************/
+class AdcSampler_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the ADC sampler class
+    ***********************************************************************************************/
+    AdcSampler_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds an analog input. Must be called before vBegin()
+    * \param[in] ucAnalogPin: Analog input (0 to 15, or A0 to A15)
+    * \return Index of the channel, or ADC_SAMPLER_INVALID_CHANNEL_UC if there is no room for more
+    ***********************************************************************************************/
+    unsigned char ucAddChannel(const uint8_t ucAnalogPin);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function takes a first reading of each channel (blocking, ~110 us per channel) and
+    * starts the sampling. Only one sampler can be running
+    ***********************************************************************************************/
+    void vBegin();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the latest filtered value of a channel
+    * \param[in] ucChannel: Index of the channel (returned by ucAddChannel())
+    * \return Filtered value [0, ADC_SAMPLER_FULL_SCALE_US]
+    ***********************************************************************************************/
+    uint16_t usGetValue(const unsigned char ucChannel) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the number of decimations since the start (every channel is updated
+    * in each one)
+    * \return Number of decimations
+    ***********************************************************************************************/
+    uint32_t ulGetDecimations() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function must only be called by the conversion complete interrupt. It adds the
+    * result to the current channel and selects the next one
+    * \param[in] usSample: Result of the conversion
+    ***********************************************************************************************/
+    void vOnConversion(const uint16_t usSample);
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function selects the input of the next conversion
+    * \param[in] ucChannel: Index of the channel
+    ***********************************************************************************************/
+    void vSelectChannel(const unsigned char ucChannel);
+
+    /***************************************** ATTRIBUTES *****************************************/
+    uint8_t           aucInputs_[ADC_SAMPLER_MAX_CHANNELS_UC];  /**< ADC input of each channel          */
+    uint16_t          ausSums_[ADC_SAMPLER_MAX_CHANNELS_UC];    /**< Samples added since the decimation */
+    volatile uint16_t ausValues_[ADC_SAMPLER_MAX_CHANNELS_UC];  /**< Filtered values                    */
+    unsigned char     ucNumChannels_;                           /**< Number of channels                 */
+    unsigned char     ucChannel_;                               /**< Channel of the ongoing conversion  */
+    unsigned char     ucSamples_;                               /**< Samples of the current decimation  */
+    volatile uint32_t ulDecimations_;                           /**< Decimations since the start        */
+};
+
+#endif /* ADC_SAMPLER_H_ */
@@ -13,11 +13,29 @@ const unsigned long MESSAGE_PREAMBLE_ULL   = 0xAABBCCDD;      /**< Message pream
 const unsigned char NUM_CHECKSUM_BYTES_UC  = sizeof(int32_t); /**< Number of bytes for the checksum                    */
 const float         COMMS_PERIOD_MS_F      = 500.0f;          /**< Period for the communications loop                  */
 const unsigned int  BAUD_RATE_UL           = 9600;            /**< Baud rate for serial communications                 */
-const unsigned int  INPUT_BUFFER_LENGTH_UL = 1000;            /**< Length of the input buffer                          */ 
+const unsigned int  INPUT_BUFFER_LENGTH_UL = 128;             /**< Input ring of each CommsManager_cl (SRAM) [bytes]   */
+
+/* The input ring must hold the longest message not parsed yet (a flight recorder chunk, 62 bytes on
+the AVR) plus the bytes received until the next read: up to the 64 bytes of the reception buffer of
+the AVR HardwareSerial. The bytes that do not fit the ring are left in the Stream until the next
+read */
+
+/* FLIGHT RECORDER (see FlightRecord_st and RecorderChunk_st) */
+const float         FLIGHT_RECORD_WIND_SCALE_F     = 256.0f; /**< Scale of the wind speed (Q8.8, [-128, 128) m/s)          */
+const float         FLIGHT_RECORD_RPM_SCALE_F      = 16.0f;  /**< Scale of the rotor speed (Q12.4, [-2048, 2048) rpm)      */
+const float         FLIGHT_RECORD_PITCH_SCALE_F    = 2.0f;   /**< Scale of the blade pitch (0.5 % steps)                   */
+const unsigned char FLIGHT_RECORD_BREAK_MASK_UC    = 0x07;   /**< Bits of ucStatus with the break status (BreakStatus_e)   */
+const unsigned char FLIGHT_RECORD_PITCH_AUTO_UC    = 0x08;   /**< Bit of ucStatus set in automatic pitch mode              */
+const unsigned char FLIGHT_RECORD_MANUAL_BREAK_UC  = 0x10;   /**< Bit of ucStatus set while a manual break is requested    */
+const unsigned char FLIGHT_RECORD_OVERSPEED_UC     = 0x20;   /**< Bit of ucStatus set with the rotor speed over its limit  */
+const unsigned char FLIGHT_RECORD_OVERWIND_UC      = 0x40;   /**< Bit of ucStatus set with the average wind over its limit */
+const uint16_t      RECORDER_REARM_CHUNK_US        = 0xFFFF; /**< Chunk request that releases the window and re-arms       */
 
 /* CONVERSION FACTORS */
 const float MILLIS_TO_SECONDS_F = 0.001f;   /**< Converstion factor from milliseconds to seconds */
+const float MICROS_TO_SECONDS_F = 1.0e-6f;  /**< Conversion factor from microseconds to seconds  */
 const float RPM_TO_RADSEC_F     = PI / 30.0; /**< Converstion factor from RPM to rad/s            */
+const float MINUTES_TO_MICROS_F = 60.0e6f;   /**< Conversion factor from minutes to microseconds  */
 
 
 #endif /* COMMON_CONSTANTS_H_ */
\ No newline at end of file
@@ -7,6 +7,9 @@
 /* Custom includes */
 
 
+/******************************************* CONSTANTS ********************************************/
+const unsigned char RECORDER_CHUNK_RECORDS_UC = 6; /**< Records sent in each chunk of a recorder download */
+
 /********************************************** TYPES *********************************************/
 /***********************************************************************************************//**
  * \enum BreakStatus_e
@@ -14,10 +17,23 @@
  **************************************************************************************************/
 enum BreakStatus_e : int16_t
 {
-    BREAK_DISABLED  = 0, /**< Break is enabled                              */
-    BREAK_ENABLED   = 1, /**< Break is disabled                             */
-    BREAK_BREAKING  = 2, /**< Break is transitioning to a break position    */
-    BREAK_RELEASING = 3, /**< Break is transitioning to a disabled position */
+    BREAK_DISABLED     = 0, /**< Break is enabled                              */
+    BREAK_ENABLED      = 1, /**< Break is disabled                             */
+    BREAK_BREAKING     = 2, /**< Break is transitioning to a break position    */
+    BREAK_RELEASING    = 3, /**< Break is transitioning to a disabled position */
+    BREAK_INITIALIZING = 4, /**< Break is moving to its initial position       */
+}; 
+
+/***********************************************************************************************//**
+ * \enum StartupStatus_e
+ * \brief Enum to indicate the startup progress of the wind turbine
+ **************************************************************************************************/
+enum StartupStatus_e : int16_t
+{
+    STARTUP_OPERATIONAL   = 0, /**< Startup finished                                           */
+    STARTUP_INITIALIZING  = 1, /**< Break and pitch servo are moving to their initial position */
+    STARTUP_BREAK_PENDING = 2, /**< Pitch servo calibrated, break still initializing          */
+    STARTUP_SERVO_PENDING = 3, /**< Break released, pitch servo still calibrating             */
 }; 
 
 /***********************************************************************************************//**
@@ -46,8 +62,9 @@ enum ManualBreak_e : int16_t
  **************************************************************************************************/
 struct AeroStatus_st
 {
-    BreakStatus_e eBreakStatus; /**< Rotor break status indicator */
-    PitchMode_e   ePitchMode;   /**< Pitch control mode           */
+    BreakStatus_e   eBreakStatus;   /**< Rotor break status indicator */
+    PitchMode_e     ePitchMode;     /**< Pitch control mode           */
+    StartupStatus_e eStartupStatus; /**< Startup progress             */
 }; 
 
 /***********************************************************************************************//**
@@ -78,15 +95,89 @@ struct AeroData_st
     AeroStatus_st stStatus;              /**< Status data of the turbine operation   */
 }; 
 
+/***********************************************************************************************//**
+ * \struct KinematicData_st
+ * \brief Fast telemetry: fields of AeroData_st that change in every sample
+ **************************************************************************************************/
+struct KinematicData_st
+{
+    float fWindSpeed;            /**< Current wind speed [m/s]    */
+    float fAverageWindSpeed;     /**< Average wind speed [m/s]    */
+    float fRotorSpeedRPM;        /**< Rotor angular speed [rpm]   */
+    float fBladePitchPercentage; /**< Blade deflection percentage */
+};
+
+/***********************************************************************************************//**
+ * \struct EnvironmentData_st
+ * \brief Slow telemetry: fields of AeroData_st refreshed with each reading of the DHT22
+ **************************************************************************************************/
+struct EnvironmentData_st
+{
+    float fTempCelsius; /**< Current ambient temperature [ºCelsius] */
+    float fRelHumidity; /**< Relative humidity [%]                  */
+};
+
+/***********************************************************************************************//**
+ * \enum RecorderState_e
+ * \brief State of the flight recorder of the Control Arduino
+ **************************************************************************************************/
+enum RecorderState_e : uint8_t
+{
+    RECORDERSTATE_RECORDING = 0, /**< Recording in the ring, waiting for a break event         */
+    RECORDERSTATE_TRIGGERED = 1, /**< Break event received, recording the post-trigger records */
+    RECORDERSTATE_FROZEN    = 2, /**< Window complete, kept until it is re-armed               */
+};
+
+/***********************************************************************************************//**
+ * \struct FlightRecord_st
+ * \brief One sample of the flight recorder, in fixed point (see FLIGHT_RECORD_XXX constants)
+ **************************************************************************************************/
+struct FlightRecord_st
+{
+    int16_t sWindSpeed;   /**< Wind speed [m/s * FLIGHT_RECORD_WIND_SCALE_F]  */
+    int16_t sRotorSpeed;  /**< Rotor speed [rpm * FLIGHT_RECORD_RPM_SCALE_F]  */
+    uint8_t ucBladePitch; /**< Blade pitch [% * FLIGHT_RECORD_PITCH_SCALE_F]  */
+    uint8_t ucStatus;     /**< Break status and break conditions (bit fields) */
+};
+
+/***********************************************************************************************//**
+ * \struct RecorderRequest_st
+ * \brief Request of one chunk of the frozen window of the flight recorder
+ **************************************************************************************************/
+struct RecorderRequest_st
+{
+    uint16_t usChunk; /**< Requested chunk, or RECORDER_REARM_CHUNK_US to re-arm the recorder */
+};
+
+/***********************************************************************************************//**
+ * \struct RecorderChunk_st
+ * \brief Chunk of the frozen window of the flight recorder, oldest records first
+ **************************************************************************************************/
+struct RecorderChunk_st
+{
+    uint16_t        usChunk;                               /**< Index of the chunk                                 */
+    uint16_t        usNumChunks;                           /**< Chunks in the window (0 if no window is frozen)    */
+    uint16_t        usTriggerRecord;                       /**< Record of the window taken right after the trigger */
+    uint16_t        usPeriodMs;                            /**< Time between records [ms]                          */
+    uint32_t        ulTriggerTimeMs;                       /**< Output of millis() at the break event              */
+    RecorderState_e eState;                                /**< State of the recorder                              */
+    uint8_t         ucNumRecords;                          /**< Valid records in this chunk                        */
+    FlightRecord_st astRecords[RECORDER_CHUNK_RECORDS_UC]; /**< Records of the chunk                               */
+};
+
 /***********************************************************************************************//**
  * \enum MessageID_e
  * \brief Message identificators
  **************************************************************************************************/
 enum MessageID_e : int16_t
 {
-    MESSAGEID_AERODATA      = 0, /**< Message from the Control Arduino to the User Arduino */
-    MESSAGEID_CONTROLPARAMS = 1, /**< Message from the User Arduino to the Control Arduino */
-    MESSAGEID_COUNT         = 2, /**< Number of different messages                         */
+    MESSAGEID_KINEMATICS      = 0, /**< Fast telemetry (KinematicData_st) from the Control Arduino      */
+    MESSAGEID_CONTROLPARAMS   = 1, /**< Message from the User Arduino to the Control Arduino            */
+    MESSAGEID_RECORDERREQUEST = 2, /**< Request of a flight recorder chunk (host, through User Arduino) */
+    MESSAGEID_RECORDERCHUNK   = 3, /**< Flight recorder chunk sent by the Control Arduino               */
+    MESSAGEID_ENVIRONMENT     = 4, /**< Slow telemetry (EnvironmentData_st) from the Control Arduino    */
+    MESSAGEID_STATUS          = 5, /**< Status (AeroStatus_st), sent when it changes and periodically   */
+    MESSAGEID_COUNT           = 6, /**< Number of different messages                                    */
 }; 
 
 /***********************************************************************************************//**
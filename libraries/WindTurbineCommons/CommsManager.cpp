@@ -42,8 +42,9 @@ bool CommsManager_cl::bReadInputMessage(Stream&        clSerial,
     /* Initialize output variable */
     eMsgId = MESSAGEID_COUNT;
 
-    /* Read all new received bytes */
-    while (clSerial.available())
+    /* Read the new received bytes that fit the buffer (one position is kept free, so a full buffer
+    is not mistaken for an empty one). The rest stay in the Stream until the next read */
+    while (ulGetNumRemainingBytes(ulNextReadPos_) < INPUT_BUFFER_LENGTH_UL - 1 && clSerial.available())
     {
         /* Read byte */
         aucInputBuffer_[ulNextWritePos_] = static_cast<unsigned char>(clSerial.read());
@@ -11,6 +11,11 @@
 #include "CommonTypes.h"
 
 
+/******************************************* CONSTANTS ********************************************/
+static_assert(sizeof(MsgHeader_st) + sizeof(RecorderChunk_st) + NUM_CHECKSUM_BYTES_UC < INPUT_BUFFER_LENGTH_UL,
+              "The longest message must fit the input buffer (see INPUT_BUFFER_LENGTH_UL)");
+
+
 /********************************************* CLASS **********************************************/
 class CommsManager_cl
 {
@@ -0,0 +1,231 @@
+#ifndef EEPROM_JOURNAL_H_
+#define EEPROM_JOURNAL_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <EEPROM.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: The journal is a ring of fixed size records in an EEPROM region. Every new record is written
+in the slot after the newest one, so the writes (and the wear) are spread over all the slots
+- NOTE2: Each record is [sequence (2 bytes), payload, CRC-8, commit]. A record is valid if its commit
+byte is EEPROM_JOURNAL_COMMITTED_UC and the CRC matches. At startup, the valid record with the newest
+sequence number is the current one
+- NOTE3: A slot is overwritten in this order: the commit byte is cleared, then the sequence, the
+payload and the CRC are written, and the commit byte is set last. A record torn by a power loss is
+therefore never valid, even if the mix of old and new bytes matched the CRC, and the previous record
+is used instead
+- NOTE4: Writing does not block. vWrite() only copies the record, and every call to vProcess() writes
+one byte (an EEPROM byte takes 3.3 ms, so vProcess() must be called with a period of 4 ms or more).
+Only the bytes that change are written
+- NOTE5: The number of slots must be lower than 32768, so the newest sequence number can be found
+after the counter overflows
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const uint8_t EEPROM_JOURNAL_CRC_POLYNOMIAL_UC = 0x07; /**< CRC-8 polynomial (x^8 + x^2 + x + 1)                 */
+const uint8_t EEPROM_JOURNAL_CRC_SEED_UC       = 0xA5; /**< CRC-8 initial value, so an erased slot is not valid */
+const uint8_t EEPROM_JOURNAL_COMMITTED_UC      = 0x5A; /**< Commit byte of a complete record (not 0xFF, erased)  */
+const uint8_t EEPROM_JOURNAL_UNCOMMITTED_UC    = 0x00; /**< Commit byte of a slot being written                  */
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief This function updates a CRC-8 with a new byte
+* \param[in] ucCrc: Current CRC value
+* \param[in] ucData: New byte
+* \return Updated CRC value
+***************************************************************************************************/
+inline uint8_t ucUpdateCrc8(uint8_t ucCrc, const uint8_t ucData)
+{
+    ucCrc ^= ucData;
+    for (unsigned char ucBit = 0; ucBit < 8; ucBit++)
+    {
+        ucCrc = (ucCrc & 0x80) ? (ucCrc << 1) ^ EEPROM_JOURNAL_CRC_POLYNOMIAL_UC : (ucCrc << 1);
+    }
+
+    return ucCrc;
+}
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class EepromJournal_cl
+ * \brief Wear levelled journal that keeps the last value of a structure in EEPROM
+ * \tparam Payload_t: Type of the stored data. It must be trivially copyable
+ **************************************************************************************************/
+template<typename Payload_t>
+class EepromJournal_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the journal class
+    ***********************************************************************************************/
+    EepromJournal_cl()
+    {
+        usStartAddress_ = 0;
+        usNumSlots_     = 0;
+        usNextSlot_     = 0;
+        usNextSequence_ = 0;
+        ucWriteIdx_     = WRITE_STEPS_UC;
+        bPending_       = false;
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Setup the class and find the newest valid record
+    * \param[in] usStartAddress: First EEPROM address used by the journal
+    * \param[in] usNumSlots: Number of records in the ring. The journal uses usNumSlots * (sizeof(
+    * Payload_t) + 4) bytes
+    * \param[out] tPayload: Newest stored data. Not modified if there is no valid record
+    * \return True if a valid record has been found
+    ***********************************************************************************************/
+    bool bSetup(const uint16_t usStartAddress, const uint16_t usNumSlots, Payload_t& tPayload)
+    {
+        usStartAddress_ = usStartAddress;
+        usNumSlots_     = usNumSlots;
+        ucWriteIdx_     = WRITE_STEPS_UC;
+        bPending_       = false;
+
+        /* Look for the valid record with the newest sequence number */
+        bool     bFound           = false;
+        uint16_t usNewestSlot     = 0;
+        uint16_t usNewestSequence = 0;
+        uint8_t  aucRecord[RECORD_SIZE_UC];
+        for (uint16_t usSlot = 0; usSlot < usNumSlots_; usSlot++)
+        {
+            for (unsigned char ucIdx = 0; ucIdx < RECORD_SIZE_UC; ucIdx++)
+            {
+                aucRecord[ucIdx] = EEPROM.read(usGetAddress(usSlot) + ucIdx);
+            }
+
+            if (aucRecord[COMMIT_IDX_UC] != EEPROM_JOURNAL_COMMITTED_UC ||
+                ucComputeCrc(aucRecord) != aucRecord[CRC_IDX_UC])
+            {
+                continue;
+            }
+
+            uint16_t usSequence = aucRecord[0] | (static_cast<uint16_t>(aucRecord[1]) << 8);
+            if (!bFound || static_cast<int16_t>(usSequence - usNewestSequence) > 0)
+            {
+                bFound           = true;
+                usNewestSlot     = usSlot;
+                usNewestSequence = usSequence;
+                memcpy(&tPayload, &aucRecord[2], sizeof(Payload_t));
+            }
+        }
+
+        /* The next record goes after the newest one */
+        usNextSlot_     = bFound ? (usNewestSlot + 1) % usNumSlots_ : 0;
+        usNextSequence_ = bFound ? usNewestSequence + 1 : 0;
+
+        return bFound;
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function requests to store a new value. If a record is being written, the new value
+    * is written after it (only the last requested value is kept)
+    * \param[in] tPayload: Data to be stored
+    ***********************************************************************************************/
+    void vWrite(const Payload_t& tPayload)
+    {
+        memcpy(&tPendingPayload_, &tPayload, sizeof(Payload_t));
+        bPending_ = true;
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function writes the next byte of the record in progress, if any
+    ***********************************************************************************************/
+    void vProcess()
+    {
+        /* Start a new record */
+        if (ucWriteIdx_ >= WRITE_STEPS_UC)
+        {
+            if (!bPending_ || usNumSlots_ == 0)
+            {
+                return;
+            }
+
+            aucRecord_[0] = usNextSequence_ & 0xFF;
+            aucRecord_[1] = usNextSequence_ >> 8;
+            memcpy(&aucRecord_[2], &tPendingPayload_, sizeof(Payload_t));
+            aucRecord_[CRC_IDX_UC]    = ucComputeCrc(aucRecord_);
+            aucRecord_[COMMIT_IDX_UC] = EEPROM_JOURNAL_COMMITTED_UC;
+            bPending_   = false;
+            ucWriteIdx_ = 0;
+        }
+
+        /* The slot is invalidated first, and the commit byte (the last byte of the record) is set
+        when the rest of the record is complete (see NOTE3) */
+        if (ucWriteIdx_ == 0)
+        {
+            EEPROM.update(usGetAddress(usNextSlot_) + COMMIT_IDX_UC, EEPROM_JOURNAL_UNCOMMITTED_UC);
+        }
+        else
+        {
+            EEPROM.update(usGetAddress(usNextSlot_) + ucWriteIdx_ - 1, aucRecord_[ucWriteIdx_ - 1]);
+        }
+        ucWriteIdx_++;
+
+        if (ucWriteIdx_ >= WRITE_STEPS_UC)
+        {
+            usNextSlot_ = (usNextSlot_ + 1) % usNumSlots_;
+            usNextSequence_++;
+        }
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function checks if there is data waiting to be written
+    * \return True while a record is being written or a write has been requested
+    ***********************************************************************************************/
+    bool bIsBusy() const
+    {
+        return bPending_ || ucWriteIdx_ < WRITE_STEPS_UC;
+    }
+
+private:
+    static const unsigned char RECORD_SIZE_UC = sizeof(Payload_t) + 4; /**< Sequence, payload, CRC and commit byte    */
+    static const unsigned char CRC_IDX_UC     = RECORD_SIZE_UC - 2;    /**< Position of the CRC in the record         */
+    static const unsigned char COMMIT_IDX_UC  = RECORD_SIZE_UC - 1;    /**< Position of the commit byte in the record */
+    static const unsigned char WRITE_STEPS_UC = RECORD_SIZE_UC + 1;    /**< Byte writes per record (see NOTE3)        */
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the EEPROM address of a slot
+    * \param[in] usSlot: Slot index
+    * \return EEPROM address of the first byte of the slot
+    ***********************************************************************************************/
+    uint16_t usGetAddress(const uint16_t usSlot) const
+    {
+        return usStartAddress_ + usSlot * RECORD_SIZE_UC;
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function computes the CRC of a record (sequence and payload)
+    * \param[in] aucRecord: Record
+    * \return CRC-8 of the record
+    ***********************************************************************************************/
+    static uint8_t ucComputeCrc(const uint8_t (&aucRecord)[RECORD_SIZE_UC])
+    {
+        uint8_t ucCrc = EEPROM_JOURNAL_CRC_SEED_UC;
+        for (unsigned char ucIdx = 0; ucIdx < CRC_IDX_UC; ucIdx++)
+        {
+            ucCrc = ucUpdateCrc8(ucCrc, aucRecord[ucIdx]);
+        }
+
+        return ucCrc;
+    }
+
+    /***************************************** ATTRIBUTES *****************************************/
+    uint16_t      usStartAddress_;            /**< First EEPROM address of the journal           */
+    uint16_t      usNumSlots_;                /**< Number of records in the ring                 */
+    uint16_t      usNextSlot_;                /**< Slot where the next record is written         */
+    uint16_t      usNextSequence_;            /**< Sequence number of the next record            */
+    uint8_t       aucRecord_[RECORD_SIZE_UC]; /**< Record being written                          */
+    unsigned char ucWriteIdx_;                /**< Next write step of the record (see NOTE3)     */
+    Payload_t     tPendingPayload_;           /**< Data waiting for the current record to finish */
+    bool          bPending_;                  /**< tPendingPayload_ must be written              */
+};
+
+#endif /* EEPROM_JOURNAL_H_ */
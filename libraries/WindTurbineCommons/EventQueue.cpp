@@ -0,0 +1,114 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+
+/* Custom includes */
+#include "EventQueue.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the event queue class
+***************************************************************************************************/
+EventQueue_cl::EventQueue_cl()
+{
+    ucCount_        = 0;
+    usNextSequence_ = 0;
+    ulDropped_      = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds an event to the queue. Must not be called from an ISR
+* \param[in] ucId: Identifier of the event
+* \param[in] ucPriority: Priority of the event. Lower values are popped first
+* \return False if the queue is full and the event has been dropped
+***************************************************************************************************/
+bool EventQueue_cl::bPush(const unsigned char ucId, const unsigned char ucPriority)
+{
+    noInterrupts();
+    bool bStatus = bPushFromIsr(ucId, ucPriority);
+    interrupts();
+
+    return bStatus;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds an event to the queue. Must only be called from an ISR
+* \param[in] ucId: Identifier of the event
+* \param[in] ucPriority: Priority of the event. Lower values are popped first
+* \return False if the queue is full and the event has been dropped
+***************************************************************************************************/
+bool EventQueue_cl::bPushFromIsr(const unsigned char ucId, const unsigned char ucPriority)
+{
+    if (ucCount_ >= EVENT_QUEUE_LENGTH_UC)
+    {
+        ulDropped_++;
+        return false;
+    }
+
+    Event_st& stEvent = astEvents_[ucCount_];
+    stEvent.ucId          = ucId;
+    stEvent.ucPriority    = ucPriority;
+    stEvent.usSequence    = usNextSequence_++;
+    stEvent.ulTimestampUs = micros();
+    ucCount_++;
+
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function removes the most urgent event from the queue
+* \param[out] stEvent: Removed event
+* \return False if the queue is empty
+***************************************************************************************************/
+bool EventQueue_cl::bPop(Event_st& stEvent)
+{
+    noInterrupts();
+    if (ucCount_ == 0)
+    {
+        interrupts();
+        return false;
+    }
+
+    /* Lower priority value wins. Same priority, the oldest one wins (signed difference, to handle
+    the overflow of the sequence number) */
+    unsigned char ucSelected = 0;
+    for (unsigned char ucIdx = 1; ucIdx < ucCount_; ucIdx++)
+    {
+        if (astEvents_[ucIdx].ucPriority < astEvents_[ucSelected].ucPriority ||
+            (astEvents_[ucIdx].ucPriority == astEvents_[ucSelected].ucPriority &&
+             static_cast<int16_t>(astEvents_[ucIdx].usSequence - astEvents_[ucSelected].usSequence) < 0))
+        {
+            ucSelected = ucIdx;
+        }
+    }
+
+    /* The queue is not sorted, so the last event fills the hole */
+    stEvent = astEvents_[ucSelected];
+    ucCount_--;
+    astEvents_[ucSelected] = astEvents_[ucCount_];
+    interrupts();
+
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the number of pending events
+* \return Number of events in the queue
+***************************************************************************************************/
+unsigned char EventQueue_cl::ucGetCount() const
+{
+    return ucCount_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the number of events dropped because the queue was full
+* \return Number of dropped events
+***************************************************************************************************/
+uint32_t EventQueue_cl::ulGetDropped() const
+{
+    noInterrupts();
+    uint32_t ulDropped = ulDropped_;
+    interrupts();
+
+    return ulDropped;
+}
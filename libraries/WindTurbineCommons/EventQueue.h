@@ -0,0 +1,90 @@
+#ifndef EVENT_QUEUE_H_
+#define EVENT_QUEUE_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Events are popped by priority (lower values first). Events with the same priority are
+popped in the same order they were pushed
+- NOTE2: bPush() may be called from the main loop. Inside an ISR (interrupts already disabled) use
+bPushFromIsr(), which does not enable interrupts again
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char EVENT_QUEUE_LENGTH_UC = 8; /**< Maximum number of pending events */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct Event_st
+ * \brief Event stored in the queue
+ **************************************************************************************************/
+struct Event_st
+{
+    unsigned char ucId;          /**< Identifier of the event (defined by the user of the queue) */
+    unsigned char ucPriority;    /**< Priority of the event. Lower values are popped first        */
+    uint16_t      usSequence;    /**< Order of arrival, to keep FIFO order inside a priority      */
+    uint32_t      ulTimestampUs; /**< Output of micros() when the event was pushed                */
+};
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class EventQueue_cl
+ * \brief Fixed size priority queue of events, that can be fed from interrupts
+ **************************************************************************************************/
+class EventQueue_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the event queue class
+    ***********************************************************************************************/
+    EventQueue_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds an event to the queue. Must not be called from an ISR
+    * \param[in] ucId: Identifier of the event
+    * \param[in] ucPriority: Priority of the event. Lower values are popped first
+    * \return False if the queue is full and the event has been dropped
+    ***********************************************************************************************/
+    bool bPush(const unsigned char ucId, const unsigned char ucPriority);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds an event to the queue. Must only be called from an ISR
+    * \param[in] ucId: Identifier of the event
+    * \param[in] ucPriority: Priority of the event. Lower values are popped first
+    * \return False if the queue is full and the event has been dropped
+    ***********************************************************************************************/
+    bool bPushFromIsr(const unsigned char ucId, const unsigned char ucPriority);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function removes the most urgent event from the queue
+    * \param[out] stEvent: Removed event
+    * \return False if the queue is empty
+    ***********************************************************************************************/
+    bool bPop(Event_st& stEvent);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the number of pending events
+    * \return Number of events in the queue
+    ***********************************************************************************************/
+    unsigned char ucGetCount() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the number of events dropped because the queue was full
+    * \return Number of dropped events
+    ***********************************************************************************************/
+    uint32_t ulGetDropped() const;
+
+private:
+    /***************************************** ATTRIBUTES *****************************************/
+    Event_st               astEvents_[EVENT_QUEUE_LENGTH_UC]; /**< Pending events (not sorted)         */
+    volatile unsigned char ucCount_;                          /**< Number of pending events            */
+    uint16_t               usNextSequence_;                   /**< Sequence number for the next event  */
+    uint32_t               ulDropped_;                        /**< Events dropped with the queue full  */
+};
+
+#endif /* EVENT_QUEUE_H_ */
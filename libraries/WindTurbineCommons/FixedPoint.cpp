@@ -0,0 +1,252 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+
+/* Custom includes */
+#include "FixedPoint.h"
+#include "Interpolation.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char CORDIC_ANGLE_FRACTIONAL_BITS_UC = 24; /**< Fractional bits used to accumulate the CORDIC angle */
+const int32_t       CORDIC_NORMALIZED_MIN_SL        = 1L << 28; /**< Lower bound for the normalized CORDIC inputs   */
+const int32_t       CORDIC_NORMALIZED_MAX_SL        = 1L << 29; /**< Upper bound for the normalized CORDIC inputs   */
+const int32_t       CORDIC_ATAN_TABLE_Q24[CORDIC_ITERATIONS_UC] = /**< atan(2^-i), in radians (Q24)           */
+        {13176795, 7778716, 4110060, 2086331, 1047214, 524117, 262123, 131069,
+         65536,    32768,   16384,   8192,    4096,    2048,   1024,   512};
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function multiplies two Q16 values. The product is built from 16x16 bits partial
+* products, so no 64 bits multiplication is needed
+* \param[in] slA: First factor (Q16)
+* \param[in] slB: Second factor (Q16)
+* \return Product of both factors (Q16), saturated to [Q16_MIN_SL, Q16_MAX_SL] (see NOTE3)
+***************************************************************************************************/
+int32_t slMulQ16(const int32_t slA, const int32_t slB)
+{
+    /* Work with magnitudes, and apply the sign at the end */
+    bool bNegative = (slA < 0) != (slB < 0);
+    uint32_t ulA = slA < 0 ? -static_cast<uint32_t>(slA) : static_cast<uint32_t>(slA);
+    uint32_t ulB = slB < 0 ? -static_cast<uint32_t>(slB) : static_cast<uint32_t>(slB);
+
+    /* Split both factors into integer and fractional halves */
+    uint16_t usAHigh = static_cast<uint16_t>(ulA >> Q16_FRACTIONAL_BITS_UC);
+    uint16_t usALow  = static_cast<uint16_t>(ulA);
+    uint16_t usBHigh = static_cast<uint16_t>(ulB >> Q16_FRACTIONAL_BITS_UC);
+    uint16_t usBLow  = static_cast<uint16_t>(ulB);
+
+    /* The integer halves product must fit in the 15 integer bits of the result */
+    uint32_t ulHighProduct = static_cast<uint32_t>(usAHigh) * usBHigh;
+    if (ulHighProduct > (Q16_MAX_SL >> Q16_FRACTIONAL_BITS_UC))
+    {
+        return bNegative ? Q16_MIN_SL : Q16_MAX_SL;
+    }
+
+    /* Add the partial products, already aligned to 16 fractional bits. A carry out of the 32 bits
+    means that the product is out of range too */
+    uint32_t aulPartial[3] = {static_cast<uint32_t>(usAHigh) * usBLow,
+                              static_cast<uint32_t>(usALow) * usBHigh,
+                              static_cast<uint32_t>(usALow) * usBLow >> Q16_FRACTIONAL_BITS_UC};
+    uint32_t ulResult = ulHighProduct << Q16_FRACTIONAL_BITS_UC;
+    for (unsigned char ucIndex = 0; ucIndex < 3; ucIndex++)
+    {
+        ulResult += aulPartial[ucIndex];
+        if (ulResult < aulPartial[ucIndex])
+        {
+            return bNegative ? Q16_MIN_SL : Q16_MAX_SL;
+        }
+    }
+
+    /* The magnitude of a negative result can be one unit higher than that of a positive one */
+    if (ulResult > (bNegative ? static_cast<uint32_t>(Q16_MAX_SL) + 1 : static_cast<uint32_t>(Q16_MAX_SL)))
+    {
+        return bNegative ? Q16_MIN_SL : Q16_MAX_SL;
+    }
+
+    return bNegative ? static_cast<int32_t>(0 - ulResult) : static_cast<int32_t>(ulResult);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function divides two Q16 values. The fractional bits are obtained by restoring
+* division, so no 64 bits division is needed
+* \param[in] slNum: Dividend (Q16)
+* \param[in] slDen: Divisor (Q16)
+* \return Quotient (Q16), truncated towards 0 and saturated to [Q16_MIN_SL, Q16_MAX_SL] (see NOTE3).
+* 0 for 0/0
+***************************************************************************************************/
+int32_t slDivQ16(const int32_t slNum, const int32_t slDen)
+{
+    /* A division by 0 is the limit with the sign of the dividend */
+    if (slDen == 0)
+    {
+        return slNum == 0 ? 0 : (slNum > 0 ? Q16_MAX_SL : Q16_MIN_SL);
+    }
+
+    /* Work with magnitudes, and apply the sign at the end */
+    bool bNegative = (slNum < 0) != (slDen < 0);
+    uint32_t ulNum = slNum < 0 ? -static_cast<uint32_t>(slNum) : static_cast<uint32_t>(slNum);
+    uint32_t ulDen = slDen < 0 ? -static_cast<uint32_t>(slDen) : static_cast<uint32_t>(slDen);
+    uint32_t ulLimit = bNegative ? static_cast<uint32_t>(Q16_MAX_SL) + 1 : static_cast<uint32_t>(Q16_MAX_SL);
+
+    /* Integer part of the quotient. It must fit in the integer bits of the result, or the shifts
+    below would lose it */
+    uint32_t ulQuotient  = ulNum / ulDen;
+    uint32_t ulRemainder = ulNum % ulDen;
+    if (ulQuotient > (ulLimit >> Q16_FRACTIONAL_BITS_UC))
+    {
+        return bNegative ? Q16_MIN_SL : Q16_MAX_SL;
+    }
+
+    /* Get the fractional bits one by one. The remainder is always lower than the divisor, so it
+    can be shifted without overflow */
+    for (unsigned char ucBit = 0; ucBit < Q16_FRACTIONAL_BITS_UC; ucBit++)
+    {
+        ulQuotient <<= 1;
+        ulRemainder <<= 1;
+        if (ulRemainder >= ulDen)
+        {
+            ulRemainder -= ulDen;
+            ulQuotient |= 1;
+        }
+    }
+
+    /* The magnitude of a negative result can be one unit higher than that of a positive one */
+    if (ulQuotient > ulLimit)
+    {
+        return bNegative ? Q16_MIN_SL : Q16_MAX_SL;
+    }
+
+    return bNegative ? static_cast<int32_t>(0 - ulQuotient) : static_cast<int32_t>(ulQuotient);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function computes atan2(y, x) using the CORDIC algorithm in vectoring mode. Maximum
+* error is below 1e-4 rad
+* \param[in] slY: Y coordinate (any fixed-point format, as long as it is the same one used for X)
+* \param[in] slX: X coordinate (same format as Y)
+* \return Angle of the vector (x, y), in radians, in the range [-PI, PI] (Q16)
+***************************************************************************************************/
+int32_t slAtan2Q16(int32_t slY, int32_t slX)
+{
+    /* The angle of a null vector is not defined. Return 0, as atan2() does */
+    if (slX == 0 && slY == 0)
+    {
+        return 0;
+    }
+
+    /* The result only depends on the direction of the vector. Normalize its magnitude to make use
+    of all the available bits, leaving room for the CORDIC gain (1.647) */
+    uint32_t ulMagnitudeX = slX < 0 ? -static_cast<uint32_t>(slX) : static_cast<uint32_t>(slX);
+    uint32_t ulMagnitudeY = slY < 0 ? -static_cast<uint32_t>(slY) : static_cast<uint32_t>(slY);
+    uint32_t ulMagnitude  = ulMagnitudeX > ulMagnitudeY ? ulMagnitudeX : ulMagnitudeY;
+    while (ulMagnitude >= static_cast<uint32_t>(CORDIC_NORMALIZED_MAX_SL))
+    {
+        slX /= 2;
+        slY /= 2;
+        ulMagnitude >>= 1;
+    }
+    while (ulMagnitude < static_cast<uint32_t>(CORDIC_NORMALIZED_MIN_SL))
+    {
+        slX *= 2;
+        slY *= 2;
+        ulMagnitude <<= 1;
+    }
+
+    /* CORDIC only converges for vectors in the right half plane. Rotate the vector 90 degrees if
+    necessary, and start accumulating from that angle */
+    int32_t slAngleQ24 = 0;
+    if (slX < 0)
+    {
+        int32_t slTemp = slX;
+        if (slY >= 0)
+        {
+            slX = slY;
+            slY = -slTemp;
+            slAngleQ24 = Q16_HALF_PI_SL << (CORDIC_ANGLE_FRACTIONAL_BITS_UC - Q16_FRACTIONAL_BITS_UC);
+        }
+        else
+        {
+            slX = -slY;
+            slY = slTemp;
+            slAngleQ24 = -(Q16_HALF_PI_SL << (CORDIC_ANGLE_FRACTIONAL_BITS_UC - Q16_FRACTIONAL_BITS_UC));
+        }
+    }
+
+    /* Rotate the vector towards the X axis, accumulating the rotated angle */
+    for (unsigned char ucIteration = 0; ucIteration < CORDIC_ITERATIONS_UC; ucIteration++)
+    {
+        int32_t slXShifted = slX >> ucIteration;
+        int32_t slYShifted = slY >> ucIteration;
+        if (slY > 0)
+        {
+            slX += slYShifted;
+            slY -= slXShifted;
+            slAngleQ24 += CORDIC_ATAN_TABLE_Q24[ucIteration];
+        }
+        else
+        {
+            slX -= slYShifted;
+            slY += slXShifted;
+            slAngleQ24 -= CORDIC_ATAN_TABLE_Q24[ucIteration];
+        }
+    }
+
+    /* Convert back to Q16, rounding to the nearest */
+    const int32_t slRounding = 1L << (CORDIC_ANGLE_FRACTIONAL_BITS_UC - Q16_FRACTIONAL_BITS_UC - 1);
+    return (slAngleQ24 + slRounding) >> (CORDIC_ANGLE_FRACTIONAL_BITS_UC - Q16_FRACTIONAL_BITS_UC);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief 1D linear interpolation/extrapolation in Q16 format
+* \param[in] pslX: X coordinates of the interpolation function y=f(x) (Q16)
+* \param[in] pslY: Value of the interpolation function in the pslX points (Q16)
+* \param[in] ucLength: Number of points of the interpolation function (at least 2)
+* \param[in] slQueryX: Query point where the function wants to be known (Q16)
+* \return Value of the function at the query point (Q16)
+* \warning Values in pslX must be sorted from lower to higher and values cannot repeat
+***************************************************************************************************/
+int32_t slInterp1DQ16(const int32_t*      pslX,
+                      const int32_t*      pslY,
+                      const unsigned char ucLength,
+                      const int32_t       slQueryX)
+{
+    /* Find the segment that contains the query point. Points out of the table use the first or the
+    last segment to extrapolate */
+    unsigned char ucPrevIndex = static_cast<unsigned char>(ulFindSegment(pslX, ucLength, slQueryX));
+
+    /* Perform linear interpolation using the previous and next point */
+    int32_t slFraction = slDivQ16(slQueryX - pslX[ucPrevIndex],
+                                  pslX[ucPrevIndex + 1] - pslX[ucPrevIndex]);
+    return pslY[ucPrevIndex] + slMulQ16(pslY[ucPrevIndex + 1] - pslY[ucPrevIndex], slFraction);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function converts the numeric fields of the turbine data into Q16 format
+* \param[in] stAeroData: Turbine data (floating point)
+* \param[out] stAeroDataQ16: Turbine data (Q16)
+***************************************************************************************************/
+void vAeroDataToQ16(const AeroData_st& stAeroData, AeroDataQ16_st& stAeroDataQ16)
+{
+    stAeroDataQ16.slTempCelsius          = slFloatToQ16(stAeroData.fTempCelsius);
+    stAeroDataQ16.slRelHumidity          = slFloatToQ16(stAeroData.fRelHumidity);
+    stAeroDataQ16.slWindSpeed            = slFloatToQ16(stAeroData.fWindSpeed);
+    stAeroDataQ16.slAverageWindSpeed     = slFloatToQ16(stAeroData.fAverageWindSpeed);
+    stAeroDataQ16.slRotorSpeedRPM        = slFloatToQ16(stAeroData.fRotorSpeedRPM);
+    stAeroDataQ16.slBladePitchPercentage = slFloatToQ16(stAeroData.fBladePitchPercentage);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function converts Q16 turbine data back into the floating point fields of AeroData_st.
+* Fields not contained in AeroDataQ16_st are not modified
+* \param[in] stAeroDataQ16: Turbine data (Q16)
+* \param[out] stAeroData: Turbine data (floating point)
+***************************************************************************************************/
+void vQ16ToAeroData(const AeroDataQ16_st& stAeroDataQ16, AeroData_st& stAeroData)
+{
+    stAeroData.fTempCelsius          = fQ16ToFloat(stAeroDataQ16.slTempCelsius);
+    stAeroData.fRelHumidity          = fQ16ToFloat(stAeroDataQ16.slRelHumidity);
+    stAeroData.fWindSpeed            = fQ16ToFloat(stAeroDataQ16.slWindSpeed);
+    stAeroData.fAverageWindSpeed     = fQ16ToFloat(stAeroDataQ16.slAverageWindSpeed);
+    stAeroData.fRotorSpeedRPM        = fQ16ToFloat(stAeroDataQ16.slRotorSpeedRPM);
+    stAeroData.fBladePitchPercentage = fQ16ToFloat(stAeroDataQ16.slBladePitchPercentage);
+}
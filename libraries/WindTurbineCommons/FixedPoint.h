@@ -0,0 +1,130 @@
+#ifndef FIXED_POINT_H_
+#define FIXED_POINT_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+#include "CommonTypes.h"
+
+
+/*
+- NOTE1: Q16 values are stored in an int32_t, with 16 integer bits (including sign) and 16
+fractional bits. The representable range is [-32768, 32768) with a resolution of 1/65536
+- NOTE2: AVR boards have no FPU, and 64 bits arithmetic is also emulated by the compiler runtime.
+All operations here only use 16 and 32 bits integer arithmetic
+- NOTE3: slMulQ16() saturates to [Q16_MIN_SL, Q16_MAX_SL] when the product is out of range (i.e. when
+|A*B| >= 32768). The control math keeps its operands well below that (speeds under 1000, angles under
+2*PI), so saturation is only a safety net against corrupted inputs. slDivQ16() and slFloatToQ16()
+saturate the same way, and a division by 0 returns the limit with the sign of the dividend
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char Q16_FRACTIONAL_BITS_UC = 16;               /**< Number of fractional bits of a Q16 value        */
+const int32_t       Q16_ONE_SL             = 65536;            /**< 1.0 in Q16 format                               */
+const int32_t       Q16_MAX_SL             = 0x7FFFFFFFL;      /**< Highest Q16 value (32767.99998)                 */
+const int32_t       Q16_MIN_SL             = -0x7FFFFFFFL - 1; /**< Lowest Q16 value (-32768)                       */
+const int32_t       Q16_PI_SL              = 205887;           /**< PI in Q16 format                                */
+const int32_t       Q16_HALF_PI_SL         = 102944;           /**< PI/2 in Q16 format                              */
+const unsigned char CORDIC_ITERATIONS_UC   = 16;               /**< Iterations of the CORDIC algorithm for atan2()  */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct AeroDataQ16_st
+ * \brief Q16 fixed-point copy of the numeric fields of AeroData_st, used by the control math
+ **************************************************************************************************/
+struct AeroDataQ16_st
+{
+    int32_t slTempCelsius;          /**< Current ambient temperature [ºCelsius] */
+    int32_t slRelHumidity;          /**< Relative humidity [%]                  */
+    int32_t slWindSpeed;            /**< Current wind speed [m/s]               */
+    int32_t slAverageWindSpeed;     /**< Average wind speed [m/s]               */
+    int32_t slRotorSpeedRPM;        /**< Rotor angular speed [rpm]              */
+    int32_t slBladePitchPercentage; /**< Blade deflection percentage            */
+};
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief This function converts a floating point value into Q16 format (rounding to the nearest). It
+* can be evaluated at compile time to build constant tables. NaN values (e.g. a failed sensor
+* reading) are converted to 0
+* \param[in] fValue: Value to be converted
+* \return Q16 representation of the input value, saturated to [Q16_MIN_SL, Q16_MAX_SL] (see NOTE3)
+***************************************************************************************************/
+constexpr int32_t slFloatToQ16(const float fValue)
+{
+    return fValue != fValue    ? 0 :
+           fValue >= 32768.0f  ? Q16_MAX_SL :
+           fValue <= -32768.0f ? Q16_MIN_SL :
+           static_cast<int32_t>(fValue * 65536.0f + (fValue >= 0.0f ? 0.5f : -0.5f));
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function converts a Q16 value into floating point
+* \param[in] slValue: Q16 value to be converted
+* \return Floating point representation of the input value
+***************************************************************************************************/
+inline float fQ16ToFloat(const int32_t slValue)
+{
+    return static_cast<float>(slValue) * (1.0f / 65536.0f);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function multiplies two Q16 values. The product is built from 16x16 bits partial
+* products, so no 64 bits multiplication is needed
+* \param[in] slA: First factor (Q16)
+* \param[in] slB: Second factor (Q16)
+* \return Product of both factors (Q16), saturated to [Q16_MIN_SL, Q16_MAX_SL] (see NOTE3)
+***************************************************************************************************/
+int32_t slMulQ16(const int32_t slA, const int32_t slB);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function divides two Q16 values. The fractional bits are obtained by restoring
+* division, so no 64 bits division is needed
+* \param[in] slNum: Dividend (Q16)
+* \param[in] slDen: Divisor (Q16)
+* \return Quotient (Q16), truncated towards 0 and saturated to [Q16_MIN_SL, Q16_MAX_SL] (see NOTE3).
+* 0 for 0/0
+***************************************************************************************************/
+int32_t slDivQ16(const int32_t slNum, const int32_t slDen);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function computes atan2(y, x) using the CORDIC algorithm in vectoring mode. Maximum
+* error is below 1e-4 rad
+* \param[in] slY: Y coordinate (any fixed-point format, as long as it is the same one used for X)
+* \param[in] slX: X coordinate (same format as Y)
+* \return Angle of the vector (x, y), in radians, in the range [-PI, PI] (Q16)
+***************************************************************************************************/
+int32_t slAtan2Q16(int32_t slY, int32_t slX);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief 1D linear interpolation/extrapolation in Q16 format
+* \param[in] pslX: X coordinates of the interpolation function y=f(x) (Q16)
+* \param[in] pslY: Value of the interpolation function in the pslX points (Q16)
+* \param[in] ucLength: Number of points of the interpolation function (at least 2)
+* \param[in] slQueryX: Query point where the function wants to be known (Q16)
+* \return Value of the function at the query point (Q16)
+* \warning Values in pslX must be sorted from lower to higher and values cannot repeat
+***************************************************************************************************/
+int32_t slInterp1DQ16(const int32_t*      pslX,
+                      const int32_t*      pslY,
+                      const unsigned char ucLength,
+                      const int32_t       slQueryX);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function converts the numeric fields of the turbine data into Q16 format
+* \param[in] stAeroData: Turbine data (floating point)
+* \param[out] stAeroDataQ16: Turbine data (Q16)
+***************************************************************************************************/
+void vAeroDataToQ16(const AeroData_st& stAeroData, AeroDataQ16_st& stAeroDataQ16);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function converts Q16 turbine data back into the floating point fields of AeroData_st.
+* Fields not contained in AeroDataQ16_st are not modified
+* \param[in] stAeroDataQ16: Turbine data (Q16)
+* \param[out] stAeroData: Turbine data (floating point)
+***************************************************************************************************/
+void vQ16ToAeroData(const AeroDataQ16_st& stAeroDataQ16, AeroData_st& stAeroData);
+
+#endif /* FIXED_POINT_H_ */
@@ -0,0 +1,160 @@
+#ifndef INTERPOLATION_H_
+#define INTERPOLATION_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+
+/* Custom includes */
+
+
+/*
+- NOTE1: All functions extrapolate linearly outside the table, using the first or the last segment
+- NOTE2: Tables used for non-uniform interpolation must be strictly increasing. When the table is a
+compile time constant, this can be checked with static_assert(bIsStrictlyIncreasing(table), "...")
+*/
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief This function checks, at compile time if possible, that the values of an array are
+* strictly increasing
+* \tparam Type_t: Type for the data of the array
+* \tparam ulDataLength: Length of the array
+* \param[in] atX: Array to be checked
+* \param[in] ulIdx: Index from which the array is checked (used for the recursion)
+* \return True if every value is greater than the previous one
+***************************************************************************************************/
+template<typename Type_t, unsigned int ulDataLength>
+constexpr bool bIsStrictlyIncreasing(const Type_t (&atX)[ulDataLength], const unsigned int ulIdx = 1)
+{
+    return ulIdx >= ulDataLength ? true :
+           (atX[ulIdx - 1] < atX[ulIdx]) && bIsStrictlyIncreasing(atX, ulIdx + 1);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function finds, using binary search, the segment of a table that must be used to
+* interpolate a query point
+* \tparam Type_t: Type for the data of the table
+* \param[in] ptX: X coordinates of the table, strictly increasing
+* \param[in] ulDataLength: Length of the table (at least 2)
+* \param[in] tQueryX: Query point
+* \return Index i of the segment [ptX[i], ptX[i+1]]. It is always in the range [0, ulDataLength-2],
+* so points out of the table get the first or the last segment
+***************************************************************************************************/
+template<typename Type_t>
+unsigned int ulFindSegment(const Type_t* ptX, const unsigned int ulDataLength, const Type_t tQueryX)
+{
+    /* Keep ptX[ulLow] <= tQueryX < ptX[ulHigh], considering the ends of the table as infinite */
+    unsigned int ulLow  = 0;
+    unsigned int ulHigh = ulDataLength - 1;
+    while (ulHigh - ulLow > 1)
+    {
+        unsigned int ulMiddle = (ulLow + ulHigh) / 2;
+        if (tQueryX < ptX[ulMiddle])
+        {
+            ulHigh = ulMiddle;
+        }
+        else
+        {
+            ulLow = ulMiddle;
+        }
+    }
+
+    return ulLow;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief 1D linear interpolation/extrapolation, for tables with any spacing (binary search)
+* \tparam Type_t: Type for the data to interpolate
+* \tparam ulDataLength: Length of array of data to interpolate
+* \param[in] atX: X coordinates of the interpolation function y=f(x)
+* \param[in] atY: Value of the interpolation function in the atX points
+* \param[in] tQueryX: Query point where the function wants to be known
+* \return Value of the function at the query point
+* \warning Values in atX must be sorted from lower to higher and values cannot repeat
+***************************************************************************************************/
+template<typename Type_t, unsigned int ulDataLength>
+Type_t tInterp1D(const Type_t (&atX)[ulDataLength], const Type_t (&atY)[ulDataLength], const Type_t tQueryX)
+{
+    static_assert(ulDataLength >= 2, "At least two points are needed to interpolate");
+
+    /* Find the index of the data that is right before the query point */
+    unsigned int ulPrevIndex = ulFindSegment(atX, ulDataLength, tQueryX);
+
+    /* Perform linear interpolation using the previous and next point */
+    Type_t tSlope = (atY[ulPrevIndex + 1] - atY[ulPrevIndex]) / (atX[ulPrevIndex + 1] - atX[ulPrevIndex]);
+    return atY[ulPrevIndex] + tSlope * (tQueryX - atX[ulPrevIndex]);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief 1D linear interpolation/extrapolation, for tables with a uniform grid. The segment is found
+* directly from the query point, with no search
+* \tparam Type_t: Type for the data to interpolate
+* \tparam ulDataLength: Length of array of data to interpolate
+* \param[in] tFirstX: X coordinate of the first value of the table
+* \param[in] tStepX: Distance between two consecutive X coordinates (greater than 0)
+* \param[in] atY: Value of the interpolation function at tFirstX + i * tStepX
+* \param[in] tQueryX: Query point where the function wants to be known
+* \return Value of the function at the query point
+***************************************************************************************************/
+template<typename Type_t, unsigned int ulDataLength>
+Type_t tInterp1DUniform(const Type_t tFirstX,
+                        const Type_t tStepX,
+                        const Type_t (&atY)[ulDataLength],
+                        const Type_t tQueryX)
+{
+    static_assert(ulDataLength >= 2, "At least two points are needed to interpolate");
+
+    /* Position of the query point, in steps from the first point. Limit the segment to the table */
+    Type_t tSteps = (tQueryX - tFirstX) / tStepX;
+    unsigned int ulPrevIndex = 0;
+    if (tSteps >= static_cast<Type_t>(ulDataLength - 2))
+    {
+        ulPrevIndex = ulDataLength - 2;
+    }
+    else if (tSteps > static_cast<Type_t>(0))
+    {
+        ulPrevIndex = static_cast<unsigned int>(tSteps);
+    }
+
+    /* Perform linear interpolation using the previous and next point */
+    Type_t tFraction = tSteps - static_cast<Type_t>(ulPrevIndex);
+    return atY[ulPrevIndex] + (atY[ulPrevIndex + 1] - atY[ulPrevIndex]) * tFraction;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief 2D bilinear interpolation/extrapolation, for tables with any spacing (binary search)
+* \tparam Type_t: Type for the data to interpolate
+* \tparam ulLengthX: Number of points in the first dimension
+* \tparam ulLengthY: Number of points in the second dimension
+* \param[in] atX: First coordinate of the interpolation function z=f(x,y)
+* \param[in] atY: Second coordinate of the interpolation function z=f(x,y)
+* \param[in] aatZ: Value of the interpolation function, aatZ[i][j] = f(atX[i], atY[j])
+* \param[in] tQueryX: First coordinate of the query point
+* \param[in] tQueryY: Second coordinate of the query point
+* \return Value of the function at the query point
+* \warning Values in atX and atY must be sorted from lower to higher and values cannot repeat
+***************************************************************************************************/
+template<typename Type_t, unsigned int ulLengthX, unsigned int ulLengthY>
+Type_t tInterp2D(const Type_t (&atX)[ulLengthX],
+                 const Type_t (&atY)[ulLengthY],
+                 const Type_t (&aatZ)[ulLengthX][ulLengthY],
+                 const Type_t tQueryX,
+                 const Type_t tQueryY)
+{
+    static_assert(ulLengthX >= 2 && ulLengthY >= 2, "At least two points per dimension are needed to interpolate");
+
+    /* Find the cell that contains the query point */
+    unsigned int ulIdxX = ulFindSegment(atX, ulLengthX, tQueryX);
+    unsigned int ulIdxY = ulFindSegment(atY, ulLengthY, tQueryY);
+
+    /* Relative position of the query point inside the cell */
+    Type_t tFractionX = (tQueryX - atX[ulIdxX]) / (atX[ulIdxX + 1] - atX[ulIdxX]);
+    Type_t tFractionY = (tQueryY - atY[ulIdxY]) / (atY[ulIdxY + 1] - atY[ulIdxY]);
+
+    /* Interpolate along the second dimension at both sides of the cell, then along the first one */
+    Type_t tLow  = aatZ[ulIdxX][ulIdxY]     + (aatZ[ulIdxX][ulIdxY + 1]     - aatZ[ulIdxX][ulIdxY])     * tFractionY;
+    Type_t tHigh = aatZ[ulIdxX + 1][ulIdxY] + (aatZ[ulIdxX + 1][ulIdxY + 1] - aatZ[ulIdxX + 1][ulIdxY]) * tFractionY;
+    return tLow + (tHigh - tLow) * tFractionX;
+}
+
+#endif /* INTERPOLATION_H_ */
@@ -0,0 +1,287 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+
+/* Custom includes */
+#include "IsrMonitor.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+static const uint16_t PROBE_PERIOD_TICKS_US = ISR_MONITOR_PROBE_PERIOD_US * ISR_MONITOR_TICKS_PER_US_UC; /**< Probe period [ticks]                          */
+static const uint16_t PROBE_GUARD_TICKS_US  = 50 * ISR_MONITOR_TICKS_PER_US_UC;                          /**< Margin to program the next compare [ticks] */
+
+/******************************************** GLOBALS *********************************************/
+static IsrMonitor_cl* pclActiveMonitor_ = NULL; /**< Monitor that receives the probe interrupts */
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the ISR monitor class
+***************************************************************************************************/
+IsrMonitor_cl::IsrMonitor_cl()
+{
+    for (unsigned char ucSourceId = 0; ucSourceId < ISR_MONITOR_MAX_SOURCES_UC; ucSourceId++)
+    {
+        astSources_[ucSourceId] = {};
+    }
+    stLatency_ = {};
+    stLatency_.pscName = F("irq latency");
+    usSectionMaxTicks_ = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function configures Timer5 and starts the latency probe. Only one monitor can be
+* running
+***************************************************************************************************/
+void IsrMonitor_cl::vBegin()
+{
+    pclActiveMonitor_ = this;
+
+#if defined(TCCR5A)
+    noInterrupts();
+    TCCR5A = 0;                                  /* Normal mode, outputs disconnected */
+    TCCR5B = _BV(CS51);                          /* Prescaler 8                       */
+    OCR5A  = TCNT5 + PROBE_PERIOD_TICKS_US;      /* First probe                       */
+    TIFR5  = _BV(OCF5A);                         /* Clear pending compare match       */
+    TIMSK5 = _BV(OCIE5A);                        /* Enable compare A interrupt only   */
+    interrupts();
+#endif
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function sets the name of a source, used in the report
+* \param[in] ucSourceId: Identifier of the source [0, ISR_MONITOR_MAX_SOURCES_UC)
+* \param[in] pscName: Name of the source, stored in flash (use the F() macro)
+***************************************************************************************************/
+void IsrMonitor_cl::vSetSourceName(const unsigned char ucSourceId, const __FlashStringHelper* pscName)
+{
+    if (ucSourceId < ISR_MONITOR_MAX_SOURCES_UC)
+    {
+        astSources_[ucSourceId].pscName = pscName;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function records the execution time of an ISR. Must be called from the ISR
+* \param[in] ucSourceId: Identifier of the source
+* \param[in] usStartTicks: Output of usGetTicks() at the start of the ISR
+***************************************************************************************************/
+void IsrMonitor_cl::vRecordDuration(const unsigned char ucSourceId, const uint16_t usStartTicks)
+{
+    if (ucSourceId < ISR_MONITOR_MAX_SOURCES_UC)
+    {
+        uint16_t usElapsedTicks = usGetTicks() - usStartTicks;
+        vAccumulate(astSources_[ucSourceId], usElapsedTicks / ISR_MONITOR_TICKS_PER_US_UC);
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function records a pulse rejected by a debounce filter. Must be called from the ISR
+* \param[in] ucSourceId: Identifier of the source
+* \param[in] ulIntervalUs: Time since the last accepted pulse [us]
+***************************************************************************************************/
+void IsrMonitor_cl::vRecordReject(const unsigned char ucSourceId, const uint32_t ulIntervalUs)
+{
+    if (ucSourceId < ISR_MONITOR_MAX_SOURCES_UC)
+    {
+        IsrStats_st& stStats = astSources_[ucSourceId];
+        stStats.ulRejected++;
+        unsigned char ucBucket = ucGetLog2Bucket(ulIntervalUs, ISR_MONITOR_NUM_BUCKETS_UC);
+        if (stStats.ausRejectHistogram[ucBucket] < ISR_MONITOR_MAX_BUCKET_COUNT_US)
+        {
+            stStats.ausRejectHistogram[ucBucket]++;
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function records a time measured outside of interrupts
+* \param[in] ucSourceId: Identifier of the source
+* \param[in] usTimeUs: Measured time [us]
+***************************************************************************************************/
+void IsrMonitor_cl::vRecordTime(const unsigned char ucSourceId, const uint16_t usTimeUs)
+{
+    if (ucSourceId < ISR_MONITOR_MAX_SOURCES_UC)
+    {
+        /* ISRs may update the same statistics */
+        noInterrupts();
+        vAccumulate(astSources_[ucSourceId], usTimeUs);
+        interrupts();
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function starts tracking the longest probe latency of a section of code
+***************************************************************************************************/
+void IsrMonitor_cl::vBeginSection()
+{
+    noInterrupts();
+    usSectionMaxTicks_ = 0;
+    interrupts();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function stops tracking the longest probe latency of a section of code
+* \return Longest latency since vBeginSection() [us]
+***************************************************************************************************/
+uint16_t IsrMonitor_cl::usEndSection()
+{
+    /* A probe delayed by the section runs as soon as interrupts are enabled again, so it has
+    already been recorded here */
+    noInterrupts();
+    uint16_t usMaxTicks = usSectionMaxTicks_;
+    interrupts();
+
+    return usMaxTicks / ISR_MONITOR_TICKS_PER_US_UC;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function must only be called by the probe interrupt. It records its latency and
+* schedules the next probe
+***************************************************************************************************/
+void IsrMonitor_cl::vProbe()
+{
+#if defined(TCNT5)
+    /* The timer keeps counting while interrupts are disabled, so the latency is the time elapsed
+    since the compare match */
+    uint16_t usNowTicks  = TCNT5;
+    uint16_t usLateTicks = usNowTicks - OCR5A;
+
+    /* Next probe one period after the compare match. If the probe is (almost) a whole period late,
+    that compare match could already be missed, so start again from now */
+    if (usLateTicks < PROBE_PERIOD_TICKS_US - PROBE_GUARD_TICKS_US)
+    {
+        OCR5A += PROBE_PERIOD_TICKS_US;
+    }
+    else
+    {
+        OCR5A = usNowTicks + PROBE_PERIOD_TICKS_US;
+    }
+
+    vAccumulate(stLatency_, usLateTicks / ISR_MONITOR_TICKS_PER_US_UC);
+    if (usLateTicks > usSectionMaxTicks_)
+    {
+        usSectionMaxTicks_ = usLateTicks;
+    }
+#endif
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets a consistent copy of the statistics of a source
+* \param[in] ucSourceId: Identifier of the source
+* \param[out] stStats: Statistics of the source
+***************************************************************************************************/
+void IsrMonitor_cl::vGetStats(const unsigned char ucSourceId, IsrStats_st& stStats) const
+{
+    noInterrupts();
+    stStats = astSources_[ucSourceId < ISR_MONITOR_MAX_SOURCES_UC ? ucSourceId : 0];
+    interrupts();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets a consistent copy of the probe latency statistics
+* \param[out] stStats: Statistics of the probe latency
+***************************************************************************************************/
+void IsrMonitor_cl::vGetLatencyStats(IsrStats_st& stStats) const
+{
+    noInterrupts();
+    stStats = stLatency_;
+    interrupts();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a text report of the probe latency and all named sources. Each line
+* contains the name, number of measurements, max time [us] and histogram, and then the rejected
+* pulses and the histogram of their intervals [us]
+* \param[in] clOutput: Where the report is written (e.g. the debug Serial)
+***************************************************************************************************/
+void IsrMonitor_cl::vPrintReport(Print& clOutput) const
+{
+    /* Statistics are copied before printing, so ISRs are only blocked during the copy */
+    IsrStats_st stStats;
+    for (unsigned char ucSourceId = 0; ucSourceId <= ISR_MONITOR_MAX_SOURCES_UC; ucSourceId++)
+    {
+        /* Latency goes first, then the named sources */
+        if (ucSourceId == 0)
+        {
+            vGetLatencyStats(stStats);
+        }
+        else
+        {
+            vGetStats(ucSourceId - 1, stStats);
+            if (stStats.pscName == NULL)
+            {
+                continue;
+            }
+        }
+
+        clOutput.print(stStats.pscName);
+        clOutput.print(F(": n="));
+        clOutput.print(stStats.ulCount);
+        clOutput.print(F(" max="));
+        clOutput.print(stStats.usMaxUs);
+        clOutput.print(F(" hist="));
+        vPrintHistogram(stStats.ausHistogram, clOutput);
+        if (stStats.ulRejected > 0)
+        {
+            clOutput.print(F(" rej="));
+            clOutput.print(stStats.ulRejected);
+            clOutput.print(F(" rej_hist="));
+            vPrintHistogram(stStats.ausRejectHistogram, clOutput);
+        }
+        clOutput.println();
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds a measured time to the statistics of a source
+* \param[in] stStats: Statistics of the source
+* \param[in] usTimeUs: Measured time [us]
+***************************************************************************************************/
+void IsrMonitor_cl::vAccumulate(IsrStats_st& stStats, const uint16_t usTimeUs)
+{
+    stStats.ulCount++;
+    if (usTimeUs > stStats.usMaxUs)
+    {
+        stStats.usMaxUs = usTimeUs;
+    }
+    unsigned char ucBucket = ucGetLog2Bucket(usTimeUs, ISR_MONITOR_NUM_BUCKETS_UC);
+    if (stStats.ausHistogram[ucBucket] < ISR_MONITOR_MAX_BUCKET_COUNT_US)
+    {
+        stStats.ausHistogram[ucBucket]++;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a histogram, skipping the unused buckets at the end
+* \param[in] ausHistogram: Histogram to be written
+* \param[in] clOutput: Where the histogram is written
+***************************************************************************************************/
+void IsrMonitor_cl::vPrintHistogram(const uint16_t (&ausHistogram)[ISR_MONITOR_NUM_BUCKETS_UC], Print& clOutput)
+{
+    unsigned char ucLastBucket = ISR_MONITOR_NUM_BUCKETS_UC - 1;
+    while (ucLastBucket > 0 && ausHistogram[ucLastBucket] == 0)
+    {
+        ucLastBucket--;
+    }
+    for (unsigned char ucBucket = 0; ucBucket <= ucLastBucket; ucBucket++)
+    {
+        if (ucBucket > 0)
+        {
+            clOutput.print(',');
+        }
+        clOutput.print(ausHistogram[ucBucket]);
+    }
+}
+
+#if defined(TIMER5_COMPA_vect)
+/****************************************** FUNCTION *******************************************//**
+* \brief Probe interrupt (Timer5 compare A)
+***************************************************************************************************/
+ISR(TIMER5_COMPA_vect)
+{
+    if (pclActiveMonitor_ != NULL)
+    {
+        pclActiveMonitor_->vProbe();
+    }
+}
+#endif
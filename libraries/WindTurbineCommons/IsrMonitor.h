@@ -0,0 +1,252 @@
+#ifndef ISR_MONITOR_H_
+#define ISR_MONITOR_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <stdint.h>
+
+/* Custom includes */
+#include "Profiler.h"
+
+
+/*
+- NOTE1: The monitor is disabled by default. To enable it, define ISR_MONITOR_ENABLED as 1 before
+including this file, and declare a global "IsrMonitor_cl clIsrMonitor_" in the sketch (only when
+the monitor is enabled). When disabled, the ISR_MONITOR_XXX() macros generate no code at all
+- NOTE2: The monitor uses Timer5 of the ATmega2560 (PWM on pins 44, 45 and 46 is lost). The timer
+runs free with 0.5 us ticks, and its compare interrupt (the probe) fires every millisecond. The
+delay from the compare match to the probe execution is the interrupt entry latency. Its maximum is
+the longest window with interrupts disabled or blocked by other ISRs (up to 32 ms). As the window
+may start at any point of the probe period, a single window may be underestimated by up to 1 ms
+- NOTE3: On other boards vBegin() does nothing and all measured times are 0
+- NOTE4: All times are stored in log2 histograms (see ucGetLog2Bucket()), in microseconds
+*/
+
+#ifndef ISR_MONITOR_ENABLED
+#define ISR_MONITOR_ENABLED 0 /**< Set to 1 before including this file to enable the monitor */
+#endif
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char ISR_MONITOR_MAX_SOURCES_UC      = 4;                 /**< Maximum number of monitored sources        */
+const unsigned char ISR_MONITOR_NUM_BUCKETS_UC      = 16;                /**< Number of histogram buckets (last 32 ms)   */
+const unsigned char ISR_MONITOR_TICKS_PER_US_UC     = F_CPU / 8000000UL; /**< Timer5 ticks per microsecond (prescaler 8) */
+const uint16_t      ISR_MONITOR_PROBE_PERIOD_US     = 1000;              /**< Period of the probe interrupt [us]         */
+const uint16_t      ISR_MONITOR_MAX_BUCKET_COUNT_US = 0xFFFF;            /**< Histogram counters saturate at this value  */
+
+/********************************************* MACROS *********************************************/
+#if ISR_MONITOR_ENABLED
+/** Measures the execution time of an ISR, from this point to the end of the enclosing scope */
+#define ISR_MONITOR_SCOPE(ucSourceId) IsrScope_cl clIsrMonitorScope(clIsrMonitor_, ucSourceId)
+
+/** Records a pulse rejected by a debounce filter, and the time since the last accepted one [us] */
+#define ISR_MONITOR_REJECT(ucSourceId, ulIntervalUs) clIsrMonitor_.vRecordReject(ucSourceId, ulIntervalUs)
+
+/** Records the longest interrupt entry latency from this point to the end of the enclosing scope.
+Used to measure code that disables interrupts (e.g. the DHT22 reading). Must not be nested */
+#define ISR_MONITOR_SECTION(ucSourceId) IsrSectionScope_cl clIsrMonitorSection(clIsrMonitor_, ucSourceId)
+#else
+#define ISR_MONITOR_SCOPE(ucSourceId)
+#define ISR_MONITOR_REJECT(ucSourceId, ulIntervalUs)
+#define ISR_MONITOR_SECTION(ucSourceId)
+#endif
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct IsrStats_st
+ * \brief Statistics of a monitored interrupt source
+ **************************************************************************************************/
+struct IsrStats_st
+{
+    const __FlashStringHelper* pscName;                                        /**< Name of the source (in flash)                 */
+    uint32_t                   ulCount;                                        /**< Number of measurements                        */
+    uint32_t                   ulRejected;                                     /**< Number of pulses rejected by debounce         */
+    uint16_t                   usMaxUs;                                        /**< Maximum measured time [us]                    */
+    uint16_t                   ausHistogram[ISR_MONITOR_NUM_BUCKETS_UC];       /**< Log2 histogram of the measured times          */
+    uint16_t                   ausRejectHistogram[ISR_MONITOR_NUM_BUCKETS_UC]; /**< Log2 histogram of intervals of rejected pulses */
+};
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class IsrMonitor_cl
+ * \brief Class that measures interrupt latency, ISR execution times and debounce rejections
+ **************************************************************************************************/
+class IsrMonitor_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the ISR monitor class
+    ***********************************************************************************************/
+    IsrMonitor_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function configures Timer5 and starts the latency probe. Only one monitor can be
+    * running
+    ***********************************************************************************************/
+    void vBegin();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function sets the name of a source, used in the report
+    * \param[in] ucSourceId: Identifier of the source [0, ISR_MONITOR_MAX_SOURCES_UC)
+    * \param[in] pscName: Name of the source, stored in flash (use the F() macro)
+    ***********************************************************************************************/
+    void vSetSourceName(const unsigned char ucSourceId, const __FlashStringHelper* pscName);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the current value of the monitor timer
+    * \return Timer ticks (ISR_MONITOR_TICKS_PER_US_UC per microsecond)
+    ***********************************************************************************************/
+    static uint16_t usGetTicks()
+    {
+#if defined(TCNT5)
+        return TCNT5;
+#else
+        return 0;
+#endif
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function records the execution time of an ISR. Must be called from the ISR
+    * \param[in] ucSourceId: Identifier of the source
+    * \param[in] usStartTicks: Output of usGetTicks() at the start of the ISR
+    ***********************************************************************************************/
+    void vRecordDuration(const unsigned char ucSourceId, const uint16_t usStartTicks);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function records a pulse rejected by a debounce filter. Must be called from the ISR
+    * \param[in] ucSourceId: Identifier of the source
+    * \param[in] ulIntervalUs: Time since the last accepted pulse [us]
+    ***********************************************************************************************/
+    void vRecordReject(const unsigned char ucSourceId, const uint32_t ulIntervalUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function records a time measured outside of interrupts
+    * \param[in] ucSourceId: Identifier of the source
+    * \param[in] usTimeUs: Measured time [us]
+    ***********************************************************************************************/
+    void vRecordTime(const unsigned char ucSourceId, const uint16_t usTimeUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function starts tracking the longest probe latency of a section of code
+    ***********************************************************************************************/
+    void vBeginSection();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function stops tracking the longest probe latency of a section of code
+    * \return Longest latency since vBeginSection() [us]
+    ***********************************************************************************************/
+    uint16_t usEndSection();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function must only be called by the probe interrupt. It records its latency and
+    * schedules the next probe
+    ***********************************************************************************************/
+    void vProbe();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets a consistent copy of the statistics of a source
+    * \param[in] ucSourceId: Identifier of the source
+    * \param[out] stStats: Statistics of the source
+    ***********************************************************************************************/
+    void vGetStats(const unsigned char ucSourceId, IsrStats_st& stStats) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets a consistent copy of the probe latency statistics
+    * \param[out] stStats: Statistics of the probe latency
+    ***********************************************************************************************/
+    void vGetLatencyStats(IsrStats_st& stStats) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function writes a text report of the probe latency and all named sources. Each
+    * line contains the name, number of measurements, max time [us] and histogram, and then the
+    * rejected pulses and the histogram of their intervals [us]
+    * \param[in] clOutput: Where the report is written (e.g. the debug Serial)
+    ***********************************************************************************************/
+    void vPrintReport(Print& clOutput) const;
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds a measured time to the statistics of a source
+    * \param[in] stStats: Statistics of the source
+    * \param[in] usTimeUs: Measured time [us]
+    ***********************************************************************************************/
+    static void vAccumulate(IsrStats_st& stStats, const uint16_t usTimeUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function writes a histogram, skipping the unused buckets at the end
+    * \param[in] ausHistogram: Histogram to be written
+    * \param[in] clOutput: Where the histogram is written
+    ***********************************************************************************************/
+    static void vPrintHistogram(const uint16_t (&ausHistogram)[ISR_MONITOR_NUM_BUCKETS_UC], Print& clOutput);
+
+    /***************************************** ATTRIBUTES *****************************************/
+    IsrStats_st       astSources_[ISR_MONITOR_MAX_SOURCES_UC]; /**< Statistics of the monitored sources      */
+    IsrStats_st       stLatency_;                              /**< Statistics of the probe latency          */
+    volatile uint16_t usSectionMaxTicks_;                      /**< Longest latency in the current section   */
+};
+
+/***********************************************************************************************//**
+ * \class IsrScope_cl
+ * \brief Measures the execution time of an ISR (use ISR_MONITOR_SCOPE())
+ **************************************************************************************************/
+class IsrScope_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor. Starts the measurement
+    * \param[in] clMonitor: Monitor where the measurement is recorded
+    * \param[in] ucSourceId: Identifier of the source
+    ***********************************************************************************************/
+    IsrScope_cl(IsrMonitor_cl& clMonitor, const unsigned char ucSourceId)
+        : clMonitor_(clMonitor), ucSourceId_(ucSourceId), usStartTicks_(IsrMonitor_cl::usGetTicks())
+    {
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Destructor. Records the measurement
+    ***********************************************************************************************/
+    ~IsrScope_cl()
+    {
+        clMonitor_.vRecordDuration(ucSourceId_, usStartTicks_);
+    }
+
+private:
+    /***************************************** ATTRIBUTES *****************************************/
+    IsrMonitor_cl& clMonitor_;    /**< Monitor where the measurement is recorded */
+    unsigned char  ucSourceId_;   /**< Identifier of the source                  */
+    uint16_t       usStartTicks_; /**< Timer ticks at the start                  */
+};
+
+/***********************************************************************************************//**
+ * \class IsrSectionScope_cl
+ * \brief Measures the longest interrupt latency inside a section of code (use ISR_MONITOR_SECTION())
+ **************************************************************************************************/
+class IsrSectionScope_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor. Starts the measurement
+    * \param[in] clMonitor: Monitor where the measurement is recorded
+    * \param[in] ucSourceId: Identifier of the source
+    ***********************************************************************************************/
+    IsrSectionScope_cl(IsrMonitor_cl& clMonitor, const unsigned char ucSourceId)
+        : clMonitor_(clMonitor), ucSourceId_(ucSourceId)
+    {
+        clMonitor_.vBeginSection();
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Destructor. Records the measurement
+    ***********************************************************************************************/
+    ~IsrSectionScope_cl()
+    {
+        clMonitor_.vRecordTime(ucSourceId_, clMonitor_.usEndSection());
+    }
+
+private:
+    /***************************************** ATTRIBUTES *****************************************/
+    IsrMonitor_cl& clMonitor_;  /**< Monitor where the measurement is recorded */
+    unsigned char  ucSourceId_; /**< Identifier of the source                  */
+};
+
+#endif /* ISR_MONITOR_H_ */
@@ -0,0 +1,154 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <string.h>
+
+/* Custom includes */
+#include "NumberFormat.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+const uint16_t NUMBER_FORMAT_POW10_US[NUMBER_FORMAT_MAX_DECIMALS_UC + 1] = {1, 10, 100, 1000, 10000}; /**< Scale for each number of decimals */
+const float    NUMBER_FORMAT_MAX_SCALED_F = 2147483520.0f; /**< Largest scaled float that fits an int32_t */
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function fills the text with a character (overflow and invalid values)
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] scFill: Character to write
+* \param[in] ucWidth: Number of characters of the text. 0 writes a single character
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+static unsigned char ucFill(char* pscBuffer, const char scFill, const unsigned char ucWidth)
+{
+    unsigned char ucLength = ucWidth == 0 ? 1 : ucWidth;
+    memset(pscBuffer, scFill, ucLength);
+    pscBuffer[ucLength] = '\0';
+
+    return ucLength;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes an integer value
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] slValue: Value to write
+* \param[in] ucWidth: Number of characters of the text. 0 to use the length of the value
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+unsigned char ucFormatInteger(char* pscBuffer, const int32_t slValue, const unsigned char ucWidth)
+{
+    return ucFormatFixed(pscBuffer, slValue, 0, ucWidth);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a fixed-point decimal value
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] slScaledValue: Value to write multiplied by 10^ucDecimals (e.g. 215 and 1 for 21.5)
+* \param[in] ucDecimals: Number of decimals (up to NUMBER_FORMAT_MAX_DECIMALS_UC)
+* \param[in] ucWidth: Number of characters of the text. 0 to use the length of the value
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+unsigned char ucFormatFixed(char*               pscBuffer,
+                            const int32_t       slScaledValue,
+                            const unsigned char ucDecimals,
+                            const unsigned char ucWidth)
+{
+    /* Digits are generated from the end, in a local buffer */
+    char ascText[NUMBER_FORMAT_MAX_LENGTH_UC];
+    char* pscText = &ascText[NUMBER_FORMAT_MAX_LENGTH_UC];
+    unsigned char ucDec = ucDecimals > NUMBER_FORMAT_MAX_DECIMALS_UC ? NUMBER_FORMAT_MAX_DECIMALS_UC : ucDecimals;
+    bool bNegative = slScaledValue < 0;
+    uint32_t ulValue = bNegative ? -static_cast<uint32_t>(slScaledValue) : static_cast<uint32_t>(slScaledValue);
+    unsigned char ucDigits = 0;
+
+    /* At least one digit before the decimal separator. 32 bits divisions only while needed */
+    while (ulValue > 0xFFFF)
+    {
+        *--pscText = '0' + static_cast<char>(ulValue % 10);
+        ulValue /= 10;
+        if (++ucDigits == ucDec)
+        {
+            *--pscText = '.';
+        }
+    }
+    uint16_t usValue = static_cast<uint16_t>(ulValue);
+    while (usValue > 0 || ucDigits <= ucDec)
+    {
+        *--pscText = '0' + static_cast<char>(usValue % 10);
+        usValue /= 10;
+        if (++ucDigits == ucDec)
+        {
+            *--pscText = '.';
+        }
+    }
+    if (bNegative)
+    {
+        *--pscText = '-';
+    }
+
+    /* Right align in the requested width */
+    unsigned char ucLength = &ascText[NUMBER_FORMAT_MAX_LENGTH_UC] - pscText;
+    if (ucWidth > 0 && ucLength > ucWidth)
+    {
+        return ucFill(pscBuffer, NUMBER_FORMAT_OVERFLOW_SC, ucWidth);
+    }
+    unsigned char ucPadding = ucWidth > ucLength ? ucWidth - ucLength : 0;
+    memset(pscBuffer, ' ', ucPadding);
+    memcpy(&pscBuffer[ucPadding], pscText, ucLength);
+    pscBuffer[ucPadding + ucLength] = '\0';
+
+    return ucPadding + ucLength;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a floating point value. Only one multiplication and one conversion to
+* integer are done in floating point
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] fValue: Value to write
+* \param[in] ucDecimals: Number of decimals (up to NUMBER_FORMAT_MAX_DECIMALS_UC)
+* \param[in] ucWidth: Number of characters of the text. 0 to use the length of the value
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+unsigned char ucFormatFloat(char*               pscBuffer,
+                            const float         fValue,
+                            const unsigned char ucDecimals,
+                            const unsigned char ucWidth)
+{
+    if (fValue != fValue)
+    {
+        return ucFill(pscBuffer, NUMBER_FORMAT_INVALID_SC, ucWidth);
+    }
+
+    /* Round to the nearest. Values too big for the integer conversion can't fit any width */
+    unsigned char ucDec = ucDecimals > NUMBER_FORMAT_MAX_DECIMALS_UC ? NUMBER_FORMAT_MAX_DECIMALS_UC : ucDecimals;
+    float fScaled = fValue * NUMBER_FORMAT_POW10_US[ucDec];
+    fScaled += fScaled >= 0.0f ? 0.5f : -0.5f;
+    if (fScaled > NUMBER_FORMAT_MAX_SCALED_F || fScaled < -NUMBER_FORMAT_MAX_SCALED_F)
+    {
+        return ucFill(pscBuffer, NUMBER_FORMAT_OVERFLOW_SC, ucWidth);
+    }
+
+    return ucFormatFixed(pscBuffer, static_cast<int32_t>(fScaled), ucDec, ucWidth);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a Q16 value (see FixedPoint.h). Only integer arithmetic is used
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] slValue: Value to write (Q16)
+* \param[in] ucDecimals: Number of decimals (up to NUMBER_FORMAT_MAX_DECIMALS_UC)
+* \param[in] ucWidth: Number of characters of the text. 0 to use the length of the value
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+unsigned char ucFormatQ16(char*               pscBuffer,
+                          const int32_t       slValue,
+                          const unsigned char ucDecimals,
+                          const unsigned char ucWidth)
+{
+    /* Integer part rounded down (arithmetic shift) and positive fraction, so the scaled value never
+    overflows: 32768 * 10^4 and 65535 * 10^4 both fit in 32 bits */
+    unsigned char ucDec = ucDecimals > NUMBER_FORMAT_MAX_DECIMALS_UC ? NUMBER_FORMAT_MAX_DECIMALS_UC : ucDecimals;
+    uint16_t usScale = NUMBER_FORMAT_POW10_US[ucDec];
+    int32_t slInteger = slValue >> 16;
+    uint32_t ulFraction = (static_cast<uint32_t>(slValue & 0xFFFF) * usScale + 0x8000) >> 16;
+
+    return ucFormatFixed(pscBuffer, slInteger * usScale + static_cast<int32_t>(ulFraction), ucDec, ucWidth);
+}
@@ -0,0 +1,82 @@
+#ifndef NUMBER_FORMAT_H_
+#define NUMBER_FORMAT_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Formatting of numbers into caller buffers, without heap allocation and without floating
+point formatting (dtostrf, String::concat(float)). Values are converted to an integer scaled by
+10^decimals, and the digits are obtained with integer divisions (16 bits ones as soon as the value
+fits, which are much cheaper on AVR)
+- NOTE2: With a width, the text is right aligned and padded with spaces to exactly that number of
+characters. Values that don't fit are shown as NUMBER_FORMAT_OVERFLOW_SC in the whole width, and NaN
+values (e.g. a failed sensor reading) as NUMBER_FORMAT_INVALID_SC. With width 0 the text has the
+length it needs (up to NUMBER_FORMAT_MAX_LENGTH_UC characters)
+- NOTE3: The buffer must have room for the characters plus the null terminator: width + 1, or
+NUMBER_FORMAT_MAX_LENGTH_UC + 1 with width 0
+- NOTE4: Values are rounded to the nearest. A value that rounds to 0 is written without sign. Float
+values are scaled in float, so only their ~7 significant digits are exact
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char NUMBER_FORMAT_MAX_DECIMALS_UC = 4;   /**< Maximum number of decimals                    */
+const unsigned char NUMBER_FORMAT_MAX_LENGTH_UC   = 12;  /**< Longest text (sign, 10 digits and separator) */
+const char          NUMBER_FORMAT_OVERFLOW_SC     = '#'; /**< Character shown when the value doesn't fit    */
+const char          NUMBER_FORMAT_INVALID_SC      = '-'; /**< Character shown for NaN values                */
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes an integer value
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] slValue: Value to write
+* \param[in] ucWidth: Number of characters of the text. 0 to use the length of the value
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+unsigned char ucFormatInteger(char* pscBuffer, const int32_t slValue, const unsigned char ucWidth);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a fixed-point decimal value
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] slScaledValue: Value to write multiplied by 10^ucDecimals (e.g. 215 and 1 for 21.5)
+* \param[in] ucDecimals: Number of decimals (up to NUMBER_FORMAT_MAX_DECIMALS_UC)
+* \param[in] ucWidth: Number of characters of the text. 0 to use the length of the value
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+unsigned char ucFormatFixed(char*               pscBuffer,
+                            const int32_t       slScaledValue,
+                            const unsigned char ucDecimals,
+                            const unsigned char ucWidth);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a floating point value. Only one multiplication and one conversion to
+* integer are done in floating point
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] fValue: Value to write
+* \param[in] ucDecimals: Number of decimals (up to NUMBER_FORMAT_MAX_DECIMALS_UC)
+* \param[in] ucWidth: Number of characters of the text. 0 to use the length of the value
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+unsigned char ucFormatFloat(char*               pscBuffer,
+                            const float         fValue,
+                            const unsigned char ucDecimals,
+                            const unsigned char ucWidth);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a Q16 value (see FixedPoint.h). Only integer arithmetic is used
+* \param[out] pscBuffer: Output text (null terminated)
+* \param[in] slValue: Value to write (Q16)
+* \param[in] ucDecimals: Number of decimals (up to NUMBER_FORMAT_MAX_DECIMALS_UC)
+* \param[in] ucWidth: Number of characters of the text. 0 to use the length of the value
+* \return Number of characters written, without the terminator
+***************************************************************************************************/
+unsigned char ucFormatQ16(char*               pscBuffer,
+                          const int32_t       slValue,
+                          const unsigned char ucDecimals,
+                          const unsigned char ucWidth);
+
+#endif /* NUMBER_FORMAT_H_ */
@@ -0,0 +1,183 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+
+/* Custom includes */
+#include "Profiler.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the profiler class
+***************************************************************************************************/
+Profiler_cl::Profiler_cl()
+{
+    ucNumRegions_ = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds a new region to be profiled
+* \param[in] pscName: Name of the region, stored in flash (use the F() macro)
+* \return Identifier of the region, or INVALID_PROFILE_REGION_UC if there is no room for more
+***************************************************************************************************/
+unsigned char Profiler_cl::ucAddRegion(const __FlashStringHelper* pscName)
+{
+    if (ucNumRegions_ >= PROFILER_MAX_REGIONS_UC)
+    {
+        return INVALID_PROFILE_REGION_UC;
+    }
+
+    astRegions_[ucNumRegions_] = {};
+    astRegions_[ucNumRegions_].pscName = pscName;
+    astRegions_[ucNumRegions_].ulMinUs = PROFILER_NO_MIN_US_UL;
+
+    return ucNumRegions_++;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds a new measurement to a region
+* \param[in] ucRegionId: Identifier of the region
+* \param[in] ulElapsedUs: Execution time [us]
+***************************************************************************************************/
+void Profiler_cl::vRecord(const unsigned char ucRegionId, const uint32_t ulElapsedUs)
+{
+    /* Measurements of regions that couldn't be added are ignored */
+    if (ucRegionId >= ucNumRegions_)
+    {
+        return;
+    }
+
+    ProfileRegion_st& stRegion = astRegions_[ucRegionId];
+    stRegion.ulCount++;
+    if (ulElapsedUs < stRegion.ulMinUs)
+    {
+        stRegion.ulMinUs = ulElapsedUs;
+    }
+    if (ulElapsedUs > stRegion.ulMaxUs)
+    {
+        stRegion.ulMaxUs = ulElapsedUs;
+    }
+
+    unsigned char ucBucket = ucGetLog2Bucket(ulElapsedUs, PROFILER_NUM_BUCKETS_UC);
+    if (stRegion.ausHistogram[ucBucket] < PROFILER_MAX_BUCKET_COUNT_US)
+    {
+        stRegion.ausHistogram[ucBucket]++;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function estimates a percentile of the execution time of a region, from its histogram.
+* The upper limit of the bucket is returned, so the estimation is pessimistic
+* \param[in] ucRegionId: Identifier of the region
+* \param[in] ucPercentile: Percentile to compute [1-100]
+* \return Execution time [us], never greater than the maximum measured time
+***************************************************************************************************/
+uint32_t Profiler_cl::ulGetPercentileUs(const unsigned char ucRegionId, const unsigned char ucPercentile) const
+{
+    if (ucRegionId >= ucNumRegions_)
+    {
+        return 0;
+    }
+    const ProfileRegion_st& stRegion = astRegions_[ucRegionId];
+
+    /* Counters may be saturated, so the total is computed from the histogram itself */
+    uint32_t ulTotal = 0;
+    for (unsigned char ucBucket = 0; ucBucket < PROFILER_NUM_BUCKETS_UC; ucBucket++)
+    {
+        ulTotal += stRegion.ausHistogram[ucBucket];
+    }
+
+    /* Find the first bucket where the accumulated count reaches the requested rank (rounded up) */
+    uint32_t ulRank = (ulTotal * ucPercentile + 99) / 100;
+    uint32_t ulAccumulated = 0;
+    for (unsigned char ucBucket = 0; ucBucket < PROFILER_NUM_BUCKETS_UC; ucBucket++)
+    {
+        ulAccumulated += stRegion.ausHistogram[ucBucket];
+        if (ulAccumulated >= ulRank && ulAccumulated > 0)
+        {
+            uint32_t ulUpperUs = ucBucket == 0 ? 0 : (static_cast<uint32_t>(1) << ucBucket) - 1;
+            return ulUpperUs < stRegion.ulMaxUs ? ulUpperUs : stRegion.ulMaxUs;
+        }
+    }
+
+    return 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the statistics of a region
+* \param[in] ucRegionId: Identifier of the region
+* \return Statistics of the region
+***************************************************************************************************/
+const ProfileRegion_st& Profiler_cl::stGetRegion(const unsigned char ucRegionId) const
+{
+    return astRegions_[ucRegionId < ucNumRegions_ ? ucRegionId : 0];
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the number of regions added to the profiler
+* \return Number of regions
+***************************************************************************************************/
+unsigned char Profiler_cl::ucGetNumRegions() const
+{
+    return ucNumRegions_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a text report of all regions. Each line contains the name, number of
+* measurements, min, p99 and max times [us] and the histogram, up to the last used bucket
+* \param[in] clOutput: Where the report is written (e.g. the debug Serial)
+***************************************************************************************************/
+void Profiler_cl::vPrintReport(Print& clOutput) const
+{
+    for (unsigned char ucRegionId = 0; ucRegionId < ucNumRegions_; ucRegionId++)
+    {
+        const ProfileRegion_st& stRegion = astRegions_[ucRegionId];
+        clOutput.print(stRegion.pscName);
+        clOutput.print(F(": n="));
+        clOutput.print(stRegion.ulCount);
+
+        /* Regions that have not run yet only show the counter */
+        if (stRegion.ulCount == 0)
+        {
+            clOutput.println();
+            continue;
+        }
+
+        clOutput.print(F(" min="));
+        clOutput.print(stRegion.ulMinUs);
+        clOutput.print(F(" p99="));
+        clOutput.print(ulGetPercentileUs(ucRegionId, 99));
+        clOutput.print(F(" max="));
+        clOutput.print(stRegion.ulMaxUs);
+
+        /* Histogram, skipping the unused buckets at the end */
+        unsigned char ucLastBucket = PROFILER_NUM_BUCKETS_UC - 1;
+        while (ucLastBucket > 0 && stRegion.ausHistogram[ucLastBucket] == 0)
+        {
+            ucLastBucket--;
+        }
+        clOutput.print(F(" hist="));
+        for (unsigned char ucBucket = 0; ucBucket <= ucLastBucket; ucBucket++)
+        {
+            if (ucBucket > 0)
+            {
+                clOutput.print(',');
+            }
+            clOutput.print(stRegion.ausHistogram[ucBucket]);
+        }
+        clOutput.println();
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function resets the statistics of all regions. Regions are kept
+***************************************************************************************************/
+void Profiler_cl::vReset()
+{
+    for (unsigned char ucRegionId = 0; ucRegionId < ucNumRegions_; ucRegionId++)
+    {
+        const __FlashStringHelper* pscName = astRegions_[ucRegionId].pscName;
+        astRegions_[ucRegionId] = {};
+        astRegions_[ucRegionId].pscName = pscName;
+        astRegions_[ucRegionId].ulMinUs = PROFILER_NO_MIN_US_UL;
+    }
+}
@@ -0,0 +1,179 @@
+#ifndef PROFILER_H_
+#define PROFILER_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Profiling is disabled by default. To enable it, define PROFILING_ENABLED as 1 before
+including this file, and declare a global "Profiler_cl clProfiler_" in the sketch (only when
+profiling is enabled). When disabled, PROFILE_SCOPE() generates no code at all
+- NOTE2: Times are measured with micros(), whose resolution is 4 us on 16 MHz AVR boards (there is
+no cycle counter). Each measurement adds ~10 us of overhead to the region
+- NOTE3: Execution times are stored in log2 histograms. Bucket 0 holds 0 us, and bucket k (k > 0)
+holds times in [2^(k-1), 2^k) us. The last bucket also holds all longer times
+*/
+
+#ifndef PROFILING_ENABLED
+#define PROFILING_ENABLED 0 /**< Set to 1 before including this file to enable profiling */
+#endif
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char PROFILER_MAX_REGIONS_UC      = 8;          /**< Maximum number of profiled regions               */
+const unsigned char PROFILER_NUM_BUCKETS_UC      = 22;         /**< Number of histogram buckets (last one is ~1 s)   */
+const unsigned char INVALID_PROFILE_REGION_UC    = 0xFF;       /**< Region identifier returned when it can't be added */
+const uint32_t      PROFILER_NO_MIN_US_UL        = 0xFFFFFFFF; /**< Minimum time of a region with no measurements    */
+const uint16_t      PROFILER_MAX_BUCKET_COUNT_US = 0xFFFF;     /**< Histogram counters saturate at this value        */
+
+/********************************************* MACROS *********************************************/
+#if PROFILING_ENABLED
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+/** Measures the execution time from this point to the end of the enclosing scope. The region is
+registered the first time it runs. pscName must be a string literal (it is stored in flash) */
+#define PROFILE_SCOPE(pscName)                                                                        \
+    static const unsigned char PROFILE_CONCAT(ucProfileRegion, __LINE__) = clProfiler_.ucAddRegion(F(pscName)); \
+    ProfileScope_cl PROFILE_CONCAT(clProfileScope, __LINE__)(clProfiler_, PROFILE_CONCAT(ucProfileRegion, __LINE__))
+#else
+#define PROFILE_SCOPE(pscName)
+#endif
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct ProfileRegion_st
+ * \brief Execution time statistics of a profiled region
+ **************************************************************************************************/
+struct ProfileRegion_st
+{
+    const __FlashStringHelper* pscName;                               /**< Name of the region (in flash)        */
+    uint32_t                   ulCount;                               /**< Number of measurements               */
+    uint32_t                   ulMinUs;                               /**< Minimum execution time [us]          */
+    uint32_t                   ulMaxUs;                               /**< Maximum execution time [us]          */
+    uint16_t                   ausHistogram[PROFILER_NUM_BUCKETS_UC]; /**< Log2 histogram (saturated counters) */
+};
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the log2 histogram bucket of a value: 0 for 0, and k (k > 0) for values
+* in [2^(k-1), 2^k). Values beyond the last bucket go to the last one
+* \param[in] ulValue: Value to be classified
+* \param[in] ucNumBuckets: Number of buckets of the histogram
+* \return Bucket of the value
+***************************************************************************************************/
+inline unsigned char ucGetLog2Bucket(uint32_t ulValue, const unsigned char ucNumBuckets)
+{
+    unsigned char ucBucket = 0;
+    while (ulValue != 0 && ucBucket < ucNumBuckets - 1)
+    {
+        ulValue >>= 1;
+        ucBucket++;
+    }
+    return ucBucket;
+}
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class Profiler_cl
+ * \brief Class that accumulates execution times of code regions into log2 histograms
+ **************************************************************************************************/
+class Profiler_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the profiler class
+    ***********************************************************************************************/
+    Profiler_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds a new region to be profiled
+    * \param[in] pscName: Name of the region, stored in flash (use the F() macro)
+    * \return Identifier of the region, or INVALID_PROFILE_REGION_UC if there is no room for more
+    ***********************************************************************************************/
+    unsigned char ucAddRegion(const __FlashStringHelper* pscName);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds a new measurement to a region
+    * \param[in] ucRegionId: Identifier of the region
+    * \param[in] ulElapsedUs: Execution time [us]
+    ***********************************************************************************************/
+    void vRecord(const unsigned char ucRegionId, const uint32_t ulElapsedUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function estimates a percentile of the execution time of a region, from its
+    * histogram. The upper limit of the bucket is returned, so the estimation is pessimistic
+    * \param[in] ucRegionId: Identifier of the region
+    * \param[in] ucPercentile: Percentile to compute [1-100]
+    * \return Execution time [us], never greater than the maximum measured time
+    ***********************************************************************************************/
+    uint32_t ulGetPercentileUs(const unsigned char ucRegionId, const unsigned char ucPercentile) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the statistics of a region
+    * \param[in] ucRegionId: Identifier of the region
+    * \return Statistics of the region
+    ***********************************************************************************************/
+    const ProfileRegion_st& stGetRegion(const unsigned char ucRegionId) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the number of regions added to the profiler
+    * \return Number of regions
+    ***********************************************************************************************/
+    unsigned char ucGetNumRegions() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function writes a text report of all regions. Each line contains the name, number
+    * of measurements, min, p99 and max times [us] and the histogram, up to the last used bucket
+    * \param[in] clOutput: Where the report is written (e.g. the debug Serial)
+    ***********************************************************************************************/
+    void vPrintReport(Print& clOutput) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function resets the statistics of all regions. Regions are kept
+    ***********************************************************************************************/
+    void vReset();
+
+private:
+    /***************************************** ATTRIBUTES *****************************************/
+    ProfileRegion_st astRegions_[PROFILER_MAX_REGIONS_UC]; /**< Profiled regions        */
+    unsigned char    ucNumRegions_;                        /**< Number of regions added */
+};
+
+/***********************************************************************************************//**
+ * \class ProfileScope_cl
+ * \brief Measures the time from its construction to its destruction (use PROFILE_SCOPE())
+ **************************************************************************************************/
+class ProfileScope_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor. Starts the measurement
+    * \param[in] clProfiler: Profiler where the measurement is recorded
+    * \param[in] ucRegionId: Identifier of the region
+    ***********************************************************************************************/
+    ProfileScope_cl(Profiler_cl& clProfiler, const unsigned char ucRegionId)
+        : clProfiler_(clProfiler), ucRegionId_(ucRegionId), ulStartUs_(micros())
+    {
+    }
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Destructor. Records the measurement
+    ***********************************************************************************************/
+    ~ProfileScope_cl()
+    {
+        clProfiler_.vRecord(ucRegionId_, micros() - ulStartUs_);
+    }
+
+private:
+    /***************************************** ATTRIBUTES *****************************************/
+    Profiler_cl&  clProfiler_; /**< Profiler where the measurement is recorded */
+    unsigned char ucRegionId_; /**< Identifier of the region                   */
+    unsigned long ulStartUs_;  /**< Output of micros() at the start            */
+};
+
+#endif /* PROFILER_H_ */
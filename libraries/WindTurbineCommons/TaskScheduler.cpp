@@ -0,0 +1,268 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+
+/* Custom includes */
+#include "TaskScheduler.h"
+
+
+/******************************************** MACROS **********************************************/
+#ifndef TASK_SCHEDULER_RUN_HOOK
+#define TASK_SCHEDULER_RUN_HOOK(pfTask) /**< See NOTE6 of TaskScheduler.h */
+#endif
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the task scheduler class
+***************************************************************************************************/
+TaskScheduler_cl::TaskScheduler_cl()
+{
+    ucNumTasks_ = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds a periodic task to the scheduler. The task is ready to run as soon as it
+* is added
+* \param[in] pfTask: Function executed by the task
+* \param[in] ulPeriodMs: Time between two releases of the task [ms]. 0 runs it in every pass
+* \param[in] ulDeadlineMs: Maximum time from release to end of execution [ms]. 0 disables the
+* deadline check
+* \param[in] ucPriority: Priority of the task. Lower values run first
+* \return Identifier of the task, or INVALID_TASK_ID_UC if there is no room for more tasks
+***************************************************************************************************/
+unsigned char TaskScheduler_cl::ucAddTask(TaskFunction_t      pfTask,
+                                          const unsigned long ulPeriodMs,
+                                          const unsigned long ulDeadlineMs,
+                                          const unsigned char ucPriority)
+{
+    /* Check there is room for the task */
+    if (ucNumTasks_ >= MAX_SCHEDULER_TASKS_UC || pfTask == NULL)
+    {
+        return INVALID_TASK_ID_UC;
+    }
+
+    /* Store the task */
+    Task_st& stTask = astTasks_[ucNumTasks_];
+    stTask.pfTask          = pfTask;
+    stTask.ulPeriodUs      = ulPeriodMs * 1000UL;
+    stTask.ulDeadlineUs    = ulDeadlineMs * 1000UL;
+    stTask.ulNextReleaseUs = micros();
+    stTask.ucPriority      = ucPriority;
+    stTask.bEnabled        = true;
+    stTask.bTriggered      = false;
+    stTask.stStats         = {};
+
+    return ucNumTasks_++;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function runs all the tasks that are ready, most urgent first. It must be invoked in
+* every step of the main Arduino loop
+***************************************************************************************************/
+void TaskScheduler_cl::vRun()
+{
+    /* The most urgent task is selected again after every execution, so a task released while
+    another one was running does not wait for the less urgent ones. Tasks with period 0 are only
+    released again in the next pass */
+    uint32_t ulPassStartUs = micros();
+    unsigned char ucMaxRuns = ucNumTasks_;
+    while (ucMaxRuns-- > 0 && bRunNext(ulPassStartUs))
+    {
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function runs the most urgent task that is ready, if any
+* \return True if a task was executed
+***************************************************************************************************/
+bool TaskScheduler_cl::bRunNext()
+{
+    return bRunNext(micros());
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function runs the most urgent task that is ready, if any
+* \param[in] ulPassStartUs: Output of micros() at the start of the current pass. Tasks with period 0
+* are only ready if they were released before this time
+* \return True if a task was executed
+***************************************************************************************************/
+bool TaskScheduler_cl::bRunNext(const uint32_t ulPassStartUs)
+{
+    /* Find the most urgent task among the ones that are ready */
+    uint32_t ulNowUs = micros();
+    unsigned char ucSelected = INVALID_TASK_ID_UC;
+    for (unsigned char ucTaskId = 0; ucTaskId < ucNumTasks_; ucTaskId++)
+    {
+        const Task_st& stTask = astTasks_[ucTaskId];
+
+        /* Signed difference of the 32 bits times, to handle the overflow of micros() (whatever the
+        size of long) */
+        uint32_t ulReferenceUs = stTask.ulPeriodUs == 0 ? ulPassStartUs : ulNowUs;
+        if (!stTask.bEnabled ||
+            (!stTask.bTriggered && static_cast<int32_t>(ulReferenceUs - stTask.ulNextReleaseUs) < 0))
+        {
+            continue;
+        }
+
+        /* Lower priority value wins. Same priority, earliest absolute deadline wins */
+        if (ucSelected == INVALID_TASK_ID_UC ||
+            stTask.ucPriority < astTasks_[ucSelected].ucPriority ||
+            (stTask.ucPriority == astTasks_[ucSelected].ucPriority &&
+             static_cast<int32_t>((stTask.ulNextReleaseUs + stTask.ulDeadlineUs) -
+                                  (astTasks_[ucSelected].ulNextReleaseUs + astTasks_[ucSelected].ulDeadlineUs)) < 0))
+        {
+            ucSelected = ucTaskId;
+        }
+    }
+
+    /* Nothing to do */
+    if (ucSelected == INVALID_TASK_ID_UC)
+    {
+        return false;
+    }
+
+    /* Run the task, measuring its execution time. A trigger arriving while the task runs is kept */
+    Task_st& stTask = astTasks_[ucSelected];
+    bool bReleased = static_cast<int32_t>(ulNowUs - stTask.ulNextReleaseUs) >= 0;
+    stTask.bTriggered = false;
+    uint32_t ulStartUs = micros();
+    stTask.pfTask();
+    TASK_SCHEDULER_RUN_HOOK(stTask.pfTask);
+    uint32_t ulEndUs = micros();
+
+    /* Update statistics */
+    stTask.stStats.ulRuns++;
+    stTask.stStats.ulLastExecTimeUs = ulEndUs - ulStartUs;
+    if (stTask.stStats.ulLastExecTimeUs > stTask.stStats.ulMaxExecTimeUs)
+    {
+        stTask.stStats.ulMaxExecTimeUs = stTask.stStats.ulLastExecTimeUs;
+    }
+
+    /* Runs triggered before the release don't count as periodic runs */
+    if (!bReleased)
+    {
+        return true;
+    }
+
+    stTask.stStats.ulLastJitterUs = ulStartUs - stTask.ulNextReleaseUs;
+    if (stTask.stStats.ulLastJitterUs > stTask.stStats.ulMaxJitterUs)
+    {
+        stTask.stStats.ulMaxJitterUs = stTask.stStats.ulLastJitterUs;
+    }
+
+    if (stTask.ulDeadlineUs > 0 &&
+        static_cast<int32_t>(ulEndUs - (stTask.ulNextReleaseUs + stTask.ulDeadlineUs)) > 0)
+    {
+        stTask.stStats.ulDeadlineMisses++;
+    }
+
+    /* Compute the next release. If the task is more than one period late, do not try to catch up
+    with the lost releases, start again from now */
+    stTask.ulNextReleaseUs += stTask.ulPeriodUs;
+    if (static_cast<int32_t>(ulEndUs - stTask.ulNextReleaseUs) >= 0)
+    {
+        stTask.ulNextReleaseUs = ulEndUs + stTask.ulPeriodUs;
+    }
+
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function changes the period of a task. The next release is not modified
+* \param[in] ucTaskId: Identifier of the task
+* \param[in] ulPeriodMs: New period [ms]
+***************************************************************************************************/
+void TaskScheduler_cl::vSetPeriod(const unsigned char ucTaskId, const unsigned long ulPeriodMs)
+{
+    if (ucTaskId < ucNumTasks_)
+    {
+        astTasks_[ucTaskId].ulPeriodUs = ulPeriodMs * 1000UL;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function enables or disables a task. An enabled task is ready immediately
+* \param[in] ucTaskId: Identifier of the task
+* \param[in] bEnabled: True to enable the task
+***************************************************************************************************/
+void TaskScheduler_cl::vSetEnabled(const unsigned char ucTaskId, const bool bEnabled)
+{
+    if (ucTaskId < ucNumTasks_)
+    {
+        if (bEnabled && !astTasks_[ucTaskId].bEnabled)
+        {
+            astTasks_[ucTaskId].ulNextReleaseUs = micros();
+        }
+        astTasks_[ucTaskId].bEnabled = bEnabled;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function makes a task ready to run as soon as possible, whatever its period. It can be
+* called from an ISR
+* \param[in] ucTaskId: Identifier of the task
+***************************************************************************************************/
+void TaskScheduler_cl::vTrigger(const unsigned char ucTaskId)
+{
+    if (ucTaskId < ucNumTasks_)
+    {
+        astTasks_[ucTaskId].bTriggered = true;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the execution statistics of a task
+* \param[in] ucTaskId: Identifier of the task
+* \return Execution statistics
+***************************************************************************************************/
+const TaskStats_st& TaskScheduler_cl::stGetStats(const unsigned char ucTaskId) const
+{
+    return astTasks_[ucTaskId < ucNumTasks_ ? ucTaskId : 0].stStats;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the number of tasks added to the scheduler
+* \return Number of tasks
+***************************************************************************************************/
+unsigned char TaskScheduler_cl::ucGetNumTasks() const
+{
+    return ucNumTasks_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function resets the execution statistics of all tasks
+***************************************************************************************************/
+void TaskScheduler_cl::vResetStats()
+{
+    for (unsigned char ucTaskId = 0; ucTaskId < ucNumTasks_; ucTaskId++)
+    {
+        astTasks_[ucTaskId].stStats = {};
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a text report with the statistics of all tasks. Each line contains the
+* task identifier, number of runs, last and max execution times [us], deadline misses and last and max
+* jitter [us]
+* \param[in] clOutput: Where the report is written (e.g. the debug Serial)
+***************************************************************************************************/
+void TaskScheduler_cl::vPrintStats(Print& clOutput) const
+{
+    for (unsigned char ucTaskId = 0; ucTaskId < ucNumTasks_; ucTaskId++)
+    {
+        const TaskStats_st& stStats = astTasks_[ucTaskId].stStats;
+        clOutput.print(F("task "));
+        clOutput.print(ucTaskId);
+        clOutput.print(F(": n="));
+        clOutput.print(stStats.ulRuns);
+        clOutput.print(F(" last="));
+        clOutput.print(stStats.ulLastExecTimeUs);
+        clOutput.print(F(" max="));
+        clOutput.print(stStats.ulMaxExecTimeUs);
+        clOutput.print(F(" misses="));
+        clOutput.print(stStats.ulDeadlineMisses);
+        clOutput.print(F(" jitter="));
+        clOutput.print(stStats.ulLastJitterUs);
+        clOutput.print(F("/"));
+        clOutput.println(stStats.ulMaxJitterUs);
+    }
+}
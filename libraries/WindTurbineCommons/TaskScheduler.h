@@ -0,0 +1,168 @@
+#ifndef TASK_SCHEDULER_H_
+#define TASK_SCHEDULER_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+#include <Print.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: The scheduler is cooperative. Tasks are never preempted, so a task must return quickly and
+never block. A task that blocks delays every other task, whatever their priority
+- NOTE2: When several tasks are ready, the one with the lowest priority value runs first. Ties are
+resolved running the task with the earliest absolute deadline
+- NOTE3: Times are measured with micros(), so intervals must be shorter than ~35 minutes
+- NOTE4: A task can also be triggered by an event (vTrigger(), also from an ISR). It is then ready
+immediately, without changing its periodic releases
+- NOTE5: The jitter of a periodic run is the time from its release to the start of its execution. It
+is the delay added by the rest of tasks (and interrupts) to the task. Triggered runs are not counted
+- NOTE6: TASK_SCHEDULER_RUN_HOOK(pfTask) is expanded after each task execution, before its end time
+is taken. It is empty on the target. The host simulator defines it (in its Arduino.h) to charge an
+execution time to its virtual clock
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char MAX_SCHEDULER_TASKS_UC = 14;   /**< Maximum number of tasks managed by the scheduler */
+const unsigned char INVALID_TASK_ID_UC     = 0xFF; /**< Task identifier returned when a task can't be added */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \brief Function executed by a task
+ **************************************************************************************************/
+typedef void (*TaskFunction_t)();
+
+/***********************************************************************************************//**
+ * \struct TaskStats_st
+ * \brief Execution statistics of a task
+ **************************************************************************************************/
+struct TaskStats_st
+{
+    uint32_t ulRuns;           /**< Number of executions of the task                                 */
+    uint32_t ulLastExecTimeUs; /**< Execution time of the last run [us]                              */
+    uint32_t ulMaxExecTimeUs;  /**< Maximum execution time since the last reset [us]                 */
+    uint32_t ulDeadlineMisses; /**< Number of runs that finished after their deadline                */
+    uint32_t ulLastJitterUs;   /**< Release to start of execution of the last periodic run [us]      */
+    uint32_t ulMaxJitterUs;    /**< Maximum release to start of execution since the last reset [us]  */
+};
+
+/***********************************************************************************************//**
+ * \struct Task_st
+ * \brief Configuration and state of a task
+ **************************************************************************************************/
+struct Task_st
+{
+    TaskFunction_t pfTask;          /**< Function executed by the task                                     */
+    uint32_t       ulPeriodUs;      /**< Time between two releases of the task [us]. 0 runs it every pass  */
+    uint32_t       ulDeadlineUs;    /**< Maximum time from release to end of execution [us]. 0 = no check  */
+    uint32_t       ulNextReleaseUs; /**< Output of micros() when the task will be ready again              */
+    unsigned char  ucPriority;      /**< Priority of the task. Lower values run first                      */
+    bool           bEnabled;        /**< Disabled tasks are never released                                 */
+    volatile bool  bTriggered;      /**< Set by vTrigger(). The task is ready until its next execution     */
+    TaskStats_st   stStats;         /**< Execution statistics                                              */
+};
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class TaskScheduler_cl
+ * \brief Cooperative scheduler with periodic tasks, priorities and deadlines
+ **************************************************************************************************/
+class TaskScheduler_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the task scheduler class
+    ***********************************************************************************************/
+    TaskScheduler_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds a periodic task to the scheduler. The task is ready to run as soon
+    * as it is added
+    * \param[in] pfTask: Function executed by the task
+    * \param[in] ulPeriodMs: Time between two releases of the task [ms]. 0 runs it in every pass
+    * \param[in] ulDeadlineMs: Maximum time from release to end of execution [ms]. 0 disables the
+    * deadline check
+    * \param[in] ucPriority: Priority of the task. Lower values run first
+    * \return Identifier of the task, or INVALID_TASK_ID_UC if there is no room for more tasks
+    ***********************************************************************************************/
+    unsigned char ucAddTask(TaskFunction_t      pfTask,
+                            const unsigned long ulPeriodMs,
+                            const unsigned long ulDeadlineMs,
+                            const unsigned char ucPriority);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function runs all the tasks that are ready, most urgent first. It must be invoked
+    * in every step of the main Arduino loop
+    ***********************************************************************************************/
+    void vRun();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function runs the most urgent task that is ready, if any
+    * \return True if a task was executed
+    ***********************************************************************************************/
+    bool bRunNext();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function changes the period of a task. The next release is not modified
+    * \param[in] ucTaskId: Identifier of the task
+    * \param[in] ulPeriodMs: New period [ms]
+    ***********************************************************************************************/
+    void vSetPeriod(const unsigned char ucTaskId, const unsigned long ulPeriodMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function enables or disables a task. An enabled task is ready immediately
+    * \param[in] ucTaskId: Identifier of the task
+    * \param[in] bEnabled: True to enable the task
+    ***********************************************************************************************/
+    void vSetEnabled(const unsigned char ucTaskId, const bool bEnabled);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function makes a task ready to run as soon as possible, whatever its period. It
+    * can be called from an ISR
+    * \param[in] ucTaskId: Identifier of the task
+    ***********************************************************************************************/
+    void vTrigger(const unsigned char ucTaskId);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the execution statistics of a task
+    * \param[in] ucTaskId: Identifier of the task
+    * \return Execution statistics
+    ***********************************************************************************************/
+    const TaskStats_st& stGetStats(const unsigned char ucTaskId) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the number of tasks added to the scheduler
+    * \return Number of tasks
+    ***********************************************************************************************/
+    unsigned char ucGetNumTasks() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function resets the execution statistics of all tasks
+    ***********************************************************************************************/
+    void vResetStats();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function writes a text report with the statistics of all tasks. Each line contains
+    * the task identifier, number of runs, last and max execution times [us], deadline misses and
+    * last and max jitter [us]
+    * \param[in] clOutput: Where the report is written (e.g. the debug Serial)
+    ***********************************************************************************************/
+    void vPrintStats(Print& clOutput) const;
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function runs the most urgent task that is ready, if any
+    * \param[in] ulPassStartUs: Output of micros() at the start of the current pass. Tasks with
+    * period 0 are only ready if they were released before this time
+    * \return True if a task was executed
+    ***********************************************************************************************/
+    bool bRunNext(const uint32_t ulPassStartUs);
+
+    /***************************************** ATTRIBUTES *****************************************/
+    Task_st       astTasks_[MAX_SCHEDULER_TASKS_UC]; /**< Tasks managed by the scheduler */
+    unsigned char ucNumTasks_;                       /**< Number of tasks added          */
+};
+
+#endif /* TASK_SCHEDULER_H_ */
@@ -0,0 +1,68 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <string.h>
+
+/* Custom includes */
+#include "Telemetry.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the fast telemetry fields of the turbine data
+* \param[in] stAeroData: Turbine data
+* \param[out] stKinematics: Fast telemetry message
+***************************************************************************************************/
+void vGetKinematicData(const AeroData_st& stAeroData, KinematicData_st& stKinematics)
+{
+    stKinematics.fWindSpeed            = stAeroData.fWindSpeed;
+    stKinematics.fAverageWindSpeed     = stAeroData.fAverageWindSpeed;
+    stKinematics.fRotorSpeedRPM        = stAeroData.fRotorSpeedRPM;
+    stKinematics.fBladePitchPercentage = stAeroData.fBladePitchPercentage;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the slow telemetry fields of the turbine data
+* \param[in] stAeroData: Turbine data
+* \param[out] stEnvironment: Slow telemetry message
+***************************************************************************************************/
+void vGetEnvironmentData(const AeroData_st& stAeroData, EnvironmentData_st& stEnvironment)
+{
+    stEnvironment.fTempCelsius = stAeroData.fTempCelsius;
+    stEnvironment.fRelHumidity = stAeroData.fRelHumidity;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function merges a received telemetry message into the turbine data (see NOTE2)
+* \param[in] eMsgId: Id of the received message
+* \param[in] pucBody: Body of the received message
+* \param[in,out] stAeroData: Turbine data. Only the fields of the message are written
+* \return True if the message was a telemetry message
+***************************************************************************************************/
+bool bMergeTelemetry(const MessageID_e eMsgId, const unsigned char* pucBody, AeroData_st& stAeroData)
+{
+    /* The bodies are copied, they are not aligned in the reception buffers */
+    if (eMsgId == MESSAGEID_KINEMATICS)
+    {
+        KinematicData_st stKinematics;
+        memcpy(&stKinematics, pucBody, sizeof(stKinematics));
+        stAeroData.fWindSpeed            = stKinematics.fWindSpeed;
+        stAeroData.fAverageWindSpeed     = stKinematics.fAverageWindSpeed;
+        stAeroData.fRotorSpeedRPM        = stKinematics.fRotorSpeedRPM;
+        stAeroData.fBladePitchPercentage = stKinematics.fBladePitchPercentage;
+        return true;
+    }
+    if (eMsgId == MESSAGEID_ENVIRONMENT)
+    {
+        EnvironmentData_st stEnvironment;
+        memcpy(&stEnvironment, pucBody, sizeof(stEnvironment));
+        stAeroData.fTempCelsius = stEnvironment.fTempCelsius;
+        stAeroData.fRelHumidity = stEnvironment.fRelHumidity;
+        return true;
+    }
+    if (eMsgId == MESSAGEID_STATUS)
+    {
+        memcpy(&stAeroData.stStatus, pucBody, sizeof(stAeroData.stStatus));
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,45 @@
+#ifndef TELEMETRY_H_
+#define TELEMETRY_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+#include "CommonTypes.h"
+
+
+/*
+- NOTE1: The Control Arduino sends the turbine data split by rate: KinematicData_st in every
+telemetry period, EnvironmentData_st with each new reading of the DHT22, and AeroStatus_st when it
+changes (plus a slow refresh, in case an event is lost)
+- NOTE2: The consumers keep an AeroData_st with the last value of each field, and merge each message
+into it (bMergeTelemetry()). Every field is only written by one message type, so the view is always
+made of the last received value of each field
+*/
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the fast telemetry fields of the turbine data
+* \param[in] stAeroData: Turbine data
+* \param[out] stKinematics: Fast telemetry message
+***************************************************************************************************/
+void vGetKinematicData(const AeroData_st& stAeroData, KinematicData_st& stKinematics);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the slow telemetry fields of the turbine data
+* \param[in] stAeroData: Turbine data
+* \param[out] stEnvironment: Slow telemetry message
+***************************************************************************************************/
+void vGetEnvironmentData(const AeroData_st& stAeroData, EnvironmentData_st& stEnvironment);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function merges a received telemetry message into the turbine data (see NOTE2)
+* \param[in] eMsgId: Id of the received message
+* \param[in] pucBody: Body of the received message
+* \param[in,out] stAeroData: Turbine data. Only the fields of the message are written
+* \return True if the message was a telemetry message
+***************************************************************************************************/
+bool bMergeTelemetry(const MessageID_e eMsgId, const unsigned char* pucBody, AeroData_st& stAeroData);
+
+#endif /* TELEMETRY_H_ */
@@ -0,0 +1,94 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+
+/* Custom includes */
+#include "FixedPoint.h"
+#include "WindPredictor.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the wind predictor class
+***************************************************************************************************/
+WindPredictor_cl::WindPredictor_cl()
+{
+    slAlphaQ16_        = Q16_ONE_SL;
+    slBetaQ16_         = 0;
+    ulSamplePeriodMs_  = 1;
+    slHorizonStepsQ16_ = 0;
+    slLevelQ16_        = 0;
+    slTrendQ16_        = 0;
+    bInitialized_      = false;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Setup the class
+* \param[in] fAlpha: Smoothing factor of the level, in the range (0, 1]
+* \param[in] fBeta: Smoothing factor of the slope, in the range [0, 1]
+* \param[in] ulSamplePeriodMs: Period of the calls to vUpdate() [ms]
+* \param[in] ulHorizonMs: Time ahead of the forecast [ms]
+***************************************************************************************************/
+void WindPredictor_cl::vSetup(const float fAlpha, const float fBeta, const unsigned long ulSamplePeriodMs,
+                              const unsigned long ulHorizonMs)
+{
+    slAlphaQ16_       = slFloatToQ16(fAlpha);
+    slBetaQ16_        = slFloatToQ16(fBeta);
+    ulSamplePeriodMs_ = ulSamplePeriodMs > 0 ? ulSamplePeriodMs : 1;
+    bInitialized_     = false;
+    vSetHorizon(ulHorizonMs);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function changes the time ahead of the forecast
+* \param[in] ulHorizonMs: Time ahead of the forecast [ms]. 0 returns the smoothed wind speed
+***************************************************************************************************/
+void WindPredictor_cl::vSetHorizon(const unsigned long ulHorizonMs)
+{
+    /* Integer and fractional parts of the number of periods, so a long horizon does not overflow */
+    uint32_t ulSteps     = ulHorizonMs / ulSamplePeriodMs_;
+    uint32_t ulRemainder = ulHorizonMs % ulSamplePeriodMs_;
+    slHorizonStepsQ16_ = static_cast<int32_t>((ulSteps << Q16_FRACTIONAL_BITS_UC) +
+                                              (ulRemainder << Q16_FRACTIONAL_BITS_UC) / ulSamplePeriodMs_);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds a new wind speed sample
+* \param[in] slWindSpeedQ16: Measured wind speed [m/s] (Q16)
+***************************************************************************************************/
+void WindPredictor_cl::vUpdate(const int32_t slWindSpeedQ16)
+{
+    /* The first sample is the level, without slope */
+    if (!bInitialized_)
+    {
+        slLevelQ16_   = slWindSpeedQ16;
+        slTrendQ16_   = 0;
+        bInitialized_ = true;
+        return;
+    }
+
+    /* level = alpha * sample + (1 - alpha) * (level + trend), written with a single product */
+    int32_t slExpectedQ16 = slLevelQ16_ + slTrendQ16_;
+    int32_t slNewLevelQ16 = slExpectedQ16 + slMulQ16(slAlphaQ16_, slWindSpeedQ16 - slExpectedQ16);
+
+    /* trend = beta * (new level - level) + (1 - beta) * trend */
+    slTrendQ16_ = slTrendQ16_ + slMulQ16(slBetaQ16_, (slNewLevelQ16 - slLevelQ16_) - slTrendQ16_);
+    slLevelQ16_ = slNewLevelQ16;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the wind speed expected at the horizon. It is never negative
+* \return Predicted wind speed [m/s] (Q16). 0 before the first sample
+***************************************************************************************************/
+int32_t WindPredictor_cl::slGetForecastQ16() const
+{
+    int32_t slForecastQ16 = slLevelQ16_ + slMulQ16(slTrendQ16_, slHorizonStepsQ16_);
+    return slForecastQ16 > 0 ? slForecastQ16 : 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the wind speed expected at the horizon, in floating point
+* \return Predicted wind speed [m/s]
+***************************************************************************************************/
+float WindPredictor_cl::fGetForecast() const
+{
+    return fQ16ToFloat(slGetForecastQ16());
+}
@@ -0,0 +1,79 @@
+#ifndef WIND_PREDICTOR_H_
+#define WIND_PREDICTOR_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Short horizon wind speed predictor, based on exponential smoothing with a trend term (Holt's
+linear method). Every sample updates a smoothed level and a smoothed slope, and the forecast is the
+level extrapolated with the slope up to the horizon
+- NOTE2: vUpdate() must be called with a constant period, the one given in vSetup(). All the math is
+done in Q16 fixed point (see FixedPoint.h)
+- NOTE3: Higher alpha follows the wind faster but lets more noise through. Higher beta reacts faster
+to gusts but overshoots when they end. A long horizon amplifies the noise of the slope
+*/
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class WindPredictor_cl
+ * \brief Online predictor of the wind speed a given time ahead
+ **************************************************************************************************/
+class WindPredictor_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the wind predictor class
+    ***********************************************************************************************/
+    WindPredictor_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Setup the class
+    * \param[in] fAlpha: Smoothing factor of the level, in the range (0, 1]
+    * \param[in] fBeta: Smoothing factor of the slope, in the range [0, 1]
+    * \param[in] ulSamplePeriodMs: Period of the calls to vUpdate() [ms]
+    * \param[in] ulHorizonMs: Time ahead of the forecast [ms]
+    ***********************************************************************************************/
+    void vSetup(const float fAlpha, const float fBeta, const unsigned long ulSamplePeriodMs,
+                const unsigned long ulHorizonMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function changes the time ahead of the forecast
+    * \param[in] ulHorizonMs: Time ahead of the forecast [ms]. 0 returns the smoothed wind speed
+    ***********************************************************************************************/
+    void vSetHorizon(const unsigned long ulHorizonMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds a new wind speed sample
+    * \param[in] slWindSpeedQ16: Measured wind speed [m/s] (Q16)
+    ***********************************************************************************************/
+    void vUpdate(const int32_t slWindSpeedQ16);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the wind speed expected at the horizon. It is never negative
+    * \return Predicted wind speed [m/s] (Q16). 0 before the first sample
+    ***********************************************************************************************/
+    int32_t slGetForecastQ16() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the wind speed expected at the horizon, in floating point
+    * \return Predicted wind speed [m/s]
+    ***********************************************************************************************/
+    float fGetForecast() const;
+
+private:
+    /***************************************** ATTRIBUTES *****************************************/
+    int32_t       slAlphaQ16_;        /**< Smoothing factor of the level (Q16)                  */
+    int32_t       slBetaQ16_;         /**< Smoothing factor of the slope (Q16)                  */
+    unsigned long ulSamplePeriodMs_;  /**< Period of the samples [ms]                           */
+    int32_t       slHorizonStepsQ16_; /**< Horizon, in number of sample periods (Q16)           */
+    int32_t       slLevelQ16_;        /**< Smoothed wind speed [m/s] (Q16)                      */
+    int32_t       slTrendQ16_;        /**< Smoothed change of wind speed per sample [m/s] (Q16) */
+    bool          bInitialized_;      /**< The first sample has been received                   */
+};
+
+#endif /* WIND_PREDICTOR_H_ */
@@ -1,16 +1,31 @@
 /******************************************** INCLUDES ********************************************/
+/* Build options (must be defined before the includes) */
+#define PROFILING_ENABLED   0 /**< Set to 1 to measure execution times and report them on the debug Serial */
+#define ISR_MONITOR_ENABLED 0 /**< Set to 1 to measure interrupt latency and report it on the debug Serial     */
+
 /* System includes */
 #include <Adafruit_Sensor.h>
 #include <DHT.h>
 #include <DHT_U.h>
 #include <ActuadorLineal.h>
-#include <Metro.h>
 #include <CommonConstants.h>
 #include <CommonTypes.h>
 #include <CommsManager.h>
+#include <EepromJournal.h>
+#include <FixedPoint.h>
+#include <Interpolation.h>
+#include <IsrMonitor.h>
+#include <Profiler.h>
+#include <TaskScheduler.h>
+#include <Telemetry.h>
+#include <WindPredictor.h>
 
 /* Custom includes */
+#include "BreakController.h"
 #include "Constants.h"
+#include "FlightRecorder.h"
+#include "RotorRegulator.h"
+#include "TelemetryGovernor.h"
 
 
 /******************************************** GLOBALS *********************************************/
@@ -19,29 +34,71 @@ const unsigned int MAX_MSG_SIZE_UL_ = sizeof(ControlParams_st) > sizeof(AeroData
 									 sizeof(ControlParams_st) : sizeof(AeroData_st);
 unsigned char aucReadingBuf_[MAX_MSG_SIZE_UL_];
 CommsManager_cl clCommsManager_;
+AeroStatus_st   stSentStatus_        = {};    /**< Last status sent to the User Arduino                      */
+unsigned long   ulLastStatusMs_      = 0;     /**< Output of millis() when the status was last sent          */
+bool            bEnvironmentPending_ = false; /**< There is a DHT22 reading not sent yet                     */
+bool            bChunkSlot_          = false; /**< The last telemetry period was taken by a recorder chunk */
+
+/* Telemetry rate */
+TelemetryGovernor_cl clTelemetryGovernor_;           /**< Rate of the kinematic data and link budget   */
+float                fActivityPitch_         = 0.0f; /**< Blade pitch at the last activity check [%]   */
+float                fActivityRotorSpeedRPM_ = 0.0f; /**< Rotor speed at the last activity check [rpm] */
+unsigned long        ulActivityCheckMs_      = 0;    /**< Output of millis() at the last activity check */
+
+/* Task scheduling */
+TaskScheduler_cl clScheduler_; /**< Scheduler that runs all periodic tasks */
+#if PROFILING_ENABLED
+Profiler_cl      clProfiler_;  /**< Execution time profiler (used by PROFILE_SCOPE) */
+#endif
+#if ISR_MONITOR_ENABLED
+IsrMonitor_cl    clIsrMonitor_; /**< Interrupt latency monitor (used by ISR_MONITOR_XXX) */
+#endif
 
 /* Sensors variables */
 LinearServo_cl   clPitchControlServo_;  			  /**< Servo to control blade pitch angle                    */
 DHT 		     clTempHRSensor_(DHT_22_PIN, DHT22);  /**< Temperature/Humidity sensor class                     */
-Metro 		     clReadDHT22Timer_(READ_PERIOD_MS);   /**< Class to control perdic temperature/humidity readings */
-Metro 		     clSenderHC12Timer_(COMMS_PERIOD_MS); /**< Class to control periodic message sends               */
+unsigned char    ucDHT22TaskId_ = INVALID_TASK_ID_UC; /**< Task that reads the DHT22 sensor                       */
+bool             bDHT22Reading_ = false;              /**< Start signal sent, waiting to receive the reading     */
 AeroData_st      stAeroData_ = {};					  /**< Current data 										 */
 ControlParams_st stControlParams_ = {};	    	      /**< Control requests by the user 	     				 */
 
 /* Wind speed variables */
-Metro clWindSampleTimer_(WIND_SPEED_SAMPLE_INTERVAL_MS_UL); /**< Class to control perdic wind speed readings                                                            */
 float afWindSamples_[NUM_AVERAGE_WIND_SPEED_SAMPLES_UL];    /**< Buffer to store samples and compute average wind speed                                                 */
 unsigned int ulWindSamplesIdx_ = 0;						    /**< Index of the last position where data was stored                                                       */
 bool bWindBufferFull           = false; 				    /**< Variable used to check if the buffer has been filled with data, and new data overwrittes oldest values */
+WindPredictor_cl clWindPredictor_;                          /**< Wind speed expected when the pitch actuator reaches its target                                         */
+
+/* Pitch control variables */
+RotorRegulator_cl clRotorRegulator_;                                /**< Rotor speed regulator of the automatic pitch mode */
+unsigned char     ucRegulatorTaskId_          = INVALID_TASK_ID_UC; /**< Task that runs the rotor speed regulator          */
+unsigned long     ulRegulatorLastRunUs_       = 0;                  /**< Output of micros() at the last regulator step     */
+float             fAutoPitchExtensionPercent_ = 0.0f;               /**< Extension requested by the automatic pitch mode   */
+
+/* Break variables */
+BreakController_cl clBreakController_;                     /**< State machine that operates the break actuator */
+unsigned char      ucBreakTaskId_ = INVALID_TASK_ID_UC;    /**< Task that dispatches the break events          */
+FlightRecorder_cl  clFlightRecorder_;                      /**< Turbine data before and after the break events */
 
-/* Break axiliary variables */
-unsigned long ullBreakLastRequestTimeMs_    = 0; /**< Output of millis() function when the break activation was requested for the last time */
-unsigned long ullBreakLastActivationTimeMs_ = 0; /**< Output of millis() function when the break activation was requested for the last time */
-unsigned long ullBreakManeouverStartTimeMs_ = 0; /**< Start time for a retraction/extension of the break actuator */
+/* Startup variables */
+unsigned char                         ucStartupTaskId_ = INVALID_TASK_ID_UC; /**< Task that monitors the startup sequence   */
+EepromJournal_cl<ActuatorPosition_st> clPositionJournal_;                    /**< Actuators position stored in EEPROM       */
+ActuatorPosition_st                   stJournalPosition_ = {};               /**< Last position written to the journal      */
 
 /* Anemometer/tacometer auxiliary variables */
 unsigned long ullAnemometerLastTimeMs = 0;
 unsigned long ullTacometerLastTimeMs = 0;
+unsigned long ulAnemometerLastTimeUs_ = 0; /**< Output of micros() function at the last anemometer pulse */
+
+/* Emergency overspeed trip variables */
+volatile unsigned long ulOverspeedPeriodUs_   = 0; /**< Tacometer periods below this value are an overspeed (0 = trip disabled) */
+volatile uint32_t      ulTacometerLastTimeUs_ = 0; /**< Output of micros() function at the last tacometer pulse                 */
+unsigned char          ucOverspeedPulses_     = 0; /**< Consecutive tacometer periods below the threshold                       */
+
+/* Rotor speed measurement variables (written by the tacometer ISR) */
+uint32_t          aulTacometerPulsesUs_[TACOMETER_NUM_MAGNETS] = {}; /**< Output of micros() at the last pulses (ring buffer)          */
+unsigned char     ucTacometerPulseIdx_    = 0;                       /**< Oldest pulse in aulTacometerPulsesUs_                        */
+unsigned char     ucTacometerValidPulses_ = 0;                       /**< Consecutive pulses in aulTacometerPulsesUs_ (up to the size)  */
+volatile uint32_t ulRevolutionTimeUs_     = 0;                       /**< Duration of the last complete turn of the rotor (0: unknown)  */
 
 
 /****************************************** FUNCTION *******************************************//**
@@ -62,13 +119,32 @@ void setup()
 	pinMode(DISABLE_BREAK_RELAY_PIN, OUTPUT);
 	pinMode(DHT_22_PIN, INPUT);
 
-	/* Initialization of the pitch control servo */
-	clPitchControlServo_.vSetup(BLADE_RETRACTION_PIN, 
-								BLADE_EXTENSION_PIN, 
-								SERVO_HALL_PIN,
-	 						 	SERVO_LENGHT_MM, 
-								SERVO_USABLE_LENGTH_MM, 
-								SERVO_TURNS_TO_FULL_EXTENSION); 
+	/* Position of the actuators before the reset. If it is not known, they are calibrated */
+	stJournalPosition_.sServoTurns  = UNKNOWN_TURNS_UL;
+	stJournalPosition_.eBreakStatus = BREAK_INITIALIZING;
+	if (clPositionJournal_.bSetup(JOURNAL_EEPROM_ADDRESS_US, JOURNAL_NUM_SLOTS_US, stJournalPosition_))
+	{
+		Serial.print(F("Stored position: servo="));
+		Serial.print(stJournalPosition_.sServoTurns);
+		Serial.print(F(" break="));
+		Serial.println(stJournalPosition_.eBreakStatus);
+	}
+
+	/* Initialization of the pitch control servo. The calibration continues in the pitch control task */
+	if (!clPitchControlServo_.bSetup(BLADE_RETRACTION_PIN, 
+									 BLADE_EXTENSION_PIN, 
+									 SERVO_HALL_PIN,
+									 SERVO_LENGHT_MM, 
+									 SERVO_USABLE_LENGTH_MM, 
+									 SERVO_TURNS_TO_FULL_EXTENSION,
+									 stJournalPosition_.sServoTurns))
+	{
+		Serial.println(F("Pitch servo: hall sensor not attached"));
+	}
+	else if (clPitchControlServo_.bIsCalibrating())
+	{
+		Serial.println(F("Pitch servo: initial retraction..."));
+	}
 
 	/* Initialization of the DHT22 Initialization of the DHT22 sensor (temperature and humidity) */
 	clTempHRSensor_.begin();
@@ -78,21 +154,61 @@ void setup()
 	digitalWrite(DISABLE_BREAK_RELAY_PIN, HIGH);
 	digitalWrite(HC12_MODE_PIN, HIGH);
 
-	/* Make sure break actuactor is fully retracted */
-	digitalWrite(ENABLE_BREAK_RELAY_PIN, LOW);
-	delay(BREAK_FULL_RETRACTION_TIME_MS);
-	digitalWrite(ENABLE_BREAK_RELAY_PIN, HIGH);
+	/* Move the break actuator to the nominal (not braked) position. The sequence continues in the
+	break task, at the same time as the pitch servo calibration */
+	clBreakController_.vSetup(ENABLE_BREAK_RELAY_PIN, DISABLE_BREAK_RELAY_PIN, stJournalPosition_.eBreakStatus);
+	stAeroData_.stStatus.eBreakStatus   = clBreakController_.eGetStatus();
+	stAeroData_.stStatus.eStartupStatus = STARTUP_INITIALIZING;
 
-	/* Release brake to nominal (not braked) position */
-	digitalWrite(DISABLE_BREAK_RELAY_PIN, LOW);
-	delay(TIME_BREAK_ACT_OP_EXTENSION_MS);
-	digitalWrite(DISABLE_BREAK_RELAY_PIN, HIGH);
+	/* Wind speed prediction and rotor speed regulation for the automatic pitch control */
+	clWindPredictor_.vSetup(WIND_PREDICTION_ALPHA_F, WIND_PREDICTION_BETA_F, WIND_PREDICTION_PERIOD_MS_UL, WIND_PREDICTION_HORIZON_MS_UL);
+	clRotorRegulator_.vSetup(ROTOR_REGULATOR_KP_F, ROTOR_REGULATOR_KI_F);
+
+	/* Telemetry rate, within a share of the HC12 link (10 bits per byte) */
+	clTelemetryGovernor_.vSetup(TELEMETRY_TASK_PERIOD_MS_UL, TELEMETRY_ACTIVE_PERIOD_MS_UL, TELEMETRY_STEADY_PERIOD_MS_UL,
+								BAUD_RATE / 10, TELEMETRY_MAX_LOAD_PERCENT_UC);
+
+	/* Flight recorder, downloaded through the User Arduino */
+	clFlightRecorder_.vSetup(RECORDER_PERIOD_MS_UL, RECORDER_POST_RECORDS_US);
 
 	/* Anemometer setup */
 	attachInterrupt(digitalPinToInterrupt(ANEMOMETER_HALL_PIN), vReadAnemometerHallSensor, RISING);	
 
 	/* Tacometer setup */
 	attachInterrupt(digitalPinToInterrupt(TACOMETER_HALL_PIN), vReadTacometerHallSensor, RISING);
+
+#if ISR_MONITOR_ENABLED
+	/* Interrupt monitoring */
+	clIsrMonitor_.vSetSourceName(ISRSOURCE_ANEMOMETER, F("anemometer"));
+	clIsrMonitor_.vSetSourceName(ISRSOURCE_TACOMETER,  F("tacometer"));
+	clIsrMonitor_.vSetSourceName(ISRSOURCE_DHT22,      F("DHT22 irq off"));
+	clIsrMonitor_.vSetSourceName(ISRSOURCE_SERVO,      F("pitch servo"));
+	clPitchControlServo_.vAttachHallSensorIsr(vReadServoHallSensor);
+	clIsrMonitor_.vBegin();
+#endif
+
+	/* The first step of the rotor speed regulator integrates the time from here, not since the boot */
+	ulRegulatorLastRunUs_ = micros();
+
+	/* Task scheduling. Break control runs ahead of everything else. Telemetry and the DHT22 reading
+	run last */
+	ucBreakTaskId_     = clScheduler_.ucAddTask(vBreakTask,          BREAK_TASK_PERIOD_MS_UL,     BREAK_TASK_PERIOD_MS_UL,     TASK_PRIORITY_SAFETY_UC);
+	ucStartupTaskId_   = clScheduler_.ucAddTask(vStartupTask,        STARTUP_TASK_PERIOD_MS_UL,   STARTUP_TASK_PERIOD_MS_UL,   TASK_PRIORITY_BACKGROUND_UC);
+	ucRegulatorTaskId_ = clScheduler_.ucAddTask(vRegulateRotorSpeed, REGULATOR_TASK_PERIOD_MS_UL, REGULATOR_TASK_PERIOD_MS_UL, TASK_PRIORITY_CONTROL_UC);
+	clScheduler_.ucAddTask(vJournalTask,       JOURNAL_TASK_PERIOD_MS_UL,        JOURNAL_TASK_PERIOD_MS_UL,        TASK_PRIORITY_BACKGROUND_UC);
+	clScheduler_.ucAddTask(vReadDataHC12,      HC12_READ_PERIOD_MS_UL,           HC12_READ_PERIOD_MS_UL,           TASK_PRIORITY_CONTROL_UC);
+	clScheduler_.ucAddTask(vBladePitchControl, PITCH_TASK_PERIOD_MS_UL,          PITCH_TASK_PERIOD_MS_UL,          TASK_PRIORITY_CONTROL_UC);
+	clScheduler_.ucAddTask(vAverageWindSpeed,  WIND_SPEED_SAMPLE_INTERVAL_MS_UL, WIND_SPEED_SAMPLE_INTERVAL_MS_UL, TASK_PRIORITY_MEASUREMENT_UC);
+	clScheduler_.ucAddTask(vPredictWindSpeed,  WIND_PREDICTION_PERIOD_MS_UL,     WIND_PREDICTION_PERIOD_MS_UL,     TASK_PRIORITY_MEASUREMENT_UC);
+	clScheduler_.ucAddTask(vFlightRecorder,    RECORDER_PERIOD_MS_UL,            RECORDER_PERIOD_MS_UL,            TASK_PRIORITY_MEASUREMENT_UC);
+	clScheduler_.ucAddTask(vSendDataHC12,      TELEMETRY_TASK_PERIOD_MS_UL,      TELEMETRY_TASK_PERIOD_MS_UL,      TASK_PRIORITY_TELEMETRY_UC);
+	ucDHT22TaskId_     = clScheduler_.ucAddTask(vReadDHT22Sensor,    READ_PERIOD_MS,              0,                           TASK_PRIORITY_BACKGROUND_UC);
+#if PROFILING_ENABLED
+	clScheduler_.ucAddTask(vReportProfiling,   PROFILING_REPORT_PERIOD_MS_UL,    0,                                TASK_PRIORITY_BACKGROUND_UC);
+#endif
+#if ISR_MONITOR_ENABLED
+	clScheduler_.ucAddTask(vReportIsrMonitor,  ISR_MONITOR_REPORT_PERIOD_MS_UL,  0,                                TASK_PRIORITY_BACKGROUND_UC);
+#endif
 }
 
 /****************************************** FUNCTION *******************************************//**
@@ -100,40 +216,256 @@ void setup()
 ***************************************************************************************************/
 void loop() 
 {
-	/* Read incoming data from the used Arduino */
-	vReadDataHC12();
+	/* Read rotor speed */
+	vMeasureRotorSpeed();
+	vUpdateBreakConditions();
 
-	/* Read temperature and humidity */
-	vReadDHT22Sensor();
+	/* Run the tasks that are ready, most critical first */
+	PROFILE_SCOPE("loop");
+	clScheduler_.vRun();
+}
 
-	/* Read current wind speed and compute average wind speed */
-	vAverageWindSpeed();
+/****************************************** FUNCTION *******************************************//**
+* \brief Task that reports the startup progress until the break and the pitch servo are ready. Then
+* it disables itself
+***************************************************************************************************/
+void vStartupTask()
+{
+	bool bBreakReady = clBreakController_.bIsInitialized();
+	bool bServoReady = !clPitchControlServo_.bIsCalibrating();
 
-	/* Read rotor speed */
-	stAeroData_.fRotorSpeedRPM = 150; // TODO: remove dummy value
+	if (bBreakReady && bServoReady)
+	{
+		stAeroData_.stStatus.eStartupStatus = STARTUP_OPERATIONAL;
+		clScheduler_.vSetEnabled(ucStartupTaskId_, false);
+
+		/* Time since power on */
+		Serial.print(F("Operational after "));
+		Serial.print(millis());
+		Serial.println(F(" ms"));
+	}
+	else if (bBreakReady)
+	{
+		stAeroData_.stStatus.eStartupStatus = STARTUP_SERVO_PENDING;
+	}
+	else if (bServoReady)
+	{
+		stAeroData_.stStatus.eStartupStatus = STARTUP_BREAK_PENDING;
+	}
+}
 
-	/* Break control */ 
-	breakManagement(); /* Check for new necessary operations */
-	vFinishBreakManoeuver(); /* Finish active operations, if necessary */
+/****************************************** FUNCTION *******************************************//**
+* \brief Task that stores the position of the actuators in the EEPROM journal when it changes. While
+* an actuator moves its position is stored as unknown, so a reset in the middle of a movement forces
+* a calibration
+***************************************************************************************************/
+void vJournalTask()
+{
+	ActuatorPosition_st stPosition;
 
-	/* Pitch control */
-	vBladePitchControl();
+	/* Pitch servo */
+	stPosition.sServoTurns = UNKNOWN_TURNS_UL;
+	if (!clPitchControlServo_.bIsCalibrating() && clPitchControlServo_.eGetState() == SERVOSTATE_STOPPED)
+	{
+		stPosition.sServoTurns = clPitchControlServo_.ulGetCurrentTurns();
+	}
+
+	/* Break */
+	stPosition.eBreakStatus = clBreakController_.eGetStatus();
+	if (stPosition.eBreakStatus != BREAK_DISABLED && stPosition.eBreakStatus != BREAK_ENABLED)
+	{
+		stPosition.eBreakStatus = BREAK_INITIALIZING;
+	}
+
+	/* Only changes are written */
+	if (stPosition.sServoTurns  != stJournalPosition_.sServoTurns || 
+		stPosition.eBreakStatus != stJournalPosition_.eBreakStatus)
+	{
+		clPositionJournal_.vWrite(stPosition);
+		stJournalPosition_ = stPosition;
+	}
+
+	/* Write the next byte, if any */
+	clPositionJournal_.vProcess();
+}
+
+#if PROFILING_ENABLED
+/****************************************** FUNCTION *******************************************//**
+* \brief Task that writes the profiling report to the debug Serial. At 9600 bauds, it blocks for
+* ~0.5 s while the data is sent
+***************************************************************************************************/
+void vReportProfiling()
+{
+	Serial.println(F("--- Profiling [us] ---"));
+	clProfiler_.vPrintReport(Serial);
+	clScheduler_.vPrintStats(Serial);
+	Serial.print(F("break latency: last="));
+	Serial.print(clBreakController_.ulGetLastLatencyUs());
+	Serial.print(F(" max="));
+	Serial.print(clBreakController_.ulGetMaxLatencyUs());
+	Serial.print(F(" dropped="));
+	Serial.println(clBreakController_.ulGetDroppedEvents());
+
+	BreakTripStats_st stTripStats;
+	clBreakController_.vGetTripStats(stTripStats);
+	Serial.print(F("overspeed trip: n="));
+	Serial.print(stTripStats.ulTrips);
+	Serial.print(F(" false="));
+	Serial.print(stTripStats.ulFalseTrips);
+	Serial.print(F(" last="));
+	Serial.print(stTripStats.usLastLatencyUs);
+	Serial.print(F(" max="));
+	Serial.println(stTripStats.usMaxLatencyUs);
+
+	Serial.print(F("pitch servo: switches="));
+	Serial.print(clPitchControlServo_.ulGetRelaySwitches());
+	Serial.print(F(" overshoots="));
+	Serial.println(clPitchControlServo_.ulGetOvershoots());
+
+	const TaskStats_st& stRegulatorStats = clScheduler_.stGetStats(ucRegulatorTaskId_);
+	Serial.print(F("rotor regulator: rms="));
+	Serial.print(clRotorRegulator_.fGetRmsErrorRPM());
+	Serial.print(F(" saturated="));
+	Serial.print(clRotorRegulator_.ulGetSaturatedSteps());
+	Serial.print(F(" jitter="));
+	Serial.print(stRegulatorStats.ulLastJitterUs);
+	Serial.print(F("/"));
+	Serial.println(stRegulatorStats.ulMaxJitterUs);
+	clRotorRegulator_.vResetStats();
+
+	Serial.print(F("telemetry: period="));
+	Serial.print(clTelemetryGovernor_.ulGetPeriodMs());
+	Serial.print(F(" ms load="));
+	Serial.print(clTelemetryGovernor_.ucGetLoadPercent());
+	Serial.print(F("% deferred="));
+	Serial.println(clTelemetryGovernor_.ulGetDeferred());
+}
+#endif
 
-	/* Send current turbine data to the user Arduino */
-	vSendDataHC12();
+#if ISR_MONITOR_ENABLED
+/****************************************** FUNCTION *******************************************//**
+* \brief Task that writes the interrupt monitor report to the debug Serial
+***************************************************************************************************/
+void vReportIsrMonitor()
+{
+	Serial.println(F("--- Interrupts [us] ---"));
+	clIsrMonitor_.vPrintReport(Serial);
+	Serial.print(F("servo hall: rej="));
+	Serial.println(clPitchControlServo_.ulGetRejectedPulses());
 }
+#endif
 
 
 /****************************************** FUNCTION *******************************************//**
-* \brief Method that sends data from the Windturbine to the user arduino
+* \brief Method that sends data from the Windturbine to the user arduino (see Telemetry.h). Each
+* pass starts with one slow message, if there is one: the status when it changes (or when it has to
+* be refreshed) or else a new DHT22 reading. The kinematic data are sent at the rate set by the
+* governor for the activity of the turbine (see TelemetryGovernor.h). During a flight recorder
+* download, a chunk takes the place of every other kinematic frame, if it fits in the free space of
+* the transmission buffer. Everything but the status waits for the link budget, and the task never
+* waits for the port
 ***************************************************************************************************/
 void vSendDataHC12() 
 {
-	/* Check if it is time to send new data */
-	if (clSenderHC12Timer_.check()) 
+	PROFILE_SCOPE("HC12 send");
+	unsigned long ulNowMs = millis();
+	clTelemetryGovernor_.vSetActivity(eGetTelemetryActivity(ulNowMs));
+
+	/* Bytes of each message (header and checksum included) */
+	const unsigned int ulOverheadBytes    = sizeof(MsgHeader_st) + NUM_CHECKSUM_BYTES_UC;
+	const unsigned int ulStatusBytes      = sizeof(AeroStatus_st) + ulOverheadBytes;
+	const unsigned int ulEnvironmentBytes = sizeof(EnvironmentData_st) + ulOverheadBytes;
+	const unsigned int ulKinematicsBytes  = sizeof(KinematicData_st) + ulOverheadBytes;
+	const unsigned int ulChunkBytes       = sizeof(RecorderChunk_st) + ulOverheadBytes;
+
+	/* Slow messages */
+	if (memcmp(&stAeroData_.stStatus, &stSentStatus_, sizeof(stSentStatus_)) != 0 ||
+		ulNowMs - ulLastStatusMs_ >= STATUS_REFRESH_PERIOD_MS_UL)
+	{
+		stSentStatus_   = stAeroData_.stStatus;
+		ulLastStatusMs_ = ulNowMs;
+		clCommsManager_.vSendMessage(stSentStatus_, MESSAGEID_STATUS, Serial1);
+		clTelemetryGovernor_.vConsume(ulStatusBytes, ulNowMs);
+	}
+	else if (bEnvironmentPending_ && clTelemetryGovernor_.bReserve(ulEnvironmentBytes, ulNowMs))
+	{
+		EnvironmentData_st stEnvironment;
+		vGetEnvironmentData(stAeroData_, stEnvironment);
+		clCommsManager_.vSendMessage(stEnvironment, MESSAGEID_ENVIRONMENT, Serial1);
+		bEnvironmentPending_ = false;
+	}
+
+	/* Fast messages */
+	if (!clTelemetryGovernor_.bIsFrameDue(ulNowMs))
+	{
+		return;
+	}
+
+	/* Flight recorder chunk requested by the User Arduino. The kinematic frame is still due, and it
+	is sent in the next pass */
+	RecorderChunk_st stChunk;
+	if (!bChunkSlot_ && clFlightRecorder_.bIsChunkPending() &&
+		Serial1.availableForWrite() >= static_cast<int>(ulChunkBytes) &&
+		clTelemetryGovernor_.bReserve(ulChunkBytes, ulNowMs) && clFlightRecorder_.bGetPendingChunk(stChunk))
+	{
+		clCommsManager_.vSendMessage(stChunk, MESSAGEID_RECORDERCHUNK, Serial1);
+		bChunkSlot_ = true;
+		return;
+	}
+
+	if (clTelemetryGovernor_.bReserve(ulKinematicsBytes, ulNowMs))
+	{
+		KinematicData_st stKinematics;
+		vGetKinematicData(stAeroData_, stKinematics);
+		clCommsManager_.vSendMessage(stKinematics, MESSAGEID_KINEMATICS, Serial1);
+		clTelemetryGovernor_.vFrameSent(ulNowMs);
+		bChunkSlot_ = false;
+	}
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Method that classifies the activity of the turbine, that sets the rate of the telemetry.
+* Break manoeuvres and pitch motion are urgent, gusts and fast rotor speed changes are active
+* \param[in] ulNowMs: Current time [ms]
+* \return Activity level
+***************************************************************************************************/
+TelemetryActivity_e eGetTelemetryActivity(const unsigned long ulNowMs)
+{
+	/* Rates of change since the last check */
+	float fDeltaS    = (ulNowMs - ulActivityCheckMs_) * MILLIS_TO_SECONDS_F;
+	float fPitchRate = 0.0f;
+	float fRotorRate = 0.0f;
+	if (fDeltaS > 0.0f)
+	{
+		fPitchRate = fabs(stAeroData_.fBladePitchPercentage - fActivityPitch_) / fDeltaS;
+		fRotorRate = fabs(stAeroData_.fRotorSpeedRPM - fActivityRotorSpeedRPM_) / fDeltaS;
+	}
+	fActivityPitch_         = stAeroData_.fBladePitchPercentage;
+	fActivityRotorSpeedRPM_ = stAeroData_.fRotorSpeedRPM;
+	ulActivityCheckMs_      = ulNowMs;
+
+	BreakStatus_e eBreakStatus = stAeroData_.stStatus.eBreakStatus;
+	if ((eBreakStatus != BREAK_DISABLED && eBreakStatus != BREAK_ENABLED) || fPitchRate > TELEMETRY_PITCH_RATE_PCT_S_F)
+	{
+		return TELEMETRYACTIVITY_URGENT;
+	}
+	if (fabs(stAeroData_.fWindSpeed - stAeroData_.fAverageWindSpeed) > TELEMETRY_GUST_MPS_F ||
+		fRotorRate > TELEMETRY_ROTOR_RATE_RPM_S_F)
 	{
-		clCommsManager_.vSendMessage(stAeroData_, MESSAGEID_AERODATA, Serial1);
+		return TELEMETRYACTIVITY_ACTIVE;
 	}
+
+	return TELEMETRYACTIVITY_STEADY;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Task that samples the turbine data into the flight recorder. The chunks requested by the
+* User Arduino are sent by the telemetry task
+***************************************************************************************************/
+void vFlightRecorder()
+{
+	PROFILE_SCOPE("recorder");
+	clFlightRecorder_.vSample(stAeroData_, stControlParams_);
 }
 
 /****************************************** FUNCTION *******************************************//**
@@ -141,6 +473,8 @@ void vSendDataHC12()
 ***************************************************************************************************/
 void vReadDataHC12() 
 {
+	PROFILE_SCOPE("HC12 read");
+
 	/* Create a variable for the message length and other one for the message ID */
 	unsigned int ulMsgLength = 0;
 	MessageID_e eMsgID = MESSAGEID_COUNT;
@@ -152,145 +486,176 @@ void vReadDataHC12()
 		if (eMsgID == MESSAGEID_CONTROLPARAMS)
 		{
 			memcpy(&stControlParams_, aucReadingBuf_, sizeof(stControlParams_));
+			vUpdateOverspeedThreshold();
+		}
+		else if (eMsgID == MESSAGEID_RECORDERREQUEST)
+		{
+			RecorderRequest_st stRequest;
+			memcpy(&stRequest, aucReadingBuf_, sizeof(stRequest));
+			clFlightRecorder_.vRequestChunk(stRequest.usChunk);
 		}
 	}
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief Method that reads temperature and humidity from DHT22 sensor
+* \brief Method that converts the maximum rotor speed into the tacometer period used by the emergency
+* overspeed trip, so the ISR doesn't need to divide
 ***************************************************************************************************/
-void vReadDHT22Sensor() {
-
-	/* Read temperature and humidity */
-	if (clReadDHT22Timer_.check()) 
+void vUpdateOverspeedThreshold()
+{
+	unsigned long ulPeriodUs = 0; /* Trip disabled */
+	if (stControlParams_.fMaxRotorSpeedRPM > 0.0f)
 	{
-		stAeroData_.fTempCelsius = clTempHRSensor_.readTemperature();
-		stAeroData_.fRelHumidity = clTempHRSensor_.readHumidity();
+		ulPeriodUs = static_cast<unsigned long>(MINUTES_TO_MICROS_F / 
+			(stControlParams_.fMaxRotorSpeedRPM * TACOMETER_NUM_MAGNETS));
 	}
+
+	/* 32 bits variable shared with the ISR */
+	noInterrupts();
+	ulOverspeedPeriodUs_ = ulPeriodUs;
+	interrupts();
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief Method that computes average wind speed
+* \brief Method that computes the rotor speed from the duration of the last turn measured by the
+* tacometer ISR. Between pulses, the turn can't be shorter than TACOMETER_NUM_MAGNETS times the time
+* since the last pulse, so a slowing rotor is seen before its next pulse
 ***************************************************************************************************/
-void vAverageWindSpeed() 
+void vMeasureRotorSpeed()
 {
-	/* Check if it is time to take a new sample for the wind speed moving average */
-	if (clWindSampleTimer_.check()) 
+	/* 32 bits variables shared with the ISR */
+	noInterrupts();
+	uint32_t ulRevolutionTimeUs = ulRevolutionTimeUs_;
+	uint32_t ulLastPulseUs      = ulTacometerLastTimeUs_;
+	interrupts();
+
+	/* Stopped rotor, or not a whole turn since it started */
+	uint32_t ulSinceLastPulseUs = static_cast<uint32_t>(micros()) - ulLastPulseUs;
+	if (ulRevolutionTimeUs == 0 || ulSinceLastPulseUs > ROTOR_STOPPED_TIMEOUT_US_UL)
 	{
-		/* Store current wind speed */
-		afWindSamples_[ulWindSamplesIdx_] = stAeroData_.fWindSpeed;
+		stAeroData_.fRotorSpeedRPM = 0.0f;
+		return;
+	}
 
-		/* Increment index for the next data save */
-		ulWindSamplesIdx_++;
-		if (ulWindSamplesIdx_ > NUM_AVERAGE_WIND_SPEED_SAMPLES_UL)
-		{
-			bWindBufferFull = true;
-			ulWindSamplesIdx_ = 0;
-		}
-	
-		/* Compute average */
-		unsigned int ulNumSamples = bWindBufferFull ? 
-				NUM_AVERAGE_WIND_SPEED_SAMPLES_UL : ulWindSamplesIdx_;
-		stAeroData_.fAverageWindSpeed = 0.0;
-		for (int ulIdx = 0; ulIdx < ulNumSamples; ulIdx++) {
-			stAeroData_.fAverageWindSpeed += afWindSamples_[ulIdx];
-		}
-		stAeroData_.fAverageWindSpeed /= ulNumSamples;	
+	if (ulSinceLastPulseUs * TACOMETER_NUM_MAGNETS > ulRevolutionTimeUs)
+	{
+		ulRevolutionTimeUs = ulSinceLastPulseUs * TACOMETER_NUM_MAGNETS;
 	}
+	stAeroData_.fRotorSpeedRPM = MINUTES_TO_MICROS_F / static_cast<float>(ulRevolutionTimeUs);
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief This method manages the activation of the break system
+* \brief Method that reads temperature and humidity from DHT22 sensor. The reading is split in two
+* runs of the task, so the 20 ms start signal does not block the other tasks: the first run sends the
+* start signal and the second one, DHT22_START_SIGNAL_MS_UL later, receives the data (~5 ms)
 ***************************************************************************************************/
-void breakManagement() {
+void vReadDHT22Sensor() {
 
-	/* Check if it is necessary to break */
-	if (stAeroData_.fAverageWindSpeed > stControlParams_.fMaxWindSpeed || /* Average wind speed over threshold */
-		stAeroData_.fRotorSpeedRPM > stControlParams_.fMaxRotorSpeedRPM    || /* Rotor speed over threshold */
-		stControlParams_.eManualBreak == MANUALBREAK_ON) /* Rotor break manually requested */
-	{ 
-		/* Break */
-		vBreak(); 
+	PROFILE_SCOPE("DHT22");
+
+	/* Send the start signal, and come back when it is over */
+	if (!bDHT22Reading_)
+	{
+		clTempHRSensor_.startRead();
+		bDHT22Reading_ = true;
+		clScheduler_.vSetPeriod(ucDHT22TaskId_, DHT22_START_SIGNAL_MS_UL);
+		return;
 	}
-	/* If none of the conditions to activate the break is currently satisfied, release break */
-	else 
+
+	/* Receive the data (interrupts disabled) and wait for the next reading */
 	{
-		vReleaseBreak();
+		ISR_MONITOR_SECTION(ISRSOURCE_DHT22);
+		clTempHRSensor_.finishRead();
 	}
+	bDHT22Reading_ = false;
+	clScheduler_.vSetPeriod(ucDHT22TaskId_, READ_PERIOD_MS);
+
+	/* Read temperature and humidity (values of the last reading) */
+	stAeroData_.fTempCelsius = clTempHRSensor_.readTemperature();
+	stAeroData_.fRelHumidity = clTempHRSensor_.readHumidity();
+	bEnvironmentPending_     = true;
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief This method activates the break system
+* \brief Method that computes average wind speed
 ***************************************************************************************************/
-void vBreak()
+void vAverageWindSpeed() 
 {
-	/* Save time of the activation request */
-	ullBreakLastRequestTimeMs_ = millis();
+	/* Store current wind speed */
+	afWindSamples_[ulWindSamplesIdx_] = stAeroData_.fWindSpeed;
 
-	// Antes de empezar un nuveo frenado, tenemos que esperar a que se termine de retraer 
-	// completamente el actuador para evitar acumular retraccion
-	/* Before to start a break operation, check if the required conditions are met */
-	if (stAeroData_.stStatus.eBreakStatus == BREAK_DISABLED  && /* Break only if the break is disabled */
-		stAeroData_.stStatus.eBreakStatus != BREAK_RELEASING && /* Do not interrupt when actuator is moving */
-		stAeroData_.stStatus.eBreakStatus != BREAK_BREAKING )   /* If system es already breaking, there is no need to do it again */
+	/* Increment index for the next data save */
+	ulWindSamplesIdx_++;
+	if (ulWindSamplesIdx_ >= NUM_AVERAGE_WIND_SPEED_SAMPLES_UL)
 	{
-		/* Active break */
-		digitalWrite(ENABLE_BREAK_RELAY_PIN, LOW);
+		bWindBufferFull = true;
+		ulWindSamplesIdx_ = 0;
+	}
 
-		/* Store time of the maneouver start */
-		ullBreakManeouverStartTimeMs_ = millis();
+	/* Compute average */
+	unsigned int ulNumSamples = bWindBufferFull ? 
+			NUM_AVERAGE_WIND_SPEED_SAMPLES_UL : ulWindSamplesIdx_;
+	stAeroData_.fAverageWindSpeed = 0.0;
+	for (unsigned int ulIdx = 0; ulIdx < ulNumSamples; ulIdx++) {
+		stAeroData_.fAverageWindSpeed += afWindSamples_[ulIdx];
+	}
+	stAeroData_.fAverageWindSpeed /= ulNumSamples;	
+}
 
-		/* Update the status variable */
-		stAeroData_.stStatus.eBreakStatus = BREAK_BREAKING;
-	}	
+/****************************************** FUNCTION *******************************************//**
+* \brief Task that feeds the wind speed predictor with the current wind speed
+***************************************************************************************************/
+void vPredictWindSpeed()
+{
+	clWindPredictor_.vUpdate(slFloatToQ16(stAeroData_.fWindSpeed));
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief This method releases the break system
+* \brief Task that manages the break system. It runs periodically (manoeuvre timing) and when it is
+* triggered by a change of the break conditions
 ***************************************************************************************************/
-void vReleaseBreak() 
+void vBreakTask()
 {
-	/* The break is released only if the break is fully enabled (not moving) and it has been breaked
-	for a minimum time interval */
-	if (stAeroData_.stStatus.eBreakStatus == BREAK_ENABLED && /* Break can only be released if the system is breaked */
-		millis()-ullBreakLastRequestTimeMs_ > BREAK_MIN_ENABLED_TIME_MS ) /* Release only if passed some time from las activation request */
+	PROFILE_SCOPE("break");
+	BreakStatus_e ePreviousStatus = stAeroData_.stStatus.eBreakStatus;
+	clBreakController_.vDispatch();
+	stAeroData_.stStatus.eBreakStatus = clBreakController_.eGetStatus();
+
+	/* Break event (the break starts acting on a released rotor). The flight recorder keeps what led
+	up to it */
+	if ((ePreviousStatus == BREAK_DISABLED || ePreviousStatus == BREAK_RELEASING) &&
+		(stAeroData_.stStatus.eBreakStatus == BREAK_BREAKING || stAeroData_.stStatus.eBreakStatus == BREAK_ENABLED))
 	{
-		/* Release break */
-		digitalWrite(DISABLE_BREAK_RELAY_PIN, LOW);
-
-		/* Store time of the maneouver start */
-		ullBreakManeouverStartTimeMs_ = millis();
-
-		/* Update the status variable */
-		stAeroData_.stStatus.eBreakStatus = BREAK_RELEASING;
+		clFlightRecorder_.vTrigger(millis());
 	}
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief This method checks if the break actuator maneouver must be ended
+* \brief This method reports the break conditions to the break controller. It is the only place where
+* they are evaluated, on every pass of loop(), so a new rotor speed, average wind speed or control
+* parameters message is seen at once. The controller queues an event only when a condition becomes
+* active, and the break task is triggered only when one changes
 ***************************************************************************************************/
-void vFinishBreakManoeuver() 
+void vUpdateBreakConditions()
 {
-	/* Check if it is time to stop the actuator and finish break manoeuver */
-	if (stAeroData_.stStatus.eBreakStatus == BREAK_BREAKING &&
-		millis() - ullBreakManeouverStartTimeMs_ > TIME_BREAK_ACT_OP_EXTENSION_MS) 
-	{
-		/* Deactivate relay of the actuator */
-		digitalWrite(ENABLE_BREAK_RELAY_PIN, HIGH); 
+	bool bChanged = false;
 
-		/* Break is enabled */
-		stAeroData_.stStatus.eBreakStatus = BREAK_ENABLED;
-	}
-	
-	/* Check if it is time to stop the actuator and finish release manoeuver */
-	if (stAeroData_.stStatus.eBreakStatus == BREAK_RELEASING && 
-		millis() - ullBreakManeouverStartTimeMs_ > BREAK_RETRACTION_TIME_MS) 
-	{
-		/* Deactivate relay of the actuator */
-		digitalWrite(DISABLE_BREAK_RELAY_PIN, HIGH);
+	/* Rotor speed over threshold */
+	bChanged |= clBreakController_.bSetCondition(BREAKEVENT_OVERSPEED,
+		stAeroData_.fRotorSpeedRPM > stControlParams_.fMaxRotorSpeedRPM);
 
-		/* Break is disabled */
-		stAeroData_.stStatus.eBreakStatus = BREAK_DISABLED;
+	/* Average wind speed over threshold */
+	bChanged |= clBreakController_.bSetCondition(BREAKEVENT_OVERWIND,
+		stAeroData_.fAverageWindSpeed > stControlParams_.fMaxWindSpeed);
+
+	/* Rotor break manually requested */
+	bChanged |= clBreakController_.bSetCondition(BREAKEVENT_MANUAL,
+		stControlParams_.eManualBreak == MANUALBREAK_ON);
+
+	/* Do not wait for the next break task period */
+	if (bChanged)
+	{
+		clScheduler_.vTrigger(ucBreakTaskId_);
 	}
 }
 
@@ -299,6 +664,8 @@ void vFinishBreakManoeuver()
 ***************************************************************************************************/
 void vBladePitchControl() 
 {
+	PROFILE_SCOPE("pitch");
+
 	/* If the system is breaked or breaking, use pitch angle to help breaking */
 	if (stAeroData_.stStatus.eBreakStatus == BREAK_ENABLED ||
 		stAeroData_.stStatus.eBreakStatus == BREAK_BREAKING)
@@ -319,34 +686,8 @@ void vBladePitchControl()
 		/* Automatic pitch control */
 		else if(stControlParams_.ePitchMode == PITCHMODE_AUTO) 
 		{ 
-			/* Compute the angle of the aerodynaimc velocity wrt rotor disc */
-			float fAlphaWind = 0.0;
-			
-			/* If there is no wind, rpm should be 0, so there would be an indetermination */
-			if (stAeroData_.fWindSpeed < 1)
-			{ 
-				fAlphaWind = PI / 2;
-			}
-			/* Compute angle os aerodinamic speed for a section at 0.3 adimensional distance 
-			(aprox 33 cm) from the root. */
-			else
-			{
-				/* Wind angle (composed from incident wind and blade rotation) relativo to the
-				plane of blade rotation */
-				fAlphaWind = atan2(stAeroData_.fWindSpeed,
-								   stAeroData_.fRotorSpeedRPM * RPM_TO_RADSEC_F * 0.33 );
-			} 
-				
-			/* The angle we have to rotate the blade is the angle of the wind less the torsion angle
-			and less the angle to operate at maximum aerodynamic efficiency */
-			float fBetaAngle = fAlphaWind - 22 * PI / 180; /* Torsion angle at section 0.3 is 12.75 deg. Angle of max efficiency is 9.25 deg. Total is 22 */
-			float fActuatorExtensionPercent = 
-				tInterp1D<float, PITCH_ANGLE_CALIBRATION_POINTS_UC>(PITCH_CONTROL_BETA_ANGLE_F, 
-																	PITCH_CONTROL_EXTENSION_F, 
-																	fBetaAngle);
-			
-			/* Command actuator extension */
-			clPitchControlServo_.vSetExtensionPercentage(fActuatorExtensionPercent);
+			/* Extension computed by the rotor speed regulator task */
+			clPitchControlServo_.vSetExtensionPercentage(fAutoPitchExtensionPercent_);
 
 			/* Get the current percentage */
 			stAeroData_.fBladePitchPercentage = clPitchControlServo_.fGetExtensionPercentage();
@@ -357,11 +698,145 @@ void vBladePitchControl()
 	clPitchControlServo_.vOperate();
 }
 
+/****************************************** FUNCTION *******************************************//**
+* \brief Task that computes the actuator extension for the automatic pitch control, at a fixed rate:
+* the extension for the predicted wind (feed-forward), corrected by the rotor speed regulator
+***************************************************************************************************/
+void vRegulateRotorSpeed()
+{
+	PROFILE_SCOPE("regulator");
+
+	/* The regulator integrates with the actual time between steps */
+	unsigned long ulNowUs = micros();
+	float fDeltaS = (ulNowUs - ulRegulatorLastRunUs_) * MICROS_TO_SECONDS_F;
+	ulRegulatorLastRunUs_ = ulNowUs;
+
+	/* Only in automatic mode, with the break released */
+	if (stControlParams_.ePitchMode != PITCHMODE_AUTO ||
+		stAeroData_.stStatus.eBreakStatus == BREAK_ENABLED ||
+		stAeroData_.stStatus.eBreakStatus == BREAK_BREAKING)
+	{
+		clRotorRegulator_.vReset();
+		return;
+	}
+
+	/* The actuator takes seconds to move, so the extension is computed for the wind expected when it
+	gets there */
+	AeroData_st stPitchInput = stAeroData_;
+	stPitchInput.fWindSpeed = clWindPredictor_.fGetForecast();
+
+	/* Compute the actuator extension for the wind and rotor speed. The float path is the default. The
+	Q16 path exists because the AVR emulates the float operations in software, so it is expected to be
+	cheaper on the target, but that has not been measured yet: the host bench (PitchBench) only checks
+	its accuracy, and on the host the float path is faster. Compare the "regulator" entry of the
+	profiler (PROFILING_ENABLED) with each method on the target before changing PITCH_CONTROL_METHOD_E */
+	float fActuatorExtensionPercent = 0.0f;
+	switch (PITCH_CONTROL_METHOD_E)
+	{
+	case PITCHCONTROL_BETA_FLOAT:
+		fActuatorExtensionPercent = fComputeAutoPitchExtension(stPitchInput);
+		break;
+
+	case PITCHCONTROL_BETA_Q16:
+		fActuatorExtensionPercent = fComputeAutoPitchExtensionQ16(stPitchInput);
+		break;
+
+	case PITCHCONTROL_SCHEDULE_2D:
+		fActuatorExtensionPercent = tInterp2D(PITCH_SCHEDULE_WIND_SPEED_F, 
+											  PITCH_SCHEDULE_ROTOR_RPM_F, 
+											  PITCH_SCHEDULE_EXTENSION_F, 
+											  stPitchInput.fWindSpeed, 
+											  stPitchInput.fRotorSpeedRPM);
+		break;
+
+	default:
+		break;
+	}
+
+	/* Regulate the rotor speed below the break limit (not possible until the limit is received) */
+	fAutoPitchExtensionPercent_ = fActuatorExtensionPercent;
+	if (stControlParams_.fMaxRotorSpeedRPM > 0.0f)
+	{
+		float fSetpointRPM = stControlParams_.fMaxRotorSpeedRPM * ROTOR_SPEED_SETPOINT_RATIO_F;
+		fAutoPitchExtensionPercent_ = clRotorRegulator_.fUpdate(fSetpointRPM,
+																stAeroData_.fRotorSpeedRPM,
+																fActuatorExtensionPercent,
+																fDeltaS);
+	}
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This method computes the actuator extension for the automatic pitch control (floating point)
+* \param[in] stAeroData: Wind and rotor speed used for the computation
+* \return Requested actuator extension percentage
+***************************************************************************************************/
+float fComputeAutoPitchExtension(const AeroData_st& stAeroData)
+{
+	/* Compute the angle of the aerodynaimc velocity wrt rotor disc */
+	float fAlphaWind = 0.0;
+	
+	/* If there is no wind, rpm should be 0, so there would be an indetermination */
+	if (stAeroData.fWindSpeed < PITCH_CONTROL_MIN_WIND_SPEED_F)
+	{ 
+		fAlphaWind = PI / 2;
+	}
+	/* Compute angle os aerodinamic speed for a section at 0.3 adimensional distance 
+	(aprox 33 cm) from the root. */
+	else
+	{
+		/* Wind angle (composed from incident wind and blade rotation) relativo to the
+		plane of blade rotation */
+		fAlphaWind = atan2(stAeroData.fWindSpeed,
+						   stAeroData.fRotorSpeedRPM * RPM_TO_RADSEC_F * PITCH_CONTROL_SECTION_RADIUS_M_F);
+	} 
+		
+	/* The angle we have to rotate the blade is the angle of the wind less the torsion angle
+	and less the angle to operate at maximum aerodynamic efficiency */
+	float fBetaAngle = fAlphaWind - PITCH_CONTROL_SECTION_ANGLE_RAD_F;
+	return tInterp1D(PITCH_CONTROL_BETA_ANGLE_F, PITCH_CONTROL_EXTENSION_F, fBetaAngle);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This method computes the actuator extension for the automatic pitch control (Q16 fixed 
+* point). Same computation as fComputeAutoPitchExtension()
+* \param[in] stAeroData: Wind and rotor speed used for the computation
+* \return Requested actuator extension percentage
+***************************************************************************************************/
+float fComputeAutoPitchExtensionQ16(const AeroData_st& stAeroData)
+{
+	/* Constants of the computation (folded by the compiler) */
+	const int32_t slMinWindSpeedQ16    = slFloatToQ16(PITCH_CONTROL_MIN_WIND_SPEED_F);
+	const int32_t slRPMToSectionSpeed  = slFloatToQ16(RPM_TO_RADSEC_F * PITCH_CONTROL_SECTION_RADIUS_M_F);
+	const int32_t slSectionAngleQ16    = slFloatToQ16(PITCH_CONTROL_SECTION_ANGLE_RAD_F);
+
+	/* Convert the turbine data */
+	AeroDataQ16_st stAeroDataQ16 = {};
+	vAeroDataToQ16(stAeroData, stAeroDataQ16);
+
+	/* Compute the angle of the aerodynamic velocity wrt rotor disc */
+	int32_t slAlphaWind = Q16_HALF_PI_SL;
+	if (stAeroDataQ16.slWindSpeed >= slMinWindSpeedQ16)
+	{
+		slAlphaWind = slAtan2Q16(stAeroDataQ16.slWindSpeed,
+								 slMulQ16(stAeroDataQ16.slRotorSpeedRPM, slRPMToSectionSpeed));
+	}
+
+	/* Get the extension for the blade angle */
+	int32_t slExtensionQ16 = slInterp1DQ16(PITCH_CONTROL_BETA_ANGLE_Q16, 
+										   PITCH_CONTROL_EXTENSION_Q16, 
+										   PITCH_ANGLE_CALIBRATION_POINTS_UC, 
+										   slAlphaWind - slSectionAngleQ16);
+	return fQ16ToFloat(slExtensionQ16);
+}
+
 /****************************************** FUNCTION *******************************************//**
 * \brief Interrupt function to read anemomenter hall sensor
 ***************************************************************************************************/
 void vReadAnemometerHallSensor() 
 {
+	ISR_MONITOR_SCOPE(ISRSOURCE_ANEMOMETER);
+	unsigned long ulNowUs = micros();
+
 	/* This if avoids reading several times the same magnet pass */ 
 	if (millis() - ullAnemometerLastTimeMs > HALL_MIN_DELAY_MS_ULL) 
 	{
@@ -372,6 +847,11 @@ void vReadAnemometerHallSensor()
 
 		/* Update time of last reading */
 		ullAnemometerLastTimeMs = millis();
+		ulAnemometerLastTimeUs_ = ulNowUs;
+	}
+	else
+	{
+		ISR_MONITOR_REJECT(ISRSOURCE_ANEMOMETER, ulNowUs - ulAnemometerLastTimeUs_);
 	}
 }
 
@@ -380,48 +860,70 @@ void vReadAnemometerHallSensor()
 ***************************************************************************************************/
 void vReadTacometerHallSensor() 
 {
+	ISR_MONITOR_SCOPE(ISRSOURCE_TACOMETER);
+	unsigned long ulNowUs = micros();
+
 	/* This if avoids reading several times the same magnet pass */ 
 	if (millis() - ullTacometerLastTimeMs > HALL_MIN_DELAY_MS_ULL) 
 	{
-		/* Get the angular speed of the tacometer */
-		float fRotorAngularSpeed = 2 * PI / ANEMOMETER_NUM_MAGNETS / 
-								   (millis() - ullTacometerLastTimeMs) / MILLIS_TO_SECONDS_F;
+		/* Emergency overspeed trip. The break relay is energised here, without waiting for the break
+		task. Several consecutive short periods are required to filter out noise */
+		if (ulNowUs - ulTacometerLastTimeUs_ < ulOverspeedPeriodUs_)
+		{
+			if (ucOverspeedPulses_ < OVERSPEED_TRIP_PULSES_UC)
+			{
+				ucOverspeedPulses_++;
+			}
+			if (ucOverspeedPulses_ >= OVERSPEED_TRIP_PULSES_UC)
+			{
+				clBreakController_.vTripFromIsr(ulNowUs);
+			}
+		}
+		else
+		{
+			ucOverspeedPulses_ = 0;
+		}
+
+		/* Rotor speed measurement. The period of a whole turn does not depend on the spacing of the
+		magnets. A pulse after a stop starts the measurement again */
+		if (ulNowUs - ulTacometerLastTimeUs_ > ROTOR_STOPPED_TIMEOUT_US_UL)
+		{
+			ucTacometerValidPulses_ = 0;
+			ulRevolutionTimeUs_     = 0;
+		}
+		if (ucTacometerValidPulses_ >= TACOMETER_NUM_MAGNETS)
+		{
+			ulRevolutionTimeUs_ = ulNowUs - aulTacometerPulsesUs_[ucTacometerPulseIdx_];
+		}
+		else
+		{
+			ucTacometerValidPulses_++;
+		}
+		aulTacometerPulsesUs_[ucTacometerPulseIdx_] = ulNowUs;
+		ucTacometerPulseIdx_ = (ucTacometerPulseIdx_ + 1) % TACOMETER_NUM_MAGNETS;
+		ulTacometerLastTimeUs_ = ulNowUs;
 
 		/* Update time of last reading */
 		ullTacometerLastTimeMs = millis();
 	}
+	else
+	{
+		ISR_MONITOR_REJECT(ISRSOURCE_TACOMETER, ulNowUs - ulTacometerLastTimeUs_);
+	}
 }
 
+#if ISR_MONITOR_ENABLED
 /****************************************** FUNCTION *******************************************//**
-* \brief 1D linear interpolation/extrapolation
-* \tparam Type_t: Type for the data to interpolate
-* \tparam ulDataLength: Length of array of data to interpolate
-* \param[in] atX: X coordinates of the interpolation function y=f(x)
-* \param[in] atY: Value of the interpolation function in the atX points
-* \param[in] tQueryX: Query point where the function wants to be known
-* \return Value of the function at the query point
-* \warning Values in atX must be sorted from lower to higher and values cannot repeat
+* \brief Interrupt function of the pitch servo hall sensor, measured by the interrupt monitor. It
+* replaces the one attached by the servo, and forwards the pulse to it
 ***************************************************************************************************/
-template<typename Type_t, unsigned int ulDataLength>
-Type_t tInterp1D(const Type_t atX[ulDataLength], const Type_t atY[ulDataLength], const Type_t tQueryX)
+void vReadServoHallSensor()
 {
-	/* Find the index of the data that is right before the query point */
-	char scPrevIndex = 0;
-	for(scPrevIndex = 0; scPrevIndex < ulDataLength; scPrevIndex++)
+	ISR_MONITOR_SCOPE(ISRSOURCE_SERVO);
+	unsigned long ulIntervalUs = 0;
+	if (!clPitchControlServo_.bReadHallSensor(ulIntervalUs))
 	{
-		if(tQueryX <= atX[scPrevIndex])
-		{
-			scPrevIndex = scPrevIndex - 1;
-			break;
-		}
+		ISR_MONITOR_REJECT(ISRSOURCE_SERVO, ulIntervalUs);
 	}
-
-	/* The index can not be lower than 0 and greater than (ulDataLength-2) */
-	scPrevIndex = min(max(0, scPrevIndex), ulDataLength-2);
-
-	/* Perform linear interpolation using the previous and next point */
-	Type_t tSlope = (atY[scPrevIndex+1] - atY[scPrevIndex]) / ((atX[scPrevIndex+1] - atX[scPrevIndex]));
-	Type_t tResult = atY[scPrevIndex] + tSlope * (tQueryX - atX[scPrevIndex]);
-
-	return tResult;
 }
+#endif
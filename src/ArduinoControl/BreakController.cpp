@@ -0,0 +1,413 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+
+/* Custom includes */
+#include "BreakController.h"
+#include "Constants.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+/* Priority of each event in the queue, indexed by BreakEvent_e. Break requests go first */
+static const unsigned char BREAK_EVENT_PRIORITIES_UC[BREAKEVENT_COUNT] =
+{
+    0, /* BREAKEVENT_OVERSPEED     */
+    0, /* BREAKEVENT_OVERWIND      */
+    0, /* BREAKEVENT_MANUAL         */
+    0, /* BREAKEVENT_OVERSPEED_TRIP */
+    1, /* BREAKEVENT_TIMER_EXPIRED  */
+    2, /* BREAKEVENT_RELEASE        */
+};
+
+/* Transition table of the break state machine */
+const BreakTransition_st BreakController_cl::astTransitions_[] =
+{
+    /* State             Event                      Guard                             Action                                         Next state */
+    {BREAK_DISABLED,     BREAKEVENT_OVERSPEED,      NULL,                             &BreakController_cl::vStartBreaking,           BREAK_BREAKING },
+    {BREAK_DISABLED,     BREAKEVENT_OVERWIND,       NULL,                             &BreakController_cl::vStartBreaking,           BREAK_BREAKING },
+    {BREAK_DISABLED,     BREAKEVENT_MANUAL,         NULL,                             &BreakController_cl::vStartBreaking,           BREAK_BREAKING },
+    {BREAK_DISABLED,     BREAKEVENT_OVERSPEED_TRIP, NULL,                             &BreakController_cl::vTakeOverTrip,            BREAK_BREAKING },
+    {BREAK_BREAKING,     BREAKEVENT_TIMER_EXPIRED,  NULL,                             &BreakController_cl::vStopBreaking,            BREAK_ENABLED  },
+    {BREAK_ENABLED,      BREAKEVENT_RELEASE,        &BreakController_cl::bCanRelease, &BreakController_cl::vStartReleasing,          BREAK_RELEASING},
+    {BREAK_RELEASING,    BREAKEVENT_TIMER_EXPIRED,  NULL,                             &BreakController_cl::vStopReleasing,           BREAK_DISABLED },
+    {BREAK_INITIALIZING, BREAKEVENT_TIMER_EXPIRED,  NULL,                             &BreakController_cl::vFinishInitialRetraction, BREAK_RELEASING},
+};
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the break controller class
+***************************************************************************************************/
+BreakController_cl::BreakController_cl()
+{
+    eStatus_             = BREAK_DISABLED;
+    scEnableRelayPin_    = 0;
+    scDisableRelayPin_   = 0;
+    ulLastRequestTimeMs_ = 0;
+    ulTimerStartMs_      = 0;
+    ulTimerDurationMs_   = 0;
+    bTimerActive_        = false;
+    bInitialized_        = false;
+    ulEventTimestampUs_  = 0;
+    ucConditions_        = 0;
+    for (unsigned char ucIdx = 0; ucIdx < BREAK_NUM_CONDITIONS_UC; ucIdx++)
+    {
+        aulConditionTimeUs_[ucIdx] = 0;
+    }
+    ulLastLatencyUs_     = 0;
+    ulMaxLatencyUs_      = 0;
+    bTripPending_        = false;
+    bTripUnconfirmed_    = false;
+    ulTripTimeMs_        = 0;
+    stTripStats_.ulTrips         = 0;
+    stTripStats_.ulFalseTrips    = 0;
+    stTripStats_.usLastLatencyUs = 0;
+    stTripStats_.usMaxLatencyUs  = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Setup the class and start moving the break actuator to its initial position
+* \param[in] scEnableRelayPin: Pin of the relay that extends the actuator (break)
+* \param[in] scDisableRelayPin: Pin of the relay that retracts the actuator (release)
+* \param[in] eInitialStatus: Known state of the actuator (BREAK_DISABLED or BREAK_ENABLED). Any other
+* value starts the initial positioning sequence
+***************************************************************************************************/
+void BreakController_cl::vSetup(const char scEnableRelayPin, const char scDisableRelayPin,
+                                const BreakStatus_e eInitialStatus)
+{
+    scEnableRelayPin_  = scEnableRelayPin;
+    scDisableRelayPin_ = scDisableRelayPin;
+
+    /* Resume from the known position. An enabled break is kept for the minimum time */
+    if (eInitialStatus == BREAK_DISABLED || eInitialStatus == BREAK_ENABLED)
+    {
+        ulLastRequestTimeMs_ = millis();
+        bInitialized_        = true;
+        eStatus_             = eInitialStatus;
+        return;
+    }
+
+    bInitialized_ = false;
+
+    /* Make sure the break actuator is fully retracted. vDispatch() finishes the sequence */
+    digitalWrite(scEnableRelayPin_, LOW);
+    vStartTimer(BREAK_FULL_RETRACTION_TIME_MS);
+    eStatus_ = BREAK_INITIALIZING;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function updates a break condition. The break request is queued only when the
+* condition becomes active. Must not be called from an ISR
+* \param[in] eCondition: BREAKEVENT_OVERSPEED, BREAKEVENT_OVERWIND or BREAKEVENT_MANUAL
+* \param[in] bActive: The condition is satisfied
+* \return True if the condition changed (vDispatch() should run as soon as possible)
+***************************************************************************************************/
+bool BreakController_cl::bSetCondition(const BreakEvent_e eCondition, const bool bActive)
+{
+    unsigned char ucMask = 1 << eCondition;
+    if (eCondition >= BREAK_NUM_CONDITIONS_UC || bActive == ((ucConditions_ & ucMask) != 0))
+    {
+        return false;
+    }
+
+    if (bActive)
+    {
+        ucConditions_ |= ucMask;
+        aulConditionTimeUs_[eCondition] = micros();
+        vPostEvent(eCondition);
+    }
+    else
+    {
+        ucConditions_ &= ~ucMask;
+    }
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function queues an event for the state machine. Must not be called from an ISR
+* \param[in] eEvent: Event to be queued
+***************************************************************************************************/
+void BreakController_cl::vPostEvent(const BreakEvent_e eEvent)
+{
+    clEvents_.bPush(eEvent, BREAK_EVENT_PRIORITIES_UC[eEvent]);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function queues an event for the state machine. Must only be called from an ISR
+* \param[in] eEvent: Event to be queued
+***************************************************************************************************/
+void BreakController_cl::vPostEventFromIsr(const BreakEvent_e eEvent)
+{
+    clEvents_.bPushFromIsr(eEvent, BREAK_EVENT_PRIORITIES_UC[eEvent]);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function energises the break relay immediately if the break is released and not
+* moving. Must only be called from an ISR
+* \param[in] ulPulseTimeUs: Output of micros() at the start of the ISR that detected the overspeed
+***************************************************************************************************/
+void BreakController_cl::vTripFromIsr(const uint32_t ulPulseTimeUs)
+{
+    /* Any other state already drives the relays (or the trip is waiting for vDispatch()) */
+    if (eStatus_ != BREAK_DISABLED || bTripPending_)
+    {
+        return;
+    }
+
+    digitalWrite(scEnableRelayPin_, LOW);
+    uint32_t ulLatencyUs = micros() - ulPulseTimeUs;
+
+    ulTripTimeMs_     = millis();
+    bTripPending_     = true;
+    bTripUnconfirmed_ = true;
+
+    /* Statistics */
+    stTripStats_.ulTrips++;
+    stTripStats_.usLastLatencyUs = ulLatencyUs > 0xFFFF ? 0xFFFF : ulLatencyUs;
+    if (stTripStats_.usLastLatencyUs > stTripStats_.usMaxLatencyUs)
+    {
+        stTripStats_.usMaxLatencyUs = stTripStats_.usLastLatencyUs;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function checks the manoeuvre timer and processes all queued events, most urgent
+* first. It must be invoked periodically, and as soon as possible after posting an event
+***************************************************************************************************/
+void BreakController_cl::vDispatch()
+{
+    /* A trip does not go through the queue, so it can't be lost when the queue is full. The relay is
+    already energised, so it goes first */
+    if (bTripPending_)
+    {
+        vProcessEvent(BREAKEVENT_OVERSPEED_TRIP, micros());
+        bTripPending_ = false;
+    }
+
+    /* The end of a manoeuvre is one more event, so it is ordered with the rest */
+    if (bTimerActive_ && millis() - ulTimerStartMs_ > ulTimerDurationMs_)
+    {
+        bTimerActive_ = false;
+        vPostEvent(BREAKEVENT_TIMER_EXPIRED);
+    }
+
+    /* Active conditions keep the break enabled, and confirm the last trip */
+    if (ucConditions_ != 0)
+    {
+        ulLastRequestTimeMs_ = millis();
+    }
+    if ((ucConditions_ & (1 << BREAKEVENT_OVERSPEED)) != 0)
+    {
+        bTripUnconfirmed_ = false;
+    }
+
+    Event_st stEvent;
+    while (clEvents_.bPop(stEvent))
+    {
+        vProcessEvent(static_cast<BreakEvent_e>(stEvent.ucId), stEvent.ulTimestampUs);
+    }
+
+    /* The conditions are levels, only their activation is queued. A request ignored while the break
+    was moving is applied once it is released, and the break is released when there is none */
+    if (ucConditions_ == 0)
+    {
+        if (eStatus_ == BREAK_ENABLED)
+        {
+            vProcessEvent(BREAKEVENT_RELEASE, micros());
+        }
+    }
+    else if (eStatus_ == BREAK_DISABLED && !bTripPending_)
+    {
+        for (unsigned char ucIdx = 0; ucIdx < BREAK_NUM_CONDITIONS_UC; ucIdx++)
+        {
+            if ((ucConditions_ & (1 << ucIdx)) != 0)
+            {
+                vProcessEvent(static_cast<BreakEvent_e>(ucIdx), aulConditionTimeUs_[ucIdx]);
+                break;
+            }
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the current state of the break
+* \return Break status
+***************************************************************************************************/
+BreakStatus_e BreakController_cl::eGetStatus() const
+{
+    return eStatus_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function checks if the initial positioning of the actuator has finished
+* \return True once the break has been released for the first time
+***************************************************************************************************/
+bool BreakController_cl::bIsInitialized() const
+{
+    return bInitialized_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the time from the last break request that started a break manoeuvre to
+* the activation of the relay
+* \return Latency [us]
+***************************************************************************************************/
+uint32_t BreakController_cl::ulGetLastLatencyUs() const
+{
+    return ulLastLatencyUs_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the maximum time from a break request to the activation of the relay
+* \return Latency [us]
+***************************************************************************************************/
+uint32_t BreakController_cl::ulGetMaxLatencyUs() const
+{
+    return ulMaxLatencyUs_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets a consistent copy of the overspeed trip statistics
+* \param[out] stStats: Trip statistics
+***************************************************************************************************/
+void BreakController_cl::vGetTripStats(BreakTripStats_st& stStats) const
+{
+    noInterrupts();
+    stStats.ulTrips         = stTripStats_.ulTrips;
+    stStats.ulFalseTrips    = stTripStats_.ulFalseTrips;
+    stStats.usLastLatencyUs = stTripStats_.usLastLatencyUs;
+    stStats.usMaxLatencyUs  = stTripStats_.usMaxLatencyUs;
+    interrupts();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the number of events lost because the queue was full
+* \return Dropped events
+***************************************************************************************************/
+uint32_t BreakController_cl::ulGetDroppedEvents() const
+{
+    return clEvents_.ulGetDropped();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function applies the first matching transition of the table for an event
+* \param[in] eEvent: Event to be processed
+* \param[in] ulTimestampUs: Output of micros() when the event was posted
+***************************************************************************************************/
+void BreakController_cl::vProcessEvent(const BreakEvent_e eEvent, const uint32_t ulTimestampUs)
+{
+    /* Every break request extends the minimum time the break stays enabled */
+    if (BREAK_EVENT_PRIORITIES_UC[eEvent] == 0)
+    {
+        ulLastRequestTimeMs_ = millis();
+    }
+
+    /* The application confirms the overspeed detected by the ISR */
+    if (eEvent == BREAKEVENT_OVERSPEED)
+    {
+        bTripUnconfirmed_ = false;
+    }
+
+    /* Look for the transition. Only the first matching row is executed */
+    for (unsigned char ucIdx = 0; ucIdx < sizeof(astTransitions_) / sizeof(astTransitions_[0]); ucIdx++)
+    {
+        const BreakTransition_st& stTransition = astTransitions_[ucIdx];
+        if (stTransition.eState == eStatus_ && stTransition.eEvent == eEvent &&
+            (stTransition.pfGuard == NULL || (this->*stTransition.pfGuard)()))
+        {
+            ulEventTimestampUs_ = ulTimestampUs;
+            (this->*stTransition.pfAction)();
+            eStatus_ = stTransition.eNextState;
+            break;
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Guard. Checks that the break has been enabled for the minimum time since the last break
+* request
+* \return True if the break can be released
+***************************************************************************************************/
+bool BreakController_cl::bCanRelease() const
+{
+    return millis() - ulLastRequestTimeMs_ > BREAK_MIN_ENABLED_TIME_MS;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Action. Energises the relay that extends the actuator
+***************************************************************************************************/
+void BreakController_cl::vStartBreaking()
+{
+    digitalWrite(scEnableRelayPin_, LOW);
+    vStartTimer(TIME_BREAK_ACT_OP_EXTENSION_MS);
+
+    /* Latency from the break request to the relay */
+    ulLastLatencyUs_ = micros() - ulEventTimestampUs_;
+    if (ulLastLatencyUs_ > ulMaxLatencyUs_)
+    {
+        ulMaxLatencyUs_ = ulLastLatencyUs_;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Action. Takes ownership of a break manoeuvre started by vTripFromIsr()
+***************************************************************************************************/
+void BreakController_cl::vTakeOverTrip()
+{
+    /* The relay is already energised. The manoeuvre started when the ISR tripped */
+    vStartTimer(TIME_BREAK_ACT_OP_EXTENSION_MS);
+    ulTimerStartMs_ = ulTripTimeMs_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Action. Stops the actuator at the end of the break manoeuvre
+***************************************************************************************************/
+void BreakController_cl::vStopBreaking()
+{
+    digitalWrite(scEnableRelayPin_, HIGH);
+
+    /* The application did not see the overspeed during the whole manoeuvre */
+    if (bTripUnconfirmed_)
+    {
+        bTripUnconfirmed_ = false;
+        stTripStats_.ulFalseTrips++;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Action. Energises the relay that retracts the actuator
+***************************************************************************************************/
+void BreakController_cl::vStartReleasing()
+{
+    digitalWrite(scDisableRelayPin_, LOW);
+    vStartTimer(BREAK_RETRACTION_TIME_MS);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Action. Stops the actuator at the end of the release manoeuvre
+***************************************************************************************************/
+void BreakController_cl::vStopReleasing()
+{
+    digitalWrite(scDisableRelayPin_, HIGH);
+    bInitialized_ = true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Action. Ends the initial retraction and moves the actuator to its nominal position
+***************************************************************************************************/
+void BreakController_cl::vFinishInitialRetraction()
+{
+    digitalWrite(scEnableRelayPin_, HIGH);
+    digitalWrite(scDisableRelayPin_, LOW);
+    vStartTimer(TIME_BREAK_ACT_OP_EXTENSION_MS);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function starts the manoeuvre timer. BREAKEVENT_TIMER_EXPIRED is posted when it expires
+* \param[in] ulDurationMs: Duration of the manoeuvre [ms]
+***************************************************************************************************/
+void BreakController_cl::vStartTimer(const unsigned long ulDurationMs)
+{
+    ulTimerStartMs_    = millis();
+    ulTimerDurationMs_ = ulDurationMs;
+    bTimerActive_      = true;
+}
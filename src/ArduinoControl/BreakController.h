@@ -0,0 +1,234 @@
+#ifndef BREAK_CONTROLLER_H_
+#define BREAK_CONTROLLER_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+#include <CommonTypes.h>
+#include <EventQueue.h>
+
+/* Custom includes */
+#include "Types.h"
+
+
+/*
+- NOTE1: The break is driven by a table of transitions (state, event) -> (guard, action, next state).
+Events not present in the table for the current state are ignored
+- NOTE2: Events are queued and processed in vDispatch(). Break requests (overspeed, over-wind,
+manual) are processed ahead of the rest of events. The application reports the break conditions with
+bSetCondition(), which posts one event when a condition becomes active, not while it stays active. The
+release is not an event of the application: vDispatch() releases the break when no condition is
+active, and starts breaking if a condition is active while the break is released (e.g. a request
+received while the break was releasing)
+- NOTE3: While a break condition is active, the time the break stays enabled is extended
+(BREAK_MIN_ENABLED_TIME_MS), also when the break is moving
+- NOTE4: vTripFromIsr() energises the break relay from the tacometer ISR, bypassing the queue. The
+next vDispatch() takes ownership of the manoeuvre as if it had been started by the state machine. A
+trip is counted as false if the overspeed condition is not active before the break is enabled
+- NOTE5: vSetup() does not block. The actuator is fully retracted and then released to its nominal
+position (BREAK_INITIALIZING, BREAK_RELEASING) while the rest of tasks run. Break requests are ignored
+until bIsInitialized(). If the actuator position is known (BREAK_DISABLED or BREAK_ENABLED stored
+before the last reset), the sequence is skipped
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char BREAK_NUM_CONDITIONS_UC = BREAKEVENT_MANUAL + 1; /**< Events that are break conditions (BREAKEVENT_OVERSPEED to BREAKEVENT_MANUAL) */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct BreakTripStats_st
+ * \brief Statistics of the emergency overspeed trip
+ **************************************************************************************************/
+struct BreakTripStats_st
+{
+    uint32_t ulTrips;           /**< Number of trips                                              */
+    uint32_t ulFalseTrips;      /**< Trips not confirmed by the application (BREAKEVENT_OVERSPEED) */
+    uint16_t usLastLatencyUs;   /**< Time from the tacometer pulse to the relay in the last trip  */
+    uint16_t usMaxLatencyUs;    /**< Maximum time from the tacometer pulse to the relay           */
+};
+
+/********************************************* CLASS **********************************************/
+class BreakController_cl;
+
+/***********************************************************************************************//**
+ * \struct BreakTransition_st
+ * \brief Row of the transition table of the break state machine
+ **************************************************************************************************/
+struct BreakTransition_st
+{
+    BreakStatus_e eState;                               /**< Current state                                 */
+    BreakEvent_e  eEvent;                               /**< Received event                                */
+    bool (BreakController_cl::*pfGuard)() const;        /**< Condition for the transition (NULL = always)  */
+    void (BreakController_cl::*pfAction)();             /**< Action executed in the transition             */
+    BreakStatus_e eNextState;                           /**< State after the transition                    */
+};
+
+/***********************************************************************************************//**
+ * \class BreakController_cl
+ * \brief Event driven state machine that operates the break actuator relays
+ **************************************************************************************************/
+class BreakController_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the break controller class
+    ***********************************************************************************************/
+    BreakController_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Setup the class and start moving the break actuator to its initial position
+    * \param[in] scEnableRelayPin: Pin of the relay that extends the actuator (break)
+    * \param[in] scDisableRelayPin: Pin of the relay that retracts the actuator (release)
+    * \param[in] eInitialStatus: Known state of the actuator (BREAK_DISABLED or BREAK_ENABLED). Any
+    * other value starts the initial positioning sequence
+    ***********************************************************************************************/
+    void vSetup(const char scEnableRelayPin, const char scDisableRelayPin,
+                const BreakStatus_e eInitialStatus = BREAK_INITIALIZING);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function updates a break condition. The break request is queued only when the
+    * condition becomes active. Must not be called from an ISR
+    * \param[in] eCondition: BREAKEVENT_OVERSPEED, BREAKEVENT_OVERWIND or BREAKEVENT_MANUAL
+    * \param[in] bActive: The condition is satisfied
+    * \return True if the condition changed (vDispatch() should run as soon as possible)
+    ***********************************************************************************************/
+    bool bSetCondition(const BreakEvent_e eCondition, const bool bActive);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function queues an event for the state machine. Must not be called from an ISR
+    * \param[in] eEvent: Event to be queued
+    ***********************************************************************************************/
+    void vPostEvent(const BreakEvent_e eEvent);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function queues an event for the state machine. Must only be called from an ISR
+    * \param[in] eEvent: Event to be queued
+    ***********************************************************************************************/
+    void vPostEventFromIsr(const BreakEvent_e eEvent);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function energises the break relay immediately if the break is released and not
+    * moving. Must only be called from an ISR
+    * \param[in] ulPulseTimeUs: Output of micros() at the start of the ISR that detected the overspeed
+    ***********************************************************************************************/
+    void vTripFromIsr(const uint32_t ulPulseTimeUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function checks the manoeuvre timer and processes all queued events, most urgent
+    * first. It must be invoked periodically, and as soon as possible after posting an event
+    ***********************************************************************************************/
+    void vDispatch();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the current state of the break
+    * \return Break status
+    ***********************************************************************************************/
+    BreakStatus_e eGetStatus() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function checks if the initial positioning of the actuator has finished
+    * \return True once the break has been released for the first time
+    ***********************************************************************************************/
+    bool bIsInitialized() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the time from the last break request that started a break
+    * manoeuvre to the activation of the relay
+    * \return Latency [us]
+    ***********************************************************************************************/
+    uint32_t ulGetLastLatencyUs() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the maximum time from a break request to the activation of the relay
+    * \return Latency [us]
+    ***********************************************************************************************/
+    uint32_t ulGetMaxLatencyUs() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets a consistent copy of the overspeed trip statistics
+    * \param[out] stStats: Trip statistics
+    ***********************************************************************************************/
+    void vGetTripStats(BreakTripStats_st& stStats) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the number of events lost because the queue was full
+    * \return Dropped events
+    ***********************************************************************************************/
+    uint32_t ulGetDroppedEvents() const;
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function applies the first matching transition of the table for an event
+    * \param[in] eEvent: Event to be processed
+    * \param[in] ulTimestampUs: Output of micros() when the event was posted
+    ***********************************************************************************************/
+    void vProcessEvent(const BreakEvent_e eEvent, const uint32_t ulTimestampUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Guard. Checks that the break has been enabled for the minimum time since the last break
+    * request
+    * \return True if the break can be released
+    ***********************************************************************************************/
+    bool bCanRelease() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Action. Energises the relay that extends the actuator
+    ***********************************************************************************************/
+    void vStartBreaking();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Action. Takes ownership of a break manoeuvre started by vTripFromIsr()
+    ***********************************************************************************************/
+    void vTakeOverTrip();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Action. Ends the initial retraction and moves the actuator to its nominal position
+    ***********************************************************************************************/
+    void vFinishInitialRetraction();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Action. Stops the actuator at the end of the break manoeuvre
+    ***********************************************************************************************/
+    void vStopBreaking();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Action. Energises the relay that retracts the actuator
+    ***********************************************************************************************/
+    void vStartReleasing();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Action. Stops the actuator at the end of the release manoeuvre
+    ***********************************************************************************************/
+    void vStopReleasing();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function starts the manoeuvre timer. BREAKEVENT_TIMER_EXPIRED is posted when it
+    * expires
+    * \param[in] ulDurationMs: Duration of the manoeuvre [ms]
+    ***********************************************************************************************/
+    void vStartTimer(const unsigned long ulDurationMs);
+
+    /***************************************** ATTRIBUTES *****************************************/
+    static const BreakTransition_st astTransitions_[]; /**< Transition table                                             */
+
+    EventQueue_cl              clEvents_;            /**< Pending events                                               */
+    volatile BreakStatus_e     eStatus_;             /**< Current state (read by vTripFromIsr())                       */
+    char                       scEnableRelayPin_;    /**< Relay that extends the actuator. Inverse logic (LOW = on)    */
+    char                       scDisableRelayPin_;   /**< Relay that retracts the actuator. Inverse logic (LOW = on)   */
+    unsigned long              ulLastRequestTimeMs_; /**< Output of millis() at the last break request                 */
+    unsigned long              ulTimerStartMs_;      /**< Output of millis() at the start of the manoeuvre             */
+    unsigned long              ulTimerDurationMs_;   /**< Duration of the manoeuvre                                    */
+    bool                       bTimerActive_;        /**< A manoeuvre is in progress                                   */
+    bool                       bInitialized_;        /**< The initial positioning of the actuator has finished         */
+    uint32_t                   ulEventTimestampUs_;  /**< Output of micros() when the event being processed was posted */
+    unsigned char              ucConditions_;        /**< Active break conditions, bit n for BreakEvent_e n            */
+    uint32_t                   aulConditionTimeUs_[BREAK_NUM_CONDITIONS_UC]; /**< Output of micros() when each condition became active */
+    uint32_t                   ulLastLatencyUs_;     /**< Last break request to relay latency                          */
+    uint32_t                   ulMaxLatencyUs_;      /**< Maximum break request to relay latency                       */
+    volatile bool              bTripPending_;        /**< The ISR tripped the break and vDispatch() did not take over  */
+    volatile bool              bTripUnconfirmed_;    /**< No BREAKEVENT_OVERSPEED received since the last trip         */
+    volatile unsigned long     ulTripTimeMs_;        /**< Output of millis() at the last trip                          */
+    volatile BreakTripStats_st stTripStats_;         /**< Statistics of the overspeed trip                             */
+};
+
+#endif /* BREAK_CONTROLLER_H_ */
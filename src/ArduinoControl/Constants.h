@@ -3,8 +3,11 @@
 
 /******************************************** INCLUDES ********************************************/
 /* System includes */
+#include <FixedPoint.h>
+#include <Interpolation.h>
 
 /* Custom includes */
+#include "Types.h"
 
 
 /******************************************* CONSTANTS ********************************************/
@@ -26,21 +29,92 @@ const unsigned int  HC12_INITIALIZATION_DELAY_MS_UL = 80; /**< Required time bef
 const unsigned long HALL_MIN_DELAY_MS_ULL           = 2;  /**< Minimum time (millis) to get a new reading and avoid "bouncing" */
 
 /* COMMUNICATIONS CONSTANTS */
-const float COMMS_PERIOD_MS = 250.0; /**< Period for the communications loop  */
-const int   BAUD_RATE       = 9600;  /**< Baud rate for serial communications */
+const int           BAUD_RATE                   = 9600; /**< Baud rate for serial communications                      */
+const unsigned long STATUS_REFRESH_PERIOD_MS_UL = 1000; /**< The status is resent after this time, in case it was lost */
+
+/* TASK SCHEDULING (lower priority values run first) */
+const unsigned char TASK_PRIORITY_SAFETY_UC         = 0;     /**< Priority for the break and overspeed tasks              */
+const unsigned char TASK_PRIORITY_CONTROL_UC        = 1;     /**< Priority for control inputs and pitch control           */
+const unsigned char TASK_PRIORITY_MEASUREMENT_UC    = 2;     /**< Priority for periodic measurements                      */
+const unsigned char TASK_PRIORITY_TELEMETRY_UC      = 3;     /**< Priority for telemetry sent to the user Arduino         */
+const unsigned char TASK_PRIORITY_BACKGROUND_UC     = 4;     /**< Priority for slow tasks that may block                  */
+const unsigned long BREAK_TASK_PERIOD_MS_UL         = 10;    /**< Period of the break management task                     */
+const unsigned long PITCH_TASK_PERIOD_MS_UL         = 10;    /**< Period of the pitch control task                        */
+const unsigned long REGULATOR_TASK_PERIOD_MS_UL     = 50;    /**< Period of the rotor speed regulator (20 Hz)             */
+const unsigned long HC12_READ_PERIOD_MS_UL          = 20;    /**< Period to read incoming messages (64 bytes UART buffer) */
+const unsigned long STARTUP_TASK_PERIOD_MS_UL       = 100;   /**< Period to check the startup progress                    */
+const unsigned long JOURNAL_TASK_PERIOD_MS_UL       = 10;    /**< Period of the position journal (one EEPROM byte each)   */
+const unsigned long WIND_PREDICTION_PERIOD_MS_UL    = 250;   /**< Period of the wind speed predictor samples              */
+const unsigned long PROFILING_REPORT_PERIOD_MS_UL   = 10000; /**< Period of the profiling report (if PROFILING_ENABLED)   */
+const unsigned long ISR_MONITOR_REPORT_PERIOD_MS_UL = 10000; /**< Period of the interrupt report (if ISR_MONITOR_ENABLED) */
+const unsigned long RECORDER_PERIOD_MS_UL           = 100;   /**< Period of the flight recorder samples (10 Hz)           */
+const unsigned long TELEMETRY_TASK_PERIOD_MS_UL     = 50;    /**< Period of the telemetry task (fastest frames, 20 Hz)    */
+
+/* FLIGHT RECORDER (300 records, see FlightRecorder.h) */
+const uint16_t RECORDER_POST_RECORDS_US = 60; /**< Records after a break event (6 s, the other 24 s are before it) */
+
+/* TELEMETRY RATE (see TelemetryGovernor.h) */
+const unsigned long TELEMETRY_ACTIVE_PERIOD_MS_UL = 100;   /**< Period of the frames with gusts or rotor speed changes (10 Hz)  */
+const unsigned long TELEMETRY_STEADY_PERIOD_MS_UL = 500;   /**< Period of the frames with steady readings (2 Hz)                */
+const unsigned char TELEMETRY_MAX_LOAD_PERCENT_UC = 50;    /**< Share of the HC12 link capacity the telemetry can use [%]       */
+const float         TELEMETRY_PITCH_RATE_PCT_S_F  = 2.0f;  /**< Pitch speed above which the pitch is moving [%/s]              */
+const float         TELEMETRY_GUST_MPS_F          = 2.0f;  /**< Difference between the wind and its average in a gust [m/s]     */
+const float         TELEMETRY_ROTOR_RATE_RPM_S_F  = 20.0f; /**< Rotor acceleration of a fast rotor speed change [rpm/s]        */
+
+/* POSITION JOURNAL (EEPROM) */
+const uint16_t JOURNAL_EEPROM_ADDRESS_US = 0;   /**< First EEPROM address of the actuators position journal              */
+const uint16_t JOURNAL_NUM_SLOTS_US      = 512; /**< Records in the journal (8 bytes each, spread the wear of the EEPROM) */
 
 /* TEMPERATURE/HUMIDITY SENSORS */
 const float READ_PERIOD_MS = 10000.0; /**< Time interval between data measurements */
+const unsigned long DHT22_START_SIGNAL_MS_UL = 20; /**< Start signal of a reading, from startRead() to finishRead() */
 
 /* VARIABLE PITCH CONTROL */
 const float SERVO_LENGHT_MM                                  = 200.0; /**< Maximum extension length for the servo responsible for the pitch control  */
 const float SERVO_USABLE_LENGTH_MM                           = 50.0;  /**< Maximum extension required for the full blade pitch control               */
 const short SERVO_TURNS_TO_FULL_EXTENSION                    = 104;   /**< Number of gear turns to fully extend the actuator                         */
 const short PITCH_ANGLE_CALIBRATION_POINTS_UC                = 5;     /**< Number of points for the calibration curve                                */
-float PITCH_CONTROL_BETA_ANGLE_F[PITCH_ANGLE_CALIBRATION_POINTS_UC] = /**< Aerodinamic angle beta at which the actuator extension is calibrated      */
+constexpr float PITCH_CONTROL_BETA_ANGLE_F[PITCH_ANGLE_CALIBRATION_POINTS_UC] = /**< Aerodinamic angle beta at which the actuator extension is calibrated      */
 							{0.0f, 0.4f, 0.8f, 1.2f, 1.5708f};
-float PITCH_CONTROL_EXTENSION_F[PITCH_ANGLE_CALIBRATION_POINTS_UC]  = /**< Extension of the actuator to achieve angles in PITCH_CONTROL_BETA_ANGLE_F */						
+constexpr float PITCH_CONTROL_EXTENSION_F[PITCH_ANGLE_CALIBRATION_POINTS_UC]  = /**< Extension of the actuator to achieve angles in PITCH_CONTROL_BETA_ANGLE_F */
 							{0.0f, 25.0f , 50.0f,  75.0f, 100.0f };
+const PitchControlMethod_e PITCH_CONTROL_METHOD_E            = PITCHCONTROL_BETA_FLOAT; /**< Method used to compute the actuator extension in automatic pitch mode */
+const float PITCH_CONTROL_SECTION_RADIUS_M_F                 = 0.33f; /**< Radius of the blade section used to compute the aerodynamic angle [m]    */
+const float PITCH_CONTROL_SECTION_ANGLE_RAD_F                = 22.0f * PI / 180.0f; /**< Torsion angle at the section (12.75 deg) plus angle of max efficiency (9.25 deg) */
+const float PITCH_CONTROL_MIN_WIND_SPEED_F                   = 1.0f;  /**< Below this wind speed, the aerodynamic angle is not computed [m/s]       */
+constexpr int32_t PITCH_CONTROL_BETA_ANGLE_Q16[PITCH_ANGLE_CALIBRATION_POINTS_UC] = /**< PITCH_CONTROL_BETA_ANGLE_F in Q16 format */
+							{slFloatToQ16(0.0f), slFloatToQ16(0.4f), slFloatToQ16(0.8f), slFloatToQ16(1.2f), slFloatToQ16(1.5708f)};
+constexpr int32_t PITCH_CONTROL_EXTENSION_Q16[PITCH_ANGLE_CALIBRATION_POINTS_UC]  = /**< PITCH_CONTROL_EXTENSION_F in Q16 format  */
+							{slFloatToQ16(0.0f), slFloatToQ16(25.0f), slFloatToQ16(50.0f), slFloatToQ16(75.0f), slFloatToQ16(100.0f)};
+static_assert(bIsStrictlyIncreasing(PITCH_CONTROL_BETA_ANGLE_F),   "Pitch calibration angles must be strictly increasing");
+static_assert(bIsStrictlyIncreasing(PITCH_CONTROL_BETA_ANGLE_Q16), "Pitch calibration angles must be strictly increasing");
+
+/* VARIABLE PITCH SCHEDULE (PITCHCONTROL_SCHEDULE_2D). Initial values reproduce the beta angle calibration, clipped to 0% */
+const short PITCH_SCHEDULE_WIND_POINTS_UC = 11; /**< Number of wind speed points of the pitch schedule */
+const short PITCH_SCHEDULE_RPM_POINTS_UC  = 7;  /**< Number of rotor speed points of the pitch schedule */
+constexpr float PITCH_SCHEDULE_WIND_SPEED_F[PITCH_SCHEDULE_WIND_POINTS_UC] = /**< Wind speeds of the pitch schedule [m/s] */
+							{0.0f, 3.0f, 6.0f, 9.0f, 12.0f, 15.0f, 18.0f, 21.0f, 24.0f, 27.0f, 30.0f};
+constexpr float PITCH_SCHEDULE_ROTOR_RPM_F[PITCH_SCHEDULE_RPM_POINTS_UC]   = /**< Rotor speeds of the pitch schedule [rpm]  */
+							{0.0f, 50.0f, 100.0f, 150.0f, 200.0f, 250.0f, 300.0f};
+constexpr float PITCH_SCHEDULE_EXTENSION_F[PITCH_SCHEDULE_WIND_POINTS_UC][PITCH_SCHEDULE_RPM_POINTS_UC] = /**< Actuator extension [%] for each wind speed (rows) and rotor speed (columns) */
+							{{74.2f, 74.2f, 74.2f, 74.2f, 74.2f, 74.2f, 74.2f},
+							 {74.2f, 41.5f, 20.7f,  8.8f,  1.6f,  0.0f,  0.0f},
+							 {74.2f, 56.7f, 41.5f, 29.6f, 20.7f, 13.9f,  8.8f},
+							 {74.2f, 62.3f, 51.3f, 41.5f, 33.2f, 26.4f, 20.7f},
+							 {74.2f, 65.2f, 56.7f, 48.7f, 41.5f, 35.2f, 29.6f},
+							 {74.2f, 67.0f, 60.0f, 53.4f, 47.2f, 41.5f, 36.4f},
+							 {74.2f, 68.2f, 62.3f, 56.7f, 51.3f, 46.2f, 41.5f},
+							 {74.2f, 69.0f, 64.0f, 59.1f, 54.3f, 49.8f, 45.5f},
+							 {74.2f, 69.7f, 65.2f, 60.9f, 56.7f, 52.6f, 48.7f},
+							 {74.2f, 70.2f, 66.2f, 62.3f, 58.5f, 54.8f, 51.3f},
+							 {74.2f, 70.6f, 67.0f, 63.5f, 60.0f, 56.7f, 53.4f}};
+static_assert(bIsStrictlyIncreasing(PITCH_SCHEDULE_WIND_SPEED_F), "Pitch schedule wind speeds must be strictly increasing");
+static_assert(bIsStrictlyIncreasing(PITCH_SCHEDULE_ROTOR_RPM_F),  "Pitch schedule rotor speeds must be strictly increasing");
+
+/* ROTOR SPEED REGULATOR (automatic pitch mode) */
+const float ROTOR_SPEED_SETPOINT_RATIO_F = 0.9f;   /**< Setpoint of the regulator, relative to fMaxRotorSpeedRPM (the break limit) */
+const float ROTOR_REGULATOR_KP_F         = 0.01f;  /**< Proportional gain [rad/rpm] (tuned with tools/HostSimulator --regulator)    */
+const float ROTOR_REGULATOR_KI_F         = 0.02f;  /**< Integral gain [rad/(rpm*s)]                                                 */
 
 /* TURBINE BREAK */
 const float TIME_BREAK_ACT_OP_EXTENSION_MS = 1000;                                 /**< Milliseconds to operational extension of the break actuator                                                                   */
@@ -49,11 +123,18 @@ const float BREAK_FULL_RETRACTION_TIME_MS  = 10000;
 const float BREAK_MIN_ENABLED_TIME_MS      = 5000;                                 /**< Min time for the break to be active once triggered                                                                            */
 
 /* TACOMETER */
-const unsigned char TACOMETER_NUM_MAGNETS  = 3; /**< Number of magnets in that hall sensor reads in a complete turn for the tacometer  */
+const unsigned char TACOMETER_NUM_MAGNETS    = 3; /**< Number of magnets in that hall sensor reads in a complete turn for the tacometer  */
+const unsigned char OVERSPEED_TRIP_PULSES_UC = 2; /**< Consecutive tacometer periods over fMaxRotorSpeedRPM that trip the break         */
+const uint32_t ROTOR_STOPPED_TIMEOUT_US_UL = 2000000; /**< Without tacometer pulses during this time, the rotor is stopped (< 10 rpm)  */
 
 /* WIND MEASUREMENTS CONSTANTS */
 const unsigned int NUM_AVERAGE_WIND_SPEED_SAMPLES_UL                    = 60;   /**< Number of samples to compute the average wind speed                                   */
 const unsigned int WIND_SPEED_SAMPLE_INTERVAL_MS_UL                     = 1000; /**< Interval between wind speed samples                                                   */
 const unsigned char ANEMOMETER_NUM_MAGNETS                              = 3;    /**< Number of magnets in that hall sensor reads in a complete turn for the anemometer     */
 
+/* WIND PREDICTION (feed-forward of the automatic pitch control) */
+const float         WIND_PREDICTION_ALPHA_F       = 0.8f; /**< Smoothing factor of the predicted wind speed level                                     */
+const float         WIND_PREDICTION_BETA_F        = 0.2f; /**< Smoothing factor of the predicted wind speed trend                                     */
+const unsigned long WIND_PREDICTION_HORIZON_MS_UL = 2000; /**< The pitch is computed for the wind expected this time ahead (about the actuator delay) */
+
 #endif // CONSTANTS_H_
\ No newline at end of file
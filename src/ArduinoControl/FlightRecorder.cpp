@@ -0,0 +1,212 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <string.h>
+
+/* Custom includes */
+#include "FlightRecorder.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the flight recorder class
+***************************************************************************************************/
+FlightRecorder_cl::FlightRecorder_cl()
+{
+    memset(astRecords_, 0, sizeof(astRecords_));
+    usNextRecord_     = 0;
+    usNumRecords_     = 0;
+    usPeriodMs_       = 0;
+    usPostRecords_    = 0;
+    usPostRemaining_  = 0;
+    usTriggerRecord_  = 0;
+    ulTriggerTimeMs_  = 0;
+    eState_           = RECORDERSTATE_RECORDING;
+    bRequestPending_  = false;
+    usRequestedChunk_ = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Setup the class
+* \param[in] usPeriodMs: Time between calls to vSample() [ms] (only reported in the chunks)
+* \param[in] usPostRecords: Records taken after the trigger (less than the size of the ring)
+***************************************************************************************************/
+void FlightRecorder_cl::vSetup(const uint16_t usPeriodMs, const uint16_t usPostRecords)
+{
+    usPeriodMs_    = usPeriodMs;
+    usPostRecords_ = usPostRecords < FLIGHT_RECORDER_NUM_RECORDS_US ? usPostRecords : FLIGHT_RECORDER_NUM_RECORDS_US - 1;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function stores a sample of the turbine data. Nothing is stored while a window is
+* frozen
+* \param[in] stAeroData: Current data of the turbine
+* \param[in] stControlParams: Current control parameters (limits of the break conditions)
+***************************************************************************************************/
+void FlightRecorder_cl::vSample(const AeroData_st& stAeroData, const ControlParams_st& stControlParams)
+{
+    if (eState_ == RECORDERSTATE_FROZEN)
+    {
+        return;
+    }
+
+    /* Fixed point fields */
+    FlightRecord_st& stRecord = astRecords_[usNextRecord_];
+    stRecord.sWindSpeed   = slToFixed(stAeroData.fWindSpeed, FLIGHT_RECORD_WIND_SCALE_F, INT16_MIN, INT16_MAX);
+    stRecord.sRotorSpeed  = slToFixed(stAeroData.fRotorSpeedRPM, FLIGHT_RECORD_RPM_SCALE_F, INT16_MIN, INT16_MAX);
+    stRecord.ucBladePitch = slToFixed(stAeroData.fBladePitchPercentage, FLIGHT_RECORD_PITCH_SCALE_F, 0, UINT8_MAX);
+
+    /* Break status and the conditions reported to the break controller (vUpdateBreakConditions()) */
+    uint8_t ucStatus = static_cast<uint8_t>(stAeroData.stStatus.eBreakStatus) & FLIGHT_RECORD_BREAK_MASK_UC;
+    if (stAeroData.stStatus.ePitchMode == PITCHMODE_AUTO)
+    {
+        ucStatus |= FLIGHT_RECORD_PITCH_AUTO_UC;
+    }
+    if (stControlParams.eManualBreak == MANUALBREAK_ON)
+    {
+        ucStatus |= FLIGHT_RECORD_MANUAL_BREAK_UC;
+    }
+    if (stAeroData.fRotorSpeedRPM > stControlParams.fMaxRotorSpeedRPM)
+    {
+        ucStatus |= FLIGHT_RECORD_OVERSPEED_UC;
+    }
+    if (stAeroData.fAverageWindSpeed > stControlParams.fMaxWindSpeed)
+    {
+        ucStatus |= FLIGHT_RECORD_OVERWIND_UC;
+    }
+    stRecord.ucStatus = ucStatus;
+
+    /* Advance in the ring */
+    usNextRecord_ = (usNextRecord_ + 1) % FLIGHT_RECORDER_NUM_RECORDS_US;
+    if (usNumRecords_ < FLIGHT_RECORDER_NUM_RECORDS_US)
+    {
+        usNumRecords_++;
+    }
+
+    /* Post-trigger window */
+    if (eState_ == RECORDERSTATE_TRIGGERED && --usPostRemaining_ == 0)
+    {
+        eState_ = RECORDERSTATE_FROZEN;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function starts the post-trigger window (see NOTE2)
+* \param[in] ulNowMs: Current time [ms]
+***************************************************************************************************/
+void FlightRecorder_cl::vTrigger(const unsigned long ulNowMs)
+{
+    if (eState_ != RECORDERSTATE_RECORDING)
+    {
+        return;
+    }
+
+    usTriggerRecord_ = usNextRecord_;
+    ulTriggerTimeMs_ = ulNowMs;
+    usPostRemaining_ = usPostRecords_;
+    eState_          = usPostRecords_ > 0 ? RECORDERSTATE_TRIGGERED : RECORDERSTATE_FROZEN;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function stores a chunk request (see NOTE3)
+* \param[in] usChunk: Requested chunk, or RECORDER_REARM_CHUNK_US to release the window
+***************************************************************************************************/
+void FlightRecorder_cl::vRequestChunk(const uint16_t usChunk)
+{
+    /* Re-arm. The ring continues from the frozen records, they are the pre-trigger records of the
+    next event until they are overwritten */
+    if (usChunk == RECORDER_REARM_CHUNK_US)
+    {
+        eState_          = RECORDERSTATE_RECORDING;
+        bRequestPending_ = false;
+        return;
+    }
+
+    usRequestedChunk_ = usChunk;
+    bRequestPending_  = true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the requested chunk, if there is a request not served yet
+* \param[out] stChunk: Requested chunk. Without a frozen window it only carries the state
+* \return True if there was a pending request
+***************************************************************************************************/
+bool FlightRecorder_cl::bGetPendingChunk(RecorderChunk_st& stChunk)
+{
+    if (!bRequestPending_)
+    {
+        return false;
+    }
+    bRequestPending_ = false;
+
+    memset(&stChunk, 0, sizeof(stChunk));
+    stChunk.usChunk    = usRequestedChunk_;
+    stChunk.usPeriodMs = usPeriodMs_;
+    stChunk.eState     = eState_;
+    if (eState_ != RECORDERSTATE_FROZEN)
+    {
+        return true;
+    }
+
+    /* Oldest record of the window. If the ring was not full yet, the window starts at 0 */
+    uint16_t usOldest = usNumRecords_ < FLIGHT_RECORDER_NUM_RECORDS_US ? 0 : usNextRecord_;
+    stChunk.usNumChunks     = (usNumRecords_ + RECORDER_CHUNK_RECORDS_UC - 1) / RECORDER_CHUNK_RECORDS_UC;
+    stChunk.usTriggerRecord = (usTriggerRecord_ + FLIGHT_RECORDER_NUM_RECORDS_US - usOldest) % FLIGHT_RECORDER_NUM_RECORDS_US;
+    stChunk.ulTriggerTimeMs = ulTriggerTimeMs_;
+
+    /* Records of the chunk (a chunk out of the window has no records) */
+    uint32_t ulFirst = static_cast<uint32_t>(usRequestedChunk_) * RECORDER_CHUNK_RECORDS_UC;
+    for (unsigned char ucIdx = 0; ucIdx < RECORDER_CHUNK_RECORDS_UC && ulFirst + ucIdx < usNumRecords_; ucIdx++)
+    {
+        stChunk.astRecords[ucIdx] = astRecords_[(usOldest + ulFirst + ucIdx) % FLIGHT_RECORDER_NUM_RECORDS_US];
+        stChunk.ucNumRecords++;
+    }
+
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function checks if there is a chunk request not served yet
+* \return True if there is a pending request
+***************************************************************************************************/
+bool FlightRecorder_cl::bIsChunkPending() const
+{
+    return bRequestPending_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the state of the recorder
+* \return State of the recorder
+***************************************************************************************************/
+RecorderState_e FlightRecorder_cl::eGetState() const
+{
+    return eState_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function converts a value to fixed point, saturating at the limits of the type
+* \param[in] fValue: Value to convert
+* \param[in] fScale: Scale of the fixed point value
+* \param[in] slMin: Lowest value of the type
+* \param[in] slMax: Highest value of the type
+* \return Scaled value, rounded to the nearest
+***************************************************************************************************/
+int32_t FlightRecorder_cl::slToFixed(const float fValue, const float fScale, const int32_t slMin, const int32_t slMax)
+{
+    /* NaN (e.g. no reading yet) is stored as 0 */
+    if (fValue != fValue)
+    {
+        return 0;
+    }
+
+    float fScaled = fValue * fScale;
+    if (fScaled <= slMin)
+    {
+        return slMin;
+    }
+    if (fScaled >= slMax)
+    {
+        return slMax;
+    }
+
+    return static_cast<int32_t>(fScaled + (fScaled >= 0.0f ? 0.5f : -0.5f));
+}
@@ -0,0 +1,113 @@
+#ifndef FLIGHT_RECORDER_H_
+#define FLIGHT_RECORDER_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+#include <CommonConstants.h>
+#include <CommonTypes.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Ring of FLIGHT_RECORDER_NUM_RECORDS_US samples of wind speed, rotor speed, blade pitch and
+break status, in fixed point (FlightRecord_st, 6 bytes each). vSample() must be called at a fixed
+rate, and overwrites the oldest record
+- NOTE2: vTrigger() (a break event) starts the post-trigger window: usPostRecords more samples are
+recorded, and then the ring is frozen. The frozen window has the records before the event (the rest
+of the ring) and after it, and it is kept until vRequestChunk(RECORDER_REARM_CHUNK_US). Events
+received while a window is being recorded or is frozen are ignored, so the first event is kept
+- NOTE3: The window is downloaded in chunks of RECORDER_CHUNK_RECORDS_UC records, oldest first. Each
+request stores the requested chunk, and bGetPendingChunk() gives it once, when the caller has room to
+send it. Lost chunks are simply requested again
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const uint16_t FLIGHT_RECORDER_NUM_RECORDS_US = 300; /**< Records in the ring (1800 bytes of SRAM) */
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class FlightRecorder_cl
+ * \brief Ring recorder of the turbine data that freezes a window around the break events
+ **************************************************************************************************/
+class FlightRecorder_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the flight recorder class
+    ***********************************************************************************************/
+    FlightRecorder_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Setup the class
+    * \param[in] usPeriodMs: Time between calls to vSample() [ms] (only reported in the chunks)
+    * \param[in] usPostRecords: Records taken after the trigger (less than the size of the ring)
+    ***********************************************************************************************/
+    void vSetup(const uint16_t usPeriodMs, const uint16_t usPostRecords);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function stores a sample of the turbine data. Nothing is stored while a window is
+    * frozen
+    * \param[in] stAeroData: Current data of the turbine
+    * \param[in] stControlParams: Current control parameters (limits of the break conditions)
+    ***********************************************************************************************/
+    void vSample(const AeroData_st& stAeroData, const ControlParams_st& stControlParams);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function starts the post-trigger window (see NOTE2)
+    * \param[in] ulNowMs: Current time [ms]
+    ***********************************************************************************************/
+    void vTrigger(const unsigned long ulNowMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function stores a chunk request (see NOTE3)
+    * \param[in] usChunk: Requested chunk, or RECORDER_REARM_CHUNK_US to release the window
+    ***********************************************************************************************/
+    void vRequestChunk(const uint16_t usChunk);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the requested chunk, if there is a request not served yet
+    * \param[out] stChunk: Requested chunk. Without a frozen window it only carries the state
+    * \return True if there was a pending request
+    ***********************************************************************************************/
+    bool bGetPendingChunk(RecorderChunk_st& stChunk);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function checks if there is a chunk request not served yet
+    * \return True if there is a pending request
+    ***********************************************************************************************/
+    bool bIsChunkPending() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the state of the recorder
+    * \return State of the recorder
+    ***********************************************************************************************/
+    RecorderState_e eGetState() const;
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function converts a value to fixed point, saturating at the limits of the type
+    * \param[in] fValue: Value to convert
+    * \param[in] fScale: Scale of the fixed point value
+    * \param[in] slMin: Lowest value of the type
+    * \param[in] slMax: Highest value of the type
+    * \return Scaled value, rounded to the nearest
+    ***********************************************************************************************/
+    static int32_t slToFixed(const float fValue, const float fScale, const int32_t slMin, const int32_t slMax);
+
+    /***************************************** ATTRIBUTES *****************************************/
+    FlightRecord_st astRecords_[FLIGHT_RECORDER_NUM_RECORDS_US]; /**< Ring of records                               */
+    uint16_t        usNextRecord_;                               /**< Position of the next record in the ring       */
+    uint16_t        usNumRecords_;                               /**< Valid records in the ring                     */
+    uint16_t        usPeriodMs_;                                 /**< Time between records [ms]                     */
+    uint16_t        usPostRecords_;                              /**< Records taken after the trigger               */
+    uint16_t        usPostRemaining_;                            /**< Post-trigger records still to be taken        */
+    uint16_t        usTriggerRecord_;                            /**< Position of the first post-trigger record     */
+    uint32_t        ulTriggerTimeMs_;                            /**< Time of the break event [ms]                  */
+    RecorderState_e eState_;                                     /**< State of the recorder                         */
+    bool            bRequestPending_;                            /**< A chunk has been requested and not sent yet   */
+    uint16_t        usRequestedChunk_;                           /**< Last requested chunk                          */
+};
+
+#endif /* FLIGHT_RECORDER_H_ */
@@ -0,0 +1,120 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <Interpolation.h>
+
+/* Custom includes */
+#include "Constants.h"
+#include "RotorRegulator.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+static const float BETA_MIN_RAD_F = PITCH_CONTROL_BETA_ANGLE_F[0];                                     /**< Lowest calibrated angle  */
+static const float BETA_MAX_RAD_F = PITCH_CONTROL_BETA_ANGLE_F[PITCH_ANGLE_CALIBRATION_POINTS_UC - 1]; /**< Highest calibrated angle */
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the rotor regulator class
+***************************************************************************************************/
+RotorRegulator_cl::RotorRegulator_cl()
+{
+    fKp_ = 0.0f;
+    fKi_ = 0.0f;
+    vReset();
+    vResetStats();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Setup the class
+* \param[in] fKp: Proportional gain [rad/rpm]
+* \param[in] fKi: Integral gain [rad/(rpm*s)]
+***************************************************************************************************/
+void RotorRegulator_cl::vSetup(const float fKp, const float fKi)
+{
+    fKp_ = fKp;
+    fKi_ = fKi;
+    vReset();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function runs one step of the regulator
+* \param[in] fSetpointRPM: Requested maximum rotor speed [rpm]
+* \param[in] fRotorSpeedRPM: Measured rotor speed [rpm]
+* \param[in] fFeedForwardPercent: Actuator extension computed by the automatic pitch [%]
+* \param[in] fDeltaS: Time since the last step [s]
+* \return Requested actuator extension [%]
+***************************************************************************************************/
+float RotorRegulator_cl::fUpdate(const float fSetpointRPM,
+                                 const float fRotorSpeedRPM,
+                                 const float fFeedForwardPercent,
+                                 const float fDeltaS)
+{
+    /* Angle requested by the feed-forward, inside the calibrated range */
+    float fBetaFeedForward = tInterp1D(PITCH_CONTROL_EXTENSION_F, PITCH_CONTROL_BETA_ANGLE_F, fFeedForwardPercent);
+    fBetaFeedForward = max(min(fBetaFeedForward, BETA_MAX_RAD_F), BETA_MIN_RAD_F);
+
+    /* The correction goes from 0 (feed-forward) to the braking position */
+    float fMinCorrection = BETA_MIN_RAD_F - fBetaFeedForward;
+    float fErrorRPM      = fSetpointRPM - fRotorSpeedRPM;
+    float fCorrection    = fKp_ * fErrorRPM + fIntegral_;
+
+    /* Anti-windup. Integrate only when the output is not saturated, or when the error moves it out
+    of the saturation */
+    if ((fCorrection < 0.0f || fErrorRPM < 0.0f) && (fCorrection > fMinCorrection || fErrorRPM > 0.0f))
+    {
+        fIntegral_ += fKi_ * fErrorRPM * fDeltaS;
+        fIntegral_  = max(min(fIntegral_, 0.0f), BETA_MIN_RAD_F - BETA_MAX_RAD_F);
+    }
+    fCorrection = max(min(fKp_ * fErrorRPM + fIntegral_, 0.0f), fMinCorrection);
+
+    /* Statistics, only while the regulator is acting */
+    if (fErrorRPM < 0.0f || fCorrection < 0.0f)
+    {
+        fSquaredErrorSum_ += fErrorRPM * fErrorRPM;
+        ulActiveSteps_++;
+    }
+    if (fCorrection <= fMinCorrection && fMinCorrection < 0.0f)
+    {
+        ulSaturatedSteps_++;
+    }
+
+    return tInterp1D(PITCH_CONTROL_BETA_ANGLE_F, PITCH_CONTROL_EXTENSION_F, fBetaFeedForward + fCorrection);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function clears the integral term (e.g. when the regulator is not used)
+***************************************************************************************************/
+void RotorRegulator_cl::vReset()
+{
+    fIntegral_ = 0.0f;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the root mean square of the speed error since the last reset of the
+* statistics. Only the steps over the setpoint or with an active correction are counted
+* \return RMS speed error [rpm]
+***************************************************************************************************/
+float RotorRegulator_cl::fGetRmsErrorRPM() const
+{
+    return ulActiveSteps_ > 0 ? sqrt(fSquaredErrorSum_ / ulActiveSteps_) : 0.0f;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the number of steps with the correction at its lower limit (blades at the
+* braking position) since the last reset of the statistics
+* \return Number of saturated steps
+***************************************************************************************************/
+uint32_t RotorRegulator_cl::ulGetSaturatedSteps() const
+{
+    return ulSaturatedSteps_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function resets the error statistics
+***************************************************************************************************/
+void RotorRegulator_cl::vResetStats()
+{
+    fSquaredErrorSum_ = 0.0f;
+    ulActiveSteps_    = 0;
+    ulSaturatedSteps_ = 0;
+}
@@ -0,0 +1,90 @@
+#ifndef ROTOR_REGULATOR_H_
+#define ROTOR_REGULATOR_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: PI regulator of the rotor speed, on top of the automatic pitch (feed-forward). It must be
+called with a fixed rate, the measured time between calls is used to integrate
+- NOTE2: The regulator works with the aerodynamic angle beta. The feed-forward extension is converted
+to beta with the inverse of the pitch calibration curve (PITCH_CONTROL_BETA_ANGLE_F,
+PITCH_CONTROL_EXTENSION_F), the correction is added, and the result is converted back to extension.
+This way the gains are scheduled with the local slope of the calibration curve
+- NOTE3: The correction only moves the blades towards the braking position (beta decreasing, 0%
+extension). Below the setpoint it saturates at 0, and the feed-forward (maximum efficiency) is used.
+The integral term is frozen while the output is saturated (anti-windup)
+*/
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class RotorRegulator_cl
+ * \brief Rotor speed regulator that corrects the automatic pitch extension
+ **************************************************************************************************/
+class RotorRegulator_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the rotor regulator class
+    ***********************************************************************************************/
+    RotorRegulator_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Setup the class
+    * \param[in] fKp: Proportional gain [rad/rpm]
+    * \param[in] fKi: Integral gain [rad/(rpm*s)]
+    ***********************************************************************************************/
+    void vSetup(const float fKp, const float fKi);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function runs one step of the regulator
+    * \param[in] fSetpointRPM: Requested maximum rotor speed [rpm]
+    * \param[in] fRotorSpeedRPM: Measured rotor speed [rpm]
+    * \param[in] fFeedForwardPercent: Actuator extension computed by the automatic pitch [%]
+    * \param[in] fDeltaS: Time since the last step [s]
+    * \return Requested actuator extension [%]
+    ***********************************************************************************************/
+    float fUpdate(const float fSetpointRPM,
+                  const float fRotorSpeedRPM,
+                  const float fFeedForwardPercent,
+                  const float fDeltaS);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function clears the integral term (e.g. when the regulator is not used)
+    ***********************************************************************************************/
+    void vReset();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the root mean square of the speed error since the last reset of the
+    * statistics. Only the steps over the setpoint or with an active correction are counted
+    * \return RMS speed error [rpm]
+    ***********************************************************************************************/
+    float fGetRmsErrorRPM() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the number of steps with the correction at its lower limit (blades at
+    * the braking position) since the last reset of the statistics
+    * \return Number of saturated steps
+    ***********************************************************************************************/
+    uint32_t ulGetSaturatedSteps() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function resets the error statistics
+    ***********************************************************************************************/
+    void vResetStats();
+
+private:
+    /***************************************** ATTRIBUTES *****************************************/
+    float    fKp_;              /**< Proportional gain [rad/rpm]                         */
+    float    fKi_;              /**< Integral gain [rad/(rpm*s)]                         */
+    float    fIntegral_;        /**< Integral term [rad]                                 */
+    float    fSquaredErrorSum_; /**< Sum of the squared speed errors [rpm^2]             */
+    uint32_t ulActiveSteps_;    /**< Steps counted in fSquaredErrorSum_                  */
+    uint32_t ulSaturatedSteps_; /**< Steps with the correction at its lower limit        */
+};
+
+#endif /* ROTOR_REGULATOR_H_ */
@@ -0,0 +1,191 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+
+/* Custom includes */
+#include "TelemetryGovernor.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the telemetry governor class
+***************************************************************************************************/
+TelemetryGovernor_cl::TelemetryGovernor_cl()
+{
+    for (unsigned char ucActivity = 0; ucActivity < TELEMETRYACTIVITY_COUNT; ucActivity++)
+    {
+        aulPeriodsMs_[ucActivity] = 0;
+    }
+    ulPeriodMs_           = 0;
+    eActivity_            = TELEMETRYACTIVITY_URGENT;
+    ulLastFrameMs_        = 0;
+    ulLinkBytesPerSecond_ = 0;
+    ulTokenRate_          = 0;
+    slTokens_             = 0;
+    ulLastRefillMs_       = 0;
+    ulWindowBytes_        = 0;
+    ulWindowStartMs_      = 0;
+    ucLoadPercent_        = 0;
+    ulDeferred_           = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Setup the class
+* \param[in] ulUrgentPeriodMs: Period of the frames with TELEMETRYACTIVITY_URGENT (task period) [ms]
+* \param[in] ulActivePeriodMs: Period of the frames with TELEMETRYACTIVITY_ACTIVE [ms]
+* \param[in] ulSteadyPeriodMs: Period of the frames with TELEMETRYACTIVITY_STEADY [ms]
+* \param[in] ulLinkBytesPerSecond: Capacity of the link [bytes/s]
+* \param[in] ucMaxLoadPercent: Share of the capacity the telemetry can use [%]
+***************************************************************************************************/
+void TelemetryGovernor_cl::vSetup(const unsigned long ulUrgentPeriodMs,
+                                  const unsigned long ulActivePeriodMs,
+                                  const unsigned long ulSteadyPeriodMs,
+                                  const unsigned long ulLinkBytesPerSecond,
+                                  const unsigned char ucMaxLoadPercent)
+{
+    aulPeriodsMs_[TELEMETRYACTIVITY_URGENT] = ulUrgentPeriodMs;
+    aulPeriodsMs_[TELEMETRYACTIVITY_ACTIVE] = ulActivePeriodMs;
+    aulPeriodsMs_[TELEMETRYACTIVITY_STEADY] = ulSteadyPeriodMs;
+    ulLinkBytesPerSecond_ = ulLinkBytesPerSecond;
+    ulTokenRate_          = ulLinkBytesPerSecond * ucMaxLoadPercent / 100;
+
+    /* Fast frames until the first activity is known. The budget starts full */
+    eActivity_  = TELEMETRYACTIVITY_URGENT;
+    ulPeriodMs_ = ulUrgentPeriodMs;
+    slTokens_   = TELEMETRY_BURST_BYTES_UL * 1000;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function sets the current activity of the turbine (see NOTE1)
+* \param[in] eActivity: Activity level
+***************************************************************************************************/
+void TelemetryGovernor_cl::vSetActivity(const TelemetryActivity_e eActivity)
+{
+    if (eActivity >= TELEMETRYACTIVITY_COUNT)
+    {
+        return;
+    }
+
+    eActivity_ = eActivity;
+    if (aulPeriodsMs_[eActivity] < ulPeriodMs_)
+    {
+        ulPeriodMs_ = aulPeriodsMs_[eActivity];
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function checks if the period of the frames has elapsed (see NOTE3)
+* \param[in] ulNowMs: Current time [ms]
+* \return True if a frame has to be sent
+***************************************************************************************************/
+bool TelemetryGovernor_cl::bIsFrameDue(const unsigned long ulNowMs)
+{
+    vRefill(ulNowMs);
+    return ulNowMs - ulLastFrameMs_ + aulPeriodsMs_[TELEMETRYACTIVITY_URGENT] / 2 >= ulPeriodMs_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function notifies that a frame has been sent
+* \param[in] ulNowMs: Current time [ms]
+***************************************************************************************************/
+void TelemetryGovernor_cl::vFrameSent(const unsigned long ulNowMs)
+{
+    ulLastFrameMs_ = ulNowMs;
+
+    /* Lower activity, one step towards its period */
+    unsigned long ulTargetMs = aulPeriodsMs_[eActivity_];
+    if (ulPeriodMs_ < ulTargetMs)
+    {
+        ulPeriodMs_ = 2 * ulPeriodMs_ < ulTargetMs ? 2 * ulPeriodMs_ : ulTargetMs;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function takes the budget of a deferrable message, if there is enough (see NOTE2)
+* \param[in] ulBytes: Bytes of the message
+* \param[in] ulNowMs: Current time [ms]
+* \return True if the message can be sent
+***************************************************************************************************/
+bool TelemetryGovernor_cl::bReserve(const unsigned long ulBytes, const unsigned long ulNowMs)
+{
+    vRefill(ulNowMs);
+    if (slTokens_ < static_cast<int32_t>(ulBytes * 1000))
+    {
+        ulDeferred_++;
+        return false;
+    }
+
+    slTokens_      -= static_cast<int32_t>(ulBytes * 1000);
+    ulWindowBytes_ += ulBytes;
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function takes the budget of a message that is always sent (see NOTE2)
+* \param[in] ulBytes: Bytes of the message
+* \param[in] ulNowMs: Current time [ms]
+***************************************************************************************************/
+void TelemetryGovernor_cl::vConsume(const unsigned long ulBytes, const unsigned long ulNowMs)
+{
+    vRefill(ulNowMs);
+    slTokens_      -= static_cast<int32_t>(ulBytes * 1000);
+    ulWindowBytes_ += ulBytes;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the current period of the frames
+* \return Period [ms]
+***************************************************************************************************/
+unsigned long TelemetryGovernor_cl::ulGetPeriodMs() const
+{
+    return ulPeriodMs_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the link load (see NOTE4)
+* \return Share of the link capacity used [%]
+***************************************************************************************************/
+unsigned char TelemetryGovernor_cl::ucGetLoadPercent() const
+{
+    return ucLoadPercent_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the number of deferrable messages held back by the budget since the
+* start
+* \return Number of messages
+***************************************************************************************************/
+uint32_t TelemetryGovernor_cl::ulGetDeferred() const
+{
+    return ulDeferred_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds the tokens earned since the last call, and closes the load window if
+* it has elapsed
+* \param[in] ulNowMs: Current time [ms]
+***************************************************************************************************/
+void TelemetryGovernor_cl::vRefill(const unsigned long ulNowMs)
+{
+    /* Tokens. The elapsed time is limited, so the product can't overflow after a long pause (the
+    bucket is full anyway) */
+    unsigned long ulElapsedMs = ulNowMs - ulLastRefillMs_;
+    ulLastRefillMs_ = ulNowMs;
+    if (ulElapsedMs > TELEMETRY_LOAD_WINDOW_MS_UL)
+    {
+        ulElapsedMs = TELEMETRY_LOAD_WINDOW_MS_UL;
+    }
+    slTokens_ += static_cast<int32_t>(ulElapsedMs * ulTokenRate_);
+    if (slTokens_ > static_cast<int32_t>(TELEMETRY_BURST_BYTES_UL * 1000))
+    {
+        slTokens_ = TELEMETRY_BURST_BYTES_UL * 1000;
+    }
+
+    /* Link load */
+    unsigned long ulWindowMs = ulNowMs - ulWindowStartMs_;
+    if (ulWindowMs >= TELEMETRY_LOAD_WINDOW_MS_UL && ulLinkBytesPerSecond_ > 0)
+    {
+        unsigned long ulLoadPercent = ulWindowBytes_ * 100000UL / (ulLinkBytesPerSecond_ * ulWindowMs);
+        ucLoadPercent_   = ulLoadPercent < 100 ? ulLoadPercent : 100;
+        ulWindowBytes_   = 0;
+        ulWindowStartMs_ = ulNowMs;
+    }
+}
@@ -0,0 +1,133 @@
+#ifndef TELEMETRY_GOVERNOR_H_
+#define TELEMETRY_GOVERNOR_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+#include "Types.h"
+
+
+/*
+- NOTE1: Rate of the fast telemetry (kinematic data). Each activity level of the turbine has its own
+period. A higher activity shortens the period at once, and a lower one lengthens it step by step
+(doubling it with each frame), so a short calm inside a gust doesn't make the rate flap
+- NOTE2: All the messages sent to the link go through the budget, a token bucket refilled at the
+allowed share of the link capacity (ucMaxLoadPercent) and limited to TELEMETRY_BURST_BYTES_UL.
+Deferrable messages (kinematic data, environment, flight recorder chunks) are only sent if there are
+enough tokens (bReserve()). The status is always sent (vConsume()), and the debt is paid by the
+next deferrable messages
+- NOTE3: bIsFrameDue() must be called with the period of the highest activity (the task period).
+A frame is due up to half a task period early, so the task jitter doesn't skip a whole period
+- NOTE4: The link load is the share of the link capacity used in the last TELEMETRY_LOAD_WINDOW_MS_UL
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned long TELEMETRY_BURST_BYTES_UL    = 64;   /**< Largest burst allowed by the budget (UART buffer) */
+const unsigned long TELEMETRY_LOAD_WINDOW_MS_UL = 1000; /**< Window of the link load measurement [ms]          */
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class TelemetryGovernor_cl
+ * \brief Rate of the telemetry driven by the activity of the turbine, within a link budget
+ **************************************************************************************************/
+class TelemetryGovernor_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the telemetry governor class
+    ***********************************************************************************************/
+    TelemetryGovernor_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Setup the class
+    * \param[in] ulUrgentPeriodMs: Period of the frames with TELEMETRYACTIVITY_URGENT (task period) [ms]
+    * \param[in] ulActivePeriodMs: Period of the frames with TELEMETRYACTIVITY_ACTIVE [ms]
+    * \param[in] ulSteadyPeriodMs: Period of the frames with TELEMETRYACTIVITY_STEADY [ms]
+    * \param[in] ulLinkBytesPerSecond: Capacity of the link [bytes/s]
+    * \param[in] ucMaxLoadPercent: Share of the capacity the telemetry can use [%]
+    ***********************************************************************************************/
+    void vSetup(const unsigned long ulUrgentPeriodMs,
+                const unsigned long ulActivePeriodMs,
+                const unsigned long ulSteadyPeriodMs,
+                const unsigned long ulLinkBytesPerSecond,
+                const unsigned char ucMaxLoadPercent);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function sets the current activity of the turbine (see NOTE1)
+    * \param[in] eActivity: Activity level
+    ***********************************************************************************************/
+    void vSetActivity(const TelemetryActivity_e eActivity);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function checks if the period of the frames has elapsed (see NOTE3)
+    * \param[in] ulNowMs: Current time [ms]
+    * \return True if a frame has to be sent
+    ***********************************************************************************************/
+    bool bIsFrameDue(const unsigned long ulNowMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function notifies that a frame has been sent
+    * \param[in] ulNowMs: Current time [ms]
+    ***********************************************************************************************/
+    void vFrameSent(const unsigned long ulNowMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function takes the budget of a deferrable message, if there is enough (see NOTE2)
+    * \param[in] ulBytes: Bytes of the message
+    * \param[in] ulNowMs: Current time [ms]
+    * \return True if the message can be sent
+    ***********************************************************************************************/
+    bool bReserve(const unsigned long ulBytes, const unsigned long ulNowMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function takes the budget of a message that is always sent (see NOTE2)
+    * \param[in] ulBytes: Bytes of the message
+    * \param[in] ulNowMs: Current time [ms]
+    ***********************************************************************************************/
+    void vConsume(const unsigned long ulBytes, const unsigned long ulNowMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the current period of the frames
+    * \return Period [ms]
+    ***********************************************************************************************/
+    unsigned long ulGetPeriodMs() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the link load (see NOTE4)
+    * \return Share of the link capacity used [%]
+    ***********************************************************************************************/
+    unsigned char ucGetLoadPercent() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the number of deferrable messages held back by the budget since the
+    * start
+    * \return Number of messages
+    ***********************************************************************************************/
+    uint32_t ulGetDeferred() const;
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds the tokens earned since the last call, and closes the load window if
+    * it has elapsed
+    * \param[in] ulNowMs: Current time [ms]
+    ***********************************************************************************************/
+    void vRefill(const unsigned long ulNowMs);
+
+    /***************************************** ATTRIBUTES *****************************************/
+    unsigned long       aulPeriodsMs_[TELEMETRYACTIVITY_COUNT]; /**< Period of each activity level [ms]          */
+    unsigned long       ulPeriodMs_;                            /**< Current period [ms]                         */
+    TelemetryActivity_e eActivity_;                             /**< Current activity level                      */
+    unsigned long       ulLastFrameMs_;                         /**< Time of the last frame [ms]                 */
+    unsigned long       ulLinkBytesPerSecond_;                  /**< Capacity of the link [bytes/s]              */
+    unsigned long       ulTokenRate_;                           /**< Tokens earned [bytes/s = millibytes/ms]     */
+    int32_t             slTokens_;                              /**< Budget, negative after a debt [millibytes]  */
+    unsigned long       ulLastRefillMs_;                        /**< Time of the last refill [ms]                */
+    unsigned long       ulWindowBytes_;                         /**< Bytes sent in the current load window       */
+    unsigned long       ulWindowStartMs_;                       /**< Start of the current load window [ms]       */
+    unsigned char       ucLoadPercent_;                         /**< Load measured in the last window [%]        */
+    uint32_t            ulDeferred_;                            /**< Messages held back by the budget            */
+};
+
+#endif /* TELEMETRY_GOVERNOR_H_ */
@@ -3,11 +3,72 @@
 
 /******************************************** INCLUDES ********************************************/
 /* System includes */
+#include <stdint.h>
+#include <CommonTypes.h>
 
 /* Custom includes */
 
 
 /********************************************** TYPES *********************************************/
+/***********************************************************************************************//**
+ * \enum PitchControlMethod_e
+ * \brief Method used to compute the actuator extension in automatic pitch mode
+ **************************************************************************************************/
+enum PitchControlMethod_e
+{
+    PITCHCONTROL_BETA_FLOAT  = 0, /**< Aerodynamic angle and 1D calibration curve, floating point  */
+    PITCHCONTROL_BETA_Q16    = 1, /**< Aerodynamic angle and 1D calibration curve, Q16 fixed point */
+    PITCHCONTROL_SCHEDULE_2D = 2, /**< 2D schedule over wind speed and rotor speed                 */
+};
+
+/***********************************************************************************************//**
+ * \enum IsrSource_e
+ * \brief Sources measured by the interrupt monitor (ISR_MONITOR_ENABLED)
+ **************************************************************************************************/
+enum IsrSource_e
+{
+    ISRSOURCE_ANEMOMETER = 0, /**< Anemometer hall sensor ISR                         */
+    ISRSOURCE_TACOMETER  = 1, /**< Tacometer hall sensor ISR                          */
+    ISRSOURCE_DHT22      = 2, /**< Longest interrupt latency while reading the DHT22 */
+    ISRSOURCE_SERVO      = 3, /**< Pitch servo hall sensor ISR                       */
+};
+
+/***********************************************************************************************//**
+ * \struct ActuatorPosition_st
+ * \brief Position of the actuators stored in the EEPROM journal, to skip the calibration at startup
+ **************************************************************************************************/
+struct ActuatorPosition_st
+{
+    int16_t       sServoTurns;  /**< Pitch servo gear turns, or UNKNOWN_TURNS_UL if it was moving         */
+    BreakStatus_e eBreakStatus; /**< BREAK_DISABLED, BREAK_ENABLED, or BREAK_INITIALIZING if it was moving */
+};
+
+/***********************************************************************************************//**
+ * \enum BreakEvent_e
+ * \brief Events processed by the break state machine
+ **************************************************************************************************/
+enum BreakEvent_e
+{
+    BREAKEVENT_OVERSPEED      = 0, /**< Rotor speed over threshold                                  */
+    BREAKEVENT_OVERWIND       = 1, /**< Average wind speed over threshold                           */
+    BREAKEVENT_MANUAL         = 2, /**< Rotor break manually requested                              */
+    BREAKEVENT_OVERSPEED_TRIP = 3, /**< The tacometer ISR already energised the break relay          */
+    BREAKEVENT_TIMER_EXPIRED  = 4, /**< End of the current actuator manoeuvre                       */
+    BREAKEVENT_RELEASE        = 5, /**< None of the break conditions is satisfied                   */
+    BREAKEVENT_COUNT          = 6, /**< Number of events                                            */
+};
+
+/***********************************************************************************************//**
+ * \enum TelemetryActivity_e
+ * \brief Activity of the turbine, that sets the rate of the telemetry (see TelemetryGovernor.h)
+ **************************************************************************************************/
+enum TelemetryActivity_e
+{
+    TELEMETRYACTIVITY_STEADY = 0, /**< Steady readings                             */
+    TELEMETRYACTIVITY_ACTIVE = 1, /**< Gusts or fast changes of the rotor speed    */
+    TELEMETRYACTIVITY_URGENT = 2, /**< Break manoeuvre or fast pitch motion        */
+    TELEMETRYACTIVITY_COUNT  = 3, /**< Number of activity levels                   */
+};
 
 
 #endif // TYPES_H_
\ No newline at end of file
@@ -1,15 +1,25 @@
 /******************************************** INCLUDES ********************************************/
+/* Build options (must be defined before the includes) */
+#define PROFILING_ENABLED 0       /**< Set to 1 to measure execution times and report them on PROFILING_SERIAL */
+#define PROFILING_SERIAL  Serial3 /**< Port of the profiling report (Serial carries the messages of the host tool)  */
+
 /* System includes */
 #include <stdlib.h>
-#include <Metro.h>
 #include <Wire.h>
 #include <LiquidCrystal_I2C.h>
 #include <SoftwareSerial.h>
 #include <CommonTypes.h>
+#include <AdcSampler.h>
 #include <CommsManager.h>
+#include <NumberFormat.h>
+#include <Profiler.h>
+#include <TaskScheduler.h>
+#include <Telemetry.h>
 
 /* Custom includes */
 #include "Constants.h"
+#include "ControlArbiter.h"
+#include "LcdFramebuffer.h"
 #include "Types.h"
 
 
@@ -17,25 +27,40 @@
 /* Operational data */
 AeroData_st      stAeroData_      = {};	                   /**< Current data 				 */
 ControlParams_st stControlParams_ = {};	                   /**< Control requests by the user */
-UserMaster_e     eUserMaster_     = DEFAULT_USER_MASTER_E; /**< Default control master		 */
+
+/* Control sources (see ControlArbiter.h) */
+ControlArbiter_cl clArbiter_;         /**< Ownership of each field of the control parameters */
+unsigned char     ucPanelSource_ = 0; /**< Physical controls of the panel                    */
+unsigned char     ucHostSource_  = 0; /**< Host tool on the USB port                         */
+unsigned char     ucAppSource_   = 0; /**< Android app, through the ESP8266                  */
 
 /* LCD screen */
-LiquidCrystal_I2C clLCD_(0x27, 20, 4);             /**< Class for the LCD management */
-Metro clLCDTimer_ = Metro(LCD_REFRESH_TIME_MS_UL); /**< LCD refresh timer            */
+LiquidCrystal_I2C clLCD_(0x27, LCD_COLUMNS_UC, LCD_ROWS_UC); /**< Class for the LCD management          */
+LcdFramebuffer_cl clScreen_;                                 /**< Shadow copy of the LCD screen content */
 
-/* HC12 Variables */
-Metro clSenderHC12Timer_ = Metro(HC12_SEND_PERIOD_MS_UL); /**< HC12 timer to send messages */
+/* Panel potentiometers */
+AdcSampler_cl clAdcSampler_;         /**< Interrupt driven sampling of the potentiometers */
+unsigned char ucMaxRPMChannel_  = 0; /**< Sampler channel of the RPM potentiometer        */
+unsigned char ucMaxWindChannel_ = 0; /**< Sampler channel of the wind potentiometer       */
+unsigned char ucPitchChannel_   = 0; /**< Sampler channel of the pitch potentiometer      */
 
-/* ESP8266 wifi module */
-Metro clSenderESP8266Timer = Metro(ESP8266_SEND_PERIOD_MS_UL);  /**< ESP8266 timer to send messages */
+/* Task scheduling */
+TaskScheduler_cl clScheduler_; /**< Scheduler that runs all periodic tasks */
+#if PROFILING_ENABLED
+Profiler_cl      clProfiler_;  /**< Execution time profiler (used by PROFILE_SCOPE) */
+#endif
 
 /* Communications variables */
-const unsigned int MAX_MSG_SIZE_UL_ = sizeof(ControlParams_st) > sizeof(AeroData_st) ? 
-									  sizeof(ControlParams_st) : sizeof(AeroData_st);
+const unsigned int MAX_TELEMETRY_SIZE_UL_ = sizeof(ControlParams_st) > sizeof(KinematicData_st) ? 
+											sizeof(ControlParams_st) : sizeof(KinematicData_st);
+const unsigned int MAX_MSG_SIZE_UL_ = sizeof(RecorderChunk_st) > MAX_TELEMETRY_SIZE_UL_ ? 
+									  sizeof(RecorderChunk_st) : MAX_TELEMETRY_SIZE_UL_;
 unsigned char aucReadingBuf_[MAX_MSG_SIZE_UL_];
 CommsManager_cl clCommsManagerHC12_;
 CommsManager_cl clCommsManagerESP8266_;
-unsigned long ulLastEsp8266Time_ = -ANDROID_TIMEOUT_MS_UL; /**< Time of the last message received from the wifi module */
+CommsManager_cl clCommsManagerHost_;
+bool bStatusPending_      = false; /**< A status message has been received and not sent to the ESP8266 yet      */
+bool bEnvironmentPending_ = false; /**< An environment message has been received and not sent to the ESP8266 yet */
 
 /* Auxiliary variables */
 unsigned int ulLastBreakSwitchReading_ = -1; /**< Variable to hold last reading of break switch        */
@@ -53,17 +78,15 @@ void setup()
 	/* Start LCD screen */
 	clLCD_.begin();
 	clLCD_.backlight();
-	clLCD_.clear(); /* Clear text */
+	clLCD_.clear(); /* Clear text (the framebuffer starts with the same empty screen) */
 
 	/* Set base text on the screen */
-	clLCD_.setCursor(0, 0);
-	clLCD_.print("Temp: xx.x C HR: xx%"); /* Line 1 */
-	clLCD_.setCursor(0, 1);
-	clLCD_.print("Wind:xxm/s Max:xxm/s"); /* Line 2 */
-	clLCD_.setCursor(0, 2);
-	clLCD_.print("RPM: xxx   Max: xxx"); /* Line 3 */
-	clLCD_.setCursor(0, 3);
-	clLCD_.print("Paso          xxx% "); /* Line 3 */
+	clScreen_.vPrint(0, 0, "Temp: xx.x C HR: xx%"); /* Line 1 */
+	clScreen_.vPrint(0, 1, "Wind:xxm/s Max:xxm/s"); /* Line 2 */
+	clScreen_.vPrint(0, 2, "RPM: xxx   Max: xxx");  /* Line 3 */
+	clScreen_.vPrint(0, 3, "Paso          xxx% ");  /* Line 4 */
+	clScreen_.vFlush(clLCD_);
+	clScreen_.vResetStats(); /* Only the flushes of the main loop are measured */
 
 	/* Initialize Arduino pins */
 	pinMode(MANUAL_BREAK_PIN_UL, INPUT);         /* Reading of break switch     */
@@ -73,6 +96,18 @@ void setup()
 	pinMode(HC12_MODE_PIN_UL, OUTPUT);           /* HC12 mode selection         */
 	pinMode(PITCH_CONTROL_SWITCH_PIN_UL, INPUT); /* Manual/automatic pitch mode */
 
+	/* Start the sampling of the potentiometers (analogRead() can't be used after this) */
+	ucMaxRPMChannel_  = clAdcSampler_.ucAddChannel(MAX_RPM_POT_PIN_UL);
+	ucMaxWindChannel_ = clAdcSampler_.ucAddChannel(MAX_WIND_POT_UL);
+	ucPitchChannel_   = clAdcSampler_.ucAddChannel(SLIDER_PITCH_PIN_UL);
+	clAdcSampler_.vBegin();
+
+	/* Control sources. The panel takes any field at once, the others wait for the lease of the
+	owner to expire */
+	ucPanelSource_ = clArbiter_.ucAddSource(CONTROL_PRIORITY_PANEL_UC, CONTROL_LEASE_PANEL_MS_UL);
+	ucHostSource_  = clArbiter_.ucAddSource(CONTROL_PRIORITY_HOST_UC,  CONTROL_LEASE_HOST_MS_UL);
+	ucAppSource_   = clArbiter_.ucAddSource(CONTROL_PRIORITY_APP_UC,   CONTROL_LEASE_APP_MS_UL);
+
 	/* Set HC12 in transparent mode */
 	digitalWrite(HC12_MODE_PIN_UL, HIGH);
 
@@ -81,6 +116,25 @@ void setup()
 	Serial.begin(COMMS_BAUD_RATE_UL);  /* Initialize serial port to communicate with the PC      */
 	Serial2.begin(COMMS_BAUD_RATE_UL); /* Initialize serial port to communicate with the ESP8266 */
 	Serial1.begin(COMMS_BAUD_RATE_UL); /* Initialize serial port to communicate with the HC12    */
+#if PROFILING_ENABLED
+	PROFILING_SERIAL.begin(COMMS_BAUD_RATE_UL); /* Text report, never mixed with the binary messages */
+#endif
+
+	/* Task scheduling. User controls (manual break) run ahead of everything else, and the LCD (slow
+	I2C writes) runs last. The screen is written in the framebuffer every LCD_REFRESH_TIME_MS_UL, and
+	sent to the LCD a few characters per pass */
+	clScheduler_.ucAddTask(vReadUserInputs,             USER_INPUTS_PERIOD_MS_UL,  USER_INPUTS_PERIOD_MS_UL,  TASK_PRIORITY_USER_INPUTS_UC);
+	clScheduler_.ucAddTask(vSendDataHC12,               HC12_SEND_PERIOD_MS_UL,    HC12_SEND_PERIOD_MS_UL,    TASK_PRIORITY_CONTROL_COMMS_UC);
+	clScheduler_.ucAddTask(vReadDataHC12,               SERIAL_READ_PERIOD_MS_UL,  SERIAL_READ_PERIOD_MS_UL,  TASK_PRIORITY_CONTROL_COMMS_UC);
+	clScheduler_.ucAddTask(vReadDataESP8266,            SERIAL_READ_PERIOD_MS_UL,  SERIAL_READ_PERIOD_MS_UL,  TASK_PRIORITY_APP_COMMS_UC);
+	clScheduler_.ucAddTask(vReadDataHost,               SERIAL_READ_PERIOD_MS_UL,  SERIAL_READ_PERIOD_MS_UL,  TASK_PRIORITY_APP_COMMS_UC);
+	clScheduler_.ucAddTask(vSendDataESP8266,            ESP8266_SEND_PERIOD_MS_UL, ESP8266_SEND_PERIOD_MS_UL, TASK_PRIORITY_APP_COMMS_UC);
+	clScheduler_.ucAddTask(vManageBreakLed,             BREAK_LED_PERIOD_MS_UL,    BREAK_LED_PERIOD_MS_UL,    TASK_PRIORITY_DISPLAY_UC);
+	clScheduler_.ucAddTask(vRefreshScreen,              LCD_REFRESH_TIME_MS_UL,    0,                         TASK_PRIORITY_DISPLAY_UC);
+	clScheduler_.ucAddTask(vFlushScreen,                0,                         0,                         TASK_PRIORITY_DISPLAY_UC);
+#if PROFILING_ENABLED
+	clScheduler_.ucAddTask(vReportProfiling,            PROFILING_REPORT_PERIOD_MS_UL, 0,                     TASK_PRIORITY_DISPLAY_UC);
+#endif
 }
 
 /****************************************** FUNCTION *******************************************//**
@@ -88,102 +142,105 @@ void setup()
 ***************************************************************************************************/
 void loop() 
 {
-	/* Manage transition of the master control */
-	vMasterTransitionManagement();
-
-	/* Read user controls */
-	vReadUserInputs();
-
-	/* Read data from the Arduino Control */
-	vReadDataHC12();
-
-	/* Read data from the Android app */
-	vReadDataESP8266();
-
-	/* Updates screen data */
-	vRefreshScreen();
-
-	/* Send data to Arduino Control */
-	vSendDataHC12();
-
-	/* Send data to the Android app */
-	vSendDataESP8266();
-
-	/* Update the break led */
-	vManageBreakLed();
+	/* Run the tasks that are ready, most critical first */
+	PROFILE_SCOPE("loop");
+	clScheduler_.vRun();
 }
 
+#if PROFILING_ENABLED
 /****************************************** FUNCTION *******************************************//**
-* \brief This method manages who is in controll of the wind turbine
+* \brief Task that writes the profiling report to PROFILING_SERIAL (pins 14 and 15, through a USB
+* to serial adapter). The USB Serial is the link of the host tool, whose binary messages must not be
+* interleaved with text. At 9600 bauds, it blocks for ~0.5 s while the data is sent
 ***************************************************************************************************/
-void vMasterTransitionManagement() 
+void vReportProfiling()
 {
-	/* Check time from the last message received from the ESP8266. If it is over a specific 
-	threshold, give control to Arduino */
-	if (millis() - ulLastEsp8266Time_ > ANDROID_TIMEOUT_MS_UL) 
-	{
-		eUserMaster_ = USERMASTER_ARDUINO; 
-	}
-	else 
-	{
-		eUserMaster_ = USERMASTER_ANDROID; 			
-	}
+	PROFILING_SERIAL.println(F("--- Profiling [us] ---"));
+	clProfiler_.vPrintReport(PROFILING_SERIAL);
+	clScheduler_.vPrintStats(PROFILING_SERIAL);
+
+	/* Operations sent to the LCD (each one is a LiquidCrystal_I2C::send()) */
+	const LcdStats_st& stLcdStats = clScreen_.stGetStats();
+	PROFILING_SERIAL.print(F("LCD flushes: "));
+	PROFILING_SERIAL.print(stLcdStats.ulFlushes);
+	PROFILING_SERIAL.print(F(" chars: "));
+	PROFILING_SERIAL.print(stLcdStats.ulChars);
+	PROFILING_SERIAL.print(F(" moves: "));
+	PROFILING_SERIAL.print(stLcdStats.ulCursorMoves);
+	PROFILING_SERIAL.print(F(" max sends: "));
+	PROFILING_SERIAL.print(stLcdStats.usMaxSends);
+	PROFILING_SERIAL.print(F(" max flush [us]: "));
+	PROFILING_SERIAL.println(stLcdStats.ulMaxFlushUs);
+
+	/* Arbitration of the control sources */
+	const ControlArbiterStats_st& stArbiterStats = clArbiter_.stGetStats();
+	PROFILING_SERIAL.print(F("Control grants: "));
+	PROFILING_SERIAL.print(stArbiterStats.ulGrants);
+	PROFILING_SERIAL.print(F(" denials: "));
+	PROFILING_SERIAL.print(stArbiterStats.ulDenials);
+	PROFILING_SERIAL.print(F(" handovers: "));
+	PROFILING_SERIAL.print(stArbiterStats.ulHandovers);
+	PROFILING_SERIAL.print(F(" max handover [ms]: "));
+	PROFILING_SERIAL.println(stArbiterStats.ulMaxHandoverMs);
 }
+#endif
 
 /****************************************** FUNCTION *******************************************//**
 * \brief This method reads all inputs the user can control from hardware elements
 ***************************************************************************************************/
 void vReadUserInputs() 
 {
-	/* User inputs are read in every iteration of the main loop, but variables are updated only if
-	a physical change is detected. The objetive is that, when transitioning from Android control to
-	Arduino control, variables set using Android to not automatically change to values set in 
-	potentiometers. Hold Android values until a physical change */
-
-	/* Read data only if the Arduino is the master */
-	if (eUserMaster_ == USERMASTER_ARDUINO) 
+	PROFILE_SCOPE("inputs");
+
+	/* User inputs are read in every iteration of the main loop, but fields are only requested to the
+	arbiter if a physical change is detected. The objetive is that, when the panel gets the control
+	back, values set by other sources are not automatically changed to the values set in the
+	potentiometers. Hold those values until a physical change. A change that is denied (the field is
+	held by another source) is requested again in the next passes, until it is granted */
+	unsigned long ulNowMs = millis();
+
+	/* Break switch reading */
+	if (static_cast<unsigned int>(ulLastBreakSwitchReading_) != digitalRead(MANUAL_BREAK_PIN_UL) &&
+		clArbiter_.bRequest(ucPanelSource_, CONTROLFIELD_MANUAL_BREAK, ulNowMs)) 
 	{
-		/* Break switch reading */
-		if (static_cast<unsigned int>(ulLastBreakSwitchReading_) != digitalRead(MANUAL_BREAK_PIN_UL)) 
-		{
-			stControlParams_.eManualBreak = static_cast<ManualBreak_e>(digitalRead(MANUAL_BREAK_PIN_UL));
-			ulLastBreakSwitchReading_ = static_cast<bool>(stControlParams_.eManualBreak);
-		}
+		stControlParams_.eManualBreak = static_cast<ManualBreak_e>(digitalRead(MANUAL_BREAK_PIN_UL));
+		ulLastBreakSwitchReading_ = static_cast<bool>(stControlParams_.eManualBreak);
+	}
 
-		/* Max RPM potentiometer reading */
-		int ulPotReading = analogRead(MAX_RPM_POT_PIN_UL);
-		ulPotReading = map(ulPotReading, 0, 1023, 0, MAX_RPM_F);
-		if (ulLastMaxRPMReading_ != ulPotReading) 
-		{
-			stControlParams_.fMaxRotorSpeedRPM = ulPotReading;
-			ulLastMaxRPMReading_ = ulPotReading;
-		}
+	/* Max RPM potentiometer reading. Filtered values from the ADC interrupt, they only change when
+	the potentiometer is moved */
+	int ulPotReading = clAdcSampler_.usGetValue(ucMaxRPMChannel_);
+	ulPotReading = map(ulPotReading, 0, ADC_SAMPLER_FULL_SCALE_US, 0, MAX_RPM_F);
+	if (ulLastMaxRPMReading_ != ulPotReading && clArbiter_.bRequest(ucPanelSource_, CONTROLFIELD_MAX_RPM, ulNowMs)) 
+	{
+		stControlParams_.fMaxRotorSpeedRPM = ulPotReading;
+		ulLastMaxRPMReading_ = ulPotReading;
+	}
 
-		/* Max wind potentiometer reading */
-		ulPotReading = analogRead(MAX_WIND_POT_UL);
-		ulPotReading = map(ulPotReading, 0, 1023, 0, MAX_WIND_F);
-		if (ulLastMaxWindReading_ != ulPotReading) 
-		{
-			stControlParams_.fMaxWindSpeed = ulPotReading;
-			ulLastMaxWindReading_ = ulPotReading;
-		}
+	/* Max wind potentiometer reading */
+	ulPotReading = clAdcSampler_.usGetValue(ucMaxWindChannel_);
+	ulPotReading = map(ulPotReading, 0, ADC_SAMPLER_FULL_SCALE_US, 0, MAX_WIND_F);
+	if (ulLastMaxWindReading_ != ulPotReading && clArbiter_.bRequest(ucPanelSource_, CONTROLFIELD_MAX_WIND, ulNowMs)) 
+	{
+		stControlParams_.fMaxWindSpeed = ulPotReading;
+		ulLastMaxWindReading_ = ulPotReading;
+	}
 
-		/* Pitch control potentiometer reading */
-		ulPotReading = analogRead(SLIDER_PITCH_PIN_UL);
-		ulPotReading = map(ulPotReading, 0, 1023, 100, 0);
-		if (ulLastPitchReading_ != ulPotReading) 
-		{
-			stControlParams_.fBladePitchPercentage = ulPotReading;
-			ulLastPitchReading_ = ulPotReading;
-		}
+	/* Pitch control potentiometer reading */
+	ulPotReading = clAdcSampler_.usGetValue(ucPitchChannel_);
+	ulPotReading = map(ulPotReading, 0, ADC_SAMPLER_FULL_SCALE_US, 100, 0);
+	if (ulLastPitchReading_ != ulPotReading && clArbiter_.bRequest(ucPanelSource_, CONTROLFIELD_PITCH, ulNowMs)) 
+	{
+		stControlParams_.fBladePitchPercentage = ulPotReading;
+		ulLastPitchReading_ = ulPotReading;
+	}
 
-		/* Pitch control mode reading */
-		int switchReading = digitalRead(PITCH_CONTROL_SWITCH_PIN_UL);
-		if (ulLastPitchModeReading_ != switchReading) 
-		{
-			stControlParams_.ePitchMode = static_cast<PitchMode_e>(switchReading);
-			ulLastPitchModeReading_ = switchReading;
-		}
+	/* Pitch control mode reading */
+	int switchReading = digitalRead(PITCH_CONTROL_SWITCH_PIN_UL);
+	if (ulLastPitchModeReading_ != switchReading && clArbiter_.bRequest(ucPanelSource_, CONTROLFIELD_PITCH_MODE, ulNowMs)) 
+	{
+		stControlParams_.ePitchMode = static_cast<PitchMode_e>(switchReading);
+		ulLastPitchModeReading_ = switchReading;
 	}
 }
 
@@ -192,6 +249,8 @@ void vReadUserInputs()
 ***************************************************************************************************/
 void vReadDataHC12() 
 {
+	PROFILE_SCOPE("HC12 read");
+
 	/* Create a variable for the message length and other one for the message ID */
 	unsigned int ulMsgLength = 0;
 	MessageID_e eMsgID = MESSAGEID_COUNT;
@@ -199,10 +258,25 @@ void vReadDataHC12()
 	/* Check if there is input data */
 	while (clCommsManagerHC12_.bReadInputMessage(Serial1, aucReadingBuf_, ulMsgLength, eMsgID))
 	{
-		/* Copy the buffer to the message */
-		if ((eMsgID == MESSAGEID_AERODATA))
+		/* Telemetry. Each message updates its own fields of the turbine data (see Telemetry.h) */
+		if (bMergeTelemetry(eMsgID, aucReadingBuf_, stAeroData_))
+		{
+			/* Slow messages are forwarded to the ESP8266 in its next period */
+			if (eMsgID == MESSAGEID_STATUS)
+			{
+				bStatusPending_ = true;
+			}
+			else if (eMsgID == MESSAGEID_ENVIRONMENT)
+			{
+				bEnvironmentPending_ = true;
+			}
+		}
+		/* Flight recorder chunks are forwarded to the host tool that requested them */
+		else if (eMsgID == MESSAGEID_RECORDERCHUNK)
 		{
-			memcpy(&stAeroData_, aucReadingBuf_, sizeof(stAeroData_));
+			RecorderChunk_st stChunk;
+			memcpy(&stChunk, aucReadingBuf_, sizeof(stChunk));
+			clCommsManagerHost_.vSendMessage(stChunk, MESSAGEID_RECORDERCHUNK, Serial);
 		}
 	}
 }
@@ -212,6 +286,8 @@ void vReadDataHC12()
 ***************************************************************************************************/
 void vReadDataESP8266() 
 {
+	PROFILE_SCOPE("ESP read");
+
 	/* Create a variable for the message length and other one for the message ID */
 	unsigned int ulMsgLength = 0;
 	MessageID_e eMsgID = MESSAGEID_COUNT;
@@ -220,101 +296,172 @@ void vReadDataESP8266()
 	while (clCommsManagerESP8266_.bReadInputMessage(Serial2, aucReadingBuf_, ulMsgLength, eMsgID))
 	{
 		/* Copy the buffer to the message */
-		if ((eMsgID == MESSAGEID_CONTROLPARAMS) /*&& (eUserMaster_ == USERMASTER_ARDUINO)*/)
+		if (eMsgID == MESSAGEID_CONTROLPARAMS)
 		{
-			memcpy(&stControlParams_, &aucReadingBuf_[0], sizeof(stControlParams_));
-
-			/* Update reception time of last message */
-			ulLastEsp8266Time_ = millis();
+			ControlParams_st stRequest;
+			memcpy(&stRequest, &aucReadingBuf_[0], sizeof(stRequest));
+			vApplyRemoteParams(ucAppSource_, stRequest);
 		}
 	}
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief Method that writes information to the lcd screen
+* \brief Method that reads the control parameters sent by a host tool through the USB port (same
+* messages as the ESP8266)
 ***************************************************************************************************/
-void vRefreshScreen() 
+void vReadDataHost() 
 {
-	/* Check if it is time to refresh screen */
-	if (clLCDTimer_.check()) 
+	/* Create a variable for the message length and other one for the message ID */
+	unsigned int ulMsgLength = 0;
+	MessageID_e eMsgID = MESSAGEID_COUNT;
+
+	/* Check if there is input data */
+	while (clCommsManagerHost_.bReadInputMessage(Serial, aucReadingBuf_, ulMsgLength, eMsgID))
 	{
-		/* Declare auxiliary variable */
-		char scAuxText[5];
-
-		/* Update temperature. Convert to a char[]. We want 5 elements, including sign and decimal
-		separator, and only one decimal value */
-		dtostrf(stAeroData_.fTempCelsius, 5, 1, scAuxText);
-		clLCD_.setCursor(5, 0);
-		clLCD_.print(scAuxText[0]); /**< sign */
-		clLCD_.print(scAuxText[1]); /**< tens */
-		clLCD_.print(scAuxText[2]); /**< units */
-		clLCD_.print(scAuxText[3]); /**< decimal separator */
-		clLCD_.print(scAuxText[4]); /**< tenths */
-
-		/* Update humidity. Convert to a char[]. We want 3 digits with no comma or sign */
-		dtostrf(stAeroData_.fRelHumidity, 3, 0, scAuxText);
-		clLCD_.setCursor(16, 0);
-		clLCD_.print(scAuxText[0]); /**< hundreds */
-		clLCD_.print(scAuxText[1]); /**< tens  */
-		clLCD_.print(scAuxText[2]); /**< units */
-
-		/* Update wind speed. Convert to a char[]. We want 2 digits with no comma or sign */
-		dtostrf(stAeroData_.fWindSpeed, 2, 0, scAuxText);
-		clLCD_.setCursor(5, 1);
-		clLCD_.print(scAuxText[0]); /**< tens  */
-		clLCD_.print(scAuxText[1]); /**< units */
-
-		/* Update max wind speed. Convert to a char[]. We want 2 digits with no comma or sign */
-		dtostrf(stControlParams_.fMaxWindSpeed, 2, 0, scAuxText);
-		clLCD_.setCursor(15, 1);
-		clLCD_.print(scAuxText[0]); /**< tens  */
-		clLCD_.print(scAuxText[1]); /**< units */
-
-		/* Update rotor speed. Convert to a char[]. We want 3 digits with no comma or sign */
-		dtostrf(stAeroData_.fRotorSpeedRPM, 3, 0, scAuxText);
-		clLCD_.setCursor(5, 2);
-		clLCD_.print(scAuxText[0]); /**< hundreds */
-		clLCD_.print(scAuxText[1]); /**< tens  */
-		clLCD_.print(scAuxText[2]); /**< units */
-
-		/* Update max rotor speed. Convert to a char[]. We want 3 digits with no comma or sign */
-		dtostrf(stControlParams_.fMaxRotorSpeedRPM, 3, 0, scAuxText); 
-		clLCD_.setCursor(16, 2);
-		clLCD_.print(scAuxText[0]); /**< hundreds */
-		clLCD_.print(scAuxText[1]); /**< tens  */
-		clLCD_.print(scAuxText[2]); /**< units */
-
-		/* Update variable step mode */
-		clLCD_.setCursor(5, 3);
-		if (stAeroData_.stStatus.ePitchMode == PITCHMODE_MANUAL) 
+		if (eMsgID == MESSAGEID_CONTROLPARAMS)
 		{
-			clLCD_.print("manual"); 	
+			ControlParams_st stRequest;
+			memcpy(&stRequest, &aucReadingBuf_[0], sizeof(stRequest));
+			vApplyRemoteParams(ucHostSource_, stRequest);
 		}
-		else 
+		/* Flight recorder requests are forwarded to the Arduino Control */
+		else if (eMsgID == MESSAGEID_RECORDERREQUEST)
 		{
-			clLCD_.print("auto. ");
+			RecorderRequest_st stRequest;
+			memcpy(&stRequest, &aucReadingBuf_[0], sizeof(stRequest));
+			clCommsManagerHC12_.vSendMessage(stRequest, MESSAGEID_RECORDERREQUEST, Serial1);
 		}
+	}
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Method that applies the control parameters received from a remote source. The messages carry
+* all the fields, also the ones the user has not touched (the app shows the values sent by
+* vSendDataESP8266()), so a field is only requested if its value changes. Unchanged fields only
+* renew the lease of the fields the source already owns
+* \param[in] ucSource: Control source that sent the message
+* \param[in] stRequest: Received control parameters
+***************************************************************************************************/
+void vApplyRemoteParams(const unsigned char ucSource, const ControlParams_st& stRequest)
+{
+	unsigned long ulNowMs = millis();
 
-		/* Update blade pitch percentage. Convert to a char[]. We want 3 digits with no comma or
-		sign */
-		dtostrf(stAeroData_.fBladePitchPercentage, 3, 0, scAuxText); 
-		clLCD_.setCursor(14, 3);
-		clLCD_.print(scAuxText[0]); /**< hundreds */
-		clLCD_.print(scAuxText[1]); /**< tens  */
-		clLCD_.print(scAuxText[2]); /**< units */
+	if (bClaimField(ucSource, CONTROLFIELD_MAX_RPM, stRequest.fMaxRotorSpeedRPM != stControlParams_.fMaxRotorSpeedRPM, ulNowMs))
+	{
+		stControlParams_.fMaxRotorSpeedRPM = stRequest.fMaxRotorSpeedRPM;
+	}
+	if (bClaimField(ucSource, CONTROLFIELD_MAX_WIND, stRequest.fMaxWindSpeed != stControlParams_.fMaxWindSpeed, ulNowMs))
+	{
+		stControlParams_.fMaxWindSpeed = stRequest.fMaxWindSpeed;
+	}
+	if (bClaimField(ucSource, CONTROLFIELD_PITCH, stRequest.fBladePitchPercentage != stControlParams_.fBladePitchPercentage, ulNowMs))
+	{
+		stControlParams_.fBladePitchPercentage = stRequest.fBladePitchPercentage;
+	}
+	if (bClaimField(ucSource, CONTROLFIELD_MANUAL_BREAK, stRequest.eManualBreak != stControlParams_.eManualBreak, ulNowMs))
+	{
+		stControlParams_.eManualBreak = stRequest.eManualBreak;
+	}
+	if (bClaimField(ucSource, CONTROLFIELD_PITCH_MODE, stRequest.ePitchMode != stControlParams_.ePitchMode, ulNowMs))
+	{
+		stControlParams_.ePitchMode = stRequest.ePitchMode;
 	}
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief Method that sends information to the Arduino Control trough HC12
+* \brief Method that requests a field of the control parameters for a remote source
+* \param[in] ucSource: Control source
+* \param[in] eField: Requested field
+* \param[in] bChanged: True if the source sends a new value for the field
+* \param[in] ulNowMs: Current time [ms]
+* \return True if the source owns the field and its value can be written
 ***************************************************************************************************/
-void vSendDataHC12() 
+bool bClaimField(const unsigned char ucSource, const ControlField_e eField, const bool bChanged, const unsigned long ulNowMs)
+{
+	/* An unchanged value doesn't take the field from anybody, it only keeps the lease of its owner */
+	if (!bChanged && clArbiter_.ucGetOwner(eField, ulNowMs) != ucSource)
+	{
+		return false;
+	}
+
+	return clArbiter_.bRequest(ucSource, eField, ulNowMs);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Method that writes information to the lcd screen. The fields are only written in the
+* framebuffer, vFlushScreen() sends the characters that have changed
+***************************************************************************************************/
+void vRefreshScreen() 
+{
+	PROFILE_SCOPE("LCD");
+
+	/* Declare auxiliary variable */
+	char scAuxText[NUMBER_FORMAT_MAX_LENGTH_UC + 1];
+
+	/* Update temperature. 5 characters, including sign and decimal separator, and only one decimal
+	value */
+	ucFormatFloat(scAuxText, stAeroData_.fTempCelsius, 1, 5);
+	clScreen_.vPrint(5, 0, scAuxText);
+
+	/* Update humidity. 3 digits with no comma or sign */
+	ucFormatFloat(scAuxText, stAeroData_.fRelHumidity, 0, 3);
+	clScreen_.vPrint(16, 0, scAuxText);
+
+	/* Update wind speed. 2 digits with no comma or sign */
+	ucFormatFloat(scAuxText, stAeroData_.fWindSpeed, 0, 2);
+	clScreen_.vPrint(5, 1, scAuxText);
+
+	/* Update max wind speed. 2 digits with no comma or sign */
+	ucFormatFloat(scAuxText, stControlParams_.fMaxWindSpeed, 0, 2);
+	clScreen_.vPrint(15, 1, scAuxText);
+
+	/* Update rotor speed. 3 digits with no comma or sign */
+	ucFormatFloat(scAuxText, stAeroData_.fRotorSpeedRPM, 0, 3);
+	clScreen_.vPrint(5, 2, scAuxText);
+
+	/* Update max rotor speed. 3 digits with no comma or sign */
+	ucFormatFloat(scAuxText, stControlParams_.fMaxRotorSpeedRPM, 0, 3);
+	clScreen_.vPrint(16, 2, scAuxText);
+
+	/* Update variable step mode */
+	if (stAeroData_.stStatus.ePitchMode == PITCHMODE_MANUAL) 
+	{
+		clScreen_.vPrint(5, 3, "manual");
+	}
+	else 
+	{
+		clScreen_.vPrint(5, 3, "auto. ");
+	}
+
+	/* Update blade pitch percentage. 3 digits with no comma or sign */
+	ucFormatFloat(scAuxText, stAeroData_.fBladePitchPercentage, 0, 3);
+	clScreen_.vPrint(14, 3, scAuxText);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Method that sends the changed characters of the framebuffer to the lcd screen. It runs in
+* every pass and returns when LCD_FLUSH_BUDGET_US_UL is used, so the I2C writes never hold the serial
+* ports and the user inputs for long
+***************************************************************************************************/
+void vFlushScreen()
 {
-	/* Check if it is time to send new data */
-	if (clSenderHC12Timer_.check()) 
+	/* Nothing to do in most passes */
+	if (!clScreen_.bIsPending())
 	{
-		clCommsManagerHC12_.vSendMessage(stControlParams_, MESSAGEID_CONTROLPARAMS, Serial1);
+		return;
 	}
+
+	PROFILE_SCOPE("LCD flush");
+	clScreen_.bFlush(clLCD_, LCD_FLUSH_BUDGET_US_UL);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Method that sends information to the Arduino Control trough HC12
+***************************************************************************************************/
+void vSendDataHC12() 
+{
+	PROFILE_SCOPE("HC12 send");
+	clCommsManagerHC12_.vSendMessage(stControlParams_, MESSAGEID_CONTROLPARAMS, Serial1);
 }
 
 /****************************************** FUNCTION *******************************************//**
@@ -322,16 +469,29 @@ void vSendDataHC12()
 ***************************************************************************************************/
 void vSendDataESP8266() 
 {
-	/* Check if it is time to send new data */
-	if (clSenderESP8266Timer.check())
+	PROFILE_SCOPE("ESP send");
+
+	/* Send Aero data comming from the Arduino control, split as it is received (see Telemetry.h).
+	The slow messages are only sent after they are received, one per period */
+	KinematicData_st stKinematics;
+	vGetKinematicData(stAeroData_, stKinematics);
+	clCommsManagerESP8266_.vSendMessage(stKinematics, MESSAGEID_KINEMATICS, Serial2);
+	if (bStatusPending_)
 	{
-		/* Send Aero data comming from the Arduino control */
-		clCommsManagerESP8266_.vSendMessage(stAeroData_, MESSAGEID_AERODATA, Serial2);
-
-		/* Send the current control params to the Wifi module, just to show them as the default 
-		values for the fields of the IHM */
-		clCommsManagerESP8266_.vSendMessage(stControlParams_, MESSAGEID_CONTROLPARAMS, Serial2);
+		clCommsManagerESP8266_.vSendMessage(stAeroData_.stStatus, MESSAGEID_STATUS, Serial2);
+		bStatusPending_ = false;
 	}
+	else if (bEnvironmentPending_)
+	{
+		EnvironmentData_st stEnvironment;
+		vGetEnvironmentData(stAeroData_, stEnvironment);
+		clCommsManagerESP8266_.vSendMessage(stEnvironment, MESSAGEID_ENVIRONMENT, Serial2);
+		bEnvironmentPending_ = false;
+	}
+
+	/* Send the current control params to the Wifi module, just to show them as the default 
+	values for the fields of the IHM */
+	clCommsManagerESP8266_.vSendMessage(stControlParams_, MESSAGEID_CONTROLPARAMS, Serial2);
 }
 
 /****************************************** FUNCTION *******************************************//**
@@ -352,6 +512,7 @@ void vManageBreakLed()
 
 	case BREAK_BREAKING:
 	case BREAK_RELEASING:
+	case BREAK_INITIALIZING:
 		vSetColorRGBLed(0, 0, 255);
 		break;
 	
@@ -30,8 +30,26 @@ const float MAX_WIND_F = 30.0f;  /**< Max wind speed that can be configured with
 const int          LCD_REFRESH_TIME_MS_UL          = 250;                /**< Refresh time for the LCD screen (milliseconds)                                      */
 const int          HC12_SEND_PERIOD_MS_UL          = 250;                /**< Time period between sending messages through HC12                                   */
 const int          ESP8266_SEND_PERIOD_MS_UL       = 250;                /**< Time period between sending messages through ESP8266                                */
-const UserMaster_e DEFAULT_USER_MASTER_E           = USERMASTER_ARDUINO; /**< Default control master                                                              */
-const int          ANDROID_TIMEOUT_MS_UL           = 30000;              /**< Timeout to transition from Android to Arduino if no messages are received           */
 const int          COMMS_BAUD_RATE_UL              = 9600;               /**< Baud rate for serial communications                                                 */
 
+/* CONTROL SOURCES (lower priority values take the fields of higher ones at once, the others wait
+for the lease of the owner to expire, see ControlArbiter.h) */
+const unsigned char CONTROL_PRIORITY_PANEL_UC = 0;    /**< Priority of the physical controls (the local operator always wins) */
+const unsigned char CONTROL_PRIORITY_HOST_UC  = 1;    /**< Priority of the host tool on the USB port                          */
+const unsigned char CONTROL_PRIORITY_APP_UC   = 2;    /**< Priority of the Android app                                        */
+const unsigned long CONTROL_LEASE_PANEL_MS_UL = 5000; /**< Time the panel keeps a field after its last change                 */
+const unsigned long CONTROL_LEASE_HOST_MS_UL  = 3000; /**< Time the host tool keeps a field after its last message            */
+const unsigned long CONTROL_LEASE_APP_MS_UL   = 3000; /**< Time the app keeps a field after its last message                  */
+
+/* TASK SCHEDULING (lower priority values run first) */
+const unsigned char TASK_PRIORITY_USER_INPUTS_UC   = 0;     /**< Priority for the user controls (manual break)           */
+const unsigned char TASK_PRIORITY_CONTROL_COMMS_UC = 1;     /**< Priority for the communications with Arduino Control    */
+const unsigned char TASK_PRIORITY_APP_COMMS_UC     = 2;     /**< Priority for the communications with the Android app    */
+const unsigned char TASK_PRIORITY_DISPLAY_UC       = 3;     /**< Priority for the LCD screen and the break led           */
+const unsigned long USER_INPUTS_PERIOD_MS_UL       = 20;    /**< Period to read the user controls                        */
+const unsigned long SERIAL_READ_PERIOD_MS_UL       = 20;    /**< Period to read incoming messages (64 bytes UART buffer) */
+const unsigned long BREAK_LED_PERIOD_MS_UL         = 100;   /**< Period to update the break led                          */
+const unsigned long PROFILING_REPORT_PERIOD_MS_UL  = 10000; /**< Period of the profiling report (if PROFILING_ENABLED)   */
+const unsigned long LCD_FLUSH_BUDGET_US_UL         = 1000;  /**< Time per pass to send characters to the LCD             */
+
 #endif // CONSTANTS_H_
\ No newline at end of file
@@ -0,0 +1,130 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <string.h>
+
+/* Custom includes */
+#include "ControlArbiter.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the arbiter class
+***************************************************************************************************/
+ControlArbiter_cl::ControlArbiter_cl()
+{
+    memset(aucPriorities_, 0, sizeof(aucPriorities_));
+    memset(aulLeasesMs_, 0, sizeof(aulLeasesMs_));
+    ucNumSources_ = 0;
+    memset(aucOwners_, CONTROL_NO_OWNER_UC, sizeof(aucOwners_));
+    memset(aulRenewalsMs_, 0, sizeof(aulRenewalsMs_));
+    memset(abWaiting_, 0, sizeof(abWaiting_));
+    memset(aulWaitStartsMs_, 0, sizeof(aulWaitStartsMs_));
+    memset(&stStats_, 0, sizeof(stStats_));
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function adds a control source
+* \param[in] ucPriority: Priority of the source (lower values take the fields of higher ones)
+* \param[in] ulLeaseMs: Time the source keeps a field without renewing it [ms]
+* \return Index of the source, or CONTROL_INVALID_SOURCE_UC if there is no room for more
+***************************************************************************************************/
+unsigned char ControlArbiter_cl::ucAddSource(const unsigned char ucPriority, const unsigned long ulLeaseMs)
+{
+    if (ucNumSources_ >= CONTROL_MAX_SOURCES_UC)
+    {
+        return CONTROL_INVALID_SOURCE_UC;
+    }
+
+    aucPriorities_[ucNumSources_] = ucPriority;
+    aulLeasesMs_[ucNumSources_]   = ulLeaseMs;
+    return ucNumSources_++;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function requests a field for a source (see NOTE2)
+* \param[in] ucSource: Index of the source (returned by ucAddSource())
+* \param[in] eField: Requested field
+* \param[in] ulNowMs: Current time [ms]
+* \return True if the source owns the field and can write it
+***************************************************************************************************/
+bool ControlArbiter_cl::bRequest(const unsigned char ucSource, const ControlField_e eField, const unsigned long ulNowMs)
+{
+    if (ucSource >= ucNumSources_ || eField >= CONTROLFIELD_COUNT)
+    {
+        return false;
+    }
+
+    /* Another source holds the field, and this one can't take it */
+    unsigned char ucOwner = aucOwners_[eField];
+    if (ucOwner != ucSource && bIsLeased(eField, ulNowMs) && aucPriorities_[ucSource] >= aucPriorities_[ucOwner])
+    {
+        if (!abWaiting_[eField])
+        {
+            abWaiting_[eField]       = true;
+            aulWaitStartsMs_[eField] = ulNowMs;
+        }
+        stStats_.ulDenials++;
+        return false;
+    }
+
+    /* Handover. The latency is 0 if nobody had to wait (free field or preemption) */
+    if (ucOwner != ucSource && ucOwner != CONTROL_NO_OWNER_UC)
+    {
+        stStats_.ulLastHandoverMs = abWaiting_[eField] ? ulNowMs - aulWaitStartsMs_[eField] : 0;
+        if (stStats_.ulLastHandoverMs > stStats_.ulMaxHandoverMs)
+        {
+            stStats_.ulMaxHandoverMs = stStats_.ulLastHandoverMs;
+        }
+        stStats_.ulHandovers++;
+    }
+    if (ucOwner != ucSource)
+    {
+        abWaiting_[eField] = false;
+    }
+
+    aucOwners_[eField]     = ucSource;
+    aulRenewalsMs_[eField] = ulNowMs;
+    stStats_.ulGrants++;
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the current owner of a field
+* \param[in] eField: Field
+* \param[in] ulNowMs: Current time [ms]
+* \return Index of the source, or CONTROL_NO_OWNER_UC if nobody holds a valid lease
+***************************************************************************************************/
+unsigned char ControlArbiter_cl::ucGetOwner(const ControlField_e eField, const unsigned long ulNowMs) const
+{
+    if (eField >= CONTROLFIELD_COUNT || !bIsLeased(eField, ulNowMs))
+    {
+        return CONTROL_NO_OWNER_UC;
+    }
+
+    return aucOwners_[eField];
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the results of the arbitration since the start
+* \return Statistics of the arbiter
+***************************************************************************************************/
+const ControlArbiterStats_st& ControlArbiter_cl::stGetStats() const
+{
+    return stStats_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function checks if the owner of a field still holds its lease
+* \param[in] eField: Field
+* \param[in] ulNowMs: Current time [ms]
+* \return True if the field has an owner and its lease has not expired
+***************************************************************************************************/
+bool ControlArbiter_cl::bIsLeased(const ControlField_e eField, const unsigned long ulNowMs) const
+{
+    unsigned char ucOwner = aucOwners_[eField];
+    if (ucOwner == CONTROL_NO_OWNER_UC)
+    {
+        return false;
+    }
+
+    return ulNowMs - aulRenewalsMs_[eField] < aulLeasesMs_[ucOwner];
+}
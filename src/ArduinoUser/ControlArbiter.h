@@ -0,0 +1,112 @@
+#ifndef CONTROL_ARBITER_H_
+#define CONTROL_ARBITER_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+#include "Types.h"
+
+
+/*
+- NOTE1: Arbitration of the control parameters between several control sources (physical panel,
+app through the ESP8266, host tool on the USB port...). Each field of the control parameters
+(ControlField_e) has its own owner, so a source can hold e.g. the pitch while another one holds the
+max RPM
+- NOTE2: A source must request a field (bRequest()) before writing it. The request is granted if the
+field has no owner, if the lease of the owner has expired, if the source is the owner (the lease is
+renewed) or if the source has a higher priority than the owner (lower value, it takes the field
+immediately). Otherwise it is denied, and the source has to retry (e.g. in its next pass or frame)
+- NOTE3: The lease of each source is the time it keeps its fields without renewing them, and so the
+longest time a lower priority source waits to take them over. Handover latency is measured from the
+first denied request of a field to the moment it is granted to another source, and reported in the
+statistics
+- NOTE4: Time is taken from the callers (ulNowMs, from millis()), and all the comparisons are done
+with differences, so they are valid across the millis() overflow
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char CONTROL_MAX_SOURCES_UC    = 4;    /**< Maximum number of control sources                  */
+const unsigned char CONTROL_INVALID_SOURCE_UC = 0xFF; /**< Source index returned when a source can't be added */
+const unsigned char CONTROL_NO_OWNER_UC       = 0xFF; /**< Owner of the fields that nobody holds              */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct ControlArbiterStats_st
+ * \brief Results of the arbitration since the start
+ **************************************************************************************************/
+struct ControlArbiterStats_st
+{
+    uint32_t ulGrants;         /**< Requests granted (including lease renewals)           */
+    uint32_t ulDenials;        /**< Requests denied because another source held the field */
+    uint32_t ulHandovers;      /**< Fields granted to a source other than their owner     */
+    uint32_t ulLastHandoverMs; /**< Handover latency of the last handover [ms]            */
+    uint32_t ulMaxHandoverMs;  /**< Longest handover latency [ms]                         */
+};
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class ControlArbiter_cl
+ * \brief Priority and lease based ownership of each field of the control parameters
+ **************************************************************************************************/
+class ControlArbiter_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the arbiter class
+    ***********************************************************************************************/
+    ControlArbiter_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function adds a control source
+    * \param[in] ucPriority: Priority of the source (lower values take the fields of higher ones)
+    * \param[in] ulLeaseMs: Time the source keeps a field without renewing it [ms]
+    * \return Index of the source, or CONTROL_INVALID_SOURCE_UC if there is no room for more
+    ***********************************************************************************************/
+    unsigned char ucAddSource(const unsigned char ucPriority, const unsigned long ulLeaseMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function requests a field for a source (see NOTE2)
+    * \param[in] ucSource: Index of the source (returned by ucAddSource())
+    * \param[in] eField: Requested field
+    * \param[in] ulNowMs: Current time [ms]
+    * \return True if the source owns the field and can write it
+    ***********************************************************************************************/
+    bool bRequest(const unsigned char ucSource, const ControlField_e eField, const unsigned long ulNowMs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the current owner of a field
+    * \param[in] eField: Field
+    * \param[in] ulNowMs: Current time [ms]
+    * \return Index of the source, or CONTROL_NO_OWNER_UC if nobody holds a valid lease
+    ***********************************************************************************************/
+    unsigned char ucGetOwner(const ControlField_e eField, const unsigned long ulNowMs) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the results of the arbitration since the start
+    * \return Statistics of the arbiter
+    ***********************************************************************************************/
+    const ControlArbiterStats_st& stGetStats() const;
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function checks if the owner of a field still holds its lease
+    * \param[in] eField: Field
+    * \param[in] ulNowMs: Current time [ms]
+    * \return True if the field has an owner and its lease has not expired
+    ***********************************************************************************************/
+    bool bIsLeased(const ControlField_e eField, const unsigned long ulNowMs) const;
+
+    /***************************************** ATTRIBUTES *****************************************/
+    unsigned char          aucPriorities_[CONTROL_MAX_SOURCES_UC]; /**< Priority of each source                   */
+    unsigned long          aulLeasesMs_[CONTROL_MAX_SOURCES_UC];   /**< Lease of each source [ms]                 */
+    unsigned char          ucNumSources_;                          /**< Number of sources                         */
+    unsigned char          aucOwners_[CONTROLFIELD_COUNT];         /**< Last owner of each field                  */
+    unsigned long          aulRenewalsMs_[CONTROLFIELD_COUNT];     /**< Time of the last grant of each field [ms] */
+    bool                   abWaiting_[CONTROLFIELD_COUNT];         /**< A request of the field has been denied    */
+    unsigned long          aulWaitStartsMs_[CONTROLFIELD_COUNT];   /**< Time of the first denied request [ms]     */
+    ControlArbiterStats_st stStats_;                               /**< Results of the arbitration                */
+};
+
+#endif /* CONTROL_ARBITER_H_ */
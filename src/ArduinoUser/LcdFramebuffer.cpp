@@ -0,0 +1,284 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <string.h>
+
+/* Custom includes */
+#include "LcdFramebuffer.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+static const unsigned char LCD_ROW_ADDRESS_UC[LCD_ROWS_UC]     = { 0x00, 0x40, 0x14, 0x54 };   /**< DDRAM address of the first cell of each row           */
+static const unsigned char LCD_FLUSH_ROW_ORDER_UC[LCD_ROWS_UC] = { 0, 2, 1, 3 };               /**< Rows in DDRAM order (see NOTE2)                       */
+static const unsigned char LCD_LINE_0_END_UC                   = 0x27;                         /**< Last DDRAM address of the first line of the HD44780   */
+static const unsigned char LCD_LINE_1_START_UC                 = 0x40;                         /**< First DDRAM address of the second line of the HD44780 */
+static const unsigned char LCD_LINE_1_END_UC                   = 0x67;                         /**< Last DDRAM address of the second line of the HD44780  */
+static const unsigned char LCD_CURSOR_UNKNOWN_UC               = 0xFF;                         /**< Cursor position not known (not a DDRAM address)       */
+static const unsigned char LCD_CELLS_UC                        = LCD_ROWS_UC * LCD_COLUMNS_UC; /**< Number of cells of the screen                         */
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the framebuffer class
+***************************************************************************************************/
+LcdFramebuffer_cl::LcdFramebuffer_cl()
+{
+    memset(ascCells_, ' ', sizeof(ascCells_));
+    memset(aucDirty_, 0, sizeof(aucDirty_));
+    vResetStats();
+    ucCursorAddress_ = LCD_CURSOR_UNKNOWN_UC;
+    ucScanIdx_       = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a null terminated text in the framebuffer. The text is clipped at the
+* end of the row
+* \param[in] ucCol: Column of the first character
+* \param[in] ucRow: Row of the text
+* \param[in] pscText: Text to write
+***************************************************************************************************/
+void LcdFramebuffer_cl::vPrint(const unsigned char ucCol, const unsigned char ucRow, const char* pscText)
+{
+    size_t ulLength = strlen(pscText);
+    vWrite(ucCol, ucRow, pscText, ulLength > LCD_COLUMNS_UC ? LCD_COLUMNS_UC : ulLength);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function writes a number of characters in the framebuffer. The text is clipped at the
+* end of the row
+* \param[in] ucCol: Column of the first character
+* \param[in] ucRow: Row of the text
+* \param[in] pscText: Characters to write (no terminator needed)
+* \param[in] ucLength: Number of characters to write
+***************************************************************************************************/
+void LcdFramebuffer_cl::vWrite(const unsigned char ucCol,
+                               const unsigned char ucRow,
+                               const char*         pscText,
+                               const unsigned char ucLength)
+{
+    if (ucRow >= LCD_ROWS_UC)
+    {
+        return;
+    }
+
+    /* Only the cells that really change are marked as dirty */
+    for (unsigned char ucIdx = 0; ucIdx < ucLength && ucCol + ucIdx < LCD_COLUMNS_UC; ucIdx++)
+    {
+        char& scCell = ascCells_[ucRow][ucCol + ucIdx];
+        if (scCell != pscText[ucIdx])
+        {
+            unsigned char ucCell = ucRow * LCD_COLUMNS_UC + ucCol + ucIdx;
+            scCell = pscText[ucIdx];
+            aucDirty_[ucCell >> 3] |= _BV(ucCell & 0x07);
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function marks all the cells as dirty, so the next flush rewrites the whole screen
+***************************************************************************************************/
+void LcdFramebuffer_cl::vInvalidate()
+{
+    memset(aucDirty_, 0xFF, sizeof(aucDirty_));
+    ucCursorAddress_ = LCD_CURSOR_UNKNOWN_UC;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function sends all the dirty cells to the screen. It blocks until everything is sent
+* \param[in] clLCD: Screen
+***************************************************************************************************/
+void LcdFramebuffer_cl::vFlush(LiquidCrystal_I2C& clLCD)
+{
+    unsigned long ulStartUs = micros();
+    uint16_t usSends = 0;
+    unsigned char ucRunSends = 0;
+
+    while ((ucRunSends = ucSendNextRun(clLCD)) > 0)
+    {
+        usSends += ucRunSends;
+    }
+
+    vUpdateStats(usSends, micros() - ulStartUs);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function sends dirty cells to the screen until the time budget is used. Runs longer
+* than LCD_FLUSH_CHUNK_CHARS_UC are split, so the budget can only be exceeded by one chunk
+* \param[in] clLCD: Screen
+* \param[in] ulBudgetUs: Time available for this call [us]
+* \return True if there are no dirty cells left
+***************************************************************************************************/
+bool LcdFramebuffer_cl::bFlush(LiquidCrystal_I2C& clLCD, const unsigned long ulBudgetUs)
+{
+    unsigned long ulStartUs = micros();
+    uint16_t usSends = 0;
+    bool bDone = false;
+
+    /* At least one chunk is sent in each call, so the screen is always progressing */
+    do
+    {
+        unsigned char ucRunSends = ucSendNextRun(clLCD);
+        if (ucRunSends == 0)
+        {
+            bDone = true;
+            break;
+        }
+        usSends += ucRunSends;
+    } while (micros() - ulStartUs < ulBudgetUs);
+
+    /* Calls with nothing to send are not counted */
+    if (usSends > 0)
+    {
+        vUpdateStats(usSends, micros() - ulStartUs);
+    }
+
+    return bDone;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function checks if there are cells not sent to the screen yet
+* \return True if at least one cell is dirty
+***************************************************************************************************/
+bool LcdFramebuffer_cl::bIsPending() const
+{
+    for (unsigned char ucIdx = 0; ucIdx < sizeof(aucDirty_); ucIdx++)
+    {
+        if (aucDirty_[ucIdx] != 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the operations sent to the screen since the start
+* \return Statistics of the framebuffer
+***************************************************************************************************/
+const LcdStats_st& LcdFramebuffer_cl::stGetStats() const
+{
+    return stStats_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function resets the statistics (e.g. after the blocking flush of the setup)
+***************************************************************************************************/
+void LcdFramebuffer_cl::vResetStats()
+{
+    memset(&stStats_, 0, sizeof(stStats_));
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function sends the next run of dirty cells, starting the search where the last run
+* ended. Cells are visited in DDRAM order, so a run at the end of a row can continue in the next one
+* without moving the cursor (see NOTE2)
+* \param[in] clLCD: Screen
+* \return Characters plus cursor movements sent. 0 if there are no dirty cells
+***************************************************************************************************/
+unsigned char LcdFramebuffer_cl::ucSendNextRun(LiquidCrystal_I2C& clLCD)
+{
+    /* Find the next dirty cell, resuming the search from the end of the last run. This way a field
+    that changes in every refresh can't starve the rest of the screen */
+    unsigned char ucRow = 0;
+    unsigned char ucCol = 0;
+    unsigned char ucVisited = 0;
+    for (; ucVisited < LCD_CELLS_UC; ucVisited++)
+    {
+        ucRow = LCD_FLUSH_ROW_ORDER_UC[ucScanIdx_ / LCD_COLUMNS_UC];
+        ucCol = ucScanIdx_ % LCD_COLUMNS_UC;
+        if (bIsDirty(ucCol, ucRow))
+        {
+            break;
+        }
+        ucScanIdx_ = (ucScanIdx_ + 1) % LCD_CELLS_UC;
+    }
+    if (ucVisited == LCD_CELLS_UC)
+    {
+        return 0;
+    }
+
+    /* Find the end of the run inside the row, up to one chunk, clearing the dirty bits */
+    unsigned char ucStart = ucCol;
+    while (ucCol < LCD_COLUMNS_UC && ucCol - ucStart < LCD_FLUSH_CHUNK_CHARS_UC && bIsDirty(ucCol, ucRow))
+    {
+        unsigned char ucCell = ucRow * LCD_COLUMNS_UC + ucCol;
+        aucDirty_[ucCell >> 3] &= ~_BV(ucCell & 0x07);
+        ucCol++;
+    }
+    unsigned char ucLength = ucCol - ucStart;
+    unsigned char ucSends = ucLength;
+    ucScanIdx_ = (ucScanIdx_ + ucLength) % LCD_CELLS_UC;
+
+    /* Move the cursor only at the start of a run */
+    unsigned char ucAddress = ucGetAddress(ucStart, ucRow);
+    if (ucAddress != ucCursorAddress_)
+    {
+        clLCD.setCursor(ucStart, ucRow);
+        stStats_.ulCursorMoves++;
+        ucSends++;
+    }
+
+    /* The whole run goes out in a burst (LiquidCrystal_I2C::write(buffer, size)) */
+    clLCD.write(reinterpret_cast<const uint8_t*>(&ascCells_[ucRow][ucStart]), ucLength);
+    stStats_.ulChars += ucLength;
+
+    /* Same auto-increment as the HD44780 in 2 lines mode */
+    ucAddress += ucLength - 1;
+    if (ucAddress == LCD_LINE_0_END_UC)
+    {
+        ucCursorAddress_ = LCD_LINE_1_START_UC;
+    }
+    else if (ucAddress == LCD_LINE_1_END_UC)
+    {
+        ucCursorAddress_ = 0;
+    }
+    else
+    {
+        ucCursorAddress_ = ucAddress + 1;
+    }
+
+    return ucSends;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function updates the statistics at the end of a flush
+* \param[in] usSends: Characters plus cursor movements sent in the flush
+* \param[in] ulElapsedUs: Duration of the flush [us]
+***************************************************************************************************/
+void LcdFramebuffer_cl::vUpdateStats(const uint16_t usSends, const unsigned long ulElapsedUs)
+{
+    stStats_.ulFlushes++;
+    stStats_.usLastSends   = usSends;
+    stStats_.ulLastFlushUs = ulElapsedUs;
+    if (usSends > stStats_.usMaxSends)
+    {
+        stStats_.usMaxSends = usSends;
+    }
+    if (ulElapsedUs > stStats_.ulMaxFlushUs)
+    {
+        stStats_.ulMaxFlushUs = ulElapsedUs;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the DDRAM address of a cell
+* \param[in] ucCol: Column of the cell
+* \param[in] ucRow: Row of the cell
+* \return DDRAM address
+***************************************************************************************************/
+unsigned char LcdFramebuffer_cl::ucGetAddress(const unsigned char ucCol, const unsigned char ucRow)
+{
+    return LCD_ROW_ADDRESS_UC[ucRow] + ucCol;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function checks if a cell has not been sent to the screen yet
+* \param[in] ucCol: Column of the cell
+* \param[in] ucRow: Row of the cell
+* \return True if the cell is dirty
+***************************************************************************************************/
+bool LcdFramebuffer_cl::bIsDirty(const unsigned char ucCol, const unsigned char ucRow) const
+{
+    unsigned char ucCell = ucRow * LCD_COLUMNS_UC + ucCol;
+    return (aucDirty_[ucCell >> 3] & _BV(ucCell & 0x07)) != 0;
+}
@@ -0,0 +1,164 @@
+#ifndef LCD_FRAMEBUFFER_H_
+#define LCD_FRAMEBUFFER_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+#include <LiquidCrystal_I2C.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Shadow copy of the characters of the LCD screen. The application writes the texts in the
+framebuffer (vPrint, vWrite), which is cheap, and vFlush() sends to the screen only the cells that
+have changed since the last flush. Each character or cursor movement sent to the LCD costs I2C bus
+time, so unchanged fields cost nothing
+- NOTE2: Consecutive dirty cells are sent as a run, with only one setCursor() at the start and one
+burst write (LiquidCrystal_I2C::write(buffer, size)). The position of the LCD cursor is tracked as
+a DDRAM address, with the same auto-increment as the HD44780 (the end of line 0 continues in line 2,
+and the end of line 2 in line 1), so a run that continues in the next cell of the DDRAM does not
+need a setCursor() either
+- NOTE3: vFlush() sends everything and blocks until done (use it in setup). In the main loop, use
+bFlush() in every pass with a time budget: the dirty cells work as the queue of pending writes (a
+cell that changes twice before being sent is only sent once), and each call sends a few runs and
+returns. The search of dirty cells resumes where the last call stopped
+- NOTE4: The framebuffer starts with spaces and nothing dirty, which is the content of the screen
+after LiquidCrystal_I2C::clear(). If the screen content is unknown, call vInvalidate()
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const unsigned char LCD_COLUMNS_UC           = 20; /**< Number of columns of the LCD screen                          */
+const unsigned char LCD_ROWS_UC              = 4;  /**< Number of rows of the LCD screen                             */
+const unsigned char LCD_FLUSH_CHUNK_CHARS_UC = 4;  /**< Longest run sent at once by bFlush() (longer runs are split) */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct LcdStats_st
+ * \brief Operations sent to the LCD screen by the framebuffer
+ **************************************************************************************************/
+struct LcdStats_st
+{
+    uint32_t ulFlushes;     /**< Calls to vFlush() and bFlush() that sent something      */
+    uint32_t ulChars;       /**< Characters written to the screen                        */
+    uint32_t ulCursorMoves; /**< Calls to setCursor()                                    */
+    uint16_t usLastSends;   /**< Characters plus cursor movements sent in the last flush */
+    uint16_t usMaxSends;    /**< Highest number of sends in a flush                      */
+    uint32_t ulLastFlushUs; /**< Duration of the last flush [us]                         */
+    uint32_t ulMaxFlushUs;  /**< Longest flush [us]                                      */
+};
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class LcdFramebuffer_cl
+ * \brief Shadow framebuffer of a 20x4 LCD screen that only sends the changed characters
+ **************************************************************************************************/
+class LcdFramebuffer_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the framebuffer class
+    ***********************************************************************************************/
+    LcdFramebuffer_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function writes a null terminated text in the framebuffer. The text is clipped at
+    * the end of the row
+    * \param[in] ucCol: Column of the first character
+    * \param[in] ucRow: Row of the text
+    * \param[in] pscText: Text to write
+    ***********************************************************************************************/
+    void vPrint(const unsigned char ucCol, const unsigned char ucRow, const char* pscText);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function writes a number of characters in the framebuffer. The text is clipped at
+    * the end of the row
+    * \param[in] ucCol: Column of the first character
+    * \param[in] ucRow: Row of the text
+    * \param[in] pscText: Characters to write (no terminator needed)
+    * \param[in] ucLength: Number of characters to write
+    ***********************************************************************************************/
+    void vWrite(const unsigned char ucCol,
+                const unsigned char ucRow,
+                const char*         pscText,
+                const unsigned char ucLength);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function marks all the cells as dirty, so the next flush rewrites the whole screen
+    ***********************************************************************************************/
+    void vInvalidate();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function sends all the dirty cells to the screen. It blocks until everything is
+    * sent
+    * \param[in] clLCD: Screen
+    ***********************************************************************************************/
+    void vFlush(LiquidCrystal_I2C& clLCD);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function sends dirty cells to the screen until the time budget is used. Runs
+    * longer than LCD_FLUSH_CHUNK_CHARS_UC are split, so the budget can only be exceeded by one chunk
+    * \param[in] clLCD: Screen
+    * \param[in] ulBudgetUs: Time available for this call [us]
+    * \return True if there are no dirty cells left
+    ***********************************************************************************************/
+    bool bFlush(LiquidCrystal_I2C& clLCD, const unsigned long ulBudgetUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function checks if there are cells not sent to the screen yet
+    * \return True if at least one cell is dirty
+    ***********************************************************************************************/
+    bool bIsPending() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the operations sent to the screen since the start
+    * \return Statistics of the framebuffer
+    ***********************************************************************************************/
+    const LcdStats_st& stGetStats() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function resets the statistics (e.g. after the blocking flush of the setup)
+    ***********************************************************************************************/
+    void vResetStats();
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the DDRAM address of a cell
+    * \param[in] ucCol: Column of the cell
+    * \param[in] ucRow: Row of the cell
+    * \return DDRAM address
+    ***********************************************************************************************/
+    static unsigned char ucGetAddress(const unsigned char ucCol, const unsigned char ucRow);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function checks if a cell has not been sent to the screen yet
+    * \param[in] ucCol: Column of the cell
+    * \param[in] ucRow: Row of the cell
+    * \return True if the cell is dirty
+    ***********************************************************************************************/
+    bool bIsDirty(const unsigned char ucCol, const unsigned char ucRow) const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function sends the next run of dirty cells, starting the search where the last
+    * run ended
+    * \param[in] clLCD: Screen
+    * \return Characters plus cursor movements sent. 0 if there are no dirty cells
+    ***********************************************************************************************/
+    unsigned char ucSendNextRun(LiquidCrystal_I2C& clLCD);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function updates the statistics at the end of a flush
+    * \param[in] usSends: Characters plus cursor movements sent in the flush
+    * \param[in] ulElapsedUs: Duration of the flush [us]
+    ***********************************************************************************************/
+    void vUpdateStats(const uint16_t usSends, const unsigned long ulElapsedUs);
+
+    /***************************************** ATTRIBUTES *****************************************/
+    char          ascCells_[LCD_ROWS_UC][LCD_COLUMNS_UC];            /**< Characters to be shown             */
+    unsigned char aucDirty_[(LCD_ROWS_UC * LCD_COLUMNS_UC + 7) / 8]; /**< One bit per cell not yet sent      */
+    unsigned char ucCursorAddress_;                                  /**< DDRAM address of the LCD cursor    */
+    unsigned char ucScanIdx_;                                        /**< Next cell to check, in DDRAM order */
+    LcdStats_st   stStats_;                                          /**< Operations sent to the screen      */
+};
+
+#endif /* LCD_FRAMEBUFFER_H_ */
@@ -9,13 +9,17 @@
 
 /********************************************** TYPES *********************************************/
 /***********************************************************************************************//**
- * \enum UserMaster_e
- * \brief Indicates who is controlling the wind turbine
+ * \enum ControlField_e
+ * \brief Fields of the control parameters, each one can be owned by a different control source
  **************************************************************************************************/
-enum UserMaster_e
+enum ControlField_e
 {
-    USERMASTER_ARDUINO = 0, /**< The wind turbine is being controlled from the Arduino     */
-    USERMASTER_ANDROID = 1, /**< The wind turbine is being controlled from the Android App */
+    CONTROLFIELD_MAX_RPM      = 0, /**< Max rotor speed (fMaxRotorSpeedRPM) */
+    CONTROLFIELD_MAX_WIND     = 1, /**< Max wind speed (fMaxWindSpeed)      */
+    CONTROLFIELD_PITCH        = 2, /**< Blade pitch (fBladePitchPercentage) */
+    CONTROLFIELD_MANUAL_BREAK = 3, /**< Manual break (eManualBreak)         */
+    CONTROLFIELD_PITCH_MODE   = 4, /**< Pitch control mode (ePitchMode)     */
+    CONTROLFIELD_COUNT        = 5, /**< Number of fields                    */
 }; 
 
 #endif /* TYPES_H_ */
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <CommonTypes.h>
 #include <CommsManager.h>
 #include <Metro.h>
+#include <NumberFormat.h>
+#include <Telemetry.h>
 
 /* Custom includes */
 
@@ -24,10 +26,16 @@ const std::string WIFI_PASS_AS[NUM_WIFI_NETWORKS] =        /**< Password for kno
                 {"123456789", "Q2bYmTm7xdfPkTWJyBX5"};
 
 /* COMMUNICATIONS CONSTANTS */
-const int BAUD_RATE         = 9600; /**< Baud rate for serial communications                    */
-const char MSG_DELIMITER_SC = ';';  /**< Delimiter between different values in a string message */
-const char MSG_START_SC     = '[';  /**< Character to indicate the start of a http message      */
-const char MSG_END_SC       = ']';  /**< Character to indicate the start of a http message      */
+const int BAUD_RATE                   = 9600; /**< Baud rate for serial communications                              */
+const char MSG_DELIMITER_SC           = ';';  /**< Delimiter between different values in a string message           */
+const char MSG_START_SC               = '[';  /**< Character to indicate the start of a http message                */
+const char MSG_END_SC                 = ']';  /**< Character to indicate the start of a http message                */
+const unsigned char MSG_DECIMALS_UC   = 2;    /**< Decimals of the values sent to Android (as String::concat(float)) */
+const unsigned char MSG_NUM_VALUES_UC = 13;   /**< Number of values in the message to Android                       */
+const char MSG_HTTP_HEADER_SC[]       =       /**< Beginning of the response to Android                             */
+                "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n<!DOCTYPE HTML>\r\n<html>\r\n";
+const unsigned int MSG_MAX_LENGTH_UL  =       /**< Longest response to Android (header, values and separators)      */
+                sizeof(MSG_HTTP_HEADER_SC) + MSG_NUM_VALUES_UC * (NUMBER_FORMAT_MAX_LENGTH_UC + 1) + 1;
 
 
 /******************************************** GLOBALS *********************************************/
@@ -36,8 +44,8 @@ AeroData_st      stAeroData_      = {};	/**< Current data 				 */
 ControlParams_st stControlParams_ = {};	/**< Control requests by the user */
 
 /* Communications variables */
-const unsigned int MAX_MSG_SIZE_UL_ = sizeof(ControlParams_st) > sizeof(AeroData_st) ? 
-									  sizeof(ControlParams_st) : sizeof(AeroData_st);
+const unsigned int MAX_MSG_SIZE_UL_ = sizeof(ControlParams_st) > sizeof(KinematicData_st) ? 
+									  sizeof(ControlParams_st) : sizeof(KinematicData_st);
 unsigned char aucReadingBuf_[MAX_MSG_SIZE_UL_];
 
 WiFiServer clServer_(SERVER_PORT_UL); 							   /**< Instance for the wifi server                                                  */
@@ -45,6 +53,7 @@ CommsManager_cl clCommsManager_;	 							   /**< Manager to communicate with the
 Metro clSenderSerialTimer_ = Metro(SERIAL_DATA_SEND_PERIOD_MS_UL); /**< Timer to send messages through serial port                                    */
 bool bNewMessageWifi_ = false;									   /**< A new message has been received trough wifi                                   */
 bool bFlagClientInitialData_ = false;							   /**< Boolean that indicates if the app has received inital state of control params */
+char ascMsgToAndroid_[MSG_MAX_LENGTH_UL];						   /**< Response to Android, built in place without String allocations                */
 
 
 /****************************************** FUNCTION *******************************************//**
@@ -171,14 +180,15 @@ void vReadSerialArduino()
 	/* Check if there is input data */
 	while (clCommsManager_.bReadInputMessage(Serial, aucReadingBuf_, ulMsgLength, eMsgID))
 	{
-		/* Copy the buffer to the message */
-		if (eMsgID == MESSAGEID_AERODATA)
+		/* Copy the buffer to the message. Each telemetry message updates its own fields of the
+		turbine data (see Telemetry.h) */
+		if (eMsgID == MESSAGEID_CONTROLPARAMS)
 		{
-			memcpy(&stAeroData_, aucReadingBuf_, sizeof(stAeroData_));
+			memcpy(&stControlParams_, aucReadingBuf_, sizeof(stControlParams_));
 		}
-		else if (eMsgID == MESSAGEID_CONTROLPARAMS)
+		else
 		{
-			memcpy(&stControlParams_, aucReadingBuf_, sizeof(stControlParams_));
+			bMergeTelemetry(eMsgID, aucReadingBuf_, stAeroData_);
 		}
 	}
 }
@@ -220,7 +230,7 @@ void vManageWifiClient()
 			if (bNewMessageWifi_)
 			{
 				/* Elaborate and send response */
-				clClient.print(sBuildMsgToAndroid());
+				clClient.print(pscBuildMsgToAndroid());
 			}
 		}
 	}
@@ -310,44 +320,63 @@ void vWifiConnect()
 }
 
 /****************************************** FUNCTION *******************************************//**
-* \brief Method that creates the message to be sent to the Android
+* \brief Method that creates the message to be sent to the Android. The values are formatted in place
+* (NumberFormat.h), with no String and no heap allocation
+* \return Message, in ascMsgToAndroid_
 ***************************************************************************************************/
-String sBuildMsgToAndroid() 
+const char* pscBuildMsgToAndroid() 
 {
 	/* Beginning of the message */
-	String sMsg = "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n<!DOCTYPE HTML>\r\n<html>\r\n";
+	memcpy(ascMsgToAndroid_, MSG_HTTP_HEADER_SC, sizeof(MSG_HTTP_HEADER_SC) - 1);
+	char* pscEnd = &ascMsgToAndroid_[sizeof(MSG_HTTP_HEADER_SC) - 1];
 
 	/* Concatenate parameter os AeroData structure */
-	sMsg.concat(MSG_START_SC);
-	sMsg.concat(stAeroData_.fAverageWindSpeed);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stAeroData_.fBladePitchPercentage);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stAeroData_.fRelHumidity);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stAeroData_.fRotorSpeedRPM);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stAeroData_.fTempCelsius);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stAeroData_.fWindSpeed);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stAeroData_.stStatus.eBreakStatus);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stAeroData_.stStatus.ePitchMode);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stControlParams_.fMaxRotorSpeedRPM);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stControlParams_.fMaxWindSpeed);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stControlParams_.fBladePitchPercentage);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stControlParams_.eManualBreak);
-	sMsg.concat(MSG_DELIMITER_SC);
-	sMsg.concat(stControlParams_.ePitchMode);
-	sMsg.concat(MSG_END_SC);
+	*pscEnd++ = MSG_START_SC;
+	pscEnd = pscAppendFloat(pscEnd, stAeroData_.fAverageWindSpeed, MSG_DELIMITER_SC);
+	pscEnd = pscAppendFloat(pscEnd, stAeroData_.fBladePitchPercentage, MSG_DELIMITER_SC);
+	pscEnd = pscAppendFloat(pscEnd, stAeroData_.fRelHumidity, MSG_DELIMITER_SC);
+	pscEnd = pscAppendFloat(pscEnd, stAeroData_.fRotorSpeedRPM, MSG_DELIMITER_SC);
+	pscEnd = pscAppendFloat(pscEnd, stAeroData_.fTempCelsius, MSG_DELIMITER_SC);
+	pscEnd = pscAppendFloat(pscEnd, stAeroData_.fWindSpeed, MSG_DELIMITER_SC);
+	pscEnd = pscAppendInteger(pscEnd, stAeroData_.stStatus.eBreakStatus, MSG_DELIMITER_SC);
+	pscEnd = pscAppendInteger(pscEnd, stAeroData_.stStatus.ePitchMode, MSG_DELIMITER_SC);
+	pscEnd = pscAppendFloat(pscEnd, stControlParams_.fMaxRotorSpeedRPM, MSG_DELIMITER_SC);
+	pscEnd = pscAppendFloat(pscEnd, stControlParams_.fMaxWindSpeed, MSG_DELIMITER_SC);
+	pscEnd = pscAppendFloat(pscEnd, stControlParams_.fBladePitchPercentage, MSG_DELIMITER_SC);
+	pscEnd = pscAppendInteger(pscEnd, stControlParams_.eManualBreak, MSG_DELIMITER_SC);
+	pscEnd = pscAppendInteger(pscEnd, stControlParams_.ePitchMode, MSG_END_SC);
 
 	/* Add message end */
-	return sMsg;
+	*pscEnd = '\0';
+	return ascMsgToAndroid_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Method that appends a decimal value and a separator to a message
+* \param[in] pscEnd: End of the message
+* \param[in] fValue: Value to append (MSG_DECIMALS_UC decimals)
+* \param[in] scSeparator: Character to add after the value
+* \return New end of the message
+***************************************************************************************************/
+char* pscAppendFloat(char* pscEnd, const float fValue, const char scSeparator)
+{
+	pscEnd += ucFormatFloat(pscEnd, fValue, MSG_DECIMALS_UC, 0);
+	*pscEnd++ = scSeparator;
+	return pscEnd;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Method that appends an integer value (e.g. an enum) and a separator to a message
+* \param[in] pscEnd: End of the message
+* \param[in] slValue: Value to append
+* \param[in] scSeparator: Character to add after the value
+* \return New end of the message
+***************************************************************************************************/
+char* pscAppendInteger(char* pscEnd, const int32_t slValue, const char scSeparator)
+{
+	pscEnd += ucFormatInteger(pscEnd, slValue, 0);
+	*pscEnd++ = scSeparator;
+	return pscEnd;
 }
 
 /****************************************** FUNCTION *******************************************//**
@@ -0,0 +1,615 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <SimCore.h>
+#include <ActuadorLineal.h>
+#include <CommonTypes.h>
+#include <CommsManager.h>
+#include <TaskScheduler.h>
+#include <Telemetry.h>
+#include <WindPredictor.h>
+#include <chrono>
+#include <deque>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+/* Custom includes */
+#include "BreakController.h"
+#include "Constants.h"
+#include "PlantModel.h"
+#include "RotorRegulator.h"
+#include "TelemetryGovernor.h"
+
+
+/*
+- NOTE1: Host simulator of the control Arduino. The sketch (ArduinoControl.ino) runs unmodified on
+the host Arduino core (shim folder) and closes the loop with the plant model (PlantModel.h). Time is
+virtual, so the simulation runs as fast as the host can execute the sketch
+- NOTE2: The code of the sketch takes no virtual time by itself. delay(), the blocking Serial writes,
+the cost of each pass of loop() (--loop-us) and the execution time of each scheduler task advance the
+clock. The task execution times (TASK_COSTS) are rough estimates for a 16 MHz AVR with emulated
+floating point, scaled by --task-cost-scale, not measurements. The task release jitter, the deadline
+misses, the break latency and everything driven by the plant (pulses, relays, manoeuvres) are
+meaningful as long as those estimates hold
+- NOTE3: The user Arduino is replaced by a control parameters message sent every
+CONTROL_PARAMS_PERIOD_US through Serial1, and a parser of the telemetry sent by the sketch. With
+--manual-break, the manual break is requested in the second half of each period (the message is sent
+as soon as the request changes)
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const uint64_t CONTROL_PARAMS_PERIOD_US = 500000;  /**< Period of the control parameters message */
+static const uint64_t SECONDS_TO_MICROS_ULL    = 1000000; /**< Microseconds in one second               */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct SimOptions_st
+ * \brief Command line options
+ **************************************************************************************************/
+struct SimOptions_st
+{
+    PlantParams_st   stPlant;         /**< Configuration of the plant model                      */
+    ControlParams_st stControl;       /**< Control parameters sent by the simulated user Arduino */
+    float            fDurationS;      /**< Virtual time to simulate [s]                          */
+    uint32_t         ulLoopCostUs;    /**< Virtual time taken by each pass of loop() [us]        */
+    const char*      pscTraceFile;    /**< CSV trace (NULL: no trace, "-": stdout)               */
+    uint32_t         ulTracePeriodMs; /**< Period of the trace samples [ms]                      */
+    const char*      pscLogFile;      /**< Debug Serial output (NULL: discarded, "-": stdout)    */
+    const char*      pscEepromFile;   /**< EEPROM image, loaded at start and stored at the end   */
+    float            fTaskCostScale;  /**< Factor applied to the task execution times (TASK_COSTS) */
+    float            fManualBreakS;   /**< Period of the manual break requests [s] (0: none)     */
+    const char*      pscRegulator;    /**< Gains of the rotor speed regulator "KP,KI" (NULL: sketch) */
+};
+
+/***********************************************************************************************//**
+ * \struct TaskCost_st
+ * \brief Execution time of a task of the sketch
+ **************************************************************************************************/
+struct TaskCost_st
+{
+    void     (*pfTask)(); /**< Function of the task          */
+    uint32_t ulCostUs;    /**< Execution time on the AVR [us] */
+};
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class FilePrint_cl
+ * \brief Print interface on a C file, to use the reports of the libraries
+ **************************************************************************************************/
+class FilePrint_cl : public Print
+{
+public:
+    explicit FilePrint_cl(FILE* pstFile) : pstFile_(pstFile) {}
+    size_t write(uint8_t ucByte) override
+    {
+        if (ucByte != '\r')
+        {
+            fputc(ucByte, pstFile_);
+        }
+        return 1;
+    }
+    using Print::write;
+
+private:
+    FILE* pstFile_; /**< Output file */
+};
+
+/***********************************************************************************************//**
+ * \class ByteStream_cl
+ * \brief Stream on a queue of bytes, to build and parse messages with CommsManager_cl
+ **************************************************************************************************/
+class ByteStream_cl : public Stream
+{
+public:
+    int available() override { return static_cast<int>(clBytes_.size()); }
+    int read() override
+    {
+        if (clBytes_.empty())
+        {
+            return -1;
+        }
+        uint8_t ucByte = clBytes_.front();
+        clBytes_.pop_front();
+        return ucByte;
+    }
+    int peek() override { return clBytes_.empty() ? -1 : clBytes_.front(); }
+    size_t write(uint8_t ucByte) override
+    {
+        clBytes_.push_back(ucByte);
+        return 1;
+    }
+    using Print::write;
+
+    std::deque<uint8_t> clBytes_; /**< Queued bytes */
+};
+
+/***********************************************************************************************//**
+ * \struct DebugLog_st
+ * \brief Destination of the debug Serial. Lines are prefixed with the virtual time
+ **************************************************************************************************/
+struct DebugLog_st
+{
+    FILE* pstFile;    /**< Output file                      */
+    bool  bLineStart; /**< Next byte is the first of a line */
+};
+
+/******************************************** GLOBALS *********************************************/
+/* Sketch (ArduinoControl.ino) */
+extern TaskScheduler_cl     clScheduler_;
+extern LinearServo_cl       clPitchControlServo_;
+extern AeroData_st          stAeroData_;
+extern ControlParams_st     stControlParams_;
+extern WindPredictor_cl     clWindPredictor_;
+extern RotorRegulator_cl    clRotorRegulator_;
+extern BreakController_cl   clBreakController_;
+extern float                fAutoPitchExtensionPercent_;
+extern TelemetryGovernor_cl clTelemetryGovernor_;
+
+void vBreakTask();
+void vStartupTask();
+void vRegulateRotorSpeed();
+void vJournalTask();
+void vReadDataHC12();
+void vBladePitchControl();
+void vAverageWindSpeed();
+void vPredictWindSpeed();
+void vFlightRecorder();
+void vSendDataHC12();
+void vReadDHT22Sensor();
+
+/* Execution times of the tasks of the sketch. Rough estimates for a 16 MHz AVR (float operations are
+emulated, ~10 us each, ~200 us for atan2()). Waits already modelled by the shim (Serial, DHT22) are
+not included */
+static const TaskCost_st TASK_COSTS[] =
+{
+    {vBreakTask,          40 },
+    {vStartupTask,        20 },
+    {vRegulateRotorSpeed, 400},
+    {vJournalTask,        30 },
+    {vReadDataHC12,       150},
+    {vBladePitchControl,  80 },
+    {vAverageWindSpeed,   700},
+    {vPredictWindSpeed,   300},
+    {vFlightRecorder,     150},
+    {vSendDataHC12,       250},
+    {vReadDHT22Sensor,    50 },
+};
+static const uint32_t DEFAULT_TASK_COST_US = 100; /**< Execution time of the tasks not in TASK_COSTS (reports) */
+
+/* Simulator */
+static float           fTaskCostScale_ = 1.0f; /**< Factor applied to TASK_COSTS */
+static PlantModel_cl   clPlant_;                                              /**< Physical system                         */
+static ByteStream_cl   clTelemetryStream_;                                    /**< Bytes sent by the sketch on Serial1     */
+static CommsManager_cl clTelemetryComms_;                                     /**< Parser of the telemetry                 */
+static uint32_t        aulTelemetryMessages_[MESSAGEID_COUNT] = {};           /**< Telemetry messages parsed, by ID        */
+static AeroData_st     stTelemetryView_                       = {};           /**< Turbine data rebuilt from the telemetry */
+static DebugLog_st     stDebugLog_                            = {NULL, true}; /**< Destination of the debug Serial         */
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Prints the usage of the simulator
+***************************************************************************************************/
+static void vPrintUsage(const char* pscProgram)
+{
+    printf("Usage: %s [options]\n"
+           "  --scenario NAME     steady, gusts, ramp, storm or a CSV file (time_s,wind_mps) [gusts]\n"
+           "  --wind M_S          Mean wind speed of the scenario [8]\n"
+           "  --turbulence RATIO  Turbulence deviation relative to the mean wind (gusts) [0.15]\n"
+           "  --seed N            Seed of the turbulence [1]\n"
+           "  --duration S        Virtual time to simulate [600]\n"
+           "  --max-rpm RPM       Rotor speed limit sent to the sketch [200]\n"
+           "  --max-wind M_S      Average wind speed limit sent to the sketch [20]\n"
+           "  --pitch MODE        auto, or the manual extension percentage [auto]\n"
+           "  --servo-turns N     Pitch servo position at power on [10]\n"
+           "  --break POS         Break actuator position at power on, 0 to 1 [0.3]\n"
+           "  --loop-us US        Virtual time taken by each pass of loop() [100]\n"
+           "  --task-cost-scale F Factor applied to the estimated task execution times, 0 for none [1]\n"
+           "  --manual-break S    Requests the manual break in the second half of every S seconds\n"
+           "  --regulator KP,KI   Gains of the rotor speed regulator, 0,0 for the feed-forward alone [sketch]\n"
+           "  --trace FILE        CSV trace, '-' for stdout\n"
+           "  --trace-ms MS       Period of the trace samples [100]\n"
+           "  --log FILE          Debug Serial output, '-' for stdout\n"
+           "  --eeprom FILE       EEPROM image, loaded at start (if it exists) and stored at the end\n",
+           pscProgram);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Parses the command line
+* \return False if the options are not valid
+***************************************************************************************************/
+static bool bParseOptions(int slArgc, char** apscArgv, SimOptions_st& stOptions)
+{
+    static const struct option astLongOptions[] =
+    {
+        {"scenario",    required_argument, NULL, 's' },
+        {"wind",        required_argument, NULL, 'w' },
+        {"turbulence",  required_argument, NULL, 'u' },
+        {"seed",        required_argument, NULL, 'r' },
+        {"duration",    required_argument, NULL, 'd' },
+        {"max-rpm",     required_argument, NULL, 'm' },
+        {"max-wind",    required_argument, NULL, 'x' },
+        {"pitch",       required_argument, NULL, 'p' },
+        {"servo-turns", required_argument, NULL, 'n' },
+        {"break",       required_argument, NULL, 'b' },
+        {"loop-us",     required_argument, NULL, 'l' },
+        {"task-cost-scale", required_argument, NULL, 'c' },
+        {"manual-break", required_argument, NULL, 'M' },
+        {"regulator",   required_argument, NULL, 'R' },
+        {"trace",       required_argument, NULL, 't' },
+        {"trace-ms",    required_argument, NULL, 'T' },
+        {"log",         required_argument, NULL, 'L' },
+        {"eeprom",      required_argument, NULL, 'e' },
+        {"help",        no_argument,       NULL, 'h' },
+        {NULL,          0,                 NULL, 0   },
+    };
+
+    /* Defaults */
+    stOptions = {};
+    stOptions.stPlant.eScenario           = WINDSCENARIO_GUSTS;
+    stOptions.stPlant.fMeanWindSpeed      = 8.0f;
+    stOptions.stPlant.fTurbulence         = 0.15f;
+    stOptions.stPlant.ulSeed              = 1;
+    stOptions.stPlant.fInitialServoTurns  = 10.0f;
+    stOptions.stPlant.fInitialBreak       = 0.3f;
+    stOptions.stControl.fMaxRotorSpeedRPM = 200.0f;
+    stOptions.stControl.fMaxWindSpeed     = 20.0f;
+    stOptions.stControl.eManualBreak      = MANUALBREAK_OFF;
+    stOptions.stControl.ePitchMode        = PITCHMODE_AUTO;
+    stOptions.fDurationS                  = 600.0f;
+    stOptions.ulLoopCostUs                = 100;
+    stOptions.fTaskCostScale              = 1.0f;
+    stOptions.ulTracePeriodMs             = 100;
+
+    int slOption = 0;
+    while ((slOption = getopt_long(slArgc, apscArgv, "h", astLongOptions, NULL)) != -1)
+    {
+        switch (slOption)
+        {
+        case 's':
+            if      (strcmp(optarg, "steady") == 0) { stOptions.stPlant.eScenario = WINDSCENARIO_STEADY; }
+            else if (strcmp(optarg, "gusts")  == 0) { stOptions.stPlant.eScenario = WINDSCENARIO_GUSTS;  }
+            else if (strcmp(optarg, "ramp")   == 0) { stOptions.stPlant.eScenario = WINDSCENARIO_RAMP;   }
+            else if (strcmp(optarg, "storm")  == 0) { stOptions.stPlant.eScenario = WINDSCENARIO_STORM;  }
+            else
+            {
+                stOptions.stPlant.eScenario   = WINDSCENARIO_FILE;
+                stOptions.stPlant.pscWindFile = optarg;
+            }
+            break;
+
+        case 'w': stOptions.stPlant.fMeanWindSpeed      = atof(optarg);             break;
+        case 'u': stOptions.stPlant.fTurbulence         = atof(optarg);             break;
+        case 'r': stOptions.stPlant.ulSeed              = strtoul(optarg, NULL, 0); break;
+        case 'd': stOptions.fDurationS                  = atof(optarg);             break;
+        case 'm': stOptions.stControl.fMaxRotorSpeedRPM = atof(optarg);             break;
+        case 'x': stOptions.stControl.fMaxWindSpeed     = atof(optarg);             break;
+        case 'n': stOptions.stPlant.fInitialServoTurns  = atof(optarg);             break;
+        case 'b': stOptions.stPlant.fInitialBreak       = atof(optarg);             break;
+        case 'l': stOptions.ulLoopCostUs                = strtoul(optarg, NULL, 0); break;
+        case 'c': stOptions.fTaskCostScale              = atof(optarg);             break;
+        case 'M': stOptions.fManualBreakS               = atof(optarg);             break;
+        case 'R': stOptions.pscRegulator                = optarg;                   break;
+        case 't': stOptions.pscTraceFile                = optarg;                   break;
+        case 'T': stOptions.ulTracePeriodMs             = strtoul(optarg, NULL, 0); break;
+        case 'L': stOptions.pscLogFile                  = optarg;                   break;
+        case 'e': stOptions.pscEepromFile               = optarg;                   break;
+
+        case 'p':
+            if (strcmp(optarg, "auto") == 0)
+            {
+                stOptions.stControl.ePitchMode = PITCHMODE_AUTO;
+            }
+            else
+            {
+                stOptions.stControl.ePitchMode            = PITCHMODE_MANUAL;
+                stOptions.stControl.fBladePitchPercentage = atof(optarg);
+            }
+            break;
+
+        default:
+            return false;
+        }
+    }
+
+    return optind == slArgc && stOptions.fDurationS > 0.0f && stOptions.ulLoopCostUs > 0 && stOptions.ulTracePeriodMs > 0 &&
+           stOptions.fTaskCostScale >= 0.0f && stOptions.fManualBreakS >= 0.0f;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Execution time of a task of the sketch (see NOTE2)
+***************************************************************************************************/
+static uint32_t ulGetTaskCost(void (*pfTask)())
+{
+    uint32_t ulCostUs = DEFAULT_TASK_COST_US;
+    for (const TaskCost_st& stCost : TASK_COSTS)
+    {
+        if (stCost.pfTask == pfTask)
+        {
+            ulCostUs = stCost.ulCostUs;
+        }
+    }
+    return static_cast<uint32_t>(ulCostUs * fTaskCostScale_ + 0.5f);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sink of the debug Serial. Writes the lines prefixed with the virtual time
+***************************************************************************************************/
+static void vDebugSink(uint8_t ucByte, void* pvContext)
+{
+    DebugLog_st* pstLog = static_cast<DebugLog_st*>(pvContext);
+    if (pstLog->pstFile == NULL || ucByte == '\r')
+    {
+        return;
+    }
+
+    if (pstLog->bLineStart)
+    {
+        fprintf(pstLog->pstFile, "[%10.3f] ", ullSimGetTimeUs() * 1e-6);
+    }
+    fputc(ucByte, pstLog->pstFile);
+    pstLog->bLineStart = ucByte == '\n';
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sink of Serial1 (HC12). The bytes are parsed as telemetry messages
+***************************************************************************************************/
+static void vTelemetrySink(uint8_t ucByte, void* pvContext)
+{
+    (void)pvContext;
+    clTelemetryStream_.write(ucByte);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Parses the telemetry received since the last call
+***************************************************************************************************/
+static void vParseTelemetry()
+{
+    unsigned char aucMessage[sizeof(RecorderChunk_st)];
+    unsigned int ulMsgLength = 0;
+    MessageID_e eMsgId = MESSAGEID_COUNT;
+
+    while (clTelemetryComms_.bReadInputMessage(clTelemetryStream_, aucMessage, ulMsgLength, eMsgId))
+    {
+        bMergeTelemetry(eMsgId, aucMessage, stTelemetryView_);
+        aulTelemetryMessages_[eMsgId]++;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sends the control parameters to the sketch through Serial1, as the user Arduino does
+***************************************************************************************************/
+static void vSendControlParams(const ControlParams_st& stControl)
+{
+    ByteStream_cl clMessage;
+    CommsManager_cl clComms;
+    clComms.vSendMessage(stControl, MESSAGEID_CONTROLPARAMS, clMessage);
+
+    std::vector<uint8_t> aucBytes(clMessage.clBytes_.begin(), clMessage.clBytes_.end());
+    Serial1.vSimInject(aucBytes.data(), aucBytes.size());
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Writes the header of the trace
+***************************************************************************************************/
+static void vWriteTraceHeader(FILE* pstTrace)
+{
+    fprintf(pstTrace, "time_s,wind_mps,measured_wind_mps,average_wind_mps,forecast_wind_mps,"
+                      "rotor_rpm,beta_rad,target_pitch_pct,pitch_pct,servo_turns,measured_servo_turns,"
+                      "break_pos,break_status,startup_status,telemetry_period_ms,link_load_pct\n");
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Writes one sample of the trace
+***************************************************************************************************/
+static void vWriteTraceSample(FILE* pstTrace)
+{
+    const PlantState_st& stPlant = clPlant_.stGetState();
+    float fTargetPitch = stControlParams_.ePitchMode == PITCHMODE_AUTO ? fAutoPitchExtensionPercent_ :
+                                                                          stControlParams_.fBladePitchPercentage;
+
+    fprintf(pstTrace, "%.3f,%.3f,%.3f,%.3f,%.3f,%.1f,%.4f,%.2f,%.2f,%.2f,%d,%.3f,%d,%d,%lu,%u\n",
+            ullSimGetTimeUs() * 1e-6,
+            stPlant.fWindSpeed,
+            stAeroData_.fWindSpeed,
+            stAeroData_.fAverageWindSpeed,
+            clWindPredictor_.fGetForecast(),
+            stPlant.fRotorSpeedRPM,
+            stPlant.fBetaRad,
+            fTargetPitch,
+            stAeroData_.fBladePitchPercentage,
+            stPlant.fServoTurns,
+            clPitchControlServo_.ulGetCurrentTurns(),
+            stPlant.fBreakPosition,
+            static_cast<int>(stAeroData_.stStatus.eBreakStatus),
+            static_cast<int>(stAeroData_.stStatus.eStartupStatus),
+            clTelemetryGovernor_.ulGetPeriodMs(),
+            clTelemetryGovernor_.ucGetLoadPercent());
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Writes the statistics of the run
+***************************************************************************************************/
+static void vPrintStatistics(double dWallS, uint64_t ullLoopPasses)
+{
+    const PlantStats_st& stPlantStats = clPlant_.stGetStats();
+    double dVirtualS = ullSimGetTimeUs() * 1e-6;
+
+    printf("--- Simulation ---\n");
+    printf("virtual time: %.1f s, wall time: %.2f s, speed-up: %.0fx\n", dVirtualS, dWallS, dWallS > 0.0 ? dVirtualS / dWallS : 0.0);
+    printf("loop passes: %llu, interrupts off max: %llu us\n",
+           static_cast<unsigned long long>(ullLoopPasses), static_cast<unsigned long long>(ullSimGetMaxInterruptsOffUs()));
+    printf("ISRs: anemometer=%u tacometer=%u servo hall=%u\n",
+           ulSimGetIsrCount(ANEMOMETER_HALL_PIN), ulSimGetIsrCount(TACOMETER_HALL_PIN), ulSimGetIsrCount(SERVO_HALL_PIN));
+    printf("HC12: tx=%u bytes, blocked=%.3f s, rx overflows=%u\n",
+           Serial1.ulSimGetTxBytes(), Serial1.ullSimGetBlockedUs() * 1e-6, Serial1.ulSimGetRxOverflows());
+    printf("telemetry: period=%lu ms, load=%u %%, deferred=%u\n", clTelemetryGovernor_.ulGetPeriodMs(),
+           clTelemetryGovernor_.ucGetLoadPercent(), clTelemetryGovernor_.ulGetDeferred());
+    printf("telemetry messages: kinematics=%u environment=%u status=%u\n", aulTelemetryMessages_[MESSAGEID_KINEMATICS],
+           aulTelemetryMessages_[MESSAGEID_ENVIRONMENT], aulTelemetryMessages_[MESSAGEID_STATUS]);
+    printf("telemetry view: rotor=%.1f rpm pitch=%.1f %% temp=%.1f C break=%d startup=%d\n",
+           stTelemetryView_.fRotorSpeedRPM, stTelemetryView_.fBladePitchPercentage, stTelemetryView_.fTempCelsius,
+           static_cast<int>(stTelemetryView_.stStatus.eBreakStatus), static_cast<int>(stTelemetryView_.stStatus.eStartupStatus));
+    printf("debug Serial: tx=%u bytes, blocked=%.3f s\n", Serial.ulSimGetTxBytes(), Serial.ullSimGetBlockedUs() * 1e-6);
+    printf("EEPROM writes: %u\n", EEPROM.ulSimGetWrites());
+
+    printf("--- Plant ---\n");
+    printf("max rotor speed: %.1f rpm (limit %.1f)\n", stPlantStats.fMaxRotorSpeedRPM, stControlParams_.fMaxRotorSpeedRPM);
+    printf("rotor over the regulator setpoint: %.1f s, over the limit: %.1f s\n", stPlantStats.fOverSetpointS, stPlantStats.fOverLimitS);
+    printf("pitch servo: against end stop=%.2f s, switches=%lu, overshoots=%lu\n",
+           stPlantStats.fServoEndStopS, clPitchControlServo_.ulGetRelaySwitches(), clPitchControlServo_.ulGetOvershoots());
+    printf("break: both relays energised=%.3f s\n", stPlantStats.fBreakConflictS);
+
+    BreakTripStats_st stTripStats;
+    clBreakController_.vGetTripStats(stTripStats);
+    printf("overspeed trips: n=%u false=%u, break latency max=%lu us, dropped events=%lu\n",
+           stTripStats.ulTrips, stTripStats.ulFalseTrips, static_cast<unsigned long>(clBreakController_.ulGetMaxLatencyUs()),
+           static_cast<unsigned long>(clBreakController_.ulGetDroppedEvents()));
+    printf("rotor regulator: rms=%.1f rpm, saturated steps=%u\n",
+           clRotorRegulator_.fGetRmsErrorRPM(), clRotorRegulator_.ulGetSaturatedSteps());
+    static const char* const apscDemandNames[BREAKDEMAND_COUNT] = {"overspeed", "manual"};
+    for (unsigned char ucDemand = 0; ucDemand < BREAKDEMAND_COUNT; ucDemand++)
+    {
+        const BreakLatency_st& stLatency = stPlantStats.astBreakLatency[ucDemand];
+        printf("break latency %s: demands=%u answered=%u withdrawn=%u mean=%.1f ms max=%.1f ms\n",
+               apscDemandNames[ucDemand], stLatency.ulDemands, stLatency.ulResponses, stLatency.ulWithdrawn,
+               stLatency.ulResponses > 0 ? stLatency.ullSumUs * 1e-3 / stLatency.ulResponses : 0.0,
+               stLatency.ullMaxUs * 1e-3);
+    }
+
+    printf("--- Scheduler [us] ---\n");
+    FilePrint_cl clStdout(stdout);
+    clScheduler_.vPrintStats(clStdout);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Opens an output file ("-" is stdout)
+***************************************************************************************************/
+static FILE* pstOpenOutput(const char* pscFileName)
+{
+    if (pscFileName == NULL)
+    {
+        return NULL;
+    }
+
+    return strcmp(pscFileName, "-") == 0 ? stdout : fopen(pscFileName, "w");
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Entry point of the simulator
+***************************************************************************************************/
+int main(int slArgc, char** apscArgv)
+{
+    SimOptions_st stOptions;
+    if (!bParseOptions(slArgc, apscArgv, stOptions))
+    {
+        vPrintUsage(apscArgv[0]);
+        return 1;
+    }
+
+    /* Outputs */
+    FILE* pstTrace = pstOpenOutput(stOptions.pscTraceFile);
+    stDebugLog_.pstFile = pstOpenOutput(stOptions.pscLogFile);
+    if ((stOptions.pscTraceFile != NULL && pstTrace == NULL) || (stOptions.pscLogFile != NULL && stDebugLog_.pstFile == NULL))
+    {
+        fprintf(stderr, "Can't open the output files\n");
+        return 1;
+    }
+    Serial.vSimSetSink(vDebugSink, &stDebugLog_);
+    Serial1.vSimSetSink(vTelemetrySink, NULL);
+    fTaskCostScale_ = stOptions.fTaskCostScale;
+    vSimSetTaskCost(ulGetTaskCost);
+
+    /* Plant and EEPROM contents of the last run */
+    stOptions.stPlant.fMaxRotorSpeedRPM = stOptions.stControl.fMaxRotorSpeedRPM;
+    stOptions.stPlant.fRotorSetpointRPM = stOptions.stControl.fMaxRotorSpeedRPM * ROTOR_SPEED_SETPOINT_RATIO_F;
+    if (!clPlant_.bSetup(stOptions.stPlant))
+    {
+        fprintf(stderr, "Can't read the wind file %s\n", stOptions.stPlant.pscWindFile);
+        return 1;
+    }
+    if (stOptions.pscEepromFile != NULL)
+    {
+        EEPROM.bSimLoad(stOptions.pscEepromFile);
+    }
+    if (pstTrace != NULL)
+    {
+        vWriteTraceHeader(pstTrace);
+    }
+
+    /* Run the sketch */
+    std::chrono::steady_clock::time_point clWallStart = std::chrono::steady_clock::now();
+    uint64_t ullEndUs          = static_cast<uint64_t>(stOptions.fDurationS * SECONDS_TO_MICROS_ULL);
+    uint64_t ullNextControlUs  = 0;
+    uint64_t ullNextTraceUs    = 0;
+    uint64_t ullLoopPasses     = 0;
+
+    setup();
+    if (stOptions.pscRegulator != NULL)
+    {
+        float fKp = 0.0f;
+        float fKi = 0.0f;
+        if (sscanf(stOptions.pscRegulator, "%f,%f", &fKp, &fKi) != 2)
+        {
+            fprintf(stderr, "Invalid regulator gains %s\n", stOptions.pscRegulator);
+            return 1;
+        }
+        clRotorRegulator_.vSetup(fKp, fKi);
+    }
+    while (ullSimGetTimeUs() < ullEndUs)
+    {
+        /* Manual break in the second half of each period. A change is sent immediately */
+        if (stOptions.fManualBreakS > 0.0f)
+        {
+            uint64_t ullPeriodUs = static_cast<uint64_t>(stOptions.fManualBreakS * SECONDS_TO_MICROS_ULL);
+            ManualBreak_e eManualBreak = ullSimGetTimeUs() % ullPeriodUs >= ullPeriodUs / 2 ? MANUALBREAK_ON : MANUALBREAK_OFF;
+            if (eManualBreak != stOptions.stControl.eManualBreak)
+            {
+                stOptions.stControl.eManualBreak = eManualBreak;
+                ullNextControlUs = ullSimGetTimeUs();
+                if (eManualBreak == MANUALBREAK_ON)
+                {
+                    clPlant_.vDemandBreak(BREAKDEMAND_MANUAL);
+                }
+            }
+        }
+
+        if (ullSimGetTimeUs() >= ullNextControlUs)
+        {
+            vSendControlParams(stOptions.stControl);
+            ullNextControlUs += CONTROL_PARAMS_PERIOD_US;
+        }
+
+        loop();
+        ullLoopPasses++;
+        vSimAdvanceUs(stOptions.ulLoopCostUs);
+        vParseTelemetry();
+
+        if (pstTrace != NULL && ullSimGetTimeUs() >= ullNextTraceUs)
+        {
+            vWriteTraceSample(pstTrace);
+            ullNextTraceUs += stOptions.ulTracePeriodMs * 1000ULL;
+        }
+    }
+    double dWallS = std::chrono::duration<double>(std::chrono::steady_clock::now() - clWallStart).count();
+
+    /* Results */
+    vPrintStatistics(dWallS, ullLoopPasses);
+    if (stOptions.pscEepromFile != NULL && !EEPROM.bSimStore(stOptions.pscEepromFile))
+    {
+        fprintf(stderr, "Can't write the EEPROM image %s\n", stOptions.pscEepromFile);
+    }
+    if (pstTrace != NULL && pstTrace != stdout)
+    {
+        fclose(pstTrace);
+    }
+    if (stDebugLog_.pstFile != NULL && stDebugLog_.pstFile != stdout)
+    {
+        fclose(stDebugLog_.pstFile);
+    }
+
+    return 0;
+}
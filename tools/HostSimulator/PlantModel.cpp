@@ -0,0 +1,373 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <CommonConstants.h>
+#include <Interpolation.h>
+#include <SimCore.h>
+#include <stdio.h>
+
+/* Custom includes */
+#include "Constants.h"
+#include "PlantModel.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+static const uint32_t PLANT_UPDATE_PERIOD_US      = 1000;                                                                              /**< Period of the slow dynamics [us]            */
+static const float    ANEMOMETER_METERS_PER_PULSE_F = 0.189f * 2.0f * PI / ANEMOMETER_NUM_MAGNETS;                                     /**< Wind run per anemometer pulse [m]           */
+static const float    SERVO_PERCENT_PER_TURN_F    = SERVO_LENGHT_MM / SERVO_TURNS_TO_FULL_EXTENSION / SERVO_USABLE_LENGTH_MM * 100.0f; /**< Actuator extension per servo turn [%]       */
+static const float    BREAK_TRAVEL_PER_S_F        = 1000.0f / TIME_BREAK_ACT_OP_EXTENSION_MS;                                          /**< Break actuator speed [1/s]                  */
+static const float    GUST_PERIOD_S_F             = 30.0f;                                                                             /**< Time between gusts (WINDSCENARIO_GUSTS) [s] */
+static const float    GUST_DURATION_S_F           = 8.0f;                                                                              /**< Duration of a gust [s]                      */
+static const float    GUST_AMPLITUDE_F            = 0.6f;                                                                              /**< Gust amplitude, relative to the mean speed  */
+static const float    RAMP_PERIOD_S_F             = 240.0f;                                                                            /**< Period of WINDSCENARIO_RAMP [s]             */
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the plant model class
+***************************************************************************************************/
+PlantModel_cl::PlantModel_cl()
+{
+    stParams_         = {};
+    stState_          = {};
+    stStats_          = {};
+    ullStartUs_       = 0;
+    ullLastStepUs_    = 0;
+    ullLastUpdateUs_  = 0;
+    fAnemometerPhase_ = 0.0f;
+    fTacometerPhase_  = 0.0f;
+    fTurbulence_      = 0.0f;
+    ulRandomState_    = 1;
+    bOverspeed_       = false;
+    for (unsigned char ucDemand = 0; ucDemand < BREAKDEMAND_COUNT; ucDemand++)
+    {
+        abDemandPending_[ucDemand] = false;
+        aullDemandUs_[ucDemand]    = 0;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Setup the model and install it as the step hook of the virtual clock
+* \param[in] stParams: Configuration of the model
+* \return False if the wind file can't be read
+***************************************************************************************************/
+bool PlantModel_cl::bSetup(const PlantParams_st& stParams)
+{
+    stParams_ = stParams;
+    if (stParams_.eScenario == WINDSCENARIO_FILE && !bReadWindFile(stParams_.pscWindFile))
+    {
+        return false;
+    }
+
+    stState_.fServoTurns    = max(min(stParams_.fInitialServoTurns, static_cast<float>(SERVO_TURNS_TO_FULL_EXTENSION)), 0.0f);
+    stState_.fBreakPosition = max(min(stParams_.fInitialBreak, 1.0f), 0.0f);
+    ulRandomState_          = stParams_.ulSeed != 0 ? stParams_.ulSeed : 1;
+    ullStartUs_             = ullSimGetTimeUs();
+    ullLastStepUs_          = ullStartUs_;
+    ullLastUpdateUs_        = ullLastStepUs_;
+    stState_.fWindSpeed     = fComputeWindSpeed(0.0f, 0.0f);
+
+    vSimSetStepHook(vStepHook, this);
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the physical state of the plant
+* \return State at the last step
+***************************************************************************************************/
+const PlantState_st& PlantModel_cl::stGetState() const
+{
+    return stState_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function gets the events counted since the start
+* \return Statistics of the plant
+***************************************************************************************************/
+const PlantStats_st& PlantModel_cl::stGetStats() const
+{
+    return stStats_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function starts a break demand of the latency probe (see NOTE5)
+* \param[in] eDemand: Kind of demand
+***************************************************************************************************/
+void PlantModel_cl::vDemandBreak(const BreakDemand_e eDemand)
+{
+    /* The break is already acting, or a demand of this kind is being measured */
+    if (stState_.fBreakPosition >= PLANT_BREAK_CONTACT_F || abDemandPending_[eDemand])
+    {
+        return;
+    }
+
+    abDemandPending_[eDemand] = true;
+    aullDemandUs_[eDemand]    = ullSimGetTimeUs();
+    stStats_.astBreakLatency[eDemand].ulDemands++;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function updates the break latency probe (see NOTE5)
+* \param[in] ullNowUs: Virtual time [us]
+***************************************************************************************************/
+void PlantModel_cl::vProbeBreakLatency(const uint64_t ullNowUs)
+{
+    /* Overspeed demand, on the crossing of the limit */
+    bool bOverspeed = stParams_.fMaxRotorSpeedRPM > 0.0f && stState_.fRotorSpeedRPM > stParams_.fMaxRotorSpeedRPM;
+    if (bOverspeed && !bOverspeed_)
+    {
+        vDemandBreak(BREAKDEMAND_OVERSPEED);
+    }
+    else if (!bOverspeed && abDemandPending_[BREAKDEMAND_OVERSPEED])
+    {
+        abDemandPending_[BREAKDEMAND_OVERSPEED] = false;
+        stStats_.astBreakLatency[BREAKDEMAND_OVERSPEED].ulWithdrawn++;
+    }
+    bOverspeed_ = bOverspeed;
+
+    /* Answer of the pending demands */
+    if (!bSimIsOutputLow(ENABLE_BREAK_RELAY_PIN))
+    {
+        return;
+    }
+    for (unsigned char ucDemand = 0; ucDemand < BREAKDEMAND_COUNT; ucDemand++)
+    {
+        if (abDemandPending_[ucDemand])
+        {
+            BreakLatency_st& stLatency = stStats_.astBreakLatency[ucDemand];
+            uint64_t ullLatencyUs = ullNowUs - aullDemandUs_[ucDemand];
+            abDemandPending_[ucDemand] = false;
+            stLatency.ulResponses++;
+            stLatency.ullSumUs += ullLatencyUs;
+            stLatency.ullMaxUs  = max(stLatency.ullMaxUs, ullLatencyUs);
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Step hook of the virtual clock (see SimCore.h)
+* \param[in] ullNowUs: Virtual time [us]
+* \param[in] pvContext: Plant model
+***************************************************************************************************/
+void PlantModel_cl::vStepHook(uint64_t ullNowUs, void* pvContext)
+{
+    static_cast<PlantModel_cl*>(pvContext)->vStep(ullNowUs);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function advances the model to a new time. The pitch servo and the pulses are updated
+* in every step of the clock, the rest at PLANT_UPDATE_PERIOD_US
+* \param[in] ullNowUs: Virtual time [us]
+***************************************************************************************************/
+void PlantModel_cl::vStep(uint64_t ullNowUs)
+{
+    float fDeltaS = (ullNowUs - ullLastStepUs_) * 1e-6f;
+    ullLastStepUs_ = ullNowUs;
+
+    if (ullNowUs - ullLastUpdateUs_ >= PLANT_UPDATE_PERIOD_US)
+    {
+        vUpdateRotor((ullNowUs - ullStartUs_) * 1e-6f, (ullNowUs - ullLastUpdateUs_) * 1e-6f);
+        ullLastUpdateUs_ = ullNowUs;
+    }
+
+    /* Pitch servo. The relays are energised with LOW, both at once is a short (no movement) */
+    bool bExtend  = bSimIsOutputLow(BLADE_EXTENSION_PIN);
+    bool bRetract = bSimIsOutputLow(BLADE_RETRACTION_PIN);
+    float fDrive  = bExtend == bRetract ? 0.0f : (bExtend ? 1.0f : -1.0f);
+    stState_.fServoSpeed += (fDrive * PLANT_SERVO_SPEED_TURNS_S - stState_.fServoSpeed) * fDeltaS / PLANT_SERVO_TAU_S;
+
+    float fOldTurns = stState_.fServoTurns;
+    stState_.fServoTurns += stState_.fServoSpeed * fDeltaS;
+    if (stState_.fServoTurns <= 0.0f || stState_.fServoTurns >= SERVO_TURNS_TO_FULL_EXTENSION)
+    {
+        stState_.fServoTurns = max(min(stState_.fServoTurns, static_cast<float>(SERVO_TURNS_TO_FULL_EXTENSION)), 0.0f);
+        stState_.fServoSpeed = 0.0f;
+        if (fDrive != 0.0f)
+        {
+            stStats_.fServoEndStopS += fDeltaS;
+        }
+    }
+    if (floor(stState_.fServoTurns) != floor(fOldTurns))
+    {
+        stStats_.ulServoPulses++;
+        vPulse(SERVO_HALL_PIN);
+    }
+
+    /* Anemometer and tacometer pulses */
+    if (stState_.fWindSpeed > PLANT_MIN_WIND_SPEED_F)
+    {
+        fAnemometerPhase_ += stState_.fWindSpeed * fDeltaS / ANEMOMETER_METERS_PER_PULSE_F;
+        if (fAnemometerPhase_ >= 1.0f)
+        {
+            fAnemometerPhase_ -= 1.0f;
+            stStats_.ulAnemometerPulses++;
+            vPulse(ANEMOMETER_HALL_PIN);
+        }
+    }
+    fTacometerPhase_ += stState_.fRotorSpeedRPM * TACOMETER_NUM_MAGNETS / 60.0f * fDeltaS;
+    if (fTacometerPhase_ >= 1.0f)
+    {
+        fTacometerPhase_ -= 1.0f;
+        stStats_.ulTacometerPulses++;
+        vPulse(TACOMETER_HALL_PIN);
+    }
+
+    vProbeBreakLatency(ullNowUs);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function updates the wind, the rotor and the break actuator (slow dynamics)
+* \param[in] fTimeS: Time since the setup [s]
+* \param[in] fDeltaS: Time since the last update [s]
+***************************************************************************************************/
+void PlantModel_cl::vUpdateRotor(const float fTimeS, const float fDeltaS)
+{
+    stState_.fWindSpeed = fComputeWindSpeed(fTimeS, fDeltaS);
+
+    /* Break actuator. Both relays at once is a short (no movement) */
+    bool bEnable  = bSimIsOutputLow(ENABLE_BREAK_RELAY_PIN);
+    bool bDisable = bSimIsOutputLow(DISABLE_BREAK_RELAY_PIN);
+    if (bEnable && bDisable)
+    {
+        stStats_.fBreakConflictS += fDeltaS;
+    }
+    else if (bEnable || bDisable)
+    {
+        stState_.fBreakPosition += (bEnable ? 1.0f : -1.0f) * BREAK_TRAVEL_PER_S_F * fDeltaS;
+        stState_.fBreakPosition  = max(min(stState_.fBreakPosition, 1.0f), 0.0f);
+    }
+
+    /* Blade angle, and angle of maximum efficiency for the current wind and rotor speed (as the
+    automatic pitch of the sketch) */
+    float fExtensionPercent = min(stState_.fServoTurns * SERVO_PERCENT_PER_TURN_F, PITCH_CONTROL_EXTENSION_F[PITCH_ANGLE_CALIBRATION_POINTS_UC - 1]);
+    stState_.fBetaRad = tInterp1D(PITCH_CONTROL_EXTENSION_F, PITCH_CONTROL_BETA_ANGLE_F, fExtensionPercent);
+    float fOptimumBeta = atan2(stState_.fWindSpeed, stState_.fRotorSpeedRPM * RPM_TO_RADSEC_F * PITCH_CONTROL_SECTION_RADIUS_M_F) -
+                         PITCH_CONTROL_SECTION_ANGLE_RAD_F;
+
+    /* Aerodynamic efficiency, and speed the rotor is moving to */
+    float fPitchError  = (stState_.fBetaRad - fOptimumBeta) / PLANT_PITCH_ERROR_WIDTH_F;
+    float fEfficiency  = max(1.0f - fPitchError * fPitchError, 0.0f);
+    float fTargetRPM   = PLANT_ROTOR_RPM_PER_WIND_F * stState_.fWindSpeed * fEfficiency;
+    stState_.fRotorSpeedRPM += (fTargetRPM - stState_.fRotorSpeedRPM) * min(fDeltaS / PLANT_ROTOR_TAU_S, 1.0f);
+
+    /* Break */
+    float fBreakForce = (stState_.fBreakPosition - PLANT_BREAK_CONTACT_F) / (1.0f - PLANT_BREAK_CONTACT_F);
+    if (fBreakForce > 0.0f)
+    {
+        stState_.fRotorSpeedRPM -= fBreakForce * PLANT_BREAK_DECEL_RPM_S * fDeltaS;
+    }
+    stState_.fRotorSpeedRPM = max(stState_.fRotorSpeedRPM, 0.0f);
+    stStats_.fMaxRotorSpeedRPM = max(stStats_.fMaxRotorSpeedRPM, stState_.fRotorSpeedRPM);
+    if (stParams_.fRotorSetpointRPM > 0.0f && stState_.fRotorSpeedRPM > stParams_.fRotorSetpointRPM)
+    {
+        stStats_.fOverSetpointS += fDeltaS;
+    }
+    if (stParams_.fMaxRotorSpeedRPM > 0.0f && stState_.fRotorSpeedRPM > stParams_.fMaxRotorSpeedRPM)
+    {
+        stStats_.fOverLimitS += fDeltaS;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function computes the wind speed of the scenario
+* \param[in] fTimeS: Time since the setup [s]
+* \param[in] fDeltaS: Time since the last update [s]
+* \return Wind speed [m/s]
+***************************************************************************************************/
+float PlantModel_cl::fComputeWindSpeed(const float fTimeS, const float fDeltaS)
+{
+    float fMean = stParams_.fMeanWindSpeed;
+    float fWindSpeed = fMean;
+
+    switch (stParams_.eScenario)
+    {
+    case WINDSCENARIO_GUSTS:
+    {
+        /* Turbulence: first order filter of uniform noise, scaled to the requested deviation */
+        ulRandomState_ = ulRandomState_ * 1664525UL + 1013904223UL;
+        float fNoise = (static_cast<float>(ulRandomState_ >> 8) / 16777216.0f - 0.5f) * 3.4641f;
+        float fGain  = fDeltaS / PLANT_TURBULENCE_TAU_S;
+        fTurbulence_ += (fNoise * stParams_.fTurbulence * fMean * sqrt(2.0f / max(fGain, 1e-6f)) - fTurbulence_) * fGain;
+
+        /* 1-cos gust at the start of each period */
+        float fGustTime = fmod(fTimeS, GUST_PERIOD_S_F);
+        float fGust     = 0.0f;
+        if (fTimeS >= GUST_PERIOD_S_F && fGustTime < GUST_DURATION_S_F)
+        {
+            fGust = 0.5f * GUST_AMPLITUDE_F * fMean * (1.0f - cos(2.0f * PI * fGustTime / GUST_DURATION_S_F));
+        }
+        fWindSpeed = fMean + fTurbulence_ + fGust;
+        break;
+    }
+
+    case WINDSCENARIO_RAMP:
+    {
+        float fPhase = fmod(fTimeS, RAMP_PERIOD_S_F) / RAMP_PERIOD_S_F;
+        fWindSpeed = 2.0f * fMean * (fPhase < 0.5f ? 2.0f * fPhase : 2.0f - 2.0f * fPhase);
+        break;
+    }
+
+    case WINDSCENARIO_STORM:
+        fWindSpeed = fTimeS >= 60.0f && fTimeS < 120.0f ? 2.5f * fMean : 0.5f * fMean;
+        break;
+
+    case WINDSCENARIO_FILE:
+    {
+        /* Linear interpolation, holding the first and last values */
+        unsigned int ulSamples = afFileTimeS_.size();
+        fWindSpeed = afFileWindSpeed_[fTimeS <= afFileTimeS_[0] ? 0 : ulSamples - 1];
+        if (ulSamples >= 2 && fTimeS > afFileTimeS_[0] && fTimeS < afFileTimeS_[ulSamples - 1])
+        {
+            unsigned int ulIdx = ulFindSegment(afFileTimeS_.data(), ulSamples, fTimeS);
+            float fRatio = (fTimeS - afFileTimeS_[ulIdx]) / (afFileTimeS_[ulIdx + 1] - afFileTimeS_[ulIdx]);
+            fWindSpeed = afFileWindSpeed_[ulIdx] + fRatio * (afFileWindSpeed_[ulIdx + 1] - afFileWindSpeed_[ulIdx]);
+        }
+        break;
+    }
+
+    default:
+        break;
+    }
+
+    return max(fWindSpeed, 0.0f);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function reads the wind file of WINDSCENARIO_FILE
+* \param[in] pscFileName: CSV file with time [s] and wind speed [m/s] in each line
+* \return False if the file can't be read or has no samples
+***************************************************************************************************/
+bool PlantModel_cl::bReadWindFile(const char* pscFileName)
+{
+    FILE* pstFile = pscFileName != NULL ? fopen(pscFileName, "r") : NULL;
+    if (pstFile == NULL)
+    {
+        return false;
+    }
+
+    /* Lines that don't start with two numbers (header, comments) are skipped. Times must increase */
+    char ascLine[128];
+    while (fgets(ascLine, sizeof(ascLine), pstFile) != NULL)
+    {
+        float fTimeS = 0.0f;
+        float fWindSpeed = 0.0f;
+        if (sscanf(ascLine, "%f%*[ ,;\t]%f", &fTimeS, &fWindSpeed) == 2 &&
+            (afFileTimeS_.empty() || fTimeS > afFileTimeS_.back()))
+        {
+            afFileTimeS_.push_back(fTimeS);
+            afFileWindSpeed_.push_back(fWindSpeed);
+        }
+    }
+    fclose(pstFile);
+
+    return !afFileTimeS_.empty();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief This function generates one pulse (rising and falling edges) on an input pin
+* \param[in] ucPin: Input pin
+***************************************************************************************************/
+void PlantModel_cl::vPulse(const uint8_t ucPin)
+{
+    vSimSetPinInput(ucPin, HIGH);
+    vSimSetPinInput(ucPin, LOW);
+}
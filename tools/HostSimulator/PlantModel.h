@@ -0,0 +1,235 @@
+#ifndef PLANT_MODEL_H_
+#define PLANT_MODEL_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+#include <vector>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Model of the physical system around the control Arduino: wind, anemometer, rotor with
+tacometer, break actuator and pitch servo with its hall sensor. It is stepped by the virtual clock of
+the host Arduino core (vStepHook), reads the relays from the output pins and generates the hall
+sensor pulses on the input pins. Pins and calibration come from the sketch (Constants.h)
+- NOTE2: The rotor is a first order system (time constant PLANT_ROTOR_TAU_S) towards a speed that
+grows linearly with the wind (PLANT_ROTOR_RPM_PER_WIND_F) and is reduced by the pitch error: the
+difference between the blade angle beta (from the actuator extension, inverse of the calibration
+curve) and the angle of maximum efficiency for the current wind and rotor speed. The model is only
+meant to close the loop with a plausible behaviour, it is not a model of the real turbine
+- NOTE3: The break actuator position goes from 0 (released stop) to 1 (break fully applied) in
+TIME_BREAK_ACT_OP_EXTENSION_MS. The break acts on the rotor over PLANT_BREAK_CONTACT_F
+- NOTE4: The pitch servo is a motor with first order speed dynamics (it coasts when the relays are
+released) and end stops at 0 and SERVO_TURNS_TO_FULL_EXTENSION turns. Each integer turn crossed
+generates a hall pulse, in both directions
+- NOTE5: Break latency probe. A break demand starts when the rotor goes over fMaxRotorSpeedRPM, or
+when the simulator sends a manual break request (vDemandBreak()), with the break pads not touching
+the rotor. Its latency is the virtual time until the break relay is energised, measured in every
+step of the clock. A demand that goes away before that (rotor back under the limit) is withdrawn
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const float PLANT_ROTOR_RPM_PER_WIND_F = 25.0f;  /**< Rotor speed at maximum efficiency [rpm/(m/s)]      */
+const float PLANT_ROTOR_TAU_S          = 3.0f;   /**< Time constant of the rotor speed [s]               */
+const float PLANT_PITCH_ERROR_WIDTH_F  = 1.2f;   /**< Pitch error with no aerodynamic torque [rad]       */
+const float PLANT_BREAK_CONTACT_F      = 0.5f;   /**< Break actuator position where the pads touch [0-1] */
+const float PLANT_BREAK_DECEL_RPM_S    = 150.0f; /**< Rotor deceleration with the break fully applied    */
+const float PLANT_SERVO_SPEED_TURNS_S  = 25.0f;  /**< Speed of the pitch servo motor [turns/s]           */
+const float PLANT_SERVO_TAU_S          = 0.025f; /**< Time constant of the pitch servo motor speed [s]   */
+const float PLANT_MIN_WIND_SPEED_F     = 0.05f;  /**< Below this wind speed the anemometer stops [m/s]   */
+const float PLANT_TURBULENCE_TAU_S     = 2.0f;   /**< Correlation time of the turbulence [s]             */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \enum WindScenario_e
+ * \brief Wind speed histories
+ **************************************************************************************************/
+enum WindScenario_e
+{
+    WINDSCENARIO_STEADY = 0, /**< Constant wind speed                                            */
+    WINDSCENARIO_GUSTS  = 1, /**< Turbulence plus a 1-cos gust every 30 s                        */
+    WINDSCENARIO_RAMP   = 2, /**< Slow ramp from 0 to twice the mean speed and back (4 min)      */
+    WINDSCENARIO_STORM  = 3, /**< Half the mean speed, 2.5 times the mean speed from 60 to 120 s */
+    WINDSCENARIO_FILE   = 4, /**< Time [s] and wind speed [m/s] read from a CSV file             */
+    WINDSCENARIO_COUNT  = 5, /**< Number of scenarios                                            */
+};
+
+/***********************************************************************************************//**
+ * \enum BreakDemand_e
+ * \brief Physical events that need the break (see NOTE5)
+ **************************************************************************************************/
+enum BreakDemand_e
+{
+    BREAKDEMAND_OVERSPEED = 0, /**< Rotor speed over the limit      */
+    BREAKDEMAND_MANUAL    = 1, /**< Manual break request sent       */
+    BREAKDEMAND_COUNT     = 2, /**< Number of kinds of break demand */
+};
+
+/***********************************************************************************************//**
+ * \struct PlantParams_st
+ * \brief Configuration of the plant model
+ **************************************************************************************************/
+struct PlantParams_st
+{
+    WindScenario_e eScenario;          /**< Wind speed history                                 */
+    float          fMeanWindSpeed;     /**< Mean wind speed of the scenario [m/s]              */
+    float          fTurbulence;        /**< Standard deviation of the turbulence [m/s per m/s] */
+    uint32_t       ulSeed;             /**< Seed of the turbulence                             */
+    const char*    pscWindFile;        /**< CSV file (WINDSCENARIO_FILE)                       */
+    float          fInitialServoTurns; /**< Position of the pitch servo at power on [turns]    */
+    float          fInitialBreak;      /**< Position of the break actuator at power on [0-1]   */
+    float          fMaxRotorSpeedRPM;  /**< Rotor speed limit of the break latency probe [rpm] */
+    float          fRotorSetpointRPM;  /**< Setpoint of the rotor speed regulator [rpm]        */
+};
+
+/***********************************************************************************************//**
+ * \struct PlantState_st
+ * \brief Physical state of the plant
+ **************************************************************************************************/
+struct PlantState_st
+{
+    float fWindSpeed;     /**< Wind speed [m/s]                              */
+    float fRotorSpeedRPM; /**< Rotor speed [rpm]                             */
+    float fBetaRad;       /**< Blade angle from the actuator extension [rad] */
+    float fServoTurns;    /**< Pitch servo position [turns]                  */
+    float fServoSpeed;    /**< Pitch servo speed [turns/s]                   */
+    float fBreakPosition; /**< Break actuator position [0-1]                 */
+};
+
+/***********************************************************************************************//**
+ * \struct BreakLatency_st
+ * \brief Break latency probe statistics of one kind of demand (see NOTE5)
+ **************************************************************************************************/
+struct BreakLatency_st
+{
+    uint32_t ulDemands;   /**< Break demands                           */
+    uint32_t ulResponses; /**< Demands answered by the break relay     */
+    uint32_t ulWithdrawn; /**< Demands that went away before the relay */
+    uint64_t ullSumUs;    /**< Sum of the latencies [us]               */
+    uint64_t ullMaxUs;    /**< Maximum latency [us]                    */
+};
+
+/***********************************************************************************************//**
+ * \struct PlantStats_st
+ * \brief Events counted by the plant model
+ **************************************************************************************************/
+struct PlantStats_st
+{
+    float    fMaxRotorSpeedRPM;  /**< Highest rotor speed [rpm]                            */
+    uint32_t ulAnemometerPulses; /**< Pulses of the anemometer hall sensor                 */
+    uint32_t ulTacometerPulses;  /**< Pulses of the tacometer hall sensor                  */
+    uint32_t ulServoPulses;      /**< Pulses of the pitch servo hall sensor                */
+    float    fServoEndStopS;     /**< Time with the servo motor powered against a stop [s] */
+    float    fBreakConflictS;    /**< Time with both break relays energised [s]            */
+    float    fOverSetpointS;     /**< Time with the rotor over fRotorSetpointRPM [s]       */
+    float    fOverLimitS;        /**< Time with the rotor over fMaxRotorSpeedRPM [s]       */
+    BreakLatency_st astBreakLatency[BREAKDEMAND_COUNT]; /**< Break latency probe, by demand    */
+};
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class PlantModel_cl
+ * \brief Physical system controlled by the sketch
+ **************************************************************************************************/
+class PlantModel_cl
+{
+public:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Constructor of the plant model class
+    ***********************************************************************************************/
+    PlantModel_cl();
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Setup the model and install it as the step hook of the virtual clock
+    * \param[in] stParams: Configuration of the model
+    * \return False if the wind file can't be read
+    ***********************************************************************************************/
+    bool bSetup(const PlantParams_st& stParams);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the physical state of the plant
+    * \return State at the last step
+    ***********************************************************************************************/
+    const PlantState_st& stGetState() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function gets the events counted since the start
+    * \return Statistics of the plant
+    ***********************************************************************************************/
+    const PlantStats_st& stGetStats() const;
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function starts a break demand of the latency probe (see NOTE5)
+    * \param[in] eDemand: Kind of demand
+    ***********************************************************************************************/
+    void vDemandBreak(BreakDemand_e eDemand);
+
+private:
+    /****************************************** FUNCTION ***************************************//**
+    * \brief Step hook of the virtual clock (see SimCore.h)
+    * \param[in] ullNowUs: Virtual time [us]
+    * \param[in] pvContext: Plant model
+    ***********************************************************************************************/
+    static void vStepHook(uint64_t ullNowUs, void* pvContext);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function advances the model to a new time
+    * \param[in] ullNowUs: Virtual time [us]
+    ***********************************************************************************************/
+    void vStep(uint64_t ullNowUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function updates the wind, the rotor and the break actuator (slow dynamics)
+    * \param[in] fTimeS: Virtual time [s]
+    * \param[in] fDeltaS: Time since the last update [s]
+    ***********************************************************************************************/
+    void vUpdateRotor(float fTimeS, float fDeltaS);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function computes the wind speed of the scenario
+    * \param[in] fTimeS: Virtual time [s]
+    * \param[in] fDeltaS: Time since the last update [s]
+    * \return Wind speed [m/s]
+    ***********************************************************************************************/
+    float fComputeWindSpeed(float fTimeS, float fDeltaS);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function reads the wind file of WINDSCENARIO_FILE
+    * \param[in] pscFileName: CSV file with time [s] and wind speed [m/s] in each line
+    * \return False if the file can't be read or has no samples
+    ***********************************************************************************************/
+    bool bReadWindFile(const char* pscFileName);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function updates the break latency probe (see NOTE5)
+    * \param[in] ullNowUs: Virtual time [us]
+    ***********************************************************************************************/
+    void vProbeBreakLatency(uint64_t ullNowUs);
+
+    /****************************************** FUNCTION ***************************************//**
+    * \brief This function generates one pulse (rising and falling edges) on an input pin
+    * \param[in] ucPin: Input pin
+    ***********************************************************************************************/
+    static void vPulse(uint8_t ucPin);
+
+    /***************************************** ATTRIBUTES *****************************************/
+    PlantParams_st     stParams_;         /**< Configuration                             */
+    PlantState_st      stState_;          /**< Physical state                            */
+    PlantStats_st      stStats_;          /**< Events counted since the start            */
+    uint64_t           ullStartUs_;       /**< Virtual time of the setup [us]            */
+    uint64_t           ullLastStepUs_;    /**< Virtual time of the last step [us]        */
+    uint64_t           ullLastUpdateUs_;  /**< Virtual time of the last slow update [us] */
+    float              fAnemometerPhase_; /**< Fraction of the anemometer pulse period   */
+    float              fTacometerPhase_;  /**< Fraction of the tacometer pulse period    */
+    float              fTurbulence_;      /**< Filtered noise of the turbulence [m/s]    */
+    uint32_t           ulRandomState_;    /**< State of the noise generator              */
+    std::vector<float> afFileTimeS_;      /**< Times of the wind file [s]                */
+    std::vector<float> afFileWindSpeed_;  /**< Wind speeds of the wind file [m/s]        */
+    bool               abDemandPending_[BREAKDEMAND_COUNT]; /**< Demand waiting for the break relay */
+    uint64_t           aullDemandUs_[BREAKDEMAND_COUNT];    /**< Virtual time of the demand [us]     */
+    bool               bOverspeed_;       /**< Rotor over the limit at the last step     */
+};
+
+#endif /* PLANT_MODEL_H_ */
@@ -0,0 +1,403 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <SimCore.h>
+#include <Wire.h>
+#include <LiquidCrystal_I2C.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Custom includes */
+#include "HostTest.h"
+#include "LcdFramebuffer.h"
+
+
+/*
+- NOTE1: Compares the I2C traffic of the panel screen of the User Arduino with the refresh of every
+field (setCursor() and one print() per character, as vRefreshScreen() did) and with the shadow
+framebuffer (LcdFramebuffer_cl, flushed after each refresh). Both screens show the same readings,
+formatted the same way (dtostrf), so only the way of updating the screen differs. The mock Wire
+(shim/Wire.h) counts the transactions and bytes of each refresh and charges their bus time
+- NOTE2: Both screens use the LiquidCrystal_I2C library of the repository, which sends a run of
+characters in one transaction. With the original library each character cost several transactions
+plus the enable pulse delays, so the legacy figures are a lower bound of the original cost
+- NOTE3: The transactions of each screen are decoded by a model of the HD44780 (4 bits mode, data
+latched on the falling edge of the enable bit), and the text shown after each refresh must be the
+same on both screens
+- NOTE4: The readings are a deterministic minute of operation: the rotor speed changes in almost
+every refresh, the wind speed and pitch every few refreshes, and the temperature and humidity
+rarely. A second pass with constant readings gives the cost of a refresh where nothing changes
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const uint8_t       LEGACY_ADDRESS_UC           = 0x27;                     /**< I2C address of the screen refreshed field by field */
+static const uint8_t       FRAMEBUFFER_ADDRESS_UC      = 0x26;                     /**< I2C address of the screen behind the framebuffer   */
+static const unsigned long REFRESHES_UL                = 240;                      /**< Refreshes of the benchmark (1 minute at 250 ms)    */
+static const float         REFRESH_TIME_S_F            = 0.25f;                    /**< Time between refreshes [s]                         */
+static const unsigned char DDRAM_SIZE_UC               = 0x80;                     /**< Addresses of the HD44780 display RAM               */
+static const unsigned char ROW_ADDRESS_UC[LCD_ROWS_UC] = { 0x00, 0x40, 0x14, 0x54 }; /**< DDRAM address of the first cell of each row        */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct Readings_st
+ * \brief Values shown on the screen
+ **************************************************************************************************/
+struct Readings_st
+{
+    float fTempCelsius;     /**< Temperature [C]         */
+    float fRelHumidity;     /**< Relative humidity [%]   */
+    float fWindSpeed;       /**< Wind speed [m/s]        */
+    float fMaxWindSpeed;    /**< Wind speed limit [m/s]  */
+    float fRotorSpeedRPM;   /**< Rotor speed [rpm]       */
+    float fMaxRotorSpeed;   /**< Rotor speed limit [rpm] */
+    bool  bManualPitch;     /**< Manual pitch mode       */
+    float fPitchPercentage; /**< Blade pitch [%]         */
+};
+
+/***********************************************************************************************//**
+ * \struct LcdModel_st
+ * \brief State of the HD44780 model (see NOTE3)
+ **************************************************************************************************/
+struct LcdModel_st
+{
+    char          ascDdram[DDRAM_SIZE_UC]; /**< Display RAM                               */
+    unsigned char ucAddress;               /**< Address counter                           */
+    uint8_t       ucLastState;             /**< Last byte written to the port expander    */
+    bool          bLowNibble;              /**< The next nibble is the low one of a byte  */
+    uint8_t       ucHighNibble;            /**< High nibble of the byte being received    */
+};
+
+/***********************************************************************************************//**
+ * \struct Traffic_st
+ * \brief I2C traffic of one way of refreshing the screen
+ **************************************************************************************************/
+struct Traffic_st
+{
+    uint32_t ulTransactions;    /**< Transactions of all the refreshes        */
+    uint32_t ulBytes;           /**< Bytes of all the refreshes               */
+    uint32_t ulDropped;         /**< Bytes dropped by the Wire buffer         */
+    uint64_t ullBusUs;          /**< Bus time of all the refreshes [us]       */
+    uint32_t ulMaxTransactions; /**< Transactions of the worst refresh        */
+    uint64_t ullMaxBusUs;       /**< Bus time of the worst refresh [us]       */
+};
+
+/******************************************** GLOBALS *********************************************/
+static LcdModel_st stLegacyModel_;      /**< Screen refreshed field by field */
+static LcdModel_st stFramebufferModel_; /**< Screen behind the framebuffer   */
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Clears the model, as after the clear command
+***************************************************************************************************/
+static void vClearModel(LcdModel_st& stModel)
+{
+    memset(stModel.ascDdram, ' ', sizeof(stModel.ascDdram));
+    stModel.ucAddress = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs a byte received by the model: a command (RS low) or a character (RS high)
+***************************************************************************************************/
+static void vRunByte(LcdModel_st& stModel, const uint8_t ucByte, const bool bData)
+{
+    if (bData)
+    {
+        /* Same auto-increment as the HD44780 in 2 lines mode */
+        stModel.ascDdram[stModel.ucAddress] = static_cast<char>(ucByte);
+        stModel.ucAddress = stModel.ucAddress == 0x27 ? 0x40 : (stModel.ucAddress == 0x67 ? 0x00 : stModel.ucAddress + 1);
+    }
+    else if ((ucByte & LCD_SETDDRAMADDR) != 0)
+    {
+        stModel.ucAddress = ucByte & (DDRAM_SIZE_UC - 1);
+    }
+    else if (ucByte == LCD_CLEARDISPLAY)
+    {
+        vClearModel(stModel);
+    }
+    else if ((ucByte & ~0x01) == LCD_RETURNHOME)
+    {
+        stModel.ucAddress = 0;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Transmit hook of the mock Wire. Decodes the port expander states of each screen
+***************************************************************************************************/
+static void vDecodeTransaction(uint8_t ucAddress, const uint8_t* pucData, size_t ulSize, void* pvContext)
+{
+    (void)pvContext;
+    LcdModel_st& stModel = ucAddress == LEGACY_ADDRESS_UC ? stLegacyModel_ : stFramebufferModel_;
+    for (size_t ulIdx = 0; ulIdx < ulSize; ulIdx++)
+    {
+        /* The nibble is latched on the falling edge of the enable bit */
+        uint8_t ucState = pucData[ulIdx];
+        if ((stModel.ucLastState & En) != 0 && (ucState & En) == 0)
+        {
+            uint8_t ucNibble = stModel.ucLastState & 0xF0;
+            if (stModel.bLowNibble)
+            {
+                vRunByte(stModel, stModel.ucHighNibble | (ucNibble >> 4), (stModel.ucLastState & Rs) != 0);
+            }
+            else
+            {
+                stModel.ucHighNibble = ucNibble;
+            }
+            stModel.bLowNibble = !stModel.bLowNibble;
+        }
+        stModel.ucLastState = ucState;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Starts a screen. The model decodes from the end of the initialisation, which sends single
+* nibbles to enter the 4 bits mode
+***************************************************************************************************/
+static void vStartScreen(LiquidCrystal_I2C& clLCD, LcdModel_st& stModel)
+{
+    Wire.vSimSetTransmitHook(NULL, NULL);
+    clLCD.begin();
+    clLCD.backlight();
+    memset(&stModel, 0, sizeof(stModel));
+    Wire.vSimSetTransmitHook(vDecodeTransaction, NULL);
+    clLCD.clear();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Checks that the model shows the same text as the framebuffer
+***************************************************************************************************/
+static bool bSameText(const LcdModel_st& stLegacy, const LcdModel_st& stFramebuffer)
+{
+    for (unsigned char ucRow = 0; ucRow < LCD_ROWS_UC; ucRow++)
+    {
+        if (memcmp(&stLegacy.ascDdram[ROW_ADDRESS_UC[ucRow]], &stFramebuffer.ascDdram[ROW_ADDRESS_UC[ucRow]],
+                   LCD_COLUMNS_UC) != 0)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Readings of a refresh (see NOTE4)
+* \param[in] ulRefresh: Number of the refresh
+* \param[in] bConstant: True to get the same readings in every refresh
+***************************************************************************************************/
+static Readings_st stGetReadings(const unsigned long ulRefresh, const bool bConstant)
+{
+    static uint32_t ulNoise = 12345;
+    float fTimeS = bConstant ? 0.0f : ulRefresh * REFRESH_TIME_S_F;
+    ulNoise = ulNoise * 1103515245UL + 12345UL;
+    float fJitter = bConstant ? 0.0f : ((ulNoise >> 16) % 1000) / 1000.0f - 0.5f;
+
+    Readings_st stReadings;
+    stReadings.fTempCelsius     = 21.3f + 0.4f * sinf(fTimeS / 20.0f);
+    stReadings.fRelHumidity     = 46.0f + 1.5f * sinf(fTimeS / 30.0f);
+    stReadings.fWindSpeed       = 9.0f + 3.0f * sinf(fTimeS / 4.0f) + 0.3f * fJitter;
+    stReadings.fMaxWindSpeed    = 20.0f;
+    stReadings.fRotorSpeedRPM   = 180.0f + 60.0f * sinf(fTimeS / 4.0f) + 6.0f * fJitter;
+    stReadings.fMaxRotorSpeed   = 300.0f;
+    stReadings.bManualPitch     = false;
+    stReadings.fPitchPercentage = 35.0f + 10.0f * sinf(fTimeS / 6.0f);
+    return stReadings;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Refresh of every field, as vRefreshScreen() before the framebuffer. The buffer has room for
+* the terminator of the 5 characters temperature (the original one did not)
+***************************************************************************************************/
+static void vRefreshLegacy(LiquidCrystal_I2C& clLCD, const Readings_st& stReadings)
+{
+    char scAuxText[8];
+
+    dtostrf(stReadings.fTempCelsius, 5, 1, scAuxText);
+    clLCD.setCursor(5, 0);
+    for (unsigned char ucIdx = 0; ucIdx < 5; ucIdx++)
+    {
+        clLCD.print(scAuxText[ucIdx]);
+    }
+
+    dtostrf(stReadings.fRelHumidity, 3, 0, scAuxText);
+    clLCD.setCursor(16, 0);
+    for (unsigned char ucIdx = 0; ucIdx < 3; ucIdx++)
+    {
+        clLCD.print(scAuxText[ucIdx]);
+    }
+
+    dtostrf(stReadings.fWindSpeed, 2, 0, scAuxText);
+    clLCD.setCursor(5, 1);
+    for (unsigned char ucIdx = 0; ucIdx < 2; ucIdx++)
+    {
+        clLCD.print(scAuxText[ucIdx]);
+    }
+
+    dtostrf(stReadings.fMaxWindSpeed, 2, 0, scAuxText);
+    clLCD.setCursor(15, 1);
+    for (unsigned char ucIdx = 0; ucIdx < 2; ucIdx++)
+    {
+        clLCD.print(scAuxText[ucIdx]);
+    }
+
+    dtostrf(stReadings.fRotorSpeedRPM, 3, 0, scAuxText);
+    clLCD.setCursor(5, 2);
+    for (unsigned char ucIdx = 0; ucIdx < 3; ucIdx++)
+    {
+        clLCD.print(scAuxText[ucIdx]);
+    }
+
+    dtostrf(stReadings.fMaxRotorSpeed, 3, 0, scAuxText);
+    clLCD.setCursor(16, 2);
+    for (unsigned char ucIdx = 0; ucIdx < 3; ucIdx++)
+    {
+        clLCD.print(scAuxText[ucIdx]);
+    }
+
+    clLCD.setCursor(5, 3);
+    clLCD.print(stReadings.bManualPitch ? "manual" : "auto. ");
+
+    dtostrf(stReadings.fPitchPercentage, 3, 0, scAuxText);
+    clLCD.setCursor(14, 3);
+    for (unsigned char ucIdx = 0; ucIdx < 3; ucIdx++)
+    {
+        clLCD.print(scAuxText[ucIdx]);
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Same refresh through the framebuffer, flushed at the end
+***************************************************************************************************/
+static void vRefreshFramebuffer(LiquidCrystal_I2C& clLCD, LcdFramebuffer_cl& clScreen, const Readings_st& stReadings)
+{
+    char scAuxText[8];
+
+    dtostrf(stReadings.fTempCelsius, 5, 1, scAuxText);
+    clScreen.vPrint(5, 0, scAuxText);
+    dtostrf(stReadings.fRelHumidity, 3, 0, scAuxText);
+    clScreen.vPrint(16, 0, scAuxText);
+    dtostrf(stReadings.fWindSpeed, 2, 0, scAuxText);
+    clScreen.vPrint(5, 1, scAuxText);
+    dtostrf(stReadings.fMaxWindSpeed, 2, 0, scAuxText);
+    clScreen.vPrint(15, 1, scAuxText);
+    dtostrf(stReadings.fRotorSpeedRPM, 3, 0, scAuxText);
+    clScreen.vPrint(5, 2, scAuxText);
+    dtostrf(stReadings.fMaxRotorSpeed, 3, 0, scAuxText);
+    clScreen.vPrint(16, 2, scAuxText);
+    clScreen.vPrint(5, 3, stReadings.bManualPitch ? "manual" : "auto. ");
+    dtostrf(stReadings.fPitchPercentage, 3, 0, scAuxText);
+    clScreen.vPrint(14, 3, scAuxText);
+
+    clScreen.vFlush(clLCD);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Adds the traffic of the mock Wire since the last reset to the totals, and resets it
+***************************************************************************************************/
+static void vAccumulate(Traffic_st& stTraffic)
+{
+    const SimWireStats_st& stStats = Wire.stSimGetStats();
+    stTraffic.ulTransactions += stStats.ulTransactions;
+    stTraffic.ulBytes        += stStats.ulBytes;
+    stTraffic.ulDropped      += stStats.ulDropped;
+    stTraffic.ullBusUs       += stStats.ullBusUs;
+    if (stStats.ulTransactions > stTraffic.ulMaxTransactions)
+    {
+        stTraffic.ulMaxTransactions = stStats.ulTransactions;
+    }
+    if (stStats.ullBusUs > stTraffic.ullMaxBusUs)
+    {
+        stTraffic.ullMaxBusUs = stStats.ullBusUs;
+    }
+    Wire.vSimResetStats();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Prints the traffic per refresh
+***************************************************************************************************/
+static void vPrintTraffic(const char* pscName, const Traffic_st& stTraffic)
+{
+    printf("  %-12s %8.1f %8lu %10.1f %10.2f %10.2f\n", pscName,
+           static_cast<double>(stTraffic.ulTransactions) / REFRESHES_UL,
+           static_cast<unsigned long>(stTraffic.ulMaxTransactions),
+           static_cast<double>(stTraffic.ulBytes) / REFRESHES_UL,
+           stTraffic.ullBusUs / 1000.0 / REFRESHES_UL,
+           stTraffic.ullMaxBusUs / 1000.0);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the refreshes of a pass (changing or constant readings) on both screens
+***************************************************************************************************/
+static void vRunPass(const char* pscName, const bool bConstant)
+{
+    LiquidCrystal_I2C clLegacyLCD(LEGACY_ADDRESS_UC, LCD_COLUMNS_UC, LCD_ROWS_UC);
+    LiquidCrystal_I2C clFramebufferLCD(FRAMEBUFFER_ADDRESS_UC, LCD_COLUMNS_UC, LCD_ROWS_UC);
+    LcdFramebuffer_cl clScreen;
+
+    /* Base text, as in the setup of the sketch */
+    static const char* const apscTemplate[LCD_ROWS_UC] =
+    {
+        "Temp: xx.x C HR: xx%", "Wind:xxm/s Max:xxm/s", "RPM: xxx   Max: xxx", "Paso          xxx% "
+    };
+    vStartScreen(clLegacyLCD, stLegacyModel_);
+    vStartScreen(clFramebufferLCD, stFramebufferModel_);
+    for (unsigned char ucRow = 0; ucRow < LCD_ROWS_UC; ucRow++)
+    {
+        clLegacyLCD.setCursor(0, ucRow);
+        clLegacyLCD.print(apscTemplate[ucRow]);
+        clScreen.vPrint(0, ucRow, apscTemplate[ucRow]);
+    }
+    clScreen.vFlush(clFramebufferLCD);
+    Wire.vSimResetStats();
+
+    Traffic_st stLegacy = {};
+    Traffic_st stFramebuffer = {};
+    unsigned long ulMismatches = 0;
+    for (unsigned long ulRefresh = 0; ulRefresh < REFRESHES_UL; ulRefresh++)
+    {
+        Readings_st stReadings = stGetReadings(ulRefresh, bConstant);
+
+        vRefreshLegacy(clLegacyLCD, stReadings);
+        vAccumulate(stLegacy);
+
+        vRefreshFramebuffer(clFramebufferLCD, clScreen, stReadings);
+        vAccumulate(stFramebuffer);
+
+        if (!bSameText(stLegacyModel_, stFramebufferModel_))
+        {
+            ulMismatches++;
+        }
+    }
+
+    printf("%s (%lu refreshes)\n", pscName, REFRESHES_UL);
+    printf("  %-12s %8s %8s %10s %10s %10s\n", "", "trans", "max", "bytes", "bus [ms]", "max [ms]");
+    vPrintTraffic("per field", stLegacy);
+    vPrintTraffic("framebuffer", stFramebuffer);
+
+    HOST_TEST_CHECK(memcmp(&stFramebufferModel_.ascDdram[ROW_ADDRESS_UC[3]], "Paso ", 5) == 0,
+                    "%s: the model of the screen does not show the template", pscName);
+    HOST_TEST_CHECK(ulMismatches == 0, "%s: %lu refreshes show a different text", pscName, ulMismatches);
+    HOST_TEST_CHECK(stLegacy.ulDropped == 0 && stFramebuffer.ulDropped == 0, "%s: bytes dropped by the Wire buffer",
+                    pscName);
+    HOST_TEST_CHECK(stFramebuffer.ulTransactions < stLegacy.ulTransactions,
+                    "%s: the framebuffer sends %lu transactions, the refresh per field %lu", pscName,
+                    static_cast<unsigned long>(stFramebuffer.ulTransactions),
+                    static_cast<unsigned long>(stLegacy.ulTransactions));
+    if (bConstant)
+    {
+        /* Only the first refresh replaces the template; after it nothing changes */
+        HOST_TEST_CHECK(stFramebuffer.ulTransactions == stFramebuffer.ulMaxTransactions,
+                        "%s: the framebuffer sends something after the first refresh", pscName);
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the benchmark
+***************************************************************************************************/
+int main()
+{
+    vRunPass("Changing readings", false);
+    vRunPass("Constant readings", true);
+
+    HOST_TEST_END("LcdFlushBench");
+}
@@ -0,0 +1,305 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <NumberFormat.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Compares NumberFormat (ucFormatFloat, ucFormatInteger) with the formatting it replaced: the
+dtostrf() of the LCD fields of the User Arduino, and the String::concat() of the response of the
+ESP8266 to the app. The output must be the same text, and the benchmark gives the host time of both
+- NOTE2: dtostrf() is the one of the shim (printf), which rounds the exact binary value, while
+NumberFormat rounds after scaling in float (NumberFormat.h, NOTE4). Both round to the nearest, so a
+value can only differ in the last digit, when it is within a float rounding error of a tie
+- NOTE3: The host core has no String class, so HostString reproduces what String::concat() does in
+WString.cpp: the buffer is reallocated to the exact new length whenever it grows, and concat(float)
+formats with dtostrf(value, 4, 2). The allocations per response are those of that class; the time
+is not
+- NOTE4: The ESP8266 sketch is not built on the host. The two response builders below follow
+sBuildMsgToAndroid() (before) and pscBuildMsgToAndroid() (after) of the sketch
+- NOTE5: Host timings do not say how much faster NumberFormat is on the AVR, where dtostrf() works
+on emulated floats. The "LCD" profiler region of the User Arduino gives the time on the target
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const unsigned long ACCURACY_VALUES_UL   = 200000;  /**< Random values of the accuracy check             */
+static const float         MAX_ACCURACY_VALUE_F = 1000.0f; /**< Range of the accuracy check (+/-)              */
+static const unsigned long TIMING_VALUES_UL     = 1000000; /**< Values formatted to time each LCD field path   */
+static const unsigned long RESPONSES_UL         = 20000;   /**< Responses built to time each builder           */
+static const unsigned char RESPONSE_FLOATS_UC   = 9;       /**< Decimal values of the response                 */
+static const unsigned char RESPONSE_INTEGERS_UC = 4;       /**< Integer values (enums) of the response         */
+static const unsigned char RESPONSE_DECIMALS_UC = 2;       /**< Decimals of the response (MSG_DECIMALS_UC)     */
+static const char          RESPONSE_HEADER_SC[] =          /**< Beginning of the response (MSG_HTTP_HEADER_SC) */
+                "HTTP/1.1 200 OK\r\nContent-Type: text/html\r\n\r\n<!DOCTYPE HTML>\r\n<html>\r\n";
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class HostString
+ * \brief Stand-in of the String class, with its growth policy (see NOTE3)
+ **************************************************************************************************/
+class HostString
+{
+public:
+    explicit HostString(const char* pscText) : pscBuffer_(NULL), ulLength_(0), ulAllocations_(0)
+    {
+        vAppend(pscText, strlen(pscText));
+    }
+    ~HostString() { free(pscBuffer_); }
+
+    void concat(const char scChar) { vAppend(&scChar, 1); }
+    void concat(const int slValue) { char ascText[12]; vAppend(ascText, sprintf(ascText, "%d", slValue)); }
+    void concat(const float fValue)
+    {
+        char ascText[20];
+        dtostrf(fValue, 4, 2, ascText);
+        vAppend(ascText, strlen(ascText));
+    }
+
+    const char* c_str() const { return pscBuffer_; }
+    unsigned long ulGetAllocations() const { return ulAllocations_; }
+
+private:
+    void vAppend(const char* pscText, const size_t ulSize)
+    {
+        pscBuffer_ = static_cast<char*>(realloc(pscBuffer_, ulLength_ + ulSize + 1));
+        ulAllocations_++;
+        memcpy(&pscBuffer_[ulLength_], pscText, ulSize);
+        ulLength_ += ulSize;
+        pscBuffer_[ulLength_] = '\0';
+    }
+
+    char*         pscBuffer_;     /**< Text (heap)               */
+    size_t        ulLength_;      /**< Length of the text        */
+    unsigned long ulAllocations_; /**< Calls to realloc() so far */
+};
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Gets a random value in [-fRange, fRange]
+***************************************************************************************************/
+static float fRandom(const float fRange)
+{
+    return (static_cast<float>(rand()) / RAND_MAX * 2.0f - 1.0f) * fRange;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Checks that two texts of a value differ at most in one unit of the last decimal (NOTE2)
+***************************************************************************************************/
+static bool bSameValue(const char* pscText, const char* pscReference, const unsigned char ucDecimals)
+{
+    double dStep = pow(10.0, -ucDecimals);
+    return fabs(atof(pscText) - atof(pscReference)) <= dStep * 1.001;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Skips the sign of a text that rounds to 0 ("-0.00"), which NumberFormat writes without sign
+* (NumberFormat.h, NOTE4)
+***************************************************************************************************/
+static const char* pscSkipNegativeZero(const char* pscText)
+{
+    return pscText[0] == '-' && strspn(&pscText[1], "0.") == strlen(&pscText[1]) ? &pscText[1] : pscText;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Checks that two responses have the same values, up to the last digit (NOTE2)
+***************************************************************************************************/
+static bool bSameResponse(const char* pscText, const char* pscReference)
+{
+    pscText      = strchr(pscText, '[');
+    pscReference = strchr(pscReference, '[');
+    while (pscText != NULL && pscReference != NULL)
+    {
+        if (!bSameValue(pscText + 1, pscReference + 1, RESPONSE_DECIMALS_UC))
+        {
+            return false;
+        }
+        pscText      = strchr(pscText + 1, ';');
+        pscReference = strchr(pscReference + 1, ';');
+    }
+
+    return pscText == NULL && pscReference == NULL;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Response built with String, as sBuildMsgToAndroid() did
+***************************************************************************************************/
+static unsigned long ulBuildWithString(const float* pfValues, const int* pslEnums, char* pscOutput)
+{
+    HostString clMsg(RESPONSE_HEADER_SC);
+    clMsg.concat('[');
+    for (unsigned char ucIdx = 0; ucIdx < RESPONSE_FLOATS_UC; ucIdx++)
+    {
+        clMsg.concat(pfValues[ucIdx]);
+        clMsg.concat(';');
+    }
+    for (unsigned char ucIdx = 0; ucIdx < RESPONSE_INTEGERS_UC; ucIdx++)
+    {
+        clMsg.concat(pslEnums[ucIdx]);
+        clMsg.concat(ucIdx + 1 < RESPONSE_INTEGERS_UC ? ';' : ']');
+    }
+
+    strcpy(pscOutput, clMsg.c_str());
+    return clMsg.ulGetAllocations();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Response built in place with NumberFormat, as pscBuildMsgToAndroid() does
+***************************************************************************************************/
+static void vBuildInPlace(const float* pfValues, const int* pslEnums, char* pscOutput)
+{
+    memcpy(pscOutput, RESPONSE_HEADER_SC, sizeof(RESPONSE_HEADER_SC) - 1);
+    char* pscEnd = &pscOutput[sizeof(RESPONSE_HEADER_SC) - 1];
+    *pscEnd++ = '[';
+    for (unsigned char ucIdx = 0; ucIdx < RESPONSE_FLOATS_UC; ucIdx++)
+    {
+        pscEnd += ucFormatFloat(pscEnd, pfValues[ucIdx], RESPONSE_DECIMALS_UC, 0);
+        *pscEnd++ = ';';
+    }
+    for (unsigned char ucIdx = 0; ucIdx < RESPONSE_INTEGERS_UC; ucIdx++)
+    {
+        pscEnd += ucFormatInteger(pscEnd, pslEnums[ucIdx], 0);
+        *pscEnd++ = ucIdx + 1 < RESPONSE_INTEGERS_UC ? ';' : ']';
+    }
+    *pscEnd = '\0';
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Gets the values of a response: wind, pitch, humidity, rotor speed, temperature, limits...
+***************************************************************************************************/
+static void vGetResponseValues(float* pfValues, int* pslEnums)
+{
+    static const float afRanges[RESPONSE_FLOATS_UC] =
+    {
+        25.0f, 100.0f, 100.0f, 400.0f, 40.0f, 25.0f, 400.0f, 25.0f, 100.0f
+    };
+    for (unsigned char ucIdx = 0; ucIdx < RESPONSE_FLOATS_UC; ucIdx++)
+    {
+        pfValues[ucIdx] = fabsf(fRandom(afRanges[ucIdx]));
+    }
+    pfValues[4] = fRandom(afRanges[4]); /* The temperature can be negative */
+    for (unsigned char ucIdx = 0; ucIdx < RESPONSE_INTEGERS_UC; ucIdx++)
+    {
+        pslEnums[ucIdx] = rand() % 3;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the benchmark
+***************************************************************************************************/
+int main()
+{
+    srand(1);
+
+    /* Accuracy against dtostrf, with the widths and decimals of the LCD fields and of the response */
+    unsigned long ulExact = 0;
+    unsigned long ulLastDigit = 0;
+    unsigned long ulWrong = 0;
+    for (unsigned long ulValue = 0; ulValue < ACCURACY_VALUES_UL; ulValue++)
+    {
+        float fValue = fRandom(MAX_ACCURACY_VALUE_F);
+        unsigned char ucDecimals = ulValue % (NUMBER_FORMAT_MAX_DECIMALS_UC);
+        char ascReference[32];
+        char ascText[NUMBER_FORMAT_MAX_LENGTH_UC + 1];
+        dtostrf(fValue, 0, ucDecimals, ascReference);
+        ucFormatFloat(ascText, fValue, ucDecimals, 0);
+
+        const char* pscReference = pscSkipNegativeZero(ascReference);
+        if (strcmp(ascText, pscReference) == 0)
+        {
+            ulExact++;
+        }
+        else if (bSameValue(ascText, pscReference, ucDecimals))
+        {
+            ulLastDigit++;
+        }
+        else
+        {
+            ulWrong++;
+            if (ulWrong <= 5)
+            {
+                printf("  %.7g with %u decimals: \"%s\" instead of \"%s\"\n", fValue, ucDecimals, ascText,
+                       pscReference);
+            }
+        }
+    }
+    printf("Accuracy against dtostrf over %lu values (+/-%.0f, 0-%u decimals):\n", ACCURACY_VALUES_UL,
+           MAX_ACCURACY_VALUE_F, NUMBER_FORMAT_MAX_DECIMALS_UC - 1);
+    printf("  same text %lu, last digit rounded the other way %lu, wrong %lu\n", ulExact, ulLastDigit, ulWrong);
+    HOST_TEST_CHECK(ulWrong == 0, "%lu values formatted wrong", ulWrong);
+
+    /* LCD field: temperature, 5 characters with 1 decimal */
+    float* pfValues = static_cast<float*>(malloc(TIMING_VALUES_UL * sizeof(float)));
+    for (unsigned long ulValue = 0; ulValue < TIMING_VALUES_UL; ulValue++)
+    {
+        pfValues[ulValue] = fRandom(40.0f);
+    }
+    char ascField[NUMBER_FORMAT_MAX_LENGTH_UC + 1];
+    volatile char scSink = 0;
+    auto tStart = std::chrono::steady_clock::now();
+    for (unsigned long ulValue = 0; ulValue < TIMING_VALUES_UL; ulValue++)
+    {
+        dtostrf(pfValues[ulValue], 5, 1, ascField);
+        scSink = scSink + ascField[3];
+    }
+    auto tMiddle = std::chrono::steady_clock::now();
+    for (unsigned long ulValue = 0; ulValue < TIMING_VALUES_UL; ulValue++)
+    {
+        ucFormatFloat(ascField, pfValues[ulValue], 1, 5);
+        scSink = scSink + ascField[3];
+    }
+    auto tEnd = std::chrono::steady_clock::now();
+    free(pfValues);
+    printf("LCD field (width 5, 1 decimal), host time per value:\n");
+    printf("  dtostrf %.1f ns, ucFormatFloat %.1f ns\n",
+           std::chrono::duration<double, std::nano>(tMiddle - tStart).count() / TIMING_VALUES_UL,
+           std::chrono::duration<double, std::nano>(tEnd - tMiddle).count() / TIMING_VALUES_UL);
+
+    /* Response to the app: same text, allocations and host time */
+    float afValues[RESPONSE_FLOATS_UC];
+    int aslEnums[RESPONSE_INTEGERS_UC];
+    char ascWithString[256];
+    char ascInPlace[256];
+    unsigned long ulAllocations = 0;
+    unsigned long ulDifferent = 0;
+    unsigned long ulWrongResponses = 0;
+    double dStringNs = 0.0;
+    double dInPlaceNs = 0.0;
+    for (unsigned long ulResponse = 0; ulResponse < RESPONSES_UL; ulResponse++)
+    {
+        vGetResponseValues(afValues, aslEnums);
+
+        tStart = std::chrono::steady_clock::now();
+        ulAllocations += ulBuildWithString(afValues, aslEnums, ascWithString);
+        tMiddle = std::chrono::steady_clock::now();
+        vBuildInPlace(afValues, aslEnums, ascInPlace);
+        tEnd = std::chrono::steady_clock::now();
+
+        dStringNs  += std::chrono::duration<double, std::nano>(tMiddle - tStart).count();
+        dInPlaceNs += std::chrono::duration<double, std::nano>(tEnd - tMiddle).count();
+        if (strcmp(ascWithString, ascInPlace) != 0)
+        {
+            ulDifferent++;
+            if (!bSameResponse(ascInPlace, ascWithString))
+            {
+                ulWrongResponses++;
+            }
+        }
+    }
+    printf("Response to the app (%u values, %lu responses):\n", RESPONSE_FLOATS_UC + RESPONSE_INTEGERS_UC,
+           RESPONSES_UL);
+    printf("  String::concat %.0f ns and %.1f allocations per response, in place %.0f ns and 0 allocations\n",
+           dStringNs / RESPONSES_UL, static_cast<double>(ulAllocations) / RESPONSES_UL, dInPlaceNs / RESPONSES_UL);
+    printf("  responses with a different text: %lu (last digit rounded the other way, see NOTE2)\n", ulDifferent);
+    printf("  (host figures only; see NOTE5 for the AVR)\n");
+    HOST_TEST_CHECK(ulWrongResponses == 0, "%lu responses have a wrong value", ulWrongResponses);
+
+    HOST_TEST_END("NumberFormatBench");
+}
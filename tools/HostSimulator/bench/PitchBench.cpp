@@ -0,0 +1,106 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <CommonTypes.h>
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Compares the floating point and Q16 paths of the automatic pitch (fComputeAutoPitchExtension
+and fComputeAutoPitchExtensionQ16 of the control sketch) over a grid of wind and rotor speeds: the
+accuracy of the Q16 path, and the execution time of both on the host
+- NOTE2: Host timings do not say which path is faster on the AVR, where the float operations are
+emulated. That needs a cycle count on the target (or an AVR simulator), which is why the float path
+stays the default (PITCH_CONTROL_METHOD_E)
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const float         MAX_WIND_SPEED_F      = 25.0f;  /**< Upper limit of the wind speed grid [m/s]  */
+static const float         WIND_SPEED_STEP_F     = 0.05f;  /**< Step of the wind speed grid [m/s]         */
+static const float         MAX_ROTOR_SPEED_F     = 400.0f; /**< Upper limit of the rotor speed grid [rpm] */
+static const float         ROTOR_SPEED_STEP_F    = 1.0f;   /**< Step of the rotor speed grid [rpm]        */
+static const float         MAX_EXTENSION_ERROR_F = 0.05f;  /**< Accepted error of the Q16 path [%]        */
+static const unsigned long TIMING_REPETITIONS_UL = 20;     /**< Passes over the grid to time each path    */
+
+/******************************************* FUNCTIONS ********************************************/
+float fComputeAutoPitchExtension(const AeroData_st& stAeroData);
+float fComputeAutoPitchExtensionQ16(const AeroData_st& stAeroData);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Times a pitch computation over the whole grid
+* \param[in] pfCompute: Pitch computation
+* \param[out] ulCalls: Number of calls
+* \return Mean execution time [ns]
+***************************************************************************************************/
+static double dTimeGrid(float (*pfCompute)(const AeroData_st&), unsigned long& ulCalls)
+{
+    AeroData_st stAeroData = {};
+    volatile float fSink = 0.0f;
+    ulCalls = 0;
+    auto tStart = std::chrono::steady_clock::now();
+    for (unsigned long ulRepetition = 0; ulRepetition < TIMING_REPETITIONS_UL; ulRepetition++)
+    {
+        for (float fWind = 0.0f; fWind <= MAX_WIND_SPEED_F; fWind += WIND_SPEED_STEP_F)
+        {
+            for (float fRPM = 0.0f; fRPM <= MAX_ROTOR_SPEED_F; fRPM += ROTOR_SPEED_STEP_F)
+            {
+                stAeroData.fWindSpeed     = fWind;
+                stAeroData.fRotorSpeedRPM = fRPM;
+                fSink = fSink + pfCompute(stAeroData);
+                ulCalls++;
+            }
+        }
+    }
+    auto tEnd = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(tEnd - tStart).count() / ulCalls;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the benchmark
+***************************************************************************************************/
+int main()
+{
+    /* Accuracy of the Q16 path against the float one */
+    AeroData_st stAeroData = {};
+    float fMaxError = 0.0f;
+    float fMaxErrorWind = 0.0f;
+    float fMaxErrorRPM = 0.0f;
+    double dSumError = 0.0;
+    unsigned long ulPoints = 0;
+    for (float fWind = 0.0f; fWind <= MAX_WIND_SPEED_F; fWind += WIND_SPEED_STEP_F)
+    {
+        for (float fRPM = 0.0f; fRPM <= MAX_ROTOR_SPEED_F; fRPM += ROTOR_SPEED_STEP_F)
+        {
+            stAeroData.fWindSpeed     = fWind;
+            stAeroData.fRotorSpeedRPM = fRPM;
+            float fError = fabsf(fComputeAutoPitchExtensionQ16(stAeroData) - fComputeAutoPitchExtension(stAeroData));
+            dSumError += fError;
+            ulPoints++;
+            if (fError > fMaxError)
+            {
+                fMaxError     = fError;
+                fMaxErrorWind = fWind;
+                fMaxErrorRPM  = fRPM;
+            }
+        }
+    }
+    printf("Pitch extension, Q16 vs float over %lu points (wind 0-%.0f m/s, rotor 0-%.0f rpm):\n",
+           ulPoints, MAX_WIND_SPEED_F, MAX_ROTOR_SPEED_F);
+    printf("  error: mean %.5f %%, max %.5f %% (wind %.2f m/s, rotor %.0f rpm)\n",
+           dSumError / ulPoints, fMaxError, fMaxErrorWind, fMaxErrorRPM);
+    HOST_TEST_CHECK(fMaxError <= MAX_EXTENSION_ERROR_F, "max error %.5f %%", fMaxError);
+
+    /* Execution time on the host */
+    unsigned long ulCalls = 0;
+    double dFloatNs = dTimeGrid(fComputeAutoPitchExtension, ulCalls);
+    double dQ16Ns   = dTimeGrid(fComputeAutoPitchExtensionQ16, ulCalls);
+    printf("  host time per call (%lu calls): float %.1f ns, Q16 %.1f ns\n", ulCalls, dFloatNs, dQ16Ns);
+    printf("  (host figures only; see NOTE2 for the AVR)\n");
+
+    HOST_TEST_END("PitchBench");
+}
@@ -0,0 +1,284 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <SimCore.h>
+#include <ActuadorLineal.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Custom includes */
+#include "Constants.h"
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Drives the pitch servo through the same setpoint profile with two control logics: the one of
+vOperate() before the position estimate (BangBangServo_cl, a copy of it: the raw hall count against
+the target, the relays rewritten on every call and the pulses counted only while a relay is
+energised), and the current LinearServo_cl (estimate between pulses, early stop, minimum dwell)
+- NOTE2: The actuator is the motor of the simulator plant: PLANT_SERVO_SPEED_TURNS_S with first order
+speed dynamics, so it coasts when the relays are released, end stops at 0 and the full extension,
+and a hall pulse at every integer turn crossed. It runs with the coast time constants of
+COAST_TAUS_S. vOperate() is called every PITCH_TASK_PERIOD_MS_UL, as in the control sketch
+- NOTE3: The profile is a random target in the used length every 1.5 to 5 s (fixed seed). For each
+target: the settling error is the distance between the actuator and the target when the next one
+is requested, and the overshoot the furthest travel beyond the target in the direction of the
+movement. Relay energisations are the HIGH to LOW writes of both relay pins
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const int      RETRACTION_PIN   = 22;                                                        /**< Retraction relay                       */
+static const int      EXTENSION_PIN    = 23;                                                        /**< Extension relay                        */
+static const int      HALL_PIN         = 18;                                                        /**< Hall sensor                            */
+static const float    SPEED_TURNS_S_F  = 25.0f;                                                     /**< Motor speed (PLANT_SERVO_SPEED_TURNS_S) */
+static const float    COAST_TAUS_S[]   = {0.010f, 0.025f, 0.060f};                                  /**< Time constants of the motor speed [s]  */
+static const uint32_t NUM_TARGETS_UL   = 80;                                                        /**< Targets of the profile                 */
+static const uint32_t MIN_HOLD_MS_UL   = 1500;                                                      /**< Shortest time at a target [ms]         */
+static const uint32_t HOLD_RANGE_MS_UL = 3500;                                                      /**< Random part of the time at a target    */
+static const float    MM_PER_TURN_F    = SERVO_LENGHT_MM / SERVO_TURNS_TO_FULL_EXTENSION;           /**< Extension of a turn [mm]               */
+static const int      USED_TURNS       = static_cast<int>(SERVO_USABLE_LENGTH_MM / MM_PER_TURN_F);  /**< Turns of the used length               */
+
+/********************************************* TYPES **********************************************/
+/** Figures of a run */
+struct MotionStats_st
+{
+    double   dSettlingError;  /**< Mean settling error [turns]                    */
+    double   dOvershoot;      /**< Mean overshoot [turns]                         */
+    float    fMaxOvershoot;   /**< Largest overshoot [turns]                      */
+    uint32_t ulEnergisations; /**< Relay energisations                            */
+    int      slCountError;    /**< Counted turns minus the actuator, at the end   */
+};
+
+/******************************************** GLOBALS *********************************************/
+static float    fMotorTau_                  = 0.0f; /**< Time constant of the motor speed [s] */
+static float    fMotorTurns_                = 0.0f; /**< Actuator position [turns]            */
+static float    fMotorSpeed_                = 0.0f; /**< Actuator speed [turns/s]             */
+static uint64_t ullLastStepUs_              = 0;    /**< Virtual time of the last step        */
+static int      aslTargets_[NUM_TARGETS_UL] = {};   /**< Target of each step of the profile  */
+static uint32_t aulHoldMs_[NUM_TARGETS_UL]  = {};   /**< Time at each target [ms]             */
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class BangBangServo_cl
+ * \brief Control logic of LinearServo_cl::vOperate() before the position estimate (see NOTE1)
+ **************************************************************************************************/
+class BangBangServo_cl
+{
+public:
+    void vSetup(const int slCurrentTurns)
+    {
+        pclInstance_    = this;
+        slCurrentTurns_ = slCurrentTurns;
+        slTargetTurns_  = slCurrentTurns;
+        eServoState_    = SERVOSTATE_STOPPED;
+        pinMode(RETRACTION_PIN, OUTPUT);
+        pinMode(EXTENSION_PIN, OUTPUT);
+        digitalWrite(EXTENSION_PIN, HIGH);
+        digitalWrite(RETRACTION_PIN, HIGH);
+        attachInterrupt(HALL_PIN, vHallSensorIsr, RISING);
+    }
+
+    void vSetTargetTurns(const int slTargetTurns) { slTargetTurns_ = slTargetTurns; }
+
+    void vOperate()
+    {
+        if (slTargetTurns_ > slCurrentTurns_ && abs(slTargetTurns_ - slCurrentTurns_) > MAX_TURNS_ERROR_UL)
+        {
+            vStop();
+            eServoState_ = SERVOSTATE_EXTENDING;
+            digitalWrite(RETRACTION_PIN, HIGH);
+            digitalWrite(EXTENSION_PIN, LOW);
+        }
+        else if (slTargetTurns_ < slCurrentTurns_ && abs(slTargetTurns_ - slCurrentTurns_) > MAX_TURNS_ERROR_UL)
+        {
+            vStop();
+            eServoState_ = SERVOSTATE_RETRACTING;
+            digitalWrite(RETRACTION_PIN, LOW);
+            digitalWrite(EXTENSION_PIN, HIGH);
+        }
+        else
+        {
+            vStop();
+        }
+    }
+
+    int slGetCurrentTurns() const { return slCurrentTurns_; }
+
+private:
+    void vStop()
+    {
+        eServoState_ = SERVOSTATE_STOPPED;
+        digitalWrite(EXTENSION_PIN, HIGH);
+        digitalWrite(RETRACTION_PIN, HIGH);
+    }
+
+    static void vHallSensorIsr()
+    {
+        if (pclInstance_->eServoState_ == SERVOSTATE_EXTENDING)
+        {
+            pclInstance_->slCurrentTurns_++;
+        }
+        else if (pclInstance_->eServoState_ == SERVOSTATE_RETRACTING)
+        {
+            pclInstance_->slCurrentTurns_--;
+        }
+        pclInstance_->slCurrentTurns_ = min(pclInstance_->slCurrentTurns_, static_cast<int>(SERVO_TURNS_TO_FULL_EXTENSION));
+    }
+
+    static BangBangServo_cl* pclInstance_;    /**< Servo of the hall sensor interrupt */
+    volatile int             slCurrentTurns_; /**< Counted turns                      */
+    int                      slTargetTurns_;  /**< Requested turns                    */
+    volatile ServoState_e    eServoState_;    /**< Current state                      */
+};
+
+BangBangServo_cl* BangBangServo_cl::pclInstance_ = NULL;
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Step hook. Moves the actuator and generates its hall pulses (see NOTE2)
+***************************************************************************************************/
+static void vMoveActuator(uint64_t ullNowUs, void* pvContext)
+{
+    (void)pvContext;
+    float fDeltaS = (ullNowUs - ullLastStepUs_) * 1e-6f;
+    ullLastStepUs_ = ullNowUs;
+
+    bool  bExtend  = bSimIsOutputLow(EXTENSION_PIN);
+    bool  bRetract = bSimIsOutputLow(RETRACTION_PIN);
+    float fDrive   = bExtend == bRetract ? 0.0f : (bExtend ? 1.0f : -1.0f);
+    fMotorSpeed_ += (fDrive * SPEED_TURNS_S_F - fMotorSpeed_) * fDeltaS / fMotorTau_;
+
+    float fOldTurns = fMotorTurns_;
+    fMotorTurns_ += fMotorSpeed_ * fDeltaS;
+    if (fMotorTurns_ <= 0.0f || fMotorTurns_ >= SERVO_TURNS_TO_FULL_EXTENSION)
+    {
+        fMotorTurns_ = max(min(fMotorTurns_, static_cast<float>(SERVO_TURNS_TO_FULL_EXTENSION)), 0.0f);
+        fMotorSpeed_ = 0.0f;
+    }
+    if (floorf(fMotorTurns_) != floorf(fOldTurns))
+    {
+        vSimSetPinInput(HALL_PIN, HIGH);
+        vSimSetPinInput(HALL_PIN, LOW);
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the profile with a control logic (see NOTE3)
+* \param[in] pfSetTarget: Requests a target, in turns
+* \param[in] pfOperate: Runs the control logic once
+* \param[in] pfGetTurns: Gets the counted turns
+***************************************************************************************************/
+template<typename SetTarget_t, typename Operate_t, typename GetTurns_t>
+static MotionStats_st stRunProfile(SetTarget_t pfSetTarget, Operate_t pfOperate, GetTurns_t pfGetTurns)
+{
+    MotionStats_st stStats = {};
+    uint32_t ulStartEnergisations = ulSimGetOutputFallCount(EXTENSION_PIN) + ulSimGetOutputFallCount(RETRACTION_PIN);
+
+    for (uint32_t ulTarget = 0; ulTarget < NUM_TARGETS_UL; ulTarget++)
+    {
+        float fTarget    = static_cast<float>(aslTargets_[ulTarget]);
+        float fDirection = fTarget >= fMotorTurns_ ? 1.0f : -1.0f;
+        float fOvershoot = 0.0f;
+        pfSetTarget(aslTargets_[ulTarget]);
+
+        for (uint32_t ulMs = 0; ulMs < aulHoldMs_[ulTarget]; ulMs += PITCH_TASK_PERIOD_MS_UL)
+        {
+            pfOperate();
+            vSimAdvanceUs(PITCH_TASK_PERIOD_MS_UL * 1000UL);
+            fOvershoot = max(fOvershoot, (fMotorTurns_ - fTarget) * fDirection);
+        }
+
+        stStats.dSettlingError += fabsf(fMotorTurns_ - fTarget);
+        stStats.dOvershoot     += fOvershoot;
+        stStats.fMaxOvershoot   = max(stStats.fMaxOvershoot, fOvershoot);
+    }
+
+    stStats.dSettlingError /= NUM_TARGETS_UL;
+    stStats.dOvershoot     /= NUM_TARGETS_UL;
+    stStats.ulEnergisations = ulSimGetOutputFallCount(EXTENSION_PIN) + ulSimGetOutputFallCount(RETRACTION_PIN) -
+                              ulStartEnergisations;
+    stStats.slCountError    = pfGetTurns() - static_cast<int>(floorf(fMotorTurns_));
+    return stStats;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Puts the actuator at rest at the start of the profile
+***************************************************************************************************/
+static void vResetActuator(const float fTau)
+{
+    fMotorTau_     = fTau;
+    fMotorTurns_   = 0.5f;
+    fMotorSpeed_   = 0.0f;
+    ullLastStepUs_ = ullSimGetTimeUs();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Prints the figures of a run
+***************************************************************************************************/
+static void vPrintStats(const char* pscName, const MotionStats_st& stStats)
+{
+    printf("    %-10s settling error %5.2f turns, overshoot mean %5.2f max %5.2f turns, "
+           "%6lu relay energisations, count error %d turns\n",
+           pscName, stStats.dSettlingError, stStats.dOvershoot, stStats.fMaxOvershoot,
+           static_cast<unsigned long>(stStats.ulEnergisations), stStats.slCountError);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the benchmark
+***************************************************************************************************/
+int main()
+{
+    /* The same profile for all the runs */
+    srand(1);
+    uint32_t ulProfileMs = 0;
+    for (uint32_t ulTarget = 0; ulTarget < NUM_TARGETS_UL; ulTarget++)
+    {
+        aslTargets_[ulTarget] = rand() % (USED_TURNS + 1);
+        aulHoldMs_[ulTarget]  = MIN_HOLD_MS_UL + rand() % HOLD_RANGE_MS_UL;
+        ulProfileMs += aulHoldMs_[ulTarget];
+    }
+    vSimSetStepHook(vMoveActuator, NULL);
+
+    printf("Pitch servo over %lu targets (%lu s), %.0f turns/s, vOperate() every %lu ms:\n",
+           static_cast<unsigned long>(NUM_TARGETS_UL), static_cast<unsigned long>(ulProfileMs / 1000),
+           SPEED_TURNS_S_F, PITCH_TASK_PERIOD_MS_UL);
+
+    static BangBangServo_cl clBangBang;
+    static LinearServo_cl   aclServos[sizeof(COAST_TAUS_S) / sizeof(COAST_TAUS_S[0])];
+    for (unsigned char ucTau = 0; ucTau < sizeof(COAST_TAUS_S) / sizeof(COAST_TAUS_S[0]); ucTau++)
+    {
+        printf("  coast time constant %.0f ms:\n", COAST_TAUS_S[ucTau] * 1000.0f);
+
+        /* Old logic */
+        vResetActuator(COAST_TAUS_S[ucTau]);
+        clBangBang.vSetup(0);
+        MotionStats_st stOld = stRunProfile([](int slTurns) { clBangBang.vSetTargetTurns(slTurns); },
+                                            []() { clBangBang.vOperate(); },
+                                            []() { return clBangBang.slGetCurrentTurns(); });
+        vPrintStats("bang-bang", stOld);
+
+        /* Current logic. The target is the centre of the turn, so the length maps back to the same turn */
+        LinearServo_cl& clServo = aclServos[ucTau];
+        vResetActuator(COAST_TAUS_S[ucTau]);
+        HOST_TEST_CHECK(clServo.bSetup(RETRACTION_PIN, EXTENSION_PIN, HALL_PIN, SERVO_LENGHT_MM, SERVO_USABLE_LENGTH_MM,
+                                       SERVO_TURNS_TO_FULL_EXTENSION, 0),
+                        "servo not attached");
+        MotionStats_st stNew = stRunProfile([&clServo](int slTurns)
+                                            { clServo.vSetExtensionLength((slTurns + 0.5f) * MM_PER_TURN_F); },
+                                            [&clServo]() { clServo.vOperate(); },
+                                            [&clServo]() { return clServo.ulGetCurrentTurns(); });
+        vPrintStats("coast", stNew);
+        printf("    %-10s %lu relay switches, %lu overshoots counted by the servo\n", "",
+               clServo.ulGetRelaySwitches(), clServo.ulGetOvershoots());
+
+        HOST_TEST_CHECK(stNew.dSettlingError <= MAX_TURNS_ERROR_UL, "settling error %.2f turns", stNew.dSettlingError);
+        HOST_TEST_CHECK(stNew.dSettlingError <= stOld.dSettlingError, "settling error %.2f turns, bang-bang %.2f",
+                        stNew.dSettlingError, stOld.dSettlingError);
+        HOST_TEST_CHECK(stNew.ulEnergisations < stOld.ulEnergisations, "%lu relay energisations, bang-bang %lu",
+                        static_cast<unsigned long>(stNew.ulEnergisations), static_cast<unsigned long>(stOld.ulEnergisations));
+        HOST_TEST_CHECK(abs(stNew.slCountError) <= 1, "counted turns %d from the actuator", stNew.slCountError);
+    }
+
+    HOST_TEST_END("ServoMotionBench");
+}
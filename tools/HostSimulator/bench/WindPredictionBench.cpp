@@ -0,0 +1,228 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <SimCore.h>
+#include <ActuadorLineal.h>
+#include <CommonTypes.h>
+#include <FixedPoint.h>
+#include <Interpolation.h>
+#include <WindPredictor.h>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+/* Custom includes */
+#include "Constants.h"
+#include "HostTest.h"
+#include "PlantModel.h"
+#include "RotorRegulator.h"
+
+
+/*
+- NOTE1: Replays a wind trace (WIND_FILE, see its header) through the simulator plant (PlantModel_cl)
+with the automatic pitch of the control sketch at its task rates: WindPredictor_cl fed with the wind
+every WIND_PREDICTION_PERIOD_MS_UL, the feed-forward (fComputeAutoPitchExtension) on the forecast
+plus RotorRegulator_cl every REGULATOR_TASK_PERIOD_MS_UL, and LinearServo_cl::vOperate() every
+PITCH_TASK_PERIOD_MS_UL. The wind and rotor speeds are the ones of the plant, not the measured ones
+- NOTE2: Each loop runs with the horizon off (the smoothed wind) and at WIND_PREDICTION_HORIZON_MS_UL,
+with the feed-forward alone (regulator gains 0) and with the regulator of the sketch. The blade
+angle error is the difference between the angle of the actuator and the angle the feed-forward
+requests for the wind and rotor speed of the plant at that moment. Overspeed is the rotor speed over
+the setpoint of the regulator (0 under it), both RMS over the run after WARMUP_S
+- NOTE3: Open loop, the same wind samples are replayed through the predictor alone: RMS error of the
+forecast against the wind that comes FORECAST_LAGS_MS later, for that horizon and for the horizon off
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const char*         WIND_FILE          = "tests/data/wind_gusts_8mps.csv";                   /**< Wind trace                        */
+static const float         DURATION_S_F       = 600.0f;                                             /**< Length of the trace [s]           */
+static const float         WARMUP_S_F         = 20.0f;                                              /**< Rotor start, not in the figures   */
+static const float         MAX_ROTOR_RPM_F    = 200.0f;                                             /**< Break limit (simulator default)   */
+static const float         SETPOINT_RPM_F     = MAX_ROTOR_RPM_F * ROTOR_SPEED_SETPOINT_RATIO_F;     /**< Setpoint of the regulator [rpm]   */
+static const float         INITIAL_TURNS_F    = 0.5f;                                               /**< Actuator at power on [turns]      */
+static const unsigned long FORECAST_LAGS_MS[] = {1000, 2000, 4000};                                 /**< Horizons of the open loop figures */
+static const unsigned char NUM_LAGS_UC        = sizeof(FORECAST_LAGS_MS) / sizeof(FORECAST_LAGS_MS[0]); /**< Number of horizons          */
+
+/********************************************* TYPES **********************************************/
+/** Figures of a closed loop run */
+struct LoopStats_st
+{
+    float    fBetaErrorDeg;   /**< RMS blade angle error [deg]                */
+    float    fOverspeedRPM;   /**< RMS rotor speed over the setpoint [rpm]    */
+    float    fOverSetpointS;  /**< Time over the setpoint [s]                 */
+    float    fMaxRotorRPM;    /**< Highest rotor speed [rpm]                  */
+    float    fRegulatorRPM;   /**< RMS error reported by the regulator [rpm]  */
+    uint32_t ulEnergisations; /**< Relay energisations of the actuator        */
+};
+
+/******************************************** GLOBALS *********************************************/
+static std::vector<float> afWindSamples_; /**< Wind of the plant at each predictor sample [m/s] */
+
+/******************************************* FUNCTIONS ********************************************/
+float fComputeAutoPitchExtension(const AeroData_st& stAeroData);
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the closed loop over the whole trace (see NOTE1)
+* \param[in] ulHorizonMs: Horizon of the predictor [ms]
+* \param[in] bRegulator: Regulator of the sketch, or the feed-forward alone
+* \param[out] stStats: Figures of the run
+* \return False if the wind file can't be read
+***************************************************************************************************/
+static bool bRunLoop(const unsigned long ulHorizonMs, const bool bRegulator, LoopStats_st& stStats)
+{
+    static PlantModel_cl     clPlant;
+    static LinearServo_cl    clServo;
+    static WindPredictor_cl  clPredictor;
+    static RotorRegulator_cl clRegulator;
+
+    clPlant = PlantModel_cl();
+    PlantParams_st stParams     = {};
+    stParams.eScenario          = WINDSCENARIO_FILE;
+    stParams.pscWindFile        = WIND_FILE;
+    stParams.fInitialServoTurns = INITIAL_TURNS_F;
+    stParams.fMaxRotorSpeedRPM  = MAX_ROTOR_RPM_F;
+    stParams.fRotorSetpointRPM  = SETPOINT_RPM_F;
+    if (!clPlant.bSetup(stParams))
+    {
+        return false;
+    }
+    clServo.bSetup(BLADE_RETRACTION_PIN, BLADE_EXTENSION_PIN, SERVO_HALL_PIN, SERVO_LENGHT_MM, SERVO_USABLE_LENGTH_MM,
+                   SERVO_TURNS_TO_FULL_EXTENSION, static_cast<int>(INITIAL_TURNS_F));
+    clPredictor.vSetup(WIND_PREDICTION_ALPHA_F, WIND_PREDICTION_BETA_F, WIND_PREDICTION_PERIOD_MS_UL, ulHorizonMs);
+    clRegulator.vSetup(bRegulator ? ROTOR_REGULATOR_KP_F : 0.0f, bRegulator ? ROTOR_REGULATOR_KI_F : 0.0f);
+    uint32_t ulStartEnergisations = ulSimGetOutputFallCount(BLADE_EXTENSION_PIN) + ulSimGetOutputFallCount(BLADE_RETRACTION_PIN);
+    bool bRecordWind = afWindSamples_.empty();
+
+    double dBetaErrorSum = 0.0;
+    double dOverspeedSum = 0.0;
+    uint32_t ulSamples   = 0;
+    uint32_t ulSteps     = static_cast<uint32_t>(DURATION_S_F * 1000.0f / PITCH_TASK_PERIOD_MS_UL);
+    for (uint32_t ulStep = 0; ulStep < ulSteps; ulStep++)
+    {
+        const PlantState_st& stPlant = clPlant.stGetState();
+        uint32_t ulTimeMs = ulStep * PITCH_TASK_PERIOD_MS_UL;
+        if (ulTimeMs % WIND_PREDICTION_PERIOD_MS_UL == 0)
+        {
+            clPredictor.vUpdate(slFloatToQ16(stPlant.fWindSpeed));
+            if (bRecordWind)
+            {
+                afWindSamples_.push_back(stPlant.fWindSpeed);
+            }
+        }
+        if (ulTimeMs % REGULATOR_TASK_PERIOD_MS_UL == 0)
+        {
+            AeroData_st stAeroData    = {};
+            stAeroData.fWindSpeed     = clPredictor.fGetForecast();
+            stAeroData.fRotorSpeedRPM = stPlant.fRotorSpeedRPM;
+            float fExtensionPercent = clRegulator.fUpdate(SETPOINT_RPM_F, stPlant.fRotorSpeedRPM,
+                                                          fComputeAutoPitchExtension(stAeroData),
+                                                          REGULATOR_TASK_PERIOD_MS_UL * 0.001f);
+            clServo.vSetExtensionPercentage(fExtensionPercent);
+        }
+        clServo.vOperate();
+        vSimAdvanceUs(PITCH_TASK_PERIOD_MS_UL * 1000UL);
+
+        /* Angle the feed-forward would request for the wind of this moment */
+        if (ulTimeMs >= WARMUP_S_F * 1000.0f)
+        {
+            AeroData_st stAeroData    = {};
+            stAeroData.fWindSpeed     = stPlant.fWindSpeed;
+            stAeroData.fRotorSpeedRPM = stPlant.fRotorSpeedRPM;
+            float fIdealBeta = tInterp1D(PITCH_CONTROL_EXTENSION_F, PITCH_CONTROL_BETA_ANGLE_F,
+                                         fComputeAutoPitchExtension(stAeroData));
+            float fBetaError = (stPlant.fBetaRad - fIdealBeta) * RAD_TO_DEG;
+            float fOverspeed = max(stPlant.fRotorSpeedRPM - SETPOINT_RPM_F, 0.0f);
+            dBetaErrorSum += fBetaError * fBetaError;
+            dOverspeedSum += fOverspeed * fOverspeed;
+            ulSamples++;
+        }
+    }
+
+    stStats = {};
+    stStats.fBetaErrorDeg   = sqrt(dBetaErrorSum / ulSamples);
+    stStats.fOverspeedRPM   = sqrt(dOverspeedSum / ulSamples);
+    stStats.fOverSetpointS  = clPlant.stGetStats().fOverSetpointS;
+    stStats.fMaxRotorRPM    = clPlant.stGetStats().fMaxRotorSpeedRPM;
+    stStats.fRegulatorRPM   = clRegulator.fGetRmsErrorRPM();
+    stStats.ulEnergisations = ulSimGetOutputFallCount(BLADE_EXTENSION_PIN) + ulSimGetOutputFallCount(BLADE_RETRACTION_PIN) -
+                              ulStartEnergisations;
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief RMS error of the forecast against the wind that comes a given time later (see NOTE3)
+* \param[in] ulHorizonMs: Horizon of the predictor [ms]
+* \param[in] ulLagMs: Time ahead of the compared wind [ms]
+* \return RMS error [m/s]
+***************************************************************************************************/
+static float fForecastError(const unsigned long ulHorizonMs, const unsigned long ulLagMs)
+{
+    WindPredictor_cl clPredictor;
+    clPredictor.vSetup(WIND_PREDICTION_ALPHA_F, WIND_PREDICTION_BETA_F, WIND_PREDICTION_PERIOD_MS_UL, ulHorizonMs);
+    size_t   ulLagSamples = ulLagMs / WIND_PREDICTION_PERIOD_MS_UL;
+    size_t   ulWarmup     = static_cast<size_t>(WARMUP_S_F * 1000.0f / WIND_PREDICTION_PERIOD_MS_UL);
+    double   dErrorSum    = 0.0;
+    uint32_t ulSamples    = 0;
+    for (size_t ulIdx = 0; ulIdx + ulLagSamples < afWindSamples_.size(); ulIdx++)
+    {
+        clPredictor.vUpdate(slFloatToQ16(afWindSamples_[ulIdx]));
+        if (ulIdx >= ulWarmup)
+        {
+            float fError = clPredictor.fGetForecast() - afWindSamples_[ulIdx + ulLagSamples];
+            dErrorSum += fError * fError;
+            ulSamples++;
+        }
+    }
+    return sqrt(dErrorSum / ulSamples);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Prints the figures of a closed loop run
+***************************************************************************************************/
+static void vPrintStats(const unsigned long ulHorizonMs, const LoopStats_st& stStats)
+{
+    printf("    horizon %4lu ms: blade angle error %5.2f deg, overspeed %5.2f rpm, %5.1f s over the setpoint, "
+           "max %5.1f rpm, regulator %5.1f rpm, %5lu relay energisations\n",
+           ulHorizonMs, stStats.fBetaErrorDeg, stStats.fOverspeedRPM, stStats.fOverSetpointS, stStats.fMaxRotorRPM,
+           stStats.fRegulatorRPM, static_cast<unsigned long>(stStats.ulEnergisations));
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the benchmark
+***************************************************************************************************/
+int main()
+{
+    printf("Wind prediction over %s (%.0f s), setpoint %.0f rpm, alpha %.2f beta %.2f every %lu ms:\n",
+           WIND_FILE, DURATION_S_F, SETPOINT_RPM_F, WIND_PREDICTION_ALPHA_F, WIND_PREDICTION_BETA_F,
+           WIND_PREDICTION_PERIOD_MS_UL);
+
+    LoopStats_st astStats[2][2] = {};
+    for (unsigned char ucRegulator = 0; ucRegulator < 2; ucRegulator++)
+    {
+        printf("  %s:\n", ucRegulator == 0 ? "feed-forward alone" : "feed-forward and regulator");
+        for (unsigned char ucHorizon = 0; ucHorizon < 2; ucHorizon++)
+        {
+            unsigned long ulHorizonMs = ucHorizon == 0 ? 0 : WIND_PREDICTION_HORIZON_MS_UL;
+            if (!bRunLoop(ulHorizonMs, ucRegulator != 0, astStats[ucRegulator][ucHorizon]))
+            {
+                HOST_TEST_CHECK(false, "can't read %s", WIND_FILE);
+                HOST_TEST_END("WindPredictionBench");
+            }
+            vPrintStats(ulHorizonMs, astStats[ucRegulator][ucHorizon]);
+        }
+    }
+
+    /* What the horizon of the sketch is for: less rotor speed over the setpoint of the regulator */
+    HOST_TEST_CHECK(astStats[1][1].fOverspeedRPM <= astStats[1][0].fOverspeedRPM, "overspeed %.2f rpm, horizon off %.2f rpm",
+                    astStats[1][1].fOverspeedRPM, astStats[1][0].fOverspeedRPM);
+
+    printf("  forecast error, open loop:\n");
+    for (unsigned char ucLag = 0; ucLag < NUM_LAGS_UC; ucLag++)
+    {
+        float fOff = fForecastError(0, FORECAST_LAGS_MS[ucLag]);
+        float fOn  = fForecastError(FORECAST_LAGS_MS[ucLag], FORECAST_LAGS_MS[ucLag]);
+        printf("    wind %4lu ms ahead: horizon off %.3f m/s, horizon on %.3f m/s\n", FORECAST_LAGS_MS[ucLag], fOff, fOn);
+    }
+
+    HOST_TEST_END("WindPredictionBench");
+}
@@ -0,0 +1,23 @@
+#!/bin/sh
+# Converts a sketch into a C++ file, as the Arduino builder does: Arduino.h is included first and the
+# prototypes of the functions defined in the sketch are declared after its last #include.
+# Usage: ino2cpp.sh <sketch.ino> <output.cpp>
+set -e
+
+INO="$1"
+OUT="$2"
+LAST_INCLUDE=$(tr -d '\r' < "$INO" | grep -n '^#include' | tail -1 | cut -d: -f1)
+
+{
+    echo '#include <Arduino.h>'
+    echo "#line 1 \"$INO\""
+    tr -d '\r' < "$INO" | head -n "$LAST_INCLUDE"
+    tr -d '\r' < "$INO" | awk '
+        /^(else|if|while|for|return|switch)[^A-Za-z0-9_]/ { next }
+        /^[A-Za-z_][A-Za-z0-9_<>:*&, ]* \**[A-Za-z_][A-Za-z0-9_]*\(.*\)[[:space:]]*\{?[[:space:]]*$/ {
+            sub(/[[:space:]]*\{?[[:space:]]*$/, "")
+            print $0 ";"
+        }'
+    echo "#line $((LAST_INCLUDE + 1)) \"$INO\""
+    tr -d '\r' < "$INO" | tail -n +"$((LAST_INCLUDE + 1))"
+} > "$OUT"
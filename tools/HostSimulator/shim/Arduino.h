@@ -0,0 +1,106 @@
+#ifndef SIM_ARDUINO_H_
+#define SIM_ARDUINO_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <type_traits>
+
+/* Custom includes */
+#include "HardwareSerial.h"
+
+
+/*
+- NOTE1: Host replacement of the Arduino core, used by the host simulator to build the sketches
+without changes. Time is virtual: it only advances in delay(), in the blocking Serial writes and
+when the simulator calls vSimAdvanceUs() between passes of loop() (see SimCore.h)
+- NOTE2: min() and max() are templates instead of the macros of the Arduino core, so the standard
+C++ headers can be included after this one
+- NOTE3: unsigned long is 64 bits on the host. micros() and millis() return 32 bits values, but the
+subtraction of two values does not wrap as on the AVR
+*/
+
+/******************************************* CONSTANTS ********************************************/
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT        0x0
+#define OUTPUT       0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE  1
+#define FALLING 2
+#define RISING  3
+
+#define PI         3.1415926535897932384626433832795
+#define HALF_PI    1.5707963267948966192313216916398
+#define TWO_PI     6.283185307179586476925286766559
+#define DEG_TO_RAD 0.017453292519943295769236907684886
+#define RAD_TO_DEG 57.295779513082320876798154814105
+
+#define F_CPU 16000000UL
+
+#define NUM_DIGITAL_PINS 70 /**< Arduino Mega */
+
+/********************************************* MACROS *********************************************/
+#define digitalPinToInterrupt(ucPin)  (ucPin) /**< Interrupts are attached to the pin numbers */
+#define clockCyclesPerMicrosecond()   (F_CPU / 1000000L)
+#define microsecondsToClockCycles(a)  ((a) * clockCyclesPerMicrosecond())
+#define constrain(amt, low, high)     ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define _BV(bit)                      (1 << (bit))
+#define bitRead(value, bit)           (((value) >> (bit)) & 0x01)
+
+/* Binary constants of binary.h, only those used by the libraries (LiquidCrystal_I2C) */
+#define B00000001 1
+#define B00000010 2
+#define B00000100 4
+
+/********************************************* TYPES **********************************************/
+typedef bool    boolean;
+typedef uint8_t byte;
+
+/******************************************* FUNCTION *********************************************/
+template <class A_t, class B_t>
+auto min(const A_t& tA, const B_t& tB) -> typename std::decay<decltype(tA < tB ? tA : tB)>::type
+{
+    return tA < tB ? tA : tB;
+}
+
+template <class A_t, class B_t>
+auto max(const A_t& tA, const B_t& tB) -> typename std::decay<decltype(tA > tB ? tA : tB)>::type
+{
+    return tA > tB ? tA : tB;
+}
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ulMs);
+void delayMicroseconds(unsigned int ulUs);
+
+void pinMode(uint8_t ucPin, uint8_t ucMode);
+void digitalWrite(uint8_t ucPin, uint8_t ucLevel);
+int  digitalRead(uint8_t ucPin);
+int  analogRead(uint8_t ucPin);
+void analogWrite(uint8_t ucPin, int slValue);
+
+void attachInterrupt(uint8_t ucInterrupt, void (*pfIsr)(void), int slMode);
+void detachInterrupt(uint8_t ucInterrupt);
+void noInterrupts();
+void interrupts();
+
+long map(long slValue, long slFromLow, long slFromHigh, long slToLow, long slToHigh);
+char* dtostrf(double dValue, signed char scWidth, unsigned char ucPrecision, char* pscBuffer);
+
+/* Entry points of the sketch */
+void setup();
+void loop();
+
+/* Execution time of the scheduler tasks on the virtual clock (see NOTE6 of TaskScheduler.h) */
+void vSimRunTaskHook(void (*pfTask)());
+#define TASK_SCHEDULER_RUN_HOOK(pfTask) vSimRunTaskHook(pfTask)
+
+#endif /* SIM_ARDUINO_H_ */
@@ -0,0 +1,308 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdio.h>
+
+/* Custom includes */
+#include "Arduino.h"
+#include "SimCore.h"
+
+
+/******************************************** GLOBALS *********************************************/
+/* Virtual clock */
+static uint64_t      ullNowUs_          = 0;     /**< Virtual time since the start [us]           */
+static bool          bAdvancing_        = false; /**< The clock is being advanced (no reentrancy) */
+static SimStepHook_t pfStepHook_        = NULL;  /**< Plant model, called after each step         */
+static void*         pvStepHookContext_ = NULL;  /**< Argument of pfStepHook_                     */
+static SimTaskCost_t pfTaskCost_        = NULL;  /**< Execution time of the scheduler tasks       */
+
+/* Pins */
+static uint8_t  aucPinMode_[NUM_DIGITAL_PINS]     = {}; /**< Mode set by pinMode()          */
+static uint8_t  aucOutputLevel_[NUM_DIGITAL_PINS] = {}; /**< Level set by digitalWrite()    */
+static uint8_t  aucInputLevel_[NUM_DIGITAL_PINS]  = {}; /**< Level set by the plant         */
+static int      aslAnalogInput_[NUM_DIGITAL_PINS] = {}; /**< Value returned by analogRead() */
+static uint32_t aulOutputFalls_[NUM_DIGITAL_PINS] = {}; /**< HIGH to LOW writes of outputs  */
+
+/* Interrupts */
+static void     (*apfIsr_[NUM_DIGITAL_PINS])(void) = {};   /**< Attached ISR of each pin             */
+static int      aslIsrMode_[NUM_DIGITAL_PINS]      = {};   /**< Edge that runs the ISR               */
+static bool     abIsrPending_[NUM_DIGITAL_PINS]    = {};   /**< Edge detected with interrupts off    */
+static uint32_t aulIsrCount_[NUM_DIGITAL_PINS]     = {};   /**< ISR executions                       */
+static bool     bInterruptsEnabled_                = true; /**< Global interrupt flag                */
+static uint64_t ullInterruptsOffUs_                = 0;    /**< Time of the last noInterrupts() [us] */
+static uint64_t ullMaxInterruptsOffUs_             = 0;    /**< Longest time with interrupts off     */
+
+/* Ambient for the DHT sensor */
+static float fTempCelsius_ = 20.0f; /**< Temperature returned by the DHT stand-in [C] */
+static float fRelHumidity_ = 50.0f; /**< Humidity returned by the DHT stand-in [%]    */
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the ISR of a pin with the interrupts disabled, as the AVR does
+***************************************************************************************************/
+static void vRunIsr(uint8_t ucPin)
+{
+    abIsrPending_[ucPin] = false;
+    if (apfIsr_[ucPin] != NULL)
+    {
+        bInterruptsEnabled_ = false;
+        aulIsrCount_[ucPin]++;
+        apfIsr_[ucPin]();
+        bInterruptsEnabled_ = true;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the pending ISRs (lower pin numbers first)
+***************************************************************************************************/
+static void vRunPendingIsrs()
+{
+    for (uint8_t ucPin = 0; ucPin < NUM_DIGITAL_PINS && bInterruptsEnabled_; ucPin++)
+    {
+        if (abIsrPending_[ucPin])
+        {
+            vRunIsr(ucPin);
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Simulator interface (see SimCore.h)
+***************************************************************************************************/
+void vSimSetStepHook(SimStepHook_t pfHook, void* pvContext)
+{
+    pfStepHook_        = pfHook;
+    pvStepHookContext_ = pvContext;
+}
+
+void vSimSetTaskCost(SimTaskCost_t pfCost)
+{
+    pfTaskCost_ = pfCost;
+}
+
+void vSimRunTaskHook(void (*pfTask)())
+{
+    if (pfTaskCost_ != NULL)
+    {
+        vSimAdvanceUs(pfTaskCost_(pfTask));
+    }
+}
+
+void vSimAdvanceUs(uint64_t ullDeltaUs)
+{
+    /* Nested call (from an ISR or from the plant). Only the time advances */
+    if (bAdvancing_)
+    {
+        ullNowUs_ += ullDeltaUs;
+        return;
+    }
+
+    bAdvancing_ = true;
+    while (ullDeltaUs > 0)
+    {
+        uint64_t ullStepUs = ullDeltaUs < SIM_STEP_US ? ullDeltaUs : SIM_STEP_US;
+        ullNowUs_  += ullStepUs;
+        ullDeltaUs -= ullStepUs;
+
+        Serial.vSimService(ullNowUs_);
+        Serial1.vSimService(ullNowUs_);
+        Serial2.vSimService(ullNowUs_);
+        Serial3.vSimService(ullNowUs_);
+        if (pfStepHook_ != NULL)
+        {
+            pfStepHook_(ullNowUs_, pvStepHookContext_);
+        }
+    }
+    bAdvancing_ = false;
+}
+
+uint64_t ullSimGetTimeUs()
+{
+    return ullNowUs_;
+}
+
+void vSimSetPinInput(uint8_t ucPin, uint8_t ucLevel)
+{
+    if (ucPin >= NUM_DIGITAL_PINS)
+    {
+        return;
+    }
+
+    uint8_t ucOldLevel = aucInputLevel_[ucPin];
+    aucInputLevel_[ucPin] = ucLevel != LOW ? HIGH : LOW;
+    if (apfIsr_[ucPin] == NULL || ucOldLevel == aucInputLevel_[ucPin])
+    {
+        return;
+    }
+
+    /* Edge detection */
+    bool bRising = aucInputLevel_[ucPin] == HIGH;
+    if (aslIsrMode_[ucPin] == CHANGE ||
+        (aslIsrMode_[ucPin] == RISING && bRising) ||
+        (aslIsrMode_[ucPin] == FALLING && !bRising))
+    {
+        abIsrPending_[ucPin] = true;
+        vRunPendingIsrs();
+    }
+}
+
+bool bSimIsOutputLow(uint8_t ucPin)
+{
+    return ucPin < NUM_DIGITAL_PINS && aucPinMode_[ucPin] == OUTPUT && aucOutputLevel_[ucPin] == LOW;
+}
+
+void vSimSetAnalogInput(uint8_t ucPin, int slValue)
+{
+    if (ucPin < NUM_DIGITAL_PINS)
+    {
+        aslAnalogInput_[ucPin] = slValue;
+    }
+}
+
+uint32_t ulSimGetIsrCount(uint8_t ucPin)
+{
+    return ucPin < NUM_DIGITAL_PINS ? aulIsrCount_[ucPin] : 0;
+}
+
+uint32_t ulSimGetOutputFallCount(uint8_t ucPin)
+{
+    return ucPin < NUM_DIGITAL_PINS ? aulOutputFalls_[ucPin] : 0;
+}
+
+uint64_t ullSimGetMaxInterruptsOffUs()
+{
+    return ullMaxInterruptsOffUs_;
+}
+
+void vSimSetAmbient(float fTempCelsius, float fRelHumidity)
+{
+    fTempCelsius_ = fTempCelsius;
+    fRelHumidity_ = fRelHumidity;
+}
+
+void vSimGetAmbient(float& fTempCelsius, float& fRelHumidity)
+{
+    fTempCelsius = fTempCelsius_;
+    fRelHumidity = fRelHumidity_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Time functions of the Arduino core (32 bits, as on the AVR)
+***************************************************************************************************/
+unsigned long millis()
+{
+    return static_cast<uint32_t>(ullNowUs_ / 1000ULL);
+}
+
+unsigned long micros()
+{
+    return static_cast<uint32_t>(ullNowUs_);
+}
+
+void delay(unsigned long ulMs)
+{
+    vSimAdvanceUs(static_cast<uint64_t>(ulMs) * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int ulUs)
+{
+    vSimAdvanceUs(ulUs);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Pin functions of the Arduino core
+***************************************************************************************************/
+void pinMode(uint8_t ucPin, uint8_t ucMode)
+{
+    if (ucPin < NUM_DIGITAL_PINS)
+    {
+        aucPinMode_[ucPin] = ucMode;
+    }
+}
+
+void digitalWrite(uint8_t ucPin, uint8_t ucLevel)
+{
+    if (ucPin < NUM_DIGITAL_PINS)
+    {
+        if (aucPinMode_[ucPin] == OUTPUT && aucOutputLevel_[ucPin] == HIGH && ucLevel == LOW)
+        {
+            aulOutputFalls_[ucPin]++;
+        }
+        aucOutputLevel_[ucPin] = ucLevel != LOW ? HIGH : LOW;
+    }
+}
+
+int digitalRead(uint8_t ucPin)
+{
+    if (ucPin >= NUM_DIGITAL_PINS)
+    {
+        return LOW;
+    }
+
+    return aucPinMode_[ucPin] == OUTPUT ? aucOutputLevel_[ucPin] : aucInputLevel_[ucPin];
+}
+
+int analogRead(uint8_t ucPin)
+{
+    return ucPin < NUM_DIGITAL_PINS ? aslAnalogInput_[ucPin] : 0;
+}
+
+void analogWrite(uint8_t ucPin, int slValue)
+{
+    digitalWrite(ucPin, slValue > 127 ? HIGH : LOW);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Interrupt functions of the Arduino core
+***************************************************************************************************/
+void attachInterrupt(uint8_t ucInterrupt, void (*pfIsr)(void), int slMode)
+{
+    if (ucInterrupt < NUM_DIGITAL_PINS)
+    {
+        apfIsr_[ucInterrupt]       = pfIsr;
+        aslIsrMode_[ucInterrupt]   = slMode;
+        abIsrPending_[ucInterrupt] = false;
+    }
+}
+
+void detachInterrupt(uint8_t ucInterrupt)
+{
+    if (ucInterrupt < NUM_DIGITAL_PINS)
+    {
+        apfIsr_[ucInterrupt]       = NULL;
+        abIsrPending_[ucInterrupt] = false;
+    }
+}
+
+void noInterrupts()
+{
+    if (bInterruptsEnabled_)
+    {
+        bInterruptsEnabled_ = false;
+        ullInterruptsOffUs_ = ullNowUs_;
+    }
+}
+
+void interrupts()
+{
+    if (!bInterruptsEnabled_)
+    {
+        uint64_t ullOffUs = ullNowUs_ - ullInterruptsOffUs_;
+        ullMaxInterruptsOffUs_ = ullOffUs > ullMaxInterruptsOffUs_ ? ullOffUs : ullMaxInterruptsOffUs_;
+        bInterruptsEnabled_ = true;
+        vRunPendingIsrs();
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Other functions of the Arduino core
+***************************************************************************************************/
+long map(long slValue, long slFromLow, long slFromHigh, long slToLow, long slToHigh)
+{
+    return (slValue - slFromLow) * (slToHigh - slToLow) / (slFromHigh - slFromLow) + slToLow;
+}
+
+char* dtostrf(double dValue, signed char scWidth, unsigned char ucPrecision, char* pscBuffer)
+{
+    sprintf(pscBuffer, "%*.*f", scWidth, ucPrecision, dValue);
+    return pscBuffer;
+}
@@ -0,0 +1,90 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+
+/* Custom includes */
+#include "DHT.h"
+#include "SimCore.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the sensor
+***************************************************************************************************/
+DHT::DHT(uint8_t ucPin, uint8_t ucType, uint8_t ucCount)
+{
+    (void)ucPin;
+    (void)ucType;
+    (void)ucCount;
+    bFirstReading_    = true;
+    ulLastReadTimeMs_ = 0;
+    fTempCelsius_     = NAN;
+    fRelHumidity_     = NAN;
+}
+
+void DHT::begin(void)
+{
+    bFirstReading_ = true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Reads the sensor, if the last reading is older than DHT_SIM_MIN_INTERVAL_MS_UL
+* \return true if the values are valid
+***************************************************************************************************/
+bool DHT::read(bool bForce)
+{
+    if (!bForce && !bFirstReading_ && millis() - ulLastReadTimeMs_ < DHT_SIM_MIN_INTERVAL_MS_UL)
+    {
+        return true;
+    }
+
+    delay(DHT_SIM_READ_TIME_MS_UL);
+    vSimGetAmbient(fTempCelsius_, fRelHumidity_);
+    bFirstReading_    = false;
+    ulLastReadTimeMs_ = millis();
+
+    return true;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sends the start signal of a non-blocking reading (takes no time)
+***************************************************************************************************/
+void DHT::startRead(void)
+{
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Receives the values of a non-blocking reading, with the interrupts disabled
+* \return true if the values are valid
+***************************************************************************************************/
+bool DHT::finishRead(void)
+{
+    noInterrupts();
+    vSimAdvanceUs(DHT_SIM_RECEIVE_TIME_US_UL);
+    interrupts();
+    vSimGetAmbient(fTempCelsius_, fRelHumidity_);
+    bFirstReading_    = false;
+    ulLastReadTimeMs_ = millis();
+
+    return true;
+}
+
+float DHT::readTemperature(bool bFahrenheit, bool bForce)
+{
+    read(bForce);
+    return bFahrenheit ? convertCtoF(fTempCelsius_) : fTempCelsius_;
+}
+
+float DHT::readHumidity(bool bForce)
+{
+    read(bForce);
+    return fRelHumidity_;
+}
+
+float DHT::convertCtoF(float fCelsius)
+{
+    return fCelsius * 1.8f + 32.0f;
+}
+
+float DHT::convertFtoC(float fFahrenheit)
+{
+    return (fFahrenheit - 32.0f) * 0.55555f;
+}
@@ -0,0 +1,55 @@
+#ifndef SIM_DHT_H_
+#define SIM_DHT_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+#include "Arduino.h"
+
+
+/*
+- NOTE1: Stand-in of the DHT library (the real one bit-bangs the sensor protocol). A reading blocks
+for DHT_SIM_READ_TIME_MS_UL, and is cached for 2 s as in the library. The values are set by the
+simulator with vSimSetAmbient()
+- NOTE2: The non-blocking reading (startRead() and finishRead() 20 ms later) only blocks for the
+reception of the 40 bits, DHT_SIM_RECEIVE_TIME_US_UL with the interrupts disabled
+*/
+
+/******************************************* CONSTANTS ********************************************/
+#define DHT11 11
+#define DHT22 22
+#define DHT21 21
+#define AM2301 21
+
+const unsigned long DHT_SIM_READ_TIME_MS_UL    = 270;  /**< Time blocked by a reading of the sensor          */
+const unsigned long DHT_SIM_RECEIVE_TIME_US_UL = 5000; /**< Time blocked by finishRead(), interrupts disabled */
+const unsigned long DHT_SIM_MIN_INTERVAL_MS_UL = 2000; /**< Readings are cached during this time             */
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class DHT
+ * \brief Temperature and humidity sensor
+ **************************************************************************************************/
+class DHT
+{
+public:
+    DHT(uint8_t ucPin, uint8_t ucType, uint8_t ucCount = 6);
+    void begin(void);
+    float readTemperature(bool bFahrenheit = false, bool bForce = false);
+    float readHumidity(bool bForce = false);
+    float convertCtoF(float fCelsius);
+    float convertFtoC(float fFahrenheit);
+    bool read(bool bForce = false);
+    void startRead(void);
+    bool finishRead(void);
+
+private:
+    bool          bFirstReading_;    /**< No reading since begin()               */
+    unsigned long ulLastReadTimeMs_; /**< Output of millis() at the last reading */
+    float         fTempCelsius_;     /**< Last temperature [C]                   */
+    float         fRelHumidity_;     /**< Last humidity [%]                      */
+};
+
+#endif /* SIM_DHT_H_ */
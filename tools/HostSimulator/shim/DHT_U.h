@@ -0,0 +1,10 @@
+#ifndef SIM_DHT_U_H_
+#define SIM_DHT_U_H_
+
+/*
+- NOTE1: Stand-in of the unified sensor interface of the DHT library. The sketches only use DHT
+*/
+#include <Adafruit_Sensor.h>
+#include "DHT.h"
+
+#endif /* SIM_DHT_U_H_ */
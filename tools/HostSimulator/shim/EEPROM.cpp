@@ -0,0 +1,93 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdio.h>
+#include <string.h>
+
+/* Custom includes */
+#include "EEPROM.h"
+
+
+/******************************************** GLOBALS *********************************************/
+EEPROMClass EEPROM;
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor. The memory starts erased
+***************************************************************************************************/
+EEPROMClass::EEPROMClass()
+{
+    memset(aucMemory_, 0xFF, sizeof(aucMemory_));
+    ulWrites_ = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Functions of the EEPROM library. Addresses out of range are ignored
+***************************************************************************************************/
+uint8_t EEPROMClass::read(int slAddress)
+{
+    return slAddress >= 0 && slAddress < SIM_EEPROM_SIZE_US ? aucMemory_[slAddress] : 0xFF;
+}
+
+void EEPROMClass::write(int slAddress, uint8_t ucValue)
+{
+    if (slAddress >= 0 && slAddress < SIM_EEPROM_SIZE_US)
+    {
+        aucMemory_[slAddress] = ucValue;
+        ulWrites_++;
+    }
+}
+
+void EEPROMClass::update(int slAddress, uint8_t ucValue)
+{
+    if (read(slAddress) != ucValue)
+    {
+        write(slAddress, ucValue);
+    }
+}
+
+uint16_t EEPROMClass::length()
+{
+    return SIM_EEPROM_SIZE_US;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Loads the contents from a file (raw image)
+* \return true if the file was read
+***************************************************************************************************/
+bool EEPROMClass::bSimLoad(const char* pscFileName)
+{
+    FILE* pstFile = fopen(pscFileName, "rb");
+    if (pstFile == NULL)
+    {
+        return false;
+    }
+
+    size_t ulRead = fread(aucMemory_, 1, sizeof(aucMemory_), pstFile);
+    fclose(pstFile);
+    return ulRead == sizeof(aucMemory_);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Stores the contents in a file (raw image)
+* \return true if the file was written
+***************************************************************************************************/
+bool EEPROMClass::bSimStore(const char* pscFileName) const
+{
+    FILE* pstFile = fopen(pscFileName, "wb");
+    if (pstFile == NULL)
+    {
+        return false;
+    }
+
+    size_t ulWritten = fwrite(aucMemory_, 1, sizeof(aucMemory_), pstFile);
+    fclose(pstFile);
+    return ulWritten == sizeof(aucMemory_);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Gets the number of cell writes since the start
+***************************************************************************************************/
+uint32_t EEPROMClass::ulSimGetWrites() const
+{
+    return ulWrites_;
+}
@@ -0,0 +1,47 @@
+#ifndef SIM_EEPROM_H_
+#define SIM_EEPROM_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Host replacement of the EEPROM library, in memory (4 KB, as the Arduino Mega). Erased cells
+read 0xFF. The simulator can load and store the contents from a file, to simulate resets
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const uint16_t SIM_EEPROM_SIZE_US = 4096; /**< Bytes of the Arduino Mega EEPROM */
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class EEPROMClass
+ * \brief In memory EEPROM
+ **************************************************************************************************/
+class EEPROMClass
+{
+public:
+    EEPROMClass();
+
+    uint8_t read(int slAddress);
+    void write(int slAddress, uint8_t ucValue);
+    void update(int slAddress, uint8_t ucValue);
+    uint16_t length();
+
+    /* Simulator side */
+    bool bSimLoad(const char* pscFileName);
+    bool bSimStore(const char* pscFileName) const;
+    uint32_t ulSimGetWrites() const;
+
+private:
+    uint8_t  aucMemory_[SIM_EEPROM_SIZE_US]; /**< Contents                         */
+    uint32_t ulWrites_;                      /**< Cell writes (wear of the EEPROM) */
+};
+
+/******************************************** GLOBALS *********************************************/
+extern EEPROMClass EEPROM;
+
+#endif /* SIM_EEPROM_H_ */
@@ -0,0 +1,194 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+
+/* Custom includes */
+#include "HardwareSerial.h"
+#include "SimCore.h"
+
+
+/******************************************* CONSTANTS ********************************************/
+static const unsigned long DEFAULT_BAUD_RATE_UL = 9600; /**< Baud rate if begin() is not called */
+static const uint64_t      BITS_PER_BYTE_ULL    = 10;   /**< Start, 8 data and stop bits        */
+
+/******************************************** GLOBALS *********************************************/
+HardwareSerial Serial;
+HardwareSerial Serial1;
+HardwareSerial Serial2;
+HardwareSerial Serial3;
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor of the serial port
+***************************************************************************************************/
+HardwareSerial::HardwareSerial()
+{
+    ullByteTimeUs_ = BITS_PER_BYTE_ULL * 1000000ULL / DEFAULT_BAUD_RATE_UL;
+    ullNextTxUs_   = 0;
+    ullNextRxUs_   = 0;
+    pfSink_        = NULL;
+    pvSinkContext_ = NULL;
+    ulTxBytes_     = 0;
+    ulRxOverflows_ = 0;
+    ullBlockedUs_  = 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sets the baud rate of the port
+***************************************************************************************************/
+void HardwareSerial::begin(unsigned long ulBaudRate)
+{
+    if (ulBaudRate > 0)
+    {
+        ullByteTimeUs_ = (BITS_PER_BYTE_ULL * 1000000ULL + ulBaudRate - 1) / ulBaudRate;
+    }
+}
+
+void HardwareSerial::end()
+{
+    flush();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Reception functions of the Stream interface
+***************************************************************************************************/
+int HardwareSerial::available()
+{
+    return static_cast<int>(clRxBuffer_.size());
+}
+
+int HardwareSerial::read()
+{
+    if (clRxBuffer_.empty())
+    {
+        return -1;
+    }
+
+    uint8_t ucByte = clRxBuffer_.front();
+    clRxBuffer_.pop_front();
+    return ucByte;
+}
+
+int HardwareSerial::peek()
+{
+    return clRxBuffer_.empty() ? -1 : clRxBuffer_.front();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Waits until all the bytes in the transmission buffer have been sent
+***************************************************************************************************/
+void HardwareSerial::flush()
+{
+    while (!clTxBuffer_.empty())
+    {
+        uint64_t ullNowUs = ullSimGetTimeUs();
+        vSimAdvanceUs(ullNextTxUs_ > ullNowUs ? ullNextTxUs_ - ullNowUs : 0);
+        vSimService(ullSimGetTimeUs());
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Queues one byte for transmission. Blocks while the buffer is full, as the AVR core
+***************************************************************************************************/
+size_t HardwareSerial::write(uint8_t ucByte)
+{
+    while (clTxBuffer_.size() >= SERIAL_TX_BUFFER_SIZE_US)
+    {
+        uint64_t ullNowUs = ullSimGetTimeUs();
+        uint64_t ullWaitUs = ullNextTxUs_ > ullNowUs ? ullNextTxUs_ - ullNowUs : 0;
+        ullBlockedUs_ += ullWaitUs;
+        vSimAdvanceUs(ullWaitUs);
+        vSimService(ullSimGetTimeUs());
+    }
+
+    /* The first byte leaves one byte time after it is written */
+    if (clTxBuffer_.empty())
+    {
+        uint64_t ullEarliestUs = ullSimGetTimeUs() + ullByteTimeUs_;
+        ullNextTxUs_ = ullNextTxUs_ > ullEarliestUs ? ullNextTxUs_ : ullEarliestUs;
+    }
+    clTxBuffer_.push_back(ucByte);
+
+    return 1;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Free space of the transmission buffer. As the AVR core, one byte less than the buffer
+***************************************************************************************************/
+int HardwareSerial::availableForWrite()
+{
+    int slFree = static_cast<int>(SERIAL_TX_BUFFER_SIZE_US) - 1 - static_cast<int>(clTxBuffer_.size());
+    return slFree > 0 ? slFree : 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Adds bytes to the line. They reach the reception buffer at the baud rate
+***************************************************************************************************/
+void HardwareSerial::vSimInject(const uint8_t* pucBuffer, size_t ulSize)
+{
+    if (clRxLine_.empty())
+    {
+        uint64_t ullEarliestUs = ullSimGetTimeUs() + ullByteTimeUs_;
+        ullNextRxUs_ = ullNextRxUs_ > ullEarliestUs ? ullNextRxUs_ : ullEarliestUs;
+    }
+    clRxLine_.insert(clRxLine_.end(), pucBuffer, pucBuffer + ulSize);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sets the function that receives the transmitted bytes
+***************************************************************************************************/
+void HardwareSerial::vSimSetSink(SerialSink_t pfSink, void* pvContext)
+{
+    pfSink_        = pfSink;
+    pvSinkContext_ = pvContext;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Moves the bytes whose time has come from the line to the reception buffer, and from the
+* transmission buffer to the sink
+***************************************************************************************************/
+void HardwareSerial::vSimService(uint64_t ullNowUs)
+{
+    while (!clTxBuffer_.empty() && ullNextTxUs_ <= ullNowUs)
+    {
+        uint8_t ucByte = clTxBuffer_.front();
+        clTxBuffer_.pop_front();
+        ulTxBytes_++;
+        ullNextTxUs_ += ullByteTimeUs_;
+        if (pfSink_ != NULL)
+        {
+            pfSink_(ucByte, pvSinkContext_);
+        }
+    }
+
+    while (!clRxLine_.empty() && ullNextRxUs_ <= ullNowUs)
+    {
+        if (clRxBuffer_.size() < SERIAL_RX_BUFFER_SIZE_US)
+        {
+            clRxBuffer_.push_back(clRxLine_.front());
+        }
+        else
+        {
+            ulRxOverflows_++;
+        }
+        clRxLine_.pop_front();
+        ullNextRxUs_ += ullByteTimeUs_;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Statistics of the port
+***************************************************************************************************/
+uint32_t HardwareSerial::ulSimGetTxBytes() const
+{
+    return ulTxBytes_;
+}
+
+uint32_t HardwareSerial::ulSimGetRxOverflows() const
+{
+    return ulRxOverflows_;
+}
+
+uint64_t HardwareSerial::ullSimGetBlockedUs() const
+{
+    return ullBlockedUs_;
+}
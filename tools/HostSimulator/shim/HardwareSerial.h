@@ -0,0 +1,78 @@
+#ifndef SIM_HARDWARE_SERIAL_H_
+#define SIM_HARDWARE_SERIAL_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+#include <deque>
+
+/* Custom includes */
+#include "Stream.h"
+
+
+/*
+- NOTE1: Host replacement of the AVR HardwareSerial. Both buffers have the size of the AVR core, and
+the bytes move at the configured baud rate (10 bits per byte) in virtual time: write() blocks
+(advancing the clock) while the transmission buffer is full, and the receive buffer overflows if the
+sketch doesn't read it on time
+- NOTE2: The simulator injects the received bytes with vSimInject(), and gets the transmitted ones
+(when they leave the port) through the sink function
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const uint16_t SERIAL_TX_BUFFER_SIZE_US = 64; /**< Transmission buffer of the AVR core [bytes] */
+const uint16_t SERIAL_RX_BUFFER_SIZE_US = 64; /**< Reception buffer of the AVR core [bytes]    */
+
+/********************************************* TYPES **********************************************/
+typedef void (*SerialSink_t)(uint8_t ucByte, void* pvContext); /**< Receives the transmitted bytes */
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class HardwareSerial
+ * \brief Serial port with virtual timing
+ **************************************************************************************************/
+class HardwareSerial : public Stream
+{
+public:
+    HardwareSerial();
+
+    void begin(unsigned long ulBaudRate);
+    void end();
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override;
+    size_t write(uint8_t ucByte) override;
+    int availableForWrite();
+    using Print::write;
+    operator bool() { return true; }
+
+    /* Simulator side */
+    void vSimInject(const uint8_t* pucBuffer, size_t ulSize);
+    void vSimSetSink(SerialSink_t pfSink, void* pvContext);
+    void vSimService(uint64_t ullNowUs);
+    uint32_t ulSimGetTxBytes() const;
+    uint32_t ulSimGetRxOverflows() const;
+    uint64_t ullSimGetBlockedUs() const;
+
+private:
+    uint64_t            ullByteTimeUs_; /**< Time to send or receive one byte [us]        */
+    uint64_t            ullNextTxUs_;   /**< Time when the next byte leaves the port      */
+    uint64_t            ullNextRxUs_;   /**< Time when the next injected byte is received */
+    std::deque<uint8_t> clTxBuffer_;    /**< Transmission buffer                          */
+    std::deque<uint8_t> clRxBuffer_;    /**< Reception buffer                             */
+    std::deque<uint8_t> clRxLine_;      /**< Injected bytes not received yet              */
+    SerialSink_t        pfSink_;        /**< Receives the transmitted bytes               */
+    void*               pvSinkContext_; /**< Argument of pfSink_                          */
+    uint32_t            ulTxBytes_;     /**< Transmitted bytes                            */
+    uint32_t            ulRxOverflows_; /**< Bytes lost with the reception buffer full    */
+    uint64_t            ullBlockedUs_;  /**< Time blocked in write() with the buffer full */
+};
+
+/******************************************** GLOBALS *********************************************/
+extern HardwareSerial Serial;
+extern HardwareSerial Serial1;
+extern HardwareSerial Serial2;
+extern HardwareSerial Serial3;
+
+#endif /* SIM_HARDWARE_SERIAL_H_ */
@@ -0,0 +1,171 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <math.h>
+#include <stdio.h>
+
+/* Custom includes */
+#include "Print.h"
+
+
+/****************************************** FUNCTION *******************************************//**
+***************************************************************************************************/
+size_t Print::write(const uint8_t* pucBuffer, size_t ulSize)
+{
+    size_t ulWritten = 0;
+    while (ulSize-- > 0)
+    {
+        ulWritten += write(*pucBuffer++);
+    }
+
+    return ulWritten;
+}
+
+size_t Print::write(const char* pscString)
+{
+    return pscString == NULL ? 0 : write(reinterpret_cast<const uint8_t*>(pscString), strlen(pscString));
+}
+
+size_t Print::write(const char* pscBuffer, size_t ulSize)
+{
+    return write(reinterpret_cast<const uint8_t*>(pscBuffer), ulSize);
+}
+
+/****************************************** FUNCTION *******************************************//**
+***************************************************************************************************/
+size_t Print::print(const __FlashStringHelper* pclString)
+{
+    return write(reinterpret_cast<const char*>(pclString));
+}
+
+size_t Print::print(const char* pscString)
+{
+    return write(pscString);
+}
+
+size_t Print::print(char scChar)
+{
+    return write(static_cast<uint8_t>(scChar));
+}
+
+size_t Print::print(unsigned char ucValue, int slBase)
+{
+    return printNumber(ucValue, slBase);
+}
+
+size_t Print::print(int slValue, int slBase)
+{
+    return print(static_cast<long>(slValue), slBase);
+}
+
+size_t Print::print(unsigned int ulValue, int slBase)
+{
+    return printNumber(ulValue, slBase);
+}
+
+size_t Print::print(long slValue, int slBase)
+{
+    /* As in the Arduino core, only base 10 numbers have sign */
+    if (slBase == DEC && slValue < 0)
+    {
+        return print('-') + printNumber(-static_cast<unsigned long>(slValue), DEC);
+    }
+
+    return printNumber(static_cast<unsigned long>(slValue), slBase);
+}
+
+size_t Print::print(unsigned long ulValue, int slBase)
+{
+    return printNumber(ulValue, slBase);
+}
+
+size_t Print::print(double dValue, int slDigits)
+{
+    /* Same special values as the Arduino core */
+    if (isnan(dValue))
+    {
+        return print("nan");
+    }
+    if (isinf(dValue))
+    {
+        return print("inf");
+    }
+
+    char ascBuffer[48];
+    snprintf(ascBuffer, sizeof(ascBuffer), "%.*f", slDigits, dValue);
+    return print(ascBuffer);
+}
+
+/****************************************** FUNCTION *******************************************//**
+***************************************************************************************************/
+size_t Print::println()
+{
+    return write("\r\n");
+}
+
+size_t Print::println(const __FlashStringHelper* pclString)
+{
+    return print(pclString) + println();
+}
+
+size_t Print::println(const char* pscString)
+{
+    return print(pscString) + println();
+}
+
+size_t Print::println(char scChar)
+{
+    return print(scChar) + println();
+}
+
+size_t Print::println(unsigned char ucValue, int slBase)
+{
+    return print(ucValue, slBase) + println();
+}
+
+size_t Print::println(int slValue, int slBase)
+{
+    return print(slValue, slBase) + println();
+}
+
+size_t Print::println(unsigned int ulValue, int slBase)
+{
+    return print(ulValue, slBase) + println();
+}
+
+size_t Print::println(long slValue, int slBase)
+{
+    return print(slValue, slBase) + println();
+}
+
+size_t Print::println(unsigned long ulValue, int slBase)
+{
+    return print(ulValue, slBase) + println();
+}
+
+size_t Print::println(double dValue, int slDigits)
+{
+    return print(dValue, slDigits) + println();
+}
+
+/****************************************** FUNCTION *******************************************//**
+***************************************************************************************************/
+size_t Print::printNumber(unsigned long ulValue, int slBase)
+{
+    char ascBuffer[8 * sizeof(unsigned long) + 1];
+    char* pscDigit = &ascBuffer[sizeof(ascBuffer) - 1];
+    *pscDigit = '\0';
+
+    if (slBase < 2)
+    {
+        slBase = DEC;
+    }
+
+    do
+    {
+        unsigned long ulDigit = ulValue % slBase;
+        *--pscDigit = ulDigit < 10 ? '0' + ulDigit : 'A' + ulDigit - 10;
+        ulValue /= slBase;
+    } while (ulValue > 0);
+
+    return write(pscDigit);
+}
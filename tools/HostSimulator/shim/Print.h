@@ -0,0 +1,70 @@
+#ifndef SIM_PRINT_H_
+#define SIM_PRINT_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Host replacement of the Print class of the Arduino core. Only the functions used by the
+wind turbine code are provided. Strings in flash (F()) are plain strings on the host
+*/
+
+/******************************************* CONSTANTS ********************************************/
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+/********************************************* MACROS *********************************************/
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class Print
+ * \brief Base class of the objects that can print text (Serial ports)
+ **************************************************************************************************/
+class Print
+{
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t ucByte) = 0;
+    virtual size_t write(const uint8_t* pucBuffer, size_t ulSize);
+    size_t write(const char* pscString);
+    size_t write(const char* pscBuffer, size_t ulSize);
+
+    size_t print(const __FlashStringHelper* pclString);
+    size_t print(const char* pscString);
+    size_t print(char scChar);
+    size_t print(unsigned char ucValue, int slBase = DEC);
+    size_t print(int slValue, int slBase = DEC);
+    size_t print(unsigned int ulValue, int slBase = DEC);
+    size_t print(long slValue, int slBase = DEC);
+    size_t print(unsigned long ulValue, int slBase = DEC);
+    size_t print(double dValue, int slDigits = 2);
+
+    size_t println();
+    size_t println(const __FlashStringHelper* pclString);
+    size_t println(const char* pscString);
+    size_t println(char scChar);
+    size_t println(unsigned char ucValue, int slBase = DEC);
+    size_t println(int slValue, int slBase = DEC);
+    size_t println(unsigned int ulValue, int slBase = DEC);
+    size_t println(long slValue, int slBase = DEC);
+    size_t println(unsigned long ulValue, int slBase = DEC);
+    size_t println(double dValue, int slDigits = 2);
+
+    void setWriteError(int slError = 1) { (void)slError; }
+
+private:
+    size_t printNumber(unsigned long ulValue, int slBase);
+};
+
+#endif /* SIM_PRINT_H_ */
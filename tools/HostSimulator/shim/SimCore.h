@@ -0,0 +1,93 @@
+#ifndef SIM_CORE_H_
+#define SIM_CORE_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Interface between the host Arduino core and the simulator. The sketch never includes this
+file
+- NOTE2: The virtual clock advances in steps of SIM_STEP_US. After each step the Serial ports are
+serviced and the step hook (the plant model) is called. The plant drives the input pins with
+vSimSetPinInput(), which runs the attached ISR on the programmed edge, or leaves it pending while the
+interrupts are disabled (one pending flag per pin, as the AVR interrupt flags)
+- NOTE3: If the clock is advanced from inside an ISR or the step hook (e.g. a blocking Serial write),
+the time advances without servicing the plant
+- NOTE4: The code of the sketch takes no virtual time by itself. The task cost function, if set, gives
+the execution time charged to the clock after each run of a scheduler task (with the interrupts
+enabled, so the plant and the ISRs keep running)
+*/
+
+/******************************************* CONSTANTS ********************************************/
+const uint32_t SIM_STEP_US = 20; /**< Resolution of the virtual clock for the plant and the pins [us] */
+
+/********************************************* TYPES **********************************************/
+typedef void (*SimStepHook_t)(uint64_t ullNowUs, void* pvContext); /**< Called after each clock step */
+typedef uint32_t (*SimTaskCost_t)(void (*pfTask)());                /**< Execution time of a task [us] */
+
+/******************************************* FUNCTION *********************************************/
+/***********************************************************************************************//**
+* \brief Sets the function called after each step of the virtual clock (only one)
+***************************************************************************************************/
+void vSimSetStepHook(SimStepHook_t pfHook, void* pvContext);
+
+/***********************************************************************************************//**
+* \brief Sets the function that gives the execution time of each scheduler task (NULL: no time)
+***************************************************************************************************/
+void vSimSetTaskCost(SimTaskCost_t pfCost);
+
+/***********************************************************************************************//**
+* \brief Advances the virtual clock, servicing the Serial ports and the plant model
+***************************************************************************************************/
+void vSimAdvanceUs(uint64_t ullDeltaUs);
+
+/***********************************************************************************************//**
+* \brief Gets the virtual time since the start of the simulation [us], without the 32 bits overflow
+***************************************************************************************************/
+uint64_t ullSimGetTimeUs();
+
+/***********************************************************************************************//**
+* \brief Sets the level of an input pin. Runs the attached ISR (or leaves it pending) on its edge
+***************************************************************************************************/
+void vSimSetPinInput(uint8_t ucPin, uint8_t ucLevel);
+
+/***********************************************************************************************//**
+* \brief Returns true if the pin is an output driven LOW (an energised relay of the relay modules)
+***************************************************************************************************/
+bool bSimIsOutputLow(uint8_t ucPin);
+
+/***********************************************************************************************//**
+* \brief Sets the value returned by analogRead() for a pin
+***************************************************************************************************/
+void vSimSetAnalogInput(uint8_t ucPin, int slValue);
+
+/***********************************************************************************************//**
+* \brief Gets the number of ISR executions of a pin since the start of the simulation
+***************************************************************************************************/
+uint32_t ulSimGetIsrCount(uint8_t ucPin);
+
+/***********************************************************************************************//**
+* \brief Gets the number of HIGH to LOW writes of an output pin (relay energisations) since the start
+***************************************************************************************************/
+uint32_t ulSimGetOutputFallCount(uint8_t ucPin);
+
+/***********************************************************************************************//**
+* \brief Gets the longest time with the interrupts disabled (noInterrupts() to interrupts()) [us]
+***************************************************************************************************/
+uint64_t ullSimGetMaxInterruptsOffUs();
+
+/***********************************************************************************************//**
+* \brief Sets the temperature and humidity returned by the DHT sensor stand-in
+***************************************************************************************************/
+void vSimSetAmbient(float fTempCelsius, float fRelHumidity);
+
+/***********************************************************************************************//**
+* \brief Gets the temperature and humidity set by vSimSetAmbient()
+***************************************************************************************************/
+void vSimGetAmbient(float& fTempCelsius, float& fRelHumidity);
+
+#endif /* SIM_CORE_H_ */
@@ -0,0 +1,25 @@
+#ifndef SIM_STREAM_H_
+#define SIM_STREAM_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+
+/* Custom includes */
+#include "Print.h"
+
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class Stream
+ * \brief Base class of the objects that can read and write bytes (Serial ports)
+ **************************************************************************************************/
+class Stream : public Print
+{
+public:
+    virtual int available() = 0;
+    virtual int read() = 0;
+    virtual int peek() = 0;
+    virtual void flush() {}
+};
+
+#endif /* SIM_STREAM_H_ */
@@ -0,0 +1,106 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <string.h>
+
+/* Custom includes */
+#include "SimCore.h"
+#include "Wire.h"
+
+
+/******************************************** GLOBALS *********************************************/
+TwoWire Wire;
+
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Constructor. No hook and no traffic
+***************************************************************************************************/
+TwoWire::TwoWire()
+{
+    ucAddress_     = 0;
+    ulLength_      = 0;
+    pfHook_        = NULL;
+    pvHookContext_ = NULL;
+    vSimResetStats();
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Functions of the Wire library (master transmitter only)
+***************************************************************************************************/
+void TwoWire::begin()
+{
+}
+
+void TwoWire::beginTransmission(uint8_t ucAddress)
+{
+    ucAddress_ = ucAddress;
+    ulLength_  = 0;
+}
+
+size_t TwoWire::write(uint8_t ucData)
+{
+    if (ulLength_ >= BUFFER_LENGTH)
+    {
+        stStats_.ulDropped++;
+        return 0;
+    }
+
+    aucBuffer_[ulLength_++] = ucData;
+    return 1;
+}
+
+size_t TwoWire::write(const uint8_t* pucData, size_t ulSize)
+{
+    size_t ulWritten = 0;
+    for (size_t ulIdx = 0; ulIdx < ulSize; ulIdx++)
+    {
+        ulWritten += write(pucData[ulIdx]);
+    }
+
+    return ulWritten;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Ends the transaction: charges its bus time (see NOTE2) and passes it to the hook
+* \return 0 (success), as the AVR library when the device acknowledges
+***************************************************************************************************/
+uint8_t TwoWire::endTransmission()
+{
+    uint64_t ullBusUs = SIM_WIRE_START_STOP_US + (ulLength_ + 1) * SIM_WIRE_BYTE_US;
+    stStats_.ulTransactions++;
+    stStats_.ulBytes  += ulLength_;
+    stStats_.ullBusUs += ullBusUs;
+    vSimAdvanceUs(ullBusUs);
+
+    if (pfHook_ != NULL)
+    {
+        pfHook_(ucAddress_, aucBuffer_, ulLength_, pvHookContext_);
+    }
+    ulLength_ = 0;
+
+    return 0;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sets the function called with the bytes of each transaction (only one, NULL: none)
+***************************************************************************************************/
+void TwoWire::vSimSetTransmitHook(SimWireHook_t pfHook, void* pvContext)
+{
+    pfHook_        = pfHook;
+    pvHookContext_ = pvContext;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Gets the traffic since the start or the last reset
+***************************************************************************************************/
+const SimWireStats_st& TwoWire::stSimGetStats() const
+{
+    return stStats_;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Resets the traffic counters
+***************************************************************************************************/
+void TwoWire::vSimResetStats()
+{
+    memset(&stStats_, 0, sizeof(stStats_));
+}
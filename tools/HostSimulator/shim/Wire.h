@@ -0,0 +1,78 @@
+#ifndef SIM_WIRE_H_
+#define SIM_WIRE_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stddef.h>
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Host replacement of the Wire library (I2C master only). The bytes of each transaction are
+kept until endTransmission(), which charges the bus time to the virtual clock and passes the
+transaction to the transmit hook, if any (e.g. a model of the device)
+- NOTE2: The bus time is the one of the AVR TWI at 100 kHz: 9 bits per byte (8 data bits and the
+acknowledge), for the address and each data byte, plus the start and stop conditions
+- NOTE3: As in the AVR library, the transmit buffer holds BUFFER_LENGTH bytes and the bytes that do
+not fit are dropped (write() returns 0). The dropped bytes are counted
+*/
+
+/******************************************* CONSTANTS ********************************************/
+#define BUFFER_LENGTH 32 /**< Transmit buffer of the AVR Wire library */
+
+const uint32_t SIM_WIRE_BYTE_US       = 90; /**< Bus time of a byte at 100 kHz (9 bits) [us]    */
+const uint32_t SIM_WIRE_START_STOP_US = 10; /**< Bus time of the start and stop conditions [us] */
+
+/********************************************* TYPES **********************************************/
+typedef void (*SimWireHook_t)(uint8_t ucAddress, const uint8_t* pucData, size_t ulSize, void* pvContext); /**< Called after each transaction */
+
+/***********************************************************************************************//**
+ * \struct SimWireStats_st
+ * \brief Traffic of the I2C bus
+ **************************************************************************************************/
+struct SimWireStats_st
+{
+    uint32_t ulTransactions; /**< Calls to endTransmission()        */
+    uint32_t ulBytes;        /**< Data bytes sent (no address byte) */
+    uint32_t ulDropped;      /**< Bytes that did not fit the buffer */
+    uint64_t ullBusUs;       /**< Bus time of all the transactions  */
+};
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class TwoWire
+ * \brief I2C master that counts the traffic instead of driving the bus
+ **************************************************************************************************/
+class TwoWire
+{
+public:
+    TwoWire();
+
+    void begin();
+    void beginTransmission(uint8_t ucAddress);
+    void beginTransmission(int slAddress) { beginTransmission(static_cast<uint8_t>(slAddress)); }
+    uint8_t endTransmission();
+    size_t write(uint8_t ucData);
+    size_t write(const uint8_t* pucData, size_t ulSize);
+    size_t write(int slData) { return write(static_cast<uint8_t>(slData)); }
+
+    /* Simulator side */
+    void vSimSetTransmitHook(SimWireHook_t pfHook, void* pvContext);
+    const SimWireStats_st& stSimGetStats() const;
+    void vSimResetStats();
+
+private:
+    uint8_t         ucAddress_;                /**< Address of the current transaction */
+    uint8_t         aucBuffer_[BUFFER_LENGTH]; /**< Bytes of the current transaction   */
+    size_t          ulLength_;                 /**< Bytes in the buffer                */
+    SimWireHook_t   pfHook_;                   /**< Transmit hook (NULL: none)         */
+    void*           pvHookContext_;            /**< Context passed to the hook         */
+    SimWireStats_st stStats_;                  /**< Traffic since the last reset       */
+};
+
+/******************************************** GLOBALS *********************************************/
+extern TwoWire Wire;
+
+#endif /* SIM_WIRE_H_ */
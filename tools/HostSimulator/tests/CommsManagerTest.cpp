@@ -0,0 +1,192 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <CommsManager.h>
+#include <Stream.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Sends flight recorder chunks (the longest message) through a memory stream and reads them
+as the sketches do: in each read period, bReadInputMessage() is called until it finds no message.
+Every chunk must arrive intact with the input buffer of INPUT_BUFFER_LENGTH_UL bytes
+- NOTE2: The stream gives the reader at most the bytes of a reception buffer, refilled between read
+periods: 64 bytes as the AVR HardwareSerial, and a large buffer with everything already received,
+which the reader must leave in the stream when its buffer is full
+- NOTE3: Noise between the messages and a corrupted message must only lose the corrupted one
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const unsigned int NUM_MESSAGES_UL    = 50;   /**< Chunks sent in each scenario                 */
+static const unsigned int AVR_RX_BUFFER_UL   = 64;   /**< Reception buffer of the AVR HardwareSerial   */
+static const unsigned int LARGE_RX_BUFFER_UL = 4096; /**< Reception buffer that holds the whole stream */
+static const unsigned int MAX_STREAM_UL      = 8192; /**< Capacity of the memory stream                */
+static const unsigned int MAX_PERIODS_UL     = 1000; /**< Read periods of each scenario                */
+
+/********************************************* CLASS **********************************************/
+/***********************************************************************************************//**
+ * \class MemoryStream
+ * \brief Stream over a memory buffer, with a reception buffer of limited size (see NOTE2)
+ **************************************************************************************************/
+class MemoryStream : public Stream
+{
+public:
+    MemoryStream() : ulLength_(0), ulReadPos_(0), ulReceived_(0) {}
+
+    size_t write(uint8_t ucByte) override
+    {
+        if (ulLength_ >= MAX_STREAM_UL)
+        {
+            return 0;
+        }
+        aucData_[ulLength_++] = ucByte;
+        return 1;
+    }
+
+    int available() override { return ulReceived_ - ulReadPos_; }
+    int read() override { return ulReadPos_ < ulReceived_ ? aucData_[ulReadPos_++] : -1; }
+    int peek() override { return ulReadPos_ < ulReceived_ ? aucData_[ulReadPos_] : -1; }
+
+    /** Receives the next bytes, up to a reception buffer of ulRxBuffer bytes */
+    void vReceive(const unsigned int ulRxBuffer)
+    {
+        ulReceived_ = ulReadPos_ + ulRxBuffer < ulLength_ ? ulReadPos_ + ulRxBuffer : ulLength_;
+    }
+
+    /** True when all the bytes have been read */
+    bool bIsEmpty() const { return ulReadPos_ == ulLength_; }
+
+    /** Corrupts a byte already written */
+    void vCorrupt(const unsigned int ulPos) { aucData_[ulPos] ^= 0x5A; }
+
+    unsigned int ulGetLength() const { return ulLength_; }
+
+private:
+    uint8_t      aucData_[MAX_STREAM_UL]; /**< Bytes written               */
+    unsigned int ulLength_;               /**< Number of bytes written     */
+    unsigned int ulReadPos_;              /**< Next byte to read           */
+    unsigned int ulReceived_;             /**< End of the reception buffer */
+};
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Gets the chunk number ulIdx, with records that depend on the index
+***************************************************************************************************/
+static RecorderChunk_st stMakeChunk(const unsigned int ulIdx)
+{
+    RecorderChunk_st stChunk = {};
+    stChunk.usChunk         = ulIdx;
+    stChunk.usNumChunks     = NUM_MESSAGES_UL;
+    stChunk.ulTriggerTimeMs = 1000 * ulIdx;
+    stChunk.ucNumRecords    = RECORDER_CHUNK_RECORDS_UC;
+    for (unsigned char ucRecord = 0; ucRecord < RECORDER_CHUNK_RECORDS_UC; ucRecord++)
+    {
+        stChunk.astRecords[ucRecord].sWindSpeed   = static_cast<int16_t>(ulIdx * 31 + ucRecord);
+        stChunk.astRecords[ucRecord].sRotorSpeed  = static_cast<int16_t>(ulIdx * 17 - ucRecord);
+        stChunk.astRecords[ucRecord].ucBladePitch = static_cast<uint8_t>(ulIdx + ucRecord);
+    }
+    return stChunk;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Reads the stream as the sketches do, one read period after each reception (see NOTE1)
+* \param[in] ulRxBuffer: Reception buffer of the stream
+* \param[out] abReceived: Chunks received intact
+* \return Number of chunks received intact
+***************************************************************************************************/
+static unsigned int ulReadAll(MemoryStream& clStream, const unsigned int ulRxBuffer, bool* abReceived)
+{
+    CommsManager_cl clCommsManager;
+    unsigned char aucMessage[sizeof(RecorderChunk_st)];
+    unsigned int ulMsgLength = 0;
+    MessageID_e eMsgId = MESSAGEID_COUNT;
+    unsigned int ulIntact = 0;
+
+    /* The reader may stop with bytes in its buffer (a corrupted message), so the periods go on after
+    the stream is empty */
+    for (unsigned int ulPeriod = 0; ulPeriod < MAX_PERIODS_UL; ulPeriod++)
+    {
+        clStream.vReceive(ulRxBuffer);
+        while (clCommsManager.bReadInputMessage(clStream, aucMessage, ulMsgLength, eMsgId))
+        {
+            RecorderChunk_st stChunk;
+            memcpy(&stChunk, aucMessage, sizeof(stChunk));
+            RecorderChunk_st stExpected = stMakeChunk(stChunk.usChunk);
+            if (eMsgId == MESSAGEID_RECORDERCHUNK && ulMsgLength == sizeof(stChunk) &&
+                stChunk.usChunk < NUM_MESSAGES_UL && memcmp(&stChunk, &stExpected, sizeof(stChunk)) == 0 &&
+                !abReceived[stChunk.usChunk])
+            {
+                abReceived[stChunk.usChunk] = true;
+                ulIntact++;
+            }
+        }
+    }
+
+    HOST_TEST_CHECK(clStream.bIsEmpty(), "bytes of the stream never read");
+    return ulIntact;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sends the chunks, optionally with noise between them and one corrupted chunk
+* \return Position of the corrupted chunk in the stream
+***************************************************************************************************/
+static unsigned int ulSendAll(MemoryStream& clStream, const bool bNoise, const unsigned int ulCorrupted)
+{
+    CommsManager_cl clCommsManager;
+    unsigned int ulCorruptPos = 0;
+    for (unsigned int ulIdx = 0; ulIdx < NUM_MESSAGES_UL; ulIdx++)
+    {
+        if (bNoise)
+        {
+            unsigned int ulNoise = rand() % 20;
+            for (unsigned int ulByte = 0; ulByte < ulNoise; ulByte++)
+            {
+                clStream.write(static_cast<uint8_t>(rand()));
+            }
+        }
+        if (ulIdx == ulCorrupted)
+        {
+            ulCorruptPos = clStream.ulGetLength() + sizeof(MsgHeader_st) + 3;
+        }
+        clCommsManager.vSendMessage(stMakeChunk(ulIdx), MESSAGEID_RECORDERCHUNK, clStream);
+    }
+    return ulCorruptPos;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the test
+***************************************************************************************************/
+int main()
+{
+    srand(1);
+
+    /* Reception buffers of the AVR and larger than the input buffer */
+    const unsigned int aulRxBuffers[] = {AVR_RX_BUFFER_UL, LARGE_RX_BUFFER_UL};
+    for (unsigned int ulRxBuffer : aulRxBuffers)
+    {
+        MemoryStream clStream;
+        bool abReceived[NUM_MESSAGES_UL] = {};
+        ulSendAll(clStream, false, NUM_MESSAGES_UL);
+        unsigned int ulIntact = ulReadAll(clStream, ulRxBuffer, abReceived);
+        HOST_TEST_CHECK(ulIntact == NUM_MESSAGES_UL, "reception buffer %u: %u of %u chunks", ulRxBuffer, ulIntact,
+                        NUM_MESSAGES_UL);
+    }
+
+    /* Noise and one corrupted chunk: only that one is lost */
+    const unsigned int CORRUPTED_UL = NUM_MESSAGES_UL / 2;
+    MemoryStream clStream;
+    bool abReceived[NUM_MESSAGES_UL] = {};
+    clStream.vCorrupt(ulSendAll(clStream, true, CORRUPTED_UL));
+    unsigned int ulIntact = ulReadAll(clStream, AVR_RX_BUFFER_UL, abReceived);
+    HOST_TEST_CHECK(ulIntact == NUM_MESSAGES_UL - 1 && !abReceived[CORRUPTED_UL], "noise: %u of %u chunks",
+                    ulIntact, NUM_MESSAGES_UL - 1);
+
+    printf("Input buffer %u bytes, longest message %u bytes (host layout)\n", INPUT_BUFFER_LENGTH_UL,
+           static_cast<unsigned int>(sizeof(MsgHeader_st) + sizeof(RecorderChunk_st) + NUM_CHECKSUM_BYTES_UC));
+    HOST_TEST_END("CommsManagerTest");
+}
@@ -0,0 +1,144 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <EEPROM.h>
+#include <EepromJournal.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Simulates a power loss after every byte of a record that overwrites an old valid one, with
+random payloads. The journal must always come back with the last complete record or the new one,
+never with a mix of both (a torn record that happens to match the CRC, ~1 in 256)
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const uint16_t      START_ADDRESS_US = 16;   /**< First EEPROM address of the test journal   */
+static const uint16_t      NUM_SLOTS_US     = 2;    /**< Slots of the ring (the third write wraps)  */
+static const unsigned long NUM_TRIALS_UL    = 4000; /**< Random payload triplets                    */
+static const unsigned char MAX_STEPS_UC     = 32;   /**< Upper bound of the byte writes of a record */
+
+/********************************************* TYPES **********************************************/
+/***********************************************************************************************//**
+ * \struct TestPayload_st
+ * \brief Data stored in the test journal
+ **************************************************************************************************/
+struct TestPayload_st
+{
+    uint8_t aucData[4]; /**< Random bytes */
+};
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Erases the EEPROM region of the test journal
+***************************************************************************************************/
+static void vEraseJournal()
+{
+    for (uint16_t usAddress = START_ADDRESS_US; usAddress < START_ADDRESS_US + NUM_SLOTS_US * MAX_STEPS_UC; usAddress++)
+    {
+        EEPROM.write(usAddress, 0xFF);
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Writes a whole record
+***************************************************************************************************/
+static void vWriteRecord(EepromJournal_cl<TestPayload_st>& clJournal, const TestPayload_st& stPayload)
+{
+    clJournal.vWrite(stPayload);
+    while (clJournal.bIsBusy())
+    {
+        clJournal.vProcess();
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Random payload
+***************************************************************************************************/
+static TestPayload_st stRandomPayload()
+{
+    TestPayload_st stPayload;
+    for (unsigned char ucIdx = 0; ucIdx < sizeof(stPayload.aucData); ucIdx++)
+    {
+        stPayload.aucData[ucIdx] = rand() & 0xFF;
+    }
+    return stPayload;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the checks
+***************************************************************************************************/
+int main()
+{
+    srand(1);
+
+    /* Empty journal */
+    {
+        vEraseJournal();
+        EepromJournal_cl<TestPayload_st> clJournal;
+        TestPayload_st stRead;
+        HOST_TEST_CHECK(!clJournal.bSetup(START_ADDRESS_US, NUM_SLOTS_US, stRead), "erased journal found a record");
+    }
+
+    /* Power loss after each byte write of a record that overwrites the oldest one */
+    unsigned long ulTornMixes = 0;
+    unsigned long ulTears     = 0;
+    for (unsigned long ulTrial = 0; ulTrial < NUM_TRIALS_UL; ulTrial++)
+    {
+        TestPayload_st stOldest = stRandomPayload();
+        TestPayload_st stNewest = stRandomPayload();
+        TestPayload_st stNew    = stRandomPayload();
+
+        for (unsigned char ucSteps = 0; ucSteps < MAX_STEPS_UC; ucSteps++)
+        {
+            vEraseJournal();
+            EepromJournal_cl<TestPayload_st> clWriter;
+            TestPayload_st stRead;
+            clWriter.bSetup(START_ADDRESS_US, NUM_SLOTS_US, stRead);
+            vWriteRecord(clWriter, stOldest);
+            vWriteRecord(clWriter, stNewest);
+
+            /* Interrupted write of the new record over stOldest */
+            clWriter.vWrite(stNew);
+            unsigned char ucDone = 0;
+            while (clWriter.bIsBusy() && ucDone < ucSteps)
+            {
+                clWriter.vProcess();
+                ucDone++;
+            }
+            bool bComplete = !clWriter.bIsBusy();
+
+            /* Restart */
+            EepromJournal_cl<TestPayload_st> clReader;
+            memset(&stRead, 0, sizeof(stRead));
+            bool bFound = clReader.bSetup(START_ADDRESS_US, NUM_SLOTS_US, stRead);
+            const TestPayload_st& stExpected = bComplete ? stNew : stNewest;
+            HOST_TEST_CHECK(bFound, "no record after %u byte writes", ucSteps);
+            if (memcmp(&stRead, &stExpected, sizeof(stRead)) != 0)
+            {
+                ulTornMixes++;
+            }
+            ulTears++;
+
+            /* The journal goes on after the restart */
+            TestPayload_st stNext = stRandomPayload();
+            vWriteRecord(clReader, stNext);
+            EepromJournal_cl<TestPayload_st> clCheck;
+            HOST_TEST_CHECK(clCheck.bSetup(START_ADDRESS_US, NUM_SLOTS_US, stRead) &&
+                            memcmp(&stRead, &stNext, sizeof(stRead)) == 0, "record after the restart not found");
+
+            if (bComplete)
+            {
+                break;
+            }
+        }
+    }
+    HOST_TEST_CHECK(ulTornMixes == 0, "%lu of %lu power losses restored a torn record", ulTornMixes, ulTears);
+
+    HOST_TEST_END("EepromJournalTest");
+}
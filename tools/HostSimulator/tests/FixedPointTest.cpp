@@ -0,0 +1,164 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <FixedPoint.h>
+#include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Checks slMulQ16() against a 64 bits reference (truncated towards zero, as the partial
+products do), including the saturation of out of range products
+- NOTE2: Checks slDivQ16() against a 64 bits reference in the same way, including the division by 0
+and quotients whose integer part does not fit, and the saturation of slFloatToQ16()
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const unsigned long RANDOM_PRODUCTS_UL  = 1000000; /**< Random factor pairs to be checked    */
+static const unsigned long RANDOM_QUOTIENTS_UL = 1000000; /**< Random dividend/divisor to be checked */
+
+/* The conversion still works at compile time */
+static_assert(slFloatToQ16(1.5f) == 98304, "slFloatToQ16() at compile time");
+static_assert(slFloatToQ16(1.0e6f) == Q16_MAX_SL && slFloatToQ16(-1.0e6f) == Q16_MIN_SL, "slFloatToQ16() saturation at compile time");
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Reference Q16 product with 64 bits arithmetic, saturated to the Q16 range
+***************************************************************************************************/
+static int32_t slReferenceMulQ16(const int32_t slA, const int32_t slB)
+{
+    int64_t sllProduct = static_cast<int64_t>(slA) * slB;
+    int64_t sllResult  = (sllProduct < 0 ? -(-sllProduct >> 16) : sllProduct >> 16);
+    if (sllResult > Q16_MAX_SL)
+    {
+        return Q16_MAX_SL;
+    }
+    if (sllResult < Q16_MIN_SL)
+    {
+        return Q16_MIN_SL;
+    }
+    return static_cast<int32_t>(sllResult);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Reference Q16 quotient with 64 bits arithmetic, saturated to the Q16 range. Division by 0
+* gives the limit with the sign of the dividend (0 for 0/0)
+***************************************************************************************************/
+static int32_t slReferenceDivQ16(const int32_t slNum, const int32_t slDen)
+{
+    if (slDen == 0)
+    {
+        return slNum == 0 ? 0 : (slNum > 0 ? Q16_MAX_SL : Q16_MIN_SL);
+    }
+    int64_t sllResult = static_cast<int64_t>(slNum) * 65536 / slDen;
+    if (sllResult > Q16_MAX_SL)
+    {
+        return Q16_MAX_SL;
+    }
+    if (sllResult < Q16_MIN_SL)
+    {
+        return Q16_MIN_SL;
+    }
+    return static_cast<int32_t>(sllResult);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Random 32 bits value, with a random magnitude so that all the ranges are covered
+***************************************************************************************************/
+static int32_t slRandomQ16()
+{
+    uint32_t ulValue = (static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand());
+    return static_cast<int32_t>(ulValue) >> (rand() % 32);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the checks
+***************************************************************************************************/
+int main()
+{
+    /* Products in range and at the limits */
+    HOST_TEST_CHECK(slMulQ16(Q16_ONE_SL, Q16_ONE_SL) == Q16_ONE_SL, "1*1");
+    HOST_TEST_CHECK(slMulQ16(-Q16_ONE_SL, Q16_ONE_SL) == -Q16_ONE_SL, "-1*1");
+    HOST_TEST_CHECK(slMulQ16(slFloatToQ16(400.0f), slFloatToQ16(0.0345575f)) ==
+                    slReferenceMulQ16(slFloatToQ16(400.0f), slFloatToQ16(0.0345575f)), "rpm to section speed");
+    HOST_TEST_CHECK(slMulQ16(Q16_MAX_SL, Q16_ONE_SL) == Q16_MAX_SL, "max*1");
+    HOST_TEST_CHECK(slMulQ16(Q16_MIN_SL, Q16_ONE_SL) == Q16_MIN_SL, "min*1");
+    HOST_TEST_CHECK(slMulQ16(slFloatToQ16(-128.0f), slFloatToQ16(256.0f)) == Q16_MIN_SL, "-128*256");
+
+    /* Out of range products saturate instead of wrapping around */
+    HOST_TEST_CHECK(slMulQ16(slFloatToQ16(256.0f), slFloatToQ16(128.0f)) == Q16_MAX_SL, "256*128");
+    HOST_TEST_CHECK(slMulQ16(slFloatToQ16(1000.0f), slFloatToQ16(-1000.0f)) == Q16_MIN_SL, "1000*-1000");
+    HOST_TEST_CHECK(slMulQ16(Q16_MIN_SL, Q16_MIN_SL) == Q16_MAX_SL, "min*min");
+    HOST_TEST_CHECK(slMulQ16(Q16_MIN_SL, -Q16_ONE_SL) == Q16_MAX_SL, "min*-1");
+    HOST_TEST_CHECK(slMulQ16(slFloatToQ16(181.02f), slFloatToQ16(181.02f)) == Q16_MAX_SL, "carry of the partial products");
+
+    /* Random factors of all magnitudes */
+    srand(1);
+    unsigned long ulMismatches = 0;
+    for (unsigned long ulIndex = 0; ulIndex < RANDOM_PRODUCTS_UL; ulIndex++)
+    {
+        int32_t slA = slRandomQ16();
+        int32_t slB = slRandomQ16();
+        if (slMulQ16(slA, slB) != slReferenceMulQ16(slA, slB))
+        {
+            if (ulMismatches++ < 10)
+            {
+                HOST_TEST_CHECK(false, "%d * %d = %d, expected %d", slA, slB, slMulQ16(slA, slB),
+                                slReferenceMulQ16(slA, slB));
+            }
+        }
+    }
+    HOST_TEST_CHECK(ulMismatches == 0, "%lu of %lu random products differ", ulMismatches, RANDOM_PRODUCTS_UL);
+
+    /* Quotients in range and at the limits */
+    HOST_TEST_CHECK(slDivQ16(Q16_ONE_SL, 3 * Q16_ONE_SL) == 21845, "1/3");
+    HOST_TEST_CHECK(slDivQ16(-Q16_ONE_SL, 3 * Q16_ONE_SL) == -21845, "-1/3");
+    HOST_TEST_CHECK(slDivQ16(Q16_MIN_SL, Q16_ONE_SL) == Q16_MIN_SL, "min/1");
+    HOST_TEST_CHECK(slDivQ16(Q16_MAX_SL, Q16_ONE_SL) == Q16_MAX_SL, "max/1");
+    HOST_TEST_CHECK(slDivQ16(Q16_MIN_SL, 2 * Q16_ONE_SL) == -(Q16_ONE_SL << 14), "min/2");
+
+    /* Division by 0 */
+    HOST_TEST_CHECK(slDivQ16(Q16_ONE_SL, 0) == Q16_MAX_SL, "1/0");
+    HOST_TEST_CHECK(slDivQ16(-Q16_ONE_SL, 0) == Q16_MIN_SL, "-1/0");
+    HOST_TEST_CHECK(slDivQ16(Q16_MIN_SL, 0) == Q16_MIN_SL, "min/0");
+    HOST_TEST_CHECK(slDivQ16(0, 0) == 0, "0/0");
+
+    /* Out of range quotients saturate, also when the integer part does not fit in 16 bits */
+    HOST_TEST_CHECK(slDivQ16(Q16_MIN_SL, -Q16_ONE_SL) == Q16_MAX_SL, "min/-1");
+    HOST_TEST_CHECK(slDivQ16(slFloatToQ16(20000.0f), slFloatToQ16(0.5f)) == Q16_MAX_SL, "20000/0.5");
+    HOST_TEST_CHECK(slDivQ16(slFloatToQ16(-20000.0f), slFloatToQ16(0.5f)) == Q16_MIN_SL, "-20000/0.5");
+    HOST_TEST_CHECK(slDivQ16(slFloatToQ16(1000.0f), slFloatToQ16(0.001f)) == Q16_MAX_SL, "1000/0.001");
+    HOST_TEST_CHECK(slDivQ16(slFloatToQ16(1000.0f), -1) == Q16_MIN_SL, "1000/-1.5e-5");
+
+    /* Random dividends and divisors of all magnitudes */
+    ulMismatches = 0;
+    for (unsigned long ulIndex = 0; ulIndex < RANDOM_QUOTIENTS_UL; ulIndex++)
+    {
+        int32_t slNum = slRandomQ16();
+        int32_t slDen = slRandomQ16();
+        if (slDivQ16(slNum, slDen) != slReferenceDivQ16(slNum, slDen))
+        {
+            if (ulMismatches++ < 10)
+            {
+                HOST_TEST_CHECK(false, "%d / %d = %d, expected %d", slNum, slDen, slDivQ16(slNum, slDen),
+                                slReferenceDivQ16(slNum, slDen));
+            }
+        }
+    }
+    HOST_TEST_CHECK(ulMismatches == 0, "%lu of %lu random quotients differ", ulMismatches, RANDOM_QUOTIENTS_UL);
+
+    /* Conversion of out of range values */
+    HOST_TEST_CHECK(slFloatToQ16(32767.5f) == 2147450880, "32767.5");
+    HOST_TEST_CHECK(slFloatToQ16(32768.0f) == Q16_MAX_SL, "32768");
+    HOST_TEST_CHECK(slFloatToQ16(-32768.0f) == Q16_MIN_SL, "-32768");
+    HOST_TEST_CHECK(slFloatToQ16(1.0e9f) == Q16_MAX_SL, "1e9");
+    HOST_TEST_CHECK(slFloatToQ16(-1.0e9f) == Q16_MIN_SL, "-1e9");
+    HOST_TEST_CHECK(slFloatToQ16(INFINITY) == Q16_MAX_SL, "+inf");
+    HOST_TEST_CHECK(slFloatToQ16(-INFINITY) == Q16_MIN_SL, "-inf");
+    HOST_TEST_CHECK(slFloatToQ16(NAN) == 0, "NaN");
+
+    HOST_TEST_END("FixedPointTest");
+}
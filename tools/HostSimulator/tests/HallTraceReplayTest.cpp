@@ -0,0 +1,164 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <SimCore.h>
+#include <ActuadorLineal.h>
+#include <stdint.h>
+#include <stdio.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Replays hall sensor edge traces (tests/data) into the servo ISR, and checks that every pulse
+is counted and every bounce is rejected by the debounce filter. Each trace is a CSV file with one edge
+per line (time [us], level), and a "# expect pulses=N glitches=M" comment line
+- NOTE2: The traces are synthetic (see the comments of each file), built from the top speed of the
+pitch servo and typical contact bounce. Traces captured on the turbine can be added with the same
+format
+- NOTE3: Run from the HostSimulator folder ("make test"), the trace paths are relative to it
+- NOTE4: The traces are replayed again through an interrupt function attached with
+vAttachHallSensorIsr(), as the interrupt monitor of the control sketch does. It must see the same
+pulses and glitches, and the interval of each glitch in microseconds (inside the debounce window)
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const int RETRACTION_PIN = 22;   /**< Retraction relay of the test servo               */
+static const int EXTENSION_PIN  = 23;   /**< Extension relay of the test servo                */
+static const int HALL_PIN       = 18;   /**< Hall sensor of the test servo                    */
+static const int MAX_TURNS      = 1000; /**< Turns of the whole length (more than any trace) */
+
+static const char* const TRACE_FILES[] = /**< Replayed traces */
+{
+    "tests/data/top_speed_clean.csv",
+    "tests/data/top_speed_bounce.csv",
+    "tests/data/fast_400hz_bounce.csv",
+};
+
+/******************************************** GLOBALS *********************************************/
+static LinearServo_cl* pclServo_      = NULL; /**< Servo of vMonitoredHallIsr() (see NOTE4)     */
+static unsigned long   ulIsrPulses_   = 0;    /**< Pulses accepted, seen by vMonitoredHallIsr() */
+static unsigned long   ulIsrGlitches_ = 0;    /**< Pulses rejected, seen by vMonitoredHallIsr() */
+static unsigned long   ulMinGlitchUs_ = 0;    /**< Shortest interval of a rejected pulse [us]   */
+static unsigned long   ulMaxGlitchUs_ = 0;    /**< Longest interval of a rejected pulse [us]    */
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Hall sensor interrupt that forwards the pulses to the servo and counts them (see NOTE4)
+***************************************************************************************************/
+static void vMonitoredHallIsr()
+{
+    unsigned long ulIntervalUs = 0;
+    if (pclServo_->bReadHallSensor(ulIntervalUs))
+    {
+        ulIsrPulses_++;
+    }
+    else
+    {
+        ulMinGlitchUs_ = ulIsrGlitches_ == 0 ? ulIntervalUs : min(ulMinGlitchUs_, ulIntervalUs);
+        ulMaxGlitchUs_ = max(ulMaxGlitchUs_, ulIntervalUs);
+        ulIsrGlitches_++;
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Replays a trace into the servo while it is extending, and checks the counts
+***************************************************************************************************/
+static void vReplayTrace(LinearServo_cl& clServo, const char* pscFileName)
+{
+    FILE* pstFile = fopen(pscFileName, "r");
+    HOST_TEST_CHECK(pstFile != NULL, "can't open %s", pscFileName);
+    if (pstFile == NULL)
+    {
+        return;
+    }
+
+    /* The servo extends (relays energised) during the whole trace. The relays are not switched
+    before SERVO_MIN_DWELL_MS_UL */
+    vSimAdvanceUs(SERVO_MIN_DWELL_MS_UL * 1000);
+    clServo.vSetExtensionPercentage(100.0f);
+    clServo.vOperate();
+    HOST_TEST_CHECK(bSimIsOutputLow(EXTENSION_PIN), "%s: the servo did not start extending", pscFileName);
+    int           slStartTurns    = clServo.ulGetCurrentTurns();
+    unsigned long ulStartRejected = clServo.ulGetRejectedPulses();
+    ulIsrPulses_   = 0;
+    ulIsrGlitches_ = 0;
+    ulMinGlitchUs_ = 0;
+    ulMaxGlitchUs_ = 0;
+
+    uint64_t      ullStartUs        = ullSimGetTimeUs();
+    unsigned long ulExpectedPulses  = 0;
+    unsigned long ulExpectedGlitches = 0;
+    unsigned long ulEdges           = 0;
+    char          ascLine[128];
+    while (fgets(ascLine, sizeof(ascLine), pstFile) != NULL)
+    {
+        unsigned long ulTimeUs = 0;
+        int           slLevel  = 0;
+        if (ascLine[0] == '#')
+        {
+            sscanf(ascLine, "# expect pulses=%lu glitches=%lu", &ulExpectedPulses, &ulExpectedGlitches);
+        }
+        else if (sscanf(ascLine, "%lu,%d", &ulTimeUs, &slLevel) == 2)
+        {
+            if (ullStartUs + ulTimeUs > ullSimGetTimeUs())
+            {
+                vSimAdvanceUs(ullStartUs + ulTimeUs - ullSimGetTimeUs());
+            }
+            vSimSetPinInput(HALL_PIN, slLevel != 0 ? HIGH : LOW);
+            ulEdges++;
+        }
+    }
+    fclose(pstFile);
+
+    unsigned long ulPulses   = clServo.ulGetCurrentTurns() - slStartTurns;
+    unsigned long ulGlitches = clServo.ulGetRejectedPulses() - ulStartRejected;
+    HOST_TEST_CHECK(ulEdges > 0 && ulExpectedPulses > 0, "%s: empty trace or no expected counts", pscFileName);
+    HOST_TEST_CHECK(ulPulses == ulExpectedPulses, "%s: %lu pulses counted, %lu expected", pscFileName, ulPulses, ulExpectedPulses);
+    HOST_TEST_CHECK(ulGlitches == ulExpectedGlitches, "%s: %lu glitches, %lu expected", pscFileName, ulGlitches, ulExpectedGlitches);
+    printf("  %s: %lu edges, %lu pulses, %lu glitches\n", pscFileName, ulEdges, ulPulses, ulGlitches);
+
+    /* Attached interrupt function (see NOTE4) */
+    if (pclServo_ != NULL)
+    {
+        HOST_TEST_CHECK(ulIsrPulses_ == ulPulses && ulIsrGlitches_ == ulGlitches, "%s: %lu pulses and %lu glitches seen by the ISR",
+                        pscFileName, ulIsrPulses_, ulIsrGlitches_);
+        HOST_TEST_CHECK(ulGlitches == 0 || (ulMinGlitchUs_ > 0 && ulMaxGlitchUs_ < HALL_DEBOUNCE_US_UL),
+                        "%s: glitch intervals %lu to %lu us", pscFileName, ulMinGlitchUs_, ulMaxGlitchUs_);
+        if (ulIsrGlitches_ > 0)
+        {
+            printf("    through vAttachHallSensorIsr(): glitches %lu to %lu us after the last pulse\n", ulMinGlitchUs_, ulMaxGlitchUs_);
+        }
+    }
+
+    /* Stop the servo where it is, for the next trace */
+    vSimAdvanceUs(SERVO_MIN_DWELL_MS_UL * 1000);
+    clServo.vSetExtensionPercentage(clServo.fGetExtensionPercentage());
+    clServo.vOperate();
+    HOST_TEST_CHECK(!bSimIsOutputLow(EXTENSION_PIN) && !bSimIsOutputLow(RETRACTION_PIN), "%s: the servo did not stop", pscFileName);
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the checks
+***************************************************************************************************/
+int main()
+{
+    static LinearServo_cl clServo;
+    HOST_TEST_CHECK(clServo.bSetup(RETRACTION_PIN, EXTENSION_PIN, HALL_PIN, 100.0f, 100.0f, MAX_TURNS, 0), "servo not attached");
+    for (const char* pscFileName : TRACE_FILES)
+    {
+        vReplayTrace(clServo, pscFileName);
+    }
+
+    /* The same traces through an attached interrupt function (see NOTE4), from the start again */
+    HOST_TEST_CHECK(clServo.bSetup(RETRACTION_PIN, EXTENSION_PIN, HALL_PIN, 100.0f, 100.0f, MAX_TURNS, 0), "servo not attached");
+    pclServo_ = &clServo;
+    clServo.vAttachHallSensorIsr(vMonitoredHallIsr);
+    for (const char* pscFileName : TRACE_FILES)
+    {
+        vReplayTrace(clServo, pscFileName);
+    }
+
+    HOST_TEST_END("HallTraceReplayTest");
+}
@@ -0,0 +1,43 @@
+#ifndef HOST_TEST_H_
+#define HOST_TEST_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdio.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Minimal checks for the host tests (tests folder) and benchmarks (bench folder). Each test is
+a program that links the firmware objects (sketch and libraries on the shim core), counts the failed
+checks and returns the count, so "make test" stops at the first failing program
+*/
+
+/******************************************** GLOBALS *********************************************/
+static unsigned long ulHostTestFailures_ = 0; /**< Number of failed checks */
+
+/******************************************** MACROS **********************************************/
+/** Checks a condition, printing the location and a message if it does not hold */
+#define HOST_TEST_CHECK(bCondition, ...)                                        \
+    do                                                                          \
+    {                                                                           \
+        if (!(bCondition))                                                      \
+        {                                                                       \
+            ulHostTestFailures_++;                                              \
+            printf("  FAIL %s:%d: %s: ", __FILE__, __LINE__, #bCondition);      \
+            printf(__VA_ARGS__);                                                \
+            printf("\n");                                                       \
+        }                                                                       \
+    } while (0)
+
+/** Prints the result of the test and returns from main() with the number of failed checks */
+#define HOST_TEST_END(pscName)                                                            \
+    do                                                                                    \
+    {                                                                                     \
+        printf("%s: %s (%lu failed checks)\n", pscName,                                    \
+               ulHostTestFailures_ == 0 ? "PASS" : "FAIL", ulHostTestFailures_);          \
+        return ulHostTestFailures_ == 0 ? 0 : 1;                                          \
+    } while (0)
+
+#endif /* HOST_TEST_H_ */
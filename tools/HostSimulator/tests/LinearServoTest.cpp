@@ -0,0 +1,160 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <SimCore.h>
+#include <ActuadorLineal.h>
+#include <math.h>
+#include <stdint.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Three servos with their own relays, hall sensor pins and speeds move at the same time. Each
+one must reach its own target and count only the pulses of its own sensor. A fourth servo can't get
+an interrupt slot: bSetup() fails and its relays are never energised
+- NOTE2: The actuators are ideal motors: they move while one relay is energised (LOW) and stop when
+both are released, with a hall pulse at every integer turn
+- NOTE3: A stop command is applied at the next vOperate(), even right after a start. Only the next
+start waits for SERVO_MIN_DWELL_MS_UL after the stop
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const unsigned char NUM_SERVOS_UC     = LINEAR_SERVO_MAX_INSTANCES_UC;                /**< Servos with an interrupt slot   */
+static const int           RETRACTION_PINS[] = {22, 24, 26};                                 /**< Retraction relay of each servo  */
+static const int           EXTENSION_PINS[]  = {23, 25, 27};                                 /**< Extension relay of each servo   */
+static const int           HALL_PINS[]       = {18, 19, 20};                                 /**< Hall sensor of each servo       */
+static const float         SPEEDS_TURNS_S[]  = {4.0f, 6.0f, 8.0f};                           /**< Speed of each actuator          */
+static const float         TOTAL_LENGTH_MM_F = 200.0f;                                       /**< Actuator length                 */
+static const float         USED_LENGTH_MM_F  = 50.0f;                                        /**< Length used (100 %)             */
+static const int           MAX_TURNS         = 104;                                          /**< Turns of the whole length       */
+static const float         MM_PER_TURN_F     = TOTAL_LENGTH_MM_F / MAX_TURNS;                /**< Extension of each turn          */
+static const uint64_t      MOVE_TIME_US_ULL  = 10000000;                                     /**< Time given to each movement     */
+static const uint64_t      STOP_AFTER_US_ULL = 50000;                                        /**< Movement before the stop        */
+
+/******************************************** GLOBALS *********************************************/
+static float    afPositionTurns_[NUM_SERVOS_UC] = {}; /**< Position of each actuator model [turns] */
+static uint64_t ullLastStepUs_                  = 0;  /**< Virtual time of the last step           */
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Step hook. Moves the actuator models and generates their hall pulses (see NOTE2)
+***************************************************************************************************/
+static void vMoveActuators(uint64_t ullNowUs, void* pvContext)
+{
+    (void)pvContext;
+    float fDeltaS = (ullNowUs - ullLastStepUs_) * 1e-6f;
+    ullLastStepUs_ = ullNowUs;
+
+    for (unsigned char ucServo = 0; ucServo < NUM_SERVOS_UC; ucServo++)
+    {
+        bool  bExtending  = bSimIsOutputLow(EXTENSION_PINS[ucServo]);
+        bool  bRetracting = bSimIsOutputLow(RETRACTION_PINS[ucServo]);
+        float fDirection  = (bExtending && !bRetracting) ? 1.0f : ((bRetracting && !bExtending) ? -1.0f : 0.0f);
+
+        float fPrevious = afPositionTurns_[ucServo];
+        afPositionTurns_[ucServo] += fDirection * SPEEDS_TURNS_S[ucServo] * fDeltaS;
+        if (floorf(afPositionTurns_[ucServo]) != floorf(fPrevious))
+        {
+            vSimSetPinInput(HALL_PINS[ucServo], HIGH);
+            vSimSetPinInput(HALL_PINS[ucServo], LOW);
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Requests a position to every servo and operates them until the movement time is over
+***************************************************************************************************/
+static void vMoveServos(LinearServo_cl (&aclServos)[NUM_SERVOS_UC], const float (&afPercent)[NUM_SERVOS_UC])
+{
+    for (unsigned char ucServo = 0; ucServo < NUM_SERVOS_UC; ucServo++)
+    {
+        aclServos[ucServo].vSetExtensionPercentage(afPercent[ucServo]);
+    }
+
+    uint64_t ullEndUs = ullSimGetTimeUs() + MOVE_TIME_US_ULL;
+    while (ullSimGetTimeUs() < ullEndUs)
+    {
+        for (unsigned char ucServo = 0; ucServo < NUM_SERVOS_UC; ucServo++)
+        {
+            aclServos[ucServo].vOperate();
+        }
+        vSimAdvanceUs(1000);
+    }
+
+    for (unsigned char ucServo = 0; ucServo < NUM_SERVOS_UC; ucServo++)
+    {
+        int slTargetTurns = static_cast<int>(afPercent[ucServo] / 100.0f * USED_LENGTH_MM_F / MM_PER_TURN_F);
+        int slCountedTurns = aclServos[ucServo].ulGetCurrentTurns();
+        int slModelTurns   = static_cast<int>(floorf(afPositionTurns_[ucServo]));
+        HOST_TEST_CHECK(abs(slCountedTurns - slTargetTurns) <= MAX_TURNS_ERROR_UL,
+                        "servo %u at %d turns, target %d", ucServo, slCountedTurns, slTargetTurns);
+        HOST_TEST_CHECK(abs(slCountedTurns - slModelTurns) <= 1,
+                        "servo %u counted %d turns, actuator at %d", ucServo, slCountedTurns, slModelTurns);
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the checks
+***************************************************************************************************/
+int main()
+{
+    vSimSetStepHook(vMoveActuators, NULL);
+
+    /* Three servos at a known position (no calibration) */
+    static LinearServo_cl aclServos[NUM_SERVOS_UC];
+    for (unsigned char ucServo = 0; ucServo < NUM_SERVOS_UC; ucServo++)
+    {
+        HOST_TEST_CHECK(aclServos[ucServo].bSetup(RETRACTION_PINS[ucServo], EXTENSION_PINS[ucServo], HALL_PINS[ucServo],
+                                                  TOTAL_LENGTH_MM_F, USED_LENGTH_MM_F, MAX_TURNS, 0),
+                        "servo %u not attached", ucServo);
+        HOST_TEST_CHECK(!aclServos[ucServo].bIsCalibrating(), "servo %u calibrating from a known position", ucServo);
+    }
+
+    /* No interrupt slot left for a fourth servo */
+    static LinearServo_cl clExtraServo;
+    HOST_TEST_CHECK(!clExtraServo.bSetup(28, 29, 2, TOTAL_LENGTH_MM_F, USED_LENGTH_MM_F, MAX_TURNS, 0),
+                    "fourth servo attached");
+    clExtraServo.vSetExtensionPercentage(50.0f);
+    clExtraServo.vOperate();
+    HOST_TEST_CHECK(!bSimIsOutputLow(28) && !bSimIsOutputLow(29), "relays of the fourth servo energised");
+
+    /* Simultaneous movements to different targets, out and back */
+    static const float afOut[NUM_SERVOS_UC]  = {100.0f, 60.0f, 30.0f};
+    static const float afBack[NUM_SERVOS_UC] = {20.0f, 80.0f, 0.0f};
+    vMoveServos(aclServos, afOut);
+    vMoveServos(aclServos, afBack);
+
+    for (unsigned char ucServo = 0; ucServo < NUM_SERVOS_UC; ucServo++)
+    {
+        HOST_TEST_CHECK(ulSimGetIsrCount(HALL_PINS[ucServo]) > 0, "no pulses on servo %u", ucServo);
+        HOST_TEST_CHECK(aclServos[ucServo].ulGetRejectedPulses() == 0, "servo %u rejected pulses", ucServo);
+    }
+
+    /* Stop shortly after a start, then ask for the movement again (see NOTE3) */
+    const unsigned char ucServo = NUM_SERVOS_UC - 1;
+    LinearServo_cl& clServo = aclServos[ucServo];
+    clServo.vSetExtensionPercentage(100.0f);
+    clServo.vOperate();
+    HOST_TEST_CHECK(clServo.eGetState() == SERVOSTATE_EXTENDING, "servo %u not started", ucServo);
+    vSimAdvanceUs(STOP_AFTER_US_ULL);
+    clServo.vSetExtensionPercentage(0.0f);
+    clServo.vOperate();
+    HOST_TEST_CHECK(clServo.eGetState() == SERVOSTATE_STOPPED && !bSimIsOutputLow(EXTENSION_PINS[ucServo]) &&
+                    !bSimIsOutputLow(RETRACTION_PINS[ucServo]),
+                    "stop %llu ms after the start delayed by the dwell", STOP_AFTER_US_ULL / 1000ULL);
+
+    uint64_t ullStopUs = ullSimGetTimeUs();
+    clServo.vSetExtensionPercentage(100.0f);
+    while (clServo.eGetState() == SERVOSTATE_STOPPED && ullSimGetTimeUs() - ullStopUs < MOVE_TIME_US_ULL)
+    {
+        vSimAdvanceUs(1000);
+        clServo.vOperate();
+    }
+    unsigned long ulRestartMs = static_cast<unsigned long>((ullSimGetTimeUs() - ullStopUs) / 1000ULL);
+    HOST_TEST_CHECK(ulRestartMs + 1 >= SERVO_MIN_DWELL_MS_UL && ulRestartMs <= SERVO_MIN_DWELL_MS_UL + 1,
+                    "restart %lu ms after the stop, dwell %lu ms", ulRestartMs, SERVO_MIN_DWELL_MS_UL);
+
+    HOST_TEST_END("LinearServoTest");
+}
@@ -0,0 +1,182 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <avr/interrupt.h>
+#include <Arduino.h>
+#include <SoftwareSerial.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Loopback of the timer driven SoftwareSerial: the TX pin is wired to the RX pin, and a
+message written in one go must be read back intact, at all the supported baud rates and with
+inverse logic. The registers are those of tests/avr/interrupt.h
+- NOTE2: Each tick of the model is a tick of timer 4 (8 CPU cycles). A compare match or a pin change
+sets its flag, and the interrupt handler runs 5 to 19 ticks later (40 to 152 cycles, the entry
+latency plus a random delay for other interrupts)
+- NOTE3: Baud rates whose bit is shorter than the handlers can keep up with (57600 at 16 MHz) are
+rejected by begin(), and write() fails
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const uint8_t       TX_PIN_UC           = 1;                      /**< Transmit pin (port B, bit 1)                    */
+static const uint8_t       RX_PIN_UC           = 2;                      /**< Receive pin (port B, bit 2)                     */
+static const unsigned long TICKS_PER_SECOND_UL = F_CPU / 8;              /**< Ticks of timer 4 per second                     */
+static const long          MIN_BIT_TICKS_L     = 48;                     /**< Shortest bit accepted by begin() (MIN_BIT_TICKS) */
+static const long          MIN_LATENCY_TICKS_L = 5;                      /**< Shortest delay of an interrupt handler          */
+static const long          LATENCY_RANGE_L     = 15;                     /**< Random part of the delay of a handler           */
+static const char          MESSAGE_SC[]        = "Hello SoftwareSerial 0123456789\x00\xff\x55\xaa"; /**< Bytes sent  */
+static const size_t        MESSAGE_LENGTH_UL   = sizeof(MESSAGE_SC) - 1; /**< Bytes of the message                            */
+
+/******************************************** GLOBALS *********************************************/
+/* Registers (see tests/avr/interrupt.h) */
+volatile uint8_t   SREG, TCCR4A, TCCR4B, TIMSK4, PCICR, PCMSK0, PORTB, PINB;
+volatile uint16_t  TCNT4, OCR4A, OCR4B;
+SimFlagRegister_st TIFR4;
+
+/* Interrupt handlers of the library */
+extern "C" void vSimPcint0Isr();
+extern "C" void vSimTimer4CompAIsr();
+extern "C" void vSimTimer4CompBIsr();
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Gets the delay of an interrupt handler (see NOTE2)
+***************************************************************************************************/
+static long slGetLatency()
+{
+    return MIN_LATENCY_TICKS_L + rand() % LATENCY_RANGE_L;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the model for a number of timer ticks, with the TX pin wired to the RX pin
+***************************************************************************************************/
+static void vRunTicks(const unsigned long ulTicks)
+{
+    long slPinChangeAt = -1;
+    long slCompareAAt  = -1;
+    long slCompareBAt  = -1;
+    for (long slNow = 0; slNow < static_cast<long>(ulTicks); slNow++)
+    {
+        TCNT4++;
+
+        /* Loopback. A change of the RX pin raises the pin change interrupt if it is enabled */
+        uint8_t ucTx = (PORTB >> TX_PIN_UC) & 0x01;
+        uint8_t ucRx = (PINB >> RX_PIN_UC) & 0x01;
+        PINB = (PINB & ~_BV(RX_PIN_UC)) | (ucTx << RX_PIN_UC);
+        if (ucTx != ucRx && (PCMSK0 & _BV(RX_PIN_UC)) != 0 && PCICR != 0 && slPinChangeAt < 0)
+        {
+            slPinChangeAt = slNow + slGetLatency();
+        }
+
+        /* Compare matches set their flag; the handler runs if its interrupt is enabled */
+        if (TCNT4 == OCR4A)
+        {
+            TIFR4.ucFlags |= _BV(OCF4A);
+        }
+        if (TCNT4 == OCR4B)
+        {
+            TIFR4.ucFlags |= _BV(OCF4B);
+        }
+        if ((TIFR4 & _BV(OCF4A)) != 0 && (TIMSK4 & _BV(OCIE4A)) != 0 && slCompareAAt < 0)
+        {
+            slCompareAAt = slNow + slGetLatency();
+        }
+        if ((TIFR4 & _BV(OCF4B)) != 0 && (TIMSK4 & _BV(OCIE4B)) != 0 && slCompareBAt < 0)
+        {
+            slCompareBAt = slNow + slGetLatency();
+        }
+
+        if (slPinChangeAt == slNow)
+        {
+            slPinChangeAt = -1;
+            vSimPcint0Isr();
+        }
+        if (slCompareAAt == slNow)
+        {
+            slCompareAAt = -1;
+            TIFR4 = _BV(OCF4A);
+            vSimTimer4CompAIsr();
+        }
+        if (slCompareBAt == slNow)
+        {
+            slCompareBAt = -1;
+            TIFR4 = _BV(OCF4B);
+            vSimTimer4CompBIsr();
+        }
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Sends the message at a baud rate and reads it back
+* \return Number of bytes read back
+***************************************************************************************************/
+static size_t ulLoopback(const long slBaud, const bool bInverse, char* pscReceived, size_t& ulWritten)
+{
+    /* Idle line: high, or low with inverse logic */
+    SREG   = _BV(SREG_I);
+    TCCR4A = 0xFF; /* As left by a PWM setup, to check that begin() takes the timer */
+    TCCR4B = 0;
+    TIFR4  = 0xFF;
+    PORTB  = bInverse ? 0x00 : 0xFF;
+    PINB   = PORTB;
+
+    SoftwareSerial clSerial(RX_PIN_UC, TX_PIN_UC, bInverse);
+    clSerial.begin(slBaud);
+    if (slBaud <= static_cast<long>(TICKS_PER_SECOND_UL) / MIN_BIT_TICKS_L)
+    {
+        HOST_TEST_CHECK(TCCR4A == 0 && TCCR4B == _BV(CS41), "%ld bauds: timer 4 not in normal mode with prescaler 8",
+                        slBaud);
+    }
+
+    /* All the bytes go to the FIFO at once; the timer sends them (start, 8 data and stop bits) */
+    ulWritten = 0;
+    for (size_t ulIdx = 0; ulIdx < MESSAGE_LENGTH_UL; ulIdx++)
+    {
+        ulWritten += clSerial.write(static_cast<uint8_t>(MESSAGE_SC[ulIdx]));
+    }
+    vRunTicks(TICKS_PER_SECOND_UL / slBaud * 10 * (MESSAGE_LENGTH_UL + 2));
+
+    size_t ulRead = 0;
+    int slByte = 0;
+    while (ulRead < MESSAGE_LENGTH_UL && (slByte = clSerial.read()) >= 0)
+    {
+        pscReceived[ulRead++] = static_cast<char>(slByte);
+    }
+    clSerial.end();
+    return ulRead;
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the test
+***************************************************************************************************/
+int main()
+{
+    srand(1);
+
+    const long aslBauds[] = {300, 1200, 9600, 19200, 38400};
+    for (unsigned char ucInverse = 0; ucInverse < 2; ucInverse++)
+    {
+        for (long slBaud : aslBauds)
+        {
+            char ascReceived[MESSAGE_LENGTH_UL];
+            size_t ulWritten = 0;
+            size_t ulRead = ulLoopback(slBaud, ucInverse != 0, ascReceived, ulWritten);
+            HOST_TEST_CHECK(ulWritten == MESSAGE_LENGTH_UL && ulRead == MESSAGE_LENGTH_UL &&
+                            memcmp(ascReceived, MESSAGE_SC, MESSAGE_LENGTH_UL) == 0,
+                            "%ld bauds, inverse %u: %zu written, %zu read back", slBaud, ucInverse, ulWritten, ulRead);
+        }
+    }
+
+    /* Too fast for the interrupt handlers (see NOTE3) */
+    char ascReceived[MESSAGE_LENGTH_UL];
+    size_t ulWritten = 0;
+    ulLoopback(57600, false, ascReceived, ulWritten);
+    HOST_TEST_CHECK(ulWritten == 0, "57600 bauds: %zu bytes written", ulWritten);
+
+    HOST_TEST_END("SoftwareSerialLoopbackTest");
+}
@@ -0,0 +1,108 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <Arduino.h>
+#include <SimCore.h>
+#include <TaskScheduler.h>
+#include <stdint.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Checks the earliest deadline first order between tasks of the same priority, and the
+releases and deadlines across the overflow of micros() (32 bits, also on the host)
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const uint64_t MICROS_OVERFLOW_ULL = 1ULL << 32; /**< Virtual time when micros() overflows [us] */
+static const uint64_t PASS_TIME_US_ULL    = 100;        /**< Virtual time of each scheduler pass [us]  */
+
+/******************************************** GLOBALS *********************************************/
+static unsigned char aucRunOrder_[8];    /**< Identifiers of the executed test tasks, in order */
+static unsigned char ucNumRuns_ = 0;     /**< Number of entries in aucRunOrder_                */
+static uint64_t      ullJumpToUs_ = 0;   /**< Virtual time set by the step hook (0: no jump)   */
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Step hook that moves the virtual clock forward once, to get close to the micros() overflow
+* without simulating the whole hour
+***************************************************************************************************/
+static void vJumpClock(uint64_t ullNowUs, void* pvContext)
+{
+    (void)pvContext;
+    if (ullJumpToUs_ > ullNowUs)
+    {
+        uint64_t ullDeltaUs = ullJumpToUs_ - ullNowUs;
+        ullJumpToUs_ = 0;
+        vSimAdvanceUs(ullDeltaUs);
+    }
+}
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Test tasks, recording their execution order
+***************************************************************************************************/
+static void vRecordRun(const unsigned char ucTask)
+{
+    if (ucNumRuns_ < sizeof(aucRunOrder_))
+    {
+        aucRunOrder_[ucNumRuns_++] = ucTask;
+    }
+}
+static void vTaskA() { vRecordRun('A'); }
+static void vTaskB() { vRecordRun('B'); }
+static void vTaskC() { vRecordRun('C'); }
+
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the checks
+***************************************************************************************************/
+int main()
+{
+    /* Same priority: the earliest absolute deadline runs first, whatever the order of addition */
+    {
+        TaskScheduler_cl clScheduler;
+        clScheduler.ucAddTask(vTaskA, 100, 50, 1);
+        clScheduler.ucAddTask(vTaskB, 100, 10, 1);
+        clScheduler.ucAddTask(vTaskC, 100, 0, 0);
+        ucNumRuns_ = 0;
+        clScheduler.vRun();
+        HOST_TEST_CHECK(ucNumRuns_ == 3 && aucRunOrder_[0] == 'C' && aucRunOrder_[1] == 'B' &&
+                        aucRunOrder_[2] == 'A', "order %.*s", ucNumRuns_, aucRunOrder_);
+    }
+
+    /* Releases and deadlines across the overflow of micros(). Task A is released 2 ms before the
+    overflow with a deadline after it, and task B just after it */
+    vSimSetStepHook(vJumpClock, NULL);
+    ullJumpToUs_ = MICROS_OVERFLOW_ULL - 2000;
+    vSimAdvanceUs(1);
+    vSimSetStepHook(NULL, NULL);
+    {
+        TaskScheduler_cl clScheduler;
+        unsigned char ucTaskA = clScheduler.ucAddTask(vTaskA, 5, 50, 1);
+        vSimAdvanceUs(2500);
+        unsigned char ucTaskB = clScheduler.ucAddTask(vTaskB, 5, 1, 1);
+        ucNumRuns_ = 0;
+        clScheduler.vRun();
+        HOST_TEST_CHECK(micros() < 1000, "micros() did not overflow (%lu)", micros());
+        HOST_TEST_CHECK(ucNumRuns_ == 2 && aucRunOrder_[0] == 'B' && aucRunOrder_[1] == 'A',
+                        "order %.*s", ucNumRuns_, aucRunOrder_);
+
+        /* One second of passes: one release every 5 ms, none missed */
+        clScheduler.vResetStats();
+        for (uint64_t ullTimeUs = 0; ullTimeUs < 1000000; ullTimeUs += PASS_TIME_US_ULL)
+        {
+            vSimAdvanceUs(PASS_TIME_US_ULL);
+            clScheduler.vRun();
+        }
+        HOST_TEST_CHECK(clScheduler.stGetStats(ucTaskA).ulRuns == 200, "task A runs %lu",
+                        static_cast<unsigned long>(clScheduler.stGetStats(ucTaskA).ulRuns));
+        HOST_TEST_CHECK(clScheduler.stGetStats(ucTaskB).ulRuns == 200, "task B runs %lu",
+                        static_cast<unsigned long>(clScheduler.stGetStats(ucTaskB).ulRuns));
+        HOST_TEST_CHECK(clScheduler.stGetStats(ucTaskA).ulDeadlineMisses == 0, "task A misses");
+        HOST_TEST_CHECK(clScheduler.stGetStats(ucTaskB).ulDeadlineMisses == 0, "task B misses");
+        HOST_TEST_CHECK(clScheduler.stGetStats(ucTaskA).ulMaxJitterUs <= PASS_TIME_US_ULL, "task A jitter %lu",
+                        static_cast<unsigned long>(clScheduler.stGetStats(ucTaskA).ulMaxJitterUs));
+    }
+
+    HOST_TEST_END("TaskSchedulerTest");
+}
@@ -0,0 +1,95 @@
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <FixedPoint.h>
+#include <WindPredictor.h>
+#include <stdint.h>
+
+/* Custom includes */
+#include "HostTest.h"
+
+
+/*
+- NOTE1: Checks the Holt update and the forecast of WindPredictor_cl against values computed by hand
+in Q16 (1.0 = 65536). Alpha 0.5 and beta 0.25 keep most of the products exact; the fourth sample
+checks the truncation of an odd product
+- NOTE2: The horizon is given in ms and converted to sample periods (250 ms): 1000 ms are 4 periods
+(262144 in Q16), 100 ms are 0.4 periods, truncated to 26214
+- NOTE3: A falling wind with alpha and beta 1 (level = sample, trend = last change) drives the
+forecast below 0, where it is clamped. Negative products are truncated towards zero
+*/
+
+/******************************************* CONSTANTS ********************************************/
+static const unsigned long SAMPLE_PERIOD_MS_UL = 250; /**< Period of the samples [ms] */
+
+/******************************************* FUNCTIONS ********************************************/
+/****************************************** FUNCTION *******************************************//**
+* \brief Runs the checks
+***************************************************************************************************/
+int main()
+{
+    WindPredictor_cl clPredictor;
+    clPredictor.vSetup(0.5f, 0.25f, SAMPLE_PERIOD_MS_UL, 1000);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 0, "forecast %d before the first sample",
+                    clPredictor.slGetForecastQ16());
+
+    /* First sample, 8 m/s: level 8, no trend */
+    clPredictor.vUpdate(524288);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 524288, "first sample: forecast %d, expected 524288",
+                    clPredictor.slGetForecastQ16());
+
+    /* 10 m/s: expected 524288, level 524288 + 0.5 * 131072 = 589824 (9 m/s), trend 0.25 * 65536 = 16384,
+    forecast 589824 + 4 * 16384 = 655360 (10 m/s) */
+    clPredictor.vUpdate(655360);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 655360, "second sample: forecast %d, expected 655360",
+                    clPredictor.slGetForecastQ16());
+
+    /* 10 m/s again: expected 606208, level 606208 + 0.5 * 49152 = 630784, trend
+    16384 + 0.25 * (40960 - 16384) = 22528, forecast 630784 + 4 * 22528 = 720896 (11 m/s) */
+    clPredictor.vUpdate(655360);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 720896, "third sample: forecast %d, expected 720896",
+                    clPredictor.slGetForecastQ16());
+    HOST_TEST_CHECK(clPredictor.fGetForecast() == 11.0f, "third sample: forecast %f m/s, expected 11",
+                    static_cast<double>(clPredictor.fGetForecast()));
+
+    /* 655361: expected 653312, 0.5 * 2049 = 1024.5 truncated to 1024, level 654336, trend
+    22528 + 0.25 * (23552 - 22528) = 22784, forecast 654336 + 4 * 22784 = 745472 */
+    clPredictor.vUpdate(655361);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 745472, "fourth sample: forecast %d, expected 745472",
+                    clPredictor.slGetForecastQ16());
+
+    /* Other horizons on the same state: none is the level, 0.4 periods adds 22784 * 26214 / 65536 = 9113 */
+    clPredictor.vSetHorizon(0);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 654336, "no horizon: forecast %d, expected 654336",
+                    clPredictor.slGetForecastQ16());
+    clPredictor.vSetHorizon(100);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 663449, "100 ms: forecast %d, expected 663449",
+                    clPredictor.slGetForecastQ16());
+
+    /* A new setup starts again from the next sample, without trend */
+    clPredictor.vSetup(0.5f, 0.25f, SAMPLE_PERIOD_MS_UL, 1000);
+    clPredictor.vUpdate(196608);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 196608, "new setup: forecast %d, expected 196608",
+                    clPredictor.slGetForecastQ16());
+
+    /* Falling wind, 2 m/s then 0.5 m/s: level 32768, trend -98304 (-1.5 m/s per sample) */
+    clPredictor.vSetup(1.0f, 1.0f, SAMPLE_PERIOD_MS_UL, 1000);
+    clPredictor.vUpdate(131072);
+    clPredictor.vUpdate(32768);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 0, "4 periods: forecast %d, expected the clamp at 0",
+                    clPredictor.slGetForecastQ16());
+    HOST_TEST_CHECK(clPredictor.fGetForecast() == 0.0f, "4 periods: forecast %f m/s, expected 0",
+                    static_cast<double>(clPredictor.fGetForecast()));
+    clPredictor.vSetHorizon(125);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 0, "0.5 periods: forecast %d, expected the clamp at 0 (-16384)",
+                    clPredictor.slGetForecastQ16());
+    clPredictor.vSetHorizon(0);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 32768, "no horizon: forecast %d, expected 32768",
+                    clPredictor.slGetForecastQ16());
+
+    /* 50 ms are 13107 periods in Q16: -98304 * 13107 / 65536 = -19660.8, truncated to -19660 */
+    clPredictor.vSetHorizon(50);
+    HOST_TEST_CHECK(clPredictor.slGetForecastQ16() == 13108, "50 ms: forecast %d, expected 13108",
+                    clPredictor.slGetForecastQ16());
+
+    HOST_TEST_END("WindPredictorTest");
+}
@@ -0,0 +1,71 @@
+#ifndef SIM_AVR_INTERRUPT_H_
+#define SIM_AVR_INTERRUPT_H_
+
+/******************************************** INCLUDES ********************************************/
+/* System includes */
+#include <stdint.h>
+
+/* Custom includes */
+
+
+/*
+- NOTE1: Registers of the ATmega2560 used by SoftwareSerial (timer 4, one port and its pin change
+interrupt), for the loopback test (SoftwareSerialLoopbackTest.cpp). They are plain variables: the
+test advances the timer, moves the pins and runs the interrupt handlers. Only that test includes
+this file; the shim core has no registers
+- NOTE2: All the pins are in port B, bits 0 to 7, and share the pin change interrupt 0
+- NOTE3: As on the AVR, writing a one to a bit of TIFR4 clears that flag; the test raises the flags
+through ucFlags
+*/
+
+/******************************************* CONSTANTS ********************************************/
+#define __AVR_ATmega2560__ 1
+
+#define SREG_I 7
+#define CS41   1
+#define OCIE4A 1
+#define OCIE4B 2
+#define OCF4A  1
+#define OCF4B  2
+
+/********************************************* TYPES **********************************************/
+/** Interrupt flag register (see NOTE3) */
+struct SimFlagRegister_st
+{
+    volatile uint8_t ucFlags; /**< Raised flags */
+
+    SimFlagRegister_st& operator=(const uint8_t ucClear)
+    {
+        ucFlags &= ~ucClear;
+        return *this;
+    }
+
+    operator uint8_t() const { return ucFlags; }
+};
+
+/******************************************** MACROS **********************************************/
+#define ISR(vector)                extern "C" void vector(void); void vector(void)
+#define PCINT0_vect                vSimPcint0Isr
+#define TIMER4_COMPA_vect          vSimTimer4CompAIsr
+#define TIMER4_COMPB_vect          vSimTimer4CompBIsr
+#define digitalPinToPCMSK(p)       (&PCMSK0)
+#define digitalPinToPCMSKbit(p)    ((p) & 7)
+#define digitalPinToPCICR(p)       (&PCICR)
+#define digitalPinToPCICRbit(p)    0
+#define digitalPinToPort(p)        (p)
+#define digitalPinToBitMask(p)     (1 << ((p) & 7))
+#define portOutputRegister(port)   ((void)(port), &PORTB)
+#define portInputRegister(port)    ((void)(port), &PINB)
+
+/******************************************** GLOBALS *********************************************/
+extern volatile uint8_t  SREG, TCCR4A, TCCR4B, TIMSK4, PCICR, PCMSK0, PORTB, PINB;
+extern volatile uint16_t TCNT4, OCR4A, OCR4B;
+extern SimFlagRegister_st TIFR4;
+
+/******************************************* FUNCTIONS ********************************************/
+inline void cli()
+{
+    SREG &= ~(1 << SREG_I);
+}
+
+#endif /* SIM_AVR_INTERRUPT_H_ */